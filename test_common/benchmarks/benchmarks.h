@@ -1,6 +1,6 @@
 //
-// Copyright (c) 2017 The Khronos Group Inc.
-// 
+// Copyright (c) 2026 The Khronos Group Inc.
+//
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
 // You may obtain a copy of the License at
@@ -13,23 +13,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
-#ifndef CONVERSIONS_FPLIB_H
-#define CONVERSIONS_FPLIB_H
-
-#include <stdbool.h>
-#include <stdint.h>
-
-typedef enum
-{
-    qcomRTZ = 0,
-    qcomRTE,
-    qcomRTP,
-    qcomRTN,
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
 
-    qcomRoundingModeCount
-}roundingMode;
+#include "harness/benchmarkHelpers.h"
 
-float qcom_u64_2_f32(uint64_t data, bool sat, roundingMode rnd);
-float qcom_s64_2_f32(int64_t data, bool sat, roundingMode rnd);
+void benchmark_thread_pool();
+void benchmark_scanlines();
+void benchmark_half_conversions();
 
-#endif
+#endif // BENCHMARKS_H
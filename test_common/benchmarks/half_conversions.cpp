@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmarks.h"
+#include "harness/errorHelpers.h"
+#include "harness/halfConversions.h"
+
+#include <string.h>
+
+#include <vector>
+
+// Time per element of the float and double to half conversions in each
+// rounding mode: cl_half_from_float and cl_half_from_double one element at a
+// time, against the array conversions of the harness.
+void benchmark_half_conversions()
+{
+    static const struct
+    {
+        cl_half_rounding_mode mode;
+        const char *name;
+    } modes[] = {
+        { CL_HALF_RTE, "rte" },
+        { CL_HALF_RTZ, "rtz" },
+        { CL_HALF_RTP, "rtp" },
+        { CL_HALF_RTN, "rtn" },
+    };
+
+    // Bit patterns spread over all the floats, in a block of 2^20 like the
+    // reference blocks of the vstore_half tests.
+    const size_t count = 1 << 20;
+    std::vector<float> floats(count);
+    std::vector<double> doubles(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        cl_uint bits = (cl_uint)(i * 0x9e3779b1U);
+        memcpy(&floats[i], &bits, sizeof(bits));
+        doubles[i] = (double)floats[i] * (1.0 + 0x1.0p-30);
+    }
+    std::vector<cl_half> halves(count);
+
+    for (const auto &mode : modes)
+    {
+        double scalarFloat = best_time([&] {
+            for (size_t i = 0; i < count; i++)
+                halves[i] = cl_half_from_float(floats[i], mode.mode);
+        });
+        keep(halves[count - 1]);
+        double arrayFloat = best_time([&] {
+            half_from_float_array(halves.data(), floats.data(), count,
+                                  mode.mode);
+        });
+        keep(halves[count - 1]);
+        double scalarDouble = best_time([&] {
+            for (size_t i = 0; i < count; i++)
+                halves[i] = cl_half_from_double(doubles[i], mode.mode);
+        });
+        keep(halves[count - 1]);
+        double arrayDouble = best_time([&] {
+            half_from_double_array(halves.data(), doubles.data(), count,
+                                   mode.mode);
+        });
+        keep(halves[count - 1]);
+
+        log_info("  %s float: %6.2f ns scalar, %6.2f ns array; double: %6.2f "
+                 "ns scalar, %6.2f ns array\n",
+                 mode.name, scalarFloat / count * 1e9,
+                 arrayFloat / count * 1e9, scalarDouble / count * 1e9,
+                 arrayDouble / count * 1e9);
+    }
+}
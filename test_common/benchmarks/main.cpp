@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmarks.h"
+#include "harness/errorHelpers.h"
+
+#include <string.h>
+
+// Benchmarks of harness code that runs on the host only, so they need no
+// OpenCL device.  Runs the benchmarks named on the command line, or all of
+// them.
+namespace {
+
+const struct
+{
+    const char *name;
+    void (*run)();
+} benchmarks[] = {
+    { "thread_pool", benchmark_thread_pool },
+    { "scanlines", benchmark_scanlines },
+    { "half_conversions", benchmark_half_conversions },
+};
+
+bool is_selected(const char *name, int argc, const char *argv[])
+{
+    if (argc <= 1) return true;
+    for (int i = 1; i < argc; i++)
+        if (strcmp(argv[i], name) == 0) return true;
+    return false;
+}
+
+} // anonymous namespace
+
+int main(int argc, const char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool found = false;
+        for (const auto &benchmark : benchmarks)
+            found |= strcmp(argv[i], benchmark.name) == 0;
+        if (!found)
+        {
+            log_error("Unknown benchmark %s, available:", argv[i]);
+            for (const auto &benchmark : benchmarks)
+                log_error(" %s", benchmark.name);
+            log_error("\n");
+            return 1;
+        }
+    }
+
+    for (const auto &benchmark : benchmarks)
+    {
+        if (!is_selected(benchmark.name, argc, argv)) continue;
+        log_info("%s:\n", benchmark.name);
+        benchmark.run();
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmarks.h"
+#include "harness/errorHelpers.h"
+#include "harness/imageHelpers.h"
+
+#include <string.h>
+
+#include <vector>
+
+// Throughput of ScanlineComparator on matching rows, the common case of the
+// image verifiers, against memcmp of the same rows.
+void benchmark_scanlines()
+{
+    static const cl_channel_order orders[] = { CL_R, CL_RG, CL_RGBA };
+    static const cl_channel_type types[] = {
+        CL_UNORM_INT8,        CL_UNORM_INT16,       CL_SNORM_INT8,
+        CL_SNORM_INT16,       CL_SIGNED_INT8,       CL_SIGNED_INT16,
+        CL_SIGNED_INT32,      CL_UNSIGNED_INT8,     CL_UNSIGNED_INT16,
+        CL_UNSIGNED_INT32,    CL_HALF_FLOAT,        CL_FLOAT,
+        CL_UNORM_INT10X6_EXT, CL_UNORM_INT12X4_EXT, CL_UNORM_INT14X2_EXT,
+    };
+
+    // The required formats of the full profile, and the formats with padding
+    // bits.
+    std::vector<cl_image_format> formats;
+    for (cl_channel_type type : types)
+        for (cl_channel_order order : orders)
+            formats.push_back({ order, type });
+    formats.push_back({ CL_BGRA, CL_UNORM_INT8 });
+    formats.push_back({ CL_RGB, CL_UNORM_SHORT_565 });
+    formats.push_back({ CL_RGB, CL_UNORM_SHORT_555 });
+    formats.push_back({ CL_RGB, CL_UNORM_INT_101010 });
+
+    // Rows of the widest pixels fit in the buffers, which are larger than the
+    // caches like the images the verifiers compare.
+    const size_t width = 4096;
+    const size_t rows = 256;
+    std::vector<char> a(width * 16 * rows);
+    for (size_t i = 0; i < a.size(); i++) a[i] = (char)(i * 0x9e3779b1U >> 24);
+    std::vector<char> b = a;
+
+    for (const cl_image_format &format : formats)
+    {
+        ScanlineComparator comparator(&format);
+        size_t rowSize = width * get_pixel_size(&format);
+        size_t columns = 0;
+        double compared = best_time([&] {
+            for (size_t row = 0; row < rows; row++)
+                columns += comparator.compare(&a[row * rowSize],
+                                              &b[row * rowSize], width);
+        });
+        int differ = 0;
+        double baseline = best_time([&] {
+            for (size_t row = 0; row < rows; row++)
+                differ |= memcmp(&a[row * rowSize], &b[row * rowSize],
+                                 rowSize);
+        });
+        keep(columns);
+        keep(differ);
+
+        double bytes = (double)rowSize * rows;
+        log_info("  %-8s %-24s %6.2f GB/s, memcmp %6.2f GB/s\n",
+                 GetChannelOrderName(format.image_channel_order),
+                 GetChannelTypeName(format.image_channel_data_type),
+                 bytes / compared * 1e-9, bytes / baseline * 1e-9);
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmarks.h"
+#include "harness/ThreadPool.h"
+#include "harness/errorHelpers.h"
+
+#include <atomic>
+
+// Scheduling overhead of ThreadPool_Do: calls of empty jobs, nested calls, and
+// short jobs against running them serially.
+namespace {
+
+std::atomic<cl_uint> gJobsRun;
+
+cl_int empty_job(cl_uint, cl_uint, void *)
+{
+    gJobsRun.fetch_add(1, std::memory_order_relaxed);
+    return CL_SUCCESS;
+}
+
+cl_int nested_job(cl_uint, cl_uint, void *userInfo)
+{
+    return ThreadPool_Do(empty_job, *(cl_uint *)userInfo, nullptr);
+}
+
+// About a microsecond of work, like the shortest reference and check jobs.
+cl_int short_job(cl_uint job_id, cl_uint, void *)
+{
+    float x = (float)job_id;
+    for (int i = 0; i < 512; i++) x = x * 0.999f + 1.0f;
+    keep(x);
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+void benchmark_thread_pool()
+{
+    log_info("  %u threads\n", GetThreadCount());
+
+    // Warm up, the first call starts the worker threads.
+    ThreadPool_Do(empty_job, 1, nullptr);
+
+    for (cl_uint count : { 1u, 16u, 256u, 4096u, 65536u })
+    {
+        int calls = count < 4096 ? 1000 : 10;
+        double time = best_time([&] {
+            for (int i = 0; i < calls; i++)
+                ThreadPool_Do(empty_job, count, nullptr);
+        });
+        log_info("  empty jobs, %6u per call: %9.2f us per call, %7.1f ns "
+                 "per job\n",
+                 count, time / calls * 1e6, time / calls / count * 1e9);
+    }
+
+    cl_uint inner = 64;
+    double nested = best_time([&] {
+        for (int i = 0; i < 10; i++) ThreadPool_Do(nested_job, 64, &inner);
+    });
+    log_info("  nested calls, 64 x 64 empty jobs: %9.2f us per call\n",
+             nested / 10 * 1e6);
+
+    const cl_uint shortCount = 65536;
+    double serial = best_time([&] {
+        for (cl_uint i = 0; i < shortCount; i++) short_job(i, 0, nullptr);
+    });
+    double parallel =
+        best_time([&] { ThreadPool_Do(short_job, shortCount, nullptr); });
+    log_info("  short jobs, %u per call: %.2f ms serial, %.2f ms pooled "
+             "(%.1fx)\n",
+             shortCount, serial * 1e3, parallel * 1e3, serial / parallel);
+}
@@ -23,7 +23,15 @@
 #if defined(__APPLE__) || defined(__linux__) || defined(_WIN32)
 // or any other POSIX system
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 #if defined(_WIN32)
@@ -32,9 +40,7 @@
 #include <intrin.h>
 #endif
 #include "mingw_compat.h"
-#include <process.h>
 #else // !_WIN32
-#include <errno.h>
 #include <pthread.h>
 #include <unistd.h>
 #ifdef __linux__
@@ -43,11 +49,6 @@
 #endif // !_WIN32
 
 // declarations
-#ifdef _WIN32
-void ThreadPool_WorkerFunc(void *p);
-#else
-void *ThreadPool_WorkerFunc(void *p);
-#endif
 void ThreadPool_Init(void);
 void ThreadPool_Exit(void);
 
@@ -60,12 +61,6 @@ CRITICAL_SECTION gAtomicLock;
 pthread_mutex_t gAtomicLock;
 #endif
 
-#if !defined(_WIN32)
-// Keep track of pthread_t's created in ThreadPool_Init() so they can be joined
-// in ThreadPool_Exit() and avoid thread leaks.
-static std::vector<pthread_t> pthreads;
-#endif
-
 // Atomic add operator with mem barrier.  Mem barrier needed to protect state
 // modified by the worker functions.
 cl_int ThreadPool_AtomicAdd(volatile cl_int *a, cl_int b)
@@ -99,384 +94,248 @@ cl_int ThreadPool_AtomicAdd(volatile cl_int *a, cl_int b)
 #endif
 }
 
-#if defined(_WIN32)
-// Uncomment the following line if Windows XP support is not required.
-// #define HAS_INIT_ONCE_EXECUTE_ONCE 1
-
-#if defined(HAS_INIT_ONCE_EXECUTE_ONCE)
-#define _INIT_ONCE INIT_ONCE
-#define _PINIT_ONCE PINIT_ONCE
-#define _InitOnceExecuteOnce InitOnceExecuteOnce
-#else // !HAS_INIT_ONCE_EXECUTE_ONCE
-
-typedef volatile LONG _INIT_ONCE;
-typedef _INIT_ONCE *_PINIT_ONCE;
-typedef BOOL(CALLBACK *_PINIT_ONCE_FN)(_PINIT_ONCE, PVOID, PVOID *);
+// The pool is a work-stealing scheduler.  Every worker owns a deque of job id
+// ranges.  A worker takes ranges from the back of its own deque and repeatedly
+// splits off the upper half of the range it is about to run, pushing it back
+// for itself or for an idle worker to steal.  Idle workers steal from the front
+// of other workers' deques, where the largest (oldest) ranges live.  There is
+// no global run counter, so the only shared state touched per job id is the
+// per-ThreadPool_Do completion counter.
+//
+// ThreadPool_Do may be called from a TPFuncPtr.  The calling worker then helps
+// run the nested job while it waits, but only picks up ranges belonging to that
+// nested job so that the thread_id of the outer job id it is running is never
+// handed out twice at the same time.
 
-#define _INIT_ONCE_UNINITIALIZED 0
-#define _INIT_ONCE_IN_PROGRESS 1
-#define _INIT_ONCE_DONE 2
+namespace {
 
-static BOOL _InitOnceExecuteOnce(_PINIT_ONCE InitOnce, _PINIT_ONCE_FN InitFn,
-                                 PVOID Parameter, LPVOID *Context)
+// State of a single ThreadPool_Do call.
+struct Job
 {
-    while (*InitOnce != _INIT_ONCE_DONE)
-    {
-        if (*InitOnce != _INIT_ONCE_IN_PROGRESS
-            && _InterlockedCompareExchange(InitOnce, _INIT_ONCE_IN_PROGRESS,
-                                           _INIT_ONCE_UNINITIALIZED)
-                == _INIT_ONCE_UNINITIALIZED)
-        {
-            InitFn(InitOnce, Parameter, Context);
-            *InitOnce = _INIT_ONCE_DONE;
-            return TRUE;
-        }
-        Sleep(1);
-    }
-    return TRUE;
-}
-#endif // !HAS_INIT_ONCE_EXECUTE_ONCE
-
-// Uncomment the following line if Windows XP support is not required.
-// #define HAS_CONDITION_VARIABLE 1
-
-#if defined(HAS_CONDITION_VARIABLE)
-#define _CONDITION_VARIABLE CONDITION_VARIABLE
-#define _InitializeConditionVariable InitializeConditionVariable
-#define _SleepConditionVariableCS SleepConditionVariableCS
-#define _WakeAllConditionVariable WakeAllConditionVariable
-#else // !HAS_CONDITION_VARIABLE
-typedef struct
-{
-    HANDLE mEvent; // Used to park the thread.
-    // Used to protect mWaiters, mGeneration and mReleaseCount:
-    CRITICAL_SECTION mLock[1];
-    volatile cl_int mWaiters; // Number of threads waiting on this cond var.
-    volatile cl_int mGeneration; // Wait generation count.
-    volatile cl_int mReleaseCount; // Number of releases to execute before
-                                   // reseting the event.
-} _CONDITION_VARIABLE;
-
-typedef _CONDITION_VARIABLE *_PCONDITION_VARIABLE;
-
-static void _InitializeConditionVariable(_PCONDITION_VARIABLE cond_var)
+    TPFuncPtr func_ptr;
+    void *userInfo;
+    // Ranges are not split below this many job ids.
+    cl_uint grain;
+    // First non-zero result returned by func_ptr.
+    std::atomic<cl_int> error{ CL_SUCCESS };
+    // Number of job ids that still have to be run or skipped.
+    std::atomic<cl_uint> remaining{ 0 };
+    // Set by the thread that retires the last job id.
+    std::atomic<bool> done{ false };
+    std::mutex doneLock;
+    std::condition_variable doneCond;
+};
+
+// A contiguous range [begin, end) of job ids of one Job.
+struct Task
 {
-    cond_var->mEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-    InitializeCriticalSection(cond_var->mLock);
-    cond_var->mWaiters = 0;
-    cond_var->mGeneration = 0;
-#if !defined(NDEBUG)
-    cond_var->mReleaseCount = 0;
-#endif // !NDEBUG
-}
+    Job *job;
+    cl_uint begin;
+    cl_uint end;
+};
 
-static void _SleepConditionVariableCS(_PCONDITION_VARIABLE cond_var,
-                                      PCRITICAL_SECTION cond_lock,
-                                      DWORD ignored)
+// Padded to keep the deques of neighbouring workers on separate cache lines.
+struct alignas(64) WorkerQueue
 {
-    EnterCriticalSection(cond_var->mLock);
-    cl_int generation = cond_var->mGeneration;
-    ++cond_var->mWaiters;
-    LeaveCriticalSection(cond_var->mLock);
-    LeaveCriticalSection(cond_lock);
+    std::mutex lock;
+    std::deque<Task> tasks;
+};
 
-    while (TRUE)
-    {
-        WaitForSingleObject(cond_var->mEvent, INFINITE);
-        EnterCriticalSection(cond_var->mLock);
-        BOOL done =
-            cond_var->mReleaseCount > 0 && cond_var->mGeneration != generation;
-        LeaveCriticalSection(cond_var->mLock);
-        if (done)
-        {
-            break;
-        }
-    }
+} // namespace
 
-    EnterCriticalSection(cond_lock);
-    EnterCriticalSection(cond_var->mLock);
-    if (--cond_var->mReleaseCount == 0)
-    {
-        ResetEvent(cond_var->mEvent);
-    }
-    --cond_var->mWaiters;
-    LeaveCriticalSection(cond_var->mLock);
-}
+// Number of times an idle worker looks for work before it parks.
+static const int kIdleSpinCount = 64;
 
-static void _WakeAllConditionVariable(_PCONDITION_VARIABLE cond_var)
-{
-    EnterCriticalSection(cond_var->mLock);
-    if (cond_var->mWaiters > 0)
-    {
-        ++cond_var->mGeneration;
-        cond_var->mReleaseCount = cond_var->mWaiters;
-        SetEvent(cond_var->mEvent);
-    }
-    LeaveCriticalSection(cond_var->mLock);
-}
-#endif // !HAS_CONDITION_VARIABLE
-#endif // _WIN32
-
-#define MAX_COUNT (1 << 29)
-
-// Global state to coordinate whether the threads have been launched
-// successfully or not
-#if defined(_MSC_VER) && (_WIN32_WINNT >= 0x600)
-static _INIT_ONCE threadpool_init_control;
-#elif defined(_WIN32) // MingW of XP
-static int threadpool_init_control;
-#else // Posix platforms
-pthread_once_t threadpool_init_control = PTHREAD_ONCE_INIT;
-#endif
+static std::once_flag threadpool_init_control;
 cl_int threadPoolInitErr = -1; // set to CL_SUCCESS on successful thread launch
 
-// critical region lock around ThreadPool_Do.  We can only run one ThreadPool_Do
-// at a time, because we are too lazy to set up a queue here, and don't expect
-// to need one.
-#if defined(_WIN32)
-CRITICAL_SECTION gThreadPoolLock[1];
-#else // !_WIN32
-pthread_mutex_t gThreadPoolLock;
-#endif // !_WIN32
+static std::vector<std::unique_ptr<WorkerQueue>> gQueues;
+static std::vector<std::thread> gWorkers;
 
-// Condition variable to park ThreadPool threads when not working
-#if defined(_WIN32)
-CRITICAL_SECTION cond_lock[1];
-_CONDITION_VARIABLE cond_var[1];
-#else // !_WIN32
-pthread_mutex_t cond_lock;
-pthread_cond_t cond_var;
-#endif // !_WIN32
+// Number of tasks sitting in any of the queues.  Used by idle workers to decide
+// whether to park, and by submitters to decide whether to wake them.
+static std::atomic<cl_int> gQueuedTasks{ 0 };
 
-// Condition variable state. How many iterations on the function left to run,
-// set to CL_INT_MAX to cause worker threads to exit. Note: this value might
-// go negative.
-std::atomic<cl_int> gRunCount{ 0 };
+// Parking lot for idle workers.
+static std::mutex gParkLock;
+static std::condition_variable gParkCond;
+static std::atomic<cl_int> gParked{ 0 };
+static std::atomic<bool> gExiting{ false };
 
-// State that only changes when the threadpool is not working.
-volatile TPFuncPtr gFunc_ptr = NULL;
-volatile void *gUserInfo = NULL;
-volatile cl_int gJobCount = 0;
+// # of worker threads that have not yet exited.
+static std::atomic<cl_int> gRunning{ 0 };
 
-// State that may change while the thread pool is working
-volatile cl_int jobError = CL_SUCCESS; // err code return for the job as a whole
+// The total number of threads launched.
+static std::atomic<cl_int> gThreadCount{ 0 };
 
-// Condition variable to park caller while waiting
-#if defined(_WIN32)
-HANDLE caller_event;
-#else // !_WIN32
-pthread_mutex_t caller_cond_lock;
-pthread_cond_t caller_cond_var;
-#endif // !_WIN32
+// Index of the calling worker thread, or -1 when not called from the pool.
+static thread_local cl_int tWorkerID = -1;
 
-// # of threads intended to be running. Running threads will decrement this
-// as they discover they've run out of work to do.
-std::atomic<cl_int> gRunning{ 0 };
+static void WakeWorkers(bool all)
+{
+    if (gParked.load() == 0) return;
 
-// The total number of threads launched.
-static std::atomic<cl_int> gThreadCount{ 0 };
+    // Taking the lock orders this wakeup after any worker that is between
+    // checking gQueuedTasks and blocking on gParkCond.
+    std::lock_guard<std::mutex> lock(gParkLock);
+    if (all)
+        gParkCond.notify_all();
+    else
+        gParkCond.notify_one();
+}
 
-#ifdef _WIN32
-void ThreadPool_WorkerFunc(void *p)
-#else
-void *ThreadPool_WorkerFunc(void *p)
-#endif
+static void PushTask(cl_uint queueID, const Task &task)
 {
-    auto &tid = *static_cast<std::atomic<cl_uint> *>(p);
-    cl_uint threadID = tid++;
-    cl_int item = gRunCount--;
+    WorkerQueue &queue = *gQueues[queueID];
+    {
+        std::lock_guard<std::mutex> lock(queue.lock);
+        queue.tasks.push_back(task);
+    }
+    gQueuedTasks++;
+}
 
-    while (MAX_COUNT > item)
+// Take a task from the back of our own queue.  If job is not NULL, only tasks
+// belonging to that job are considered.
+static bool PopTask(cl_uint queueID, const Job *job, Task &task)
+{
+    WorkerQueue &queue = *gQueues[queueID];
+    std::lock_guard<std::mutex> lock(queue.lock);
+    for (auto it = queue.tasks.rbegin(); it != queue.tasks.rend(); ++it)
     {
-        cl_int err;
+        if (job == NULL || it->job == job)
+        {
+            task = *it;
+            queue.tasks.erase(std::next(it).base());
+            gQueuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
 
-        // check for more work to do
-        if (0 >= item)
+// Take a task from the front of another worker's queue.
+static bool StealTask(cl_uint thiefID, const Job *job, Task &task)
+{
+    cl_uint count = (cl_uint)gQueues.size();
+    for (cl_uint i = 1; i < count; i++)
+    {
+        WorkerQueue &queue = *gQueues[(thiefID + i) % count];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        for (auto it = queue.tasks.begin(); it != queue.tasks.end(); ++it)
         {
-            // No work to do. Attempt to block waiting for work
-#if defined(_WIN32)
-            EnterCriticalSection(cond_lock);
-#else // !_WIN32
-            if ((err = pthread_mutex_lock(&cond_lock)))
+            if (job == NULL || it->job == job)
             {
-                log_error(
-                    "Error %d from pthread_mutex_lock. Worker %d unable to "
-                    "block waiting for work. ThreadPool_WorkerFunc failed.\n",
-                    err, threadID);
-                goto exit;
-            }
-#endif // !_WIN32
-
-            cl_int remaining = gRunning--;
-            if (1 == remaining)
-            { // last thread out signal the main thread to wake up
-#if defined(_WIN32)
-                SetEvent(caller_event);
-#else // !_WIN32
-                if ((err = pthread_mutex_lock(&caller_cond_lock)))
-                {
-                    log_error("Error %d from pthread_mutex_lock. Unable to "
-                              "wake caller.\n",
-                              err);
-                    goto exit;
-                }
-                if ((err = pthread_cond_broadcast(&caller_cond_var)))
-                {
-                    log_error(
-                        "Error %d from pthread_cond_broadcast. Unable to wake "
-                        "up main thread. ThreadPool_WorkerFunc failed.\n",
-                        err);
-                    goto exit;
-                }
-                if ((err = pthread_mutex_unlock(&caller_cond_lock)))
-                {
-                    log_error("Error %d from pthread_mutex_lock. Unable to "
-                              "wake caller.\n",
-                              err);
-                    goto exit;
-                }
-#endif // !_WIN32
+                task = *it;
+                queue.tasks.erase(it);
+                gQueuedTasks--;
+                return true;
             }
+        }
+    }
+    return false;
+}
 
-            // loop in case we are woken only to discover that some other thread
-            // already did all the work
-            while (0 >= item)
-            {
-#if defined(_WIN32)
-                _SleepConditionVariableCS(cond_var, cond_lock, INFINITE);
-#else // !_WIN32
-                if ((err = pthread_cond_wait(&cond_var, &cond_lock)))
-                {
-                    log_error(
-                        "Error %d from pthread_cond_wait. Unable to block for "
-                        "waiting for work. ThreadPool_WorkerFunc failed.\n",
-                        err);
-                    pthread_mutex_unlock(&cond_lock);
-                    goto exit;
-                }
-#endif // !_WIN32
+static bool FindTask(cl_uint threadID, const Job *job, Task &task)
+{
+    return PopTask(threadID, job, task) || StealTask(threadID, job, task);
+}
 
-                // try again to get a valid item id
-                item = gRunCount--;
-                if (MAX_COUNT <= item) // exit if we are done
-                {
-#if defined(_WIN32)
-                    LeaveCriticalSection(cond_lock);
-#else // !_WIN32
-                    pthread_mutex_unlock(&cond_lock);
-#endif // !_WIN32
-                    goto exit;
-                }
-            }
+static void RetireJobIds(Job &job, cl_uint count)
+{
+    if (job.remaining.fetch_sub(count) != count) return;
 
-            gRunning++;
+    // The waiter may destroy the job as soon as it sees done, so the lock is
+    // held until we stop touching it.
+    std::lock_guard<std::mutex> lock(job.doneLock);
+    job.done = true;
+    job.doneCond.notify_all();
+}
 
-#if defined(_WIN32)
-            LeaveCriticalSection(cond_lock);
-#else // !_WIN32
-            if ((err = pthread_mutex_unlock(&cond_lock)))
-            {
-                log_error(
-                    "Error %d from pthread_mutex_unlock. Unable to block for "
-                    "waiting for work. ThreadPool_WorkerFunc failed.\n",
-                    err);
-                goto exit;
-            }
-#endif // !_WIN32
-        }
+static void RunTask(cl_uint threadID, Task task)
+{
+    Job &job = *task.job;
 
-        // we have a valid item, so do the work
-        // but only if we haven't already encountered an error
-        if (CL_SUCCESS == jobError)
-        {
-            // log_info("Thread %d doing job %d\n", threadID, item - 1);
+    // Leave the upper halves of the range behind for idle workers to steal.
+    bool pushed = false;
+    while (task.end - task.begin > job.grain)
+    {
+        cl_uint mid = task.begin + (task.end - task.begin) / 2;
+        PushTask(threadID, Task{ &job, mid, task.end });
+        task.end = mid;
+        pushed = true;
+    }
+    if (pushed) WakeWorkers(false);
 
 #if defined(__APPLE__) && defined(__arm__)
-            // On most platforms which support denorm, default is FTZ off.
-            // However, on some hardware where the reference is computed,
-            // default might be flush denorms to zero e.g. arm. This creates
-            // issues in result verification. Since spec allows the
-            // implementation to either flush or not flush denorms to zero, an
-            // implementation may choose not be flush i.e. return denorm result
-            // whereas reference result may be zero (flushed denorm). Hence we
-            // need to disable denorm flushing on host side where reference is
-            // being computed to make sure we get non-flushed reference result.
-            // If implementation returns flushed result, we correctly take care
-            // of that in verification code.
-            FPU_mode_type oldMode;
-            DisableFTZ(&oldMode);
+    // On most platforms which support denorm, default is FTZ off. However, on
+    // some hardware where the reference is computed, default might be flush
+    // denorms to zero e.g. arm. This creates issues in result verification.
+    // Since spec allows the implementation to either flush or not flush denorms
+    // to zero, an implementation may choose not be flush i.e. return denorm
+    // result whereas reference result may be zero (flushed denorm). Hence we
+    // need to disable denorm flushing on host side where reference is being
+    // computed to make sure we get non-flushed reference result. If
+    // implementation returns flushed result, we correctly take care of that in
+    // verification code.
+    FPU_mode_type oldMode;
+    DisableFTZ(&oldMode);
 #endif
 
-            // Call the user's function with this item ID
-            err = gFunc_ptr(item - 1, threadID, (void *)gUserInfo);
+    for (cl_uint item = task.begin; item < task.end; item++)
+    {
+        // Skip the remaining work once an error has been encountered.
+        if (CL_SUCCESS != job.error.load(std::memory_order_relaxed)) break;
+
+        cl_int err = job.func_ptr(item, threadID, job.userInfo);
+        if (err)
+        {
+            // set the new error if we are the first one there.
+            cl_int expected = CL_SUCCESS;
+            job.error.compare_exchange_strong(expected, err);
+        }
+    }
+
 #if defined(__APPLE__) && defined(__arm__)
-            // Restore FP state
-            RestoreFPState(&oldMode);
+    // Restore FP state
+    RestoreFPState(&oldMode);
 #endif
 
-            if (err)
-            {
-#if (__MINGW32__)
-                EnterCriticalSection(&gAtomicLock);
-                if (jobError == CL_SUCCESS) jobError = err;
-                gRunCount = 0;
-                LeaveCriticalSection(&gAtomicLock);
-#elif defined(__GNUC__)
-                // GCC extension:
-                // http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
-                // set the new error if we are the first one there.
-                __sync_val_compare_and_swap(&jobError, CL_SUCCESS, err);
-
-                // drop run count to 0
-                gRunCount = 0;
-                __sync_synchronize();
-#elif defined(_MSC_VER)
-                // set the new error if we are the first one there.
-                _InterlockedCompareExchange((volatile LONG *)&jobError, err,
-                                            CL_SUCCESS);
-
-                // drop run count to 0
-                gRunCount = 0;
-#if defined(_M_IX86) || defined(_M_X64)
-                _mm_mfence();
-#elif defined(_M_ARM64)
-                __dmb(_ARM64_BARRIER_ISHST);
-#else
-#error Architecture needs an implementation
-#endif
+    RetireJobIds(job, task.end - task.begin);
+}
 
-#else
-                if (pthread_mutex_lock(&gAtomicLock))
-                    log_error(
-                        "Atomic operation failed. "
-                        "pthread_mutex_lock(&gAtomicLock) returned an error\n");
-                if (jobError == CL_SUCCESS) jobError = err;
-                gRunCount = 0;
-                if (pthread_mutex_unlock(&gAtomicLock))
-                    log_error("Failed to release gAtomicLock. Further atomic "
-                              "operations may deadlock\n");
-#endif
-            }
+static void ThreadPool_WorkerFunc(cl_uint threadID)
+{
+    tWorkerID = threadID;
+
+    while (!gExiting)
+    {
+        Task task;
+        bool found = false;
+        for (int spin = 0; !found && spin < kIdleSpinCount; spin++)
+        {
+            found = FindTask(threadID, NULL, task);
+            if (!found) std::this_thread::yield();
+        }
+
+        if (found)
+        {
+            RunTask(threadID, task);
+            continue;
         }
 
-        // get the next item
-        item = gRunCount--;
+        // No work to do. Block waiting for work.
+        std::unique_lock<std::mutex> lock(gParkLock);
+        gParked++;
+        gParkCond.wait(lock, [] { return gExiting || gQueuedTasks > 0; });
+        gParked--;
     }
 
-exit:
     log_info("ThreadPool: thread %d exiting.\n", threadID);
-    gThreadCount--;
-#if !defined(_WIN32)
-    return NULL;
-#endif
+    gRunning--;
 }
 
 void ThreadPool_Init(void)
 {
-    cl_int i;
-    int err;
-    std::atomic<cl_uint> threadID{ 0 };
-
     // Check for manual override of multithreading code. We add this for better
     // debuggability.
     if (getenv("CL_TEST_SINGLE_THREADED") || (gNumThreadPoolThreads != 0))
@@ -572,200 +431,108 @@ void ThreadPool_Init(void)
     }
 #endif
 
-#if defined(_WIN32)
-    InitializeCriticalSection(gThreadPoolLock);
-    InitializeCriticalSection(cond_lock);
-    _InitializeConditionVariable(cond_var);
-    caller_event = CreateEvent(NULL, FALSE, FALSE, NULL);
-#elif defined(__GNUC__)
-    // Dont rely on PTHREAD_MUTEX_INITIALIZER for intialization of a mutex since
-    // it might cause problem with some flavors of gcc compilers.
-    pthread_cond_init(&cond_var, NULL);
-    pthread_mutex_init(&cond_lock, NULL);
-    pthread_cond_init(&caller_cond_var, NULL);
-    pthread_mutex_init(&caller_cond_lock, NULL);
-    pthread_mutex_init(&gThreadPoolLock, NULL);
-#endif
-
 #if !(defined(__GNUC__) || defined(_MSC_VER) || defined(__MINGW32__))
     pthread_mutex_initialize(gAtomicLock);
 #elif defined(__MINGW32__)
     InitializeCriticalSection(&gAtomicLock);
 #endif
-    // Make sure the last thread done in the work pool doesn't signal us to wake
-    // before we get to the point where we are supposed to wait
-    //  That would cause a deadlock.
-#if !defined(_WIN32)
-    if ((err = pthread_mutex_lock(&caller_cond_lock)))
-    {
-        log_error("Error %d from pthread_mutex_lock. Unable to block for work "
-                  "to finish. ThreadPool_Init failed.\n",
-                  err);
-        gThreadCount = 1;
-        return;
-    }
-#endif // !_WIN32
 
-    gRunning = gThreadCount.load();
+    // The queues must all exist before any worker starts stealing.
+    for (cl_int i = 0; i < gThreadCount; i++)
+        gQueues.emplace_back(new WorkerQueue);
+
     // init threads
-    for (i = 0; i < gThreadCount; i++)
+    for (cl_int i = 0; i < gThreadCount; i++)
     {
-#if defined(_WIN32)
-        uintptr_t handle =
-            _beginthread(ThreadPool_WorkerFunc, 0, (void *)&threadID);
-        err = (handle == 0);
-#else // !_WIN32
-        pthread_t tid = 0;
-        err = pthread_create(&tid, NULL, ThreadPool_WorkerFunc,
-                             (void *)&threadID);
-#endif // !_WIN32
-        if (err)
+        gRunning++;
+        try
+        {
+            gWorkers.emplace_back(ThreadPool_WorkerFunc, (cl_uint)i);
+        } catch (const std::system_error &e)
         {
-            log_error("Error %d launching thread %d\n", err, i);
-            threadPoolInitErr = err;
-            gThreadCount = i;
+            gRunning--;
+            log_error("Error %d launching thread %d\n", e.code().value(), i);
+            threadPoolInitErr = e.code().value();
             break;
         }
-#if !defined(_WIN32)
-        pthreads.push_back(tid);
-#endif // !_WIN32
     }
 
     atexit(ThreadPool_Exit);
 
-    // block until they are done launching.
-    do
+    if ((cl_int)gWorkers.size() != gThreadCount)
     {
-#if defined(_WIN32)
-        WaitForSingleObject(caller_event, INFINITE);
-#else // !_WIN32
-        if ((err = pthread_cond_wait(&caller_cond_var, &caller_cond_lock)))
-        {
-            log_error("Error %d from pthread_cond_wait. Unable to block for "
-                      "work to finish. ThreadPool_Init failed.\n",
-                      err);
-            pthread_mutex_unlock(&caller_cond_lock);
-            return;
-        }
-#endif // !_WIN32
-    } while (gRunCount != -gThreadCount);
-#if !defined(_WIN32)
-    if ((err = pthread_mutex_unlock(&caller_cond_lock)))
-    {
-        log_error("Error %d from pthread_mutex_unlock. Unable to block for "
-                  "work to finish. ThreadPool_Init failed.\n",
-                  err);
+        // Fall back to running jobs on the calling thread.  The workers that
+        // did start will only ever find empty queues.
+        gThreadCount = (cl_int)gWorkers.size();
         return;
     }
-#endif // !_WIN32
 
     threadPoolInitErr = CL_SUCCESS;
 }
 
-#if defined(_MSC_VER)
-static BOOL CALLBACK _ThreadPool_Init(_PINIT_ONCE InitOnce, PVOID Parameter,
-                                      PVOID *lpContex)
-{
-    ThreadPool_Init();
-    return TRUE;
-}
-#endif
-
 void ThreadPool_Exit(void)
 {
-    gRunCount = CL_INT_MAX;
-
-#if defined(__GNUC__)
-    // GCC extension:
-    // http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
-    __sync_synchronize();
-#elif defined(_MSC_VER)
-#if defined(_M_IX86) || defined(_M_X64)
-    _mm_mfence();
-#elif defined(_M_ARM64)
-    __dmb(_ARM64_BARRIER_ISHST);
-#else
-#error Architecture needs an implementation
-#endif
-#else
-#warning If this is a weakly ordered memory system, please add a memory barrier here to force this and everything else to memory before we proceed
-#endif
-
-    // spin waiting for threads to die
-    for (int count = 0; 0 != gThreadCount && count < 1000; count++)
     {
-#if defined(_WIN32)
-        _WakeAllConditionVariable(cond_var);
-        Sleep(1);
-#else // !_WIN32
-        if (int err = pthread_cond_broadcast(&cond_var))
-        {
-            log_error("Error %d from pthread_cond_broadcast. Unable to wake up "
-                      "work threads. ThreadPool_Exit failed.\n",
-                      err);
-            break;
-        }
-        usleep(1000);
-#endif // !_WIN32
+        std::lock_guard<std::mutex> lock(gParkLock);
+        gExiting = true;
+        gParkCond.notify_all();
     }
 
-    if (gThreadCount)
+    // wait for the threads to die.  A thread may be stuck in a job if exit()
+    // was called while work was in flight, so don't wait forever.
+    for (int count = 0; 0 != gRunning && count < 1000; count++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    if (gRunning)
+    {
         log_error("Error: Thread pool timed out after 1 second with %d threads "
                   "still active.\n",
-                  gThreadCount.load());
+                  gRunning.load());
+        for (std::thread &worker : gWorkers) worker.detach();
+    }
     else
     {
-#if !defined(_WIN32)
-        for (pthread_t pthread : pthreads)
+        for (std::thread &worker : gWorkers)
         {
-            if (int err = pthread_join(pthread, nullptr))
-            {
-                log_error("Error from %d from pthread_join. Unable to join "
-                          "work threads. ThreadPool_Exit failed.\n",
-                          err);
-            }
+            if (worker.get_id() == std::this_thread::get_id())
+                worker.detach();
+            else
+                worker.join();
         }
-#endif
         log_info("Thread pool exited in a orderly fashion.\n");
     }
+    gWorkers.clear();
 }
 
+static cl_int ThreadPool_EnsureInit(void)
+{
+    try
+    {
+        std::call_once(threadpool_init_control, ThreadPool_Init);
+    } catch (const std::system_error &e)
+    {
+        log_error("Error %d from std::call_once. Unable to init threads. "
+                  "ThreadPool_Do failed.\n",
+                  e.code().value());
+        return e.code().value();
+    }
+    return CL_SUCCESS;
+}
 
 // Blocking API that farms out count jobs to a thread pool.
 // It may return with some work undone if func_ptr() returns a non-zero
 // result.
 //
-// This function obviously has its shortcommings. Only one call to ThreadPool_Do
-// can be running at a time. It is not intended for general purpose use.
-// If clEnqueueNativeKernelFn, out of order queues and a CL_DEVICE_TYPE_CPU were
-// all available then it would make more sense to use those features.
+// Any number of calls to ThreadPool_Do may be in flight at once, including
+// calls made from a TPFuncPtr.  If clEnqueueNativeKernelFn, out of order queues
+// and a CL_DEVICE_TYPE_CPU were all available then it would make more sense to
+// use those features.
 cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
 {
-#ifndef _WIN32
-    cl_int newErr;
-#endif
-    cl_int err = 0;
     // Lazily set up our threads
-#if defined(_MSC_VER) && (_WIN32_WINNT >= 0x600)
-    err = !_InitOnceExecuteOnce(&threadpool_init_control, _ThreadPool_Init,
-                                NULL, NULL);
-#elif defined(_WIN32)
-    if (threadpool_init_control == 0)
-    {
-#warning This is buggy and race prone.  Find a better way.
-        ThreadPool_Init();
-        threadpool_init_control = 1;
-    }
-#else // posix platform
-    err = pthread_once(&threadpool_init_control, ThreadPool_Init);
-    if (err)
-    {
-        log_error("Error %d from pthread_once. Unable to init threads. "
-                  "ThreadPool_Do failed.\n",
-                  err);
-        return err;
-    }
-#endif
+    cl_int err = ThreadPool_EnsureInit();
+    if (err) return err;
+
     // Single threaded code to handle case where threadpool wasn't allocated or
     // was disabled by environment variable
     if (threadPoolInitErr)
@@ -781,7 +548,7 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
         // not flush denorms to zero, an implementation may choose not be flush
         // i.e. return denorm result whereas reference result may be zero
         // (flushed denorm). Hence we need to disable denorm flushing on host
-        // side where reference is being computed to make sure we get
+        // side where reference is computed to make sure we get
         // non-flushed reference result. If implementation returns flushed
         // result, we correctly take care of that in verification code.
         FPU_mode_type oldMode;
@@ -805,162 +572,62 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
         return CL_SUCCESS;
     }
 
-    if (count >= MAX_COUNT)
-    {
-        log_error(
-            "Error: ThreadPool_Do count %d >= max threadpool count of %d\n",
-            count, MAX_COUNT);
-        return -1;
-    }
-
-    // Enter critical region
-#if defined(_WIN32)
-    EnterCriticalSection(gThreadPoolLock);
-#else // !_WIN32
-    if ((err = pthread_mutex_lock(&gThreadPoolLock)))
-    {
-        switch (err)
-        {
-            case EDEADLK:
-                log_error(
-                    "Error EDEADLK returned in ThreadPool_Do(). ThreadPool_Do "
-                    "is not designed to work recursively!\n");
-                break;
-            case EINVAL:
-                log_error("Error EINVAL returned in ThreadPool_Do(). How did "
-                          "we end up with an invalid gThreadPoolLock?\n");
-                break;
-            default: break;
-        }
-        return err;
-    }
-#endif // !_WIN32
-
-    // Start modifying the job state observable by worker threads
-#if defined(_WIN32)
-    EnterCriticalSection(cond_lock);
-#else // !_WIN32
-    if ((err = pthread_mutex_lock(&cond_lock)))
-    {
-        log_error("Error %d from pthread_mutex_lock. Unable to wake up work "
-                  "threads. ThreadPool_Do failed.\n",
-                  err);
-        goto exit;
-    }
-#endif // !_WIN32
-
-    // Make sure the last thread done in the work pool doesn't signal us to wake
-    // before we get to the point where we are supposed to wait
-    //  That would cause a deadlock.
-#if !defined(_WIN32)
-    if ((err = pthread_mutex_lock(&caller_cond_lock)))
-    {
-        log_error("Error %d from pthread_mutex_lock. Unable to block for work "
-                  "to finish. ThreadPool_Do failed.\n",
-                  err);
-        goto exit;
-    }
-#endif // !_WIN32
+    if (0 == count) return CL_SUCCESS;
 
-    // Prime the worker threads to get going
-    jobError = CL_SUCCESS;
-    gRunCount = gJobCount = count;
-    gFunc_ptr = func_ptr;
-    gUserInfo = userInfo;
+    cl_uint threadCount = (cl_uint)gQueues.size();
+    Job job;
+    job.func_ptr = func_ptr;
+    job.userInfo = userInfo;
+    // Small enough to balance uneven job ids, large enough that splitting
+    // doesn't dominate very short ones.
+    job.grain = std::max<cl_uint>(1, count / (threadCount * 16));
+    job.remaining = count;
 
-#if defined(_WIN32)
-    ResetEvent(caller_event);
-    _WakeAllConditionVariable(cond_var);
-    LeaveCriticalSection(cond_lock);
-#else // !_WIN32
-    if ((err = pthread_cond_broadcast(&cond_var)))
-    {
-        log_error("Error %d from pthread_cond_broadcast. Unable to wake up "
-                  "work threads. ThreadPool_Do failed.\n",
-                  err);
-        goto exit;
-    }
-    if ((err = pthread_mutex_unlock(&cond_lock)))
+    if (tWorkerID >= 0)
     {
-        log_error("Error %d from pthread_mutex_unlock. Unable to wake up work "
-                  "threads. ThreadPool_Do failed.\n",
-                  err);
-        goto exit;
-    }
-#endif // !_WIN32
+        // Nested call: queue the whole range locally and help run it.  Only
+        // ranges of this job are taken, see the comment at the top of the file.
+        cl_uint threadID = (cl_uint)tWorkerID;
+        PushTask(threadID, Task{ &job, 0, count });
+        WakeWorkers(false);
 
-    // block until they are done.  It would be slightly more efficient to do
-    // some of the work here though.
-    do
-    {
-#if defined(_WIN32)
-        WaitForSingleObject(caller_event, INFINITE);
-#else // !_WIN32
-        if ((err = pthread_cond_wait(&caller_cond_var, &caller_cond_lock)))
+        while (!job.done)
         {
-            log_error("Error %d from pthread_cond_wait. Unable to block for "
-                      "work to finish. ThreadPool_Do failed.\n",
-                      err);
-            pthread_mutex_unlock(&caller_cond_lock);
-            goto exit;
+            Task task;
+            if (FindTask(threadID, &job, task))
+                RunTask(threadID, task);
+            else
+                std::this_thread::yield();
         }
-#endif // !_WIN32
-    } while (gRunning);
-#if !defined(_WIN32)
-    if ((err = pthread_mutex_unlock(&caller_cond_lock)))
-    {
-        log_error("Error %d from pthread_mutex_unlock. Unable to block for "
-                  "work to finish. ThreadPool_Do failed.\n",
-                  err);
-        goto exit;
-    }
-#endif // !_WIN32
 
-    err = jobError;
+        // Wait for the retiring thread to release the job.
+        std::lock_guard<std::mutex> lock(job.doneLock);
+        return job.error;
+    }
 
-#ifndef _WIN32
-exit:
-#endif
-    // exit critical region
-#if defined(_WIN32)
-    LeaveCriticalSection(gThreadPoolLock);
-#else // !_WIN32
-    newErr = pthread_mutex_unlock(&gThreadPoolLock);
-    if (newErr)
+    // Deal one slice of the range to every worker, they split it further and
+    // steal from each other as they go.
+    cl_uint slices = std::min(count, threadCount);
+    for (cl_uint i = 0; i < slices; i++)
     {
-        log_error("Error %d from pthread_mutex_unlock. Unable to exit critical "
-                  "region. ThreadPool_Do failed.\n",
-                  newErr);
-        return err;
+        cl_uint begin = (cl_uint)((cl_ulong)count * i / slices);
+        cl_uint end = (cl_uint)((cl_ulong)count * (i + 1) / slices);
+        PushTask(i, Task{ &job, begin, end });
     }
-#endif // !_WIN32
+    WakeWorkers(true);
+
+    // block until they are done.
+    std::unique_lock<std::mutex> lock(job.doneLock);
+    job.doneCond.wait(lock, [&job] { return job.done.load(); });
 
-    return err;
+    return job.error;
 }
 
 cl_uint GetThreadCount(void)
 {
     // Lazily set up our threads
-#if defined(_MSC_VER) && (_WIN32_WINNT >= 0x600)
-    cl_int err = !_InitOnceExecuteOnce(&threadpool_init_control,
-                                       _ThreadPool_Init, NULL, NULL);
-#elif defined(_WIN32)
-    if (threadpool_init_control == 0)
-    {
-#warning This is buggy and race prone.  Find a better way.
-        ThreadPool_Init();
-        threadpool_init_control = 1;
-    }
-#else
-    cl_int err = pthread_once(&threadpool_init_control, ThreadPool_Init);
-    if (err)
-    {
-        log_error("Error %d from pthread_once. Unable to init threads. "
-                  "ThreadPool_Do failed.\n",
-                  err);
-        return err;
-    }
-#endif // !_WIN32
+    cl_int err = ThreadPool_EnsureInit();
+    if (err) return err;
 
     if (gThreadCount < 1) return 1;
 
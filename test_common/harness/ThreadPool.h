@@ -30,18 +30,23 @@ cl_int ThreadPool_AtomicAdd(volatile cl_int *a, cl_int b); // returns old value
 //
 // A function pointer to the function you want to execute in a multithreaded
 // context.  No synchronization primitives are provided, other than the atomic
-// add above. You may not call ThreadPool_Do from your function.
-// ThreadPool_AtomicAdd() and GetThreadCount() should work, however.
+// add above. ThreadPool_Do(), ThreadPool_AtomicAdd() and GetThreadCount() may
+// all be called from your function.
 //
 // job ids and thread ids are 0 based.  If number of jobs or threads was 8, they
 // will numbered be 0 through 7. Note that while every job will be run, it is
-// not guaranteed that every thread will wake up before the work is done.
+// not guaranteed that every thread will wake up before the work is done, nor
+// that job ids are run in order.  A thread id is never used by two running
+// job ids of the same ThreadPool_Do call, so it may index per thread storage.
+// A nested ThreadPool_Do call runs its job ids with the thread id of the
+// calling job id among others, so the nested call needs storage of its own.
 typedef cl_int (*TPFuncPtr)(cl_uint /*job_id*/, cl_uint /* thread_id */,
                             void *userInfo);
 
 // returns first non-zero result from func_ptr, or CL_SUCCESS if all are zero.
 // Some workitems may not run if a non-zero result is returned from func_ptr().
-// This function may not be called from a TPFuncPtr.
+// This function may be called from a TPFuncPtr and from several threads at
+// once.
 cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo);
 
 // Returns the number of worker threads that underlie the threadpool.  The value
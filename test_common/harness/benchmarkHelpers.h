@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef BENCHMARK_HELPERS_H
+#define BENCHMARK_HELPERS_H
+
+#include <chrono>
+
+// Seconds taken by the fastest of a few runs of fn, which filters out most of
+// the noise of other processes.
+template <typename Fn> double best_time(Fn &&fn, int runs = 5)
+{
+    double best = 0.0;
+    for (int run = 0; run < runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> time =
+            std::chrono::steady_clock::now() - start;
+        if (run == 0 || time.count() < best) best = time.count();
+    }
+    return best;
+}
+
+// Keeps the compiler from optimizing away the computation of value.
+template <typename T> void keep(const T &value)
+{
+    volatile T sink = value;
+    (void)sink;
+}
+
+#endif // BENCHMARK_HELPERS_H
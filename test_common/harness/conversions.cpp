@@ -20,6 +20,11 @@
 #include <assert.h>
 #include "mt19937.h"
 #include "compat.h"
+#include "counterRandom.h"
+#include "parseParameters.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
 
 #include <CL/cl_half.h>
 
@@ -1027,8 +1032,8 @@ void convert_explicit_value(void *inRaw, void *outRaw, ExplicitType inType,
     }
 }
 
-void generate_random_data(ExplicitType type, size_t count, MTdata d,
-                          void *outData)
+static void generate_mt19937_random_data(ExplicitType type, size_t count,
+                                         MTdata d, void *outData)
 {
     bool *boolPtr;
     cl_char *charPtr;
@@ -1208,6 +1213,183 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
     }
 }
 
+// Elements decoded from one fill of the counter stream.  It is a multiple of
+// 32 so that the elements of a block start on a word of the stream.
+#define RANDOM_DATA_BLOCK 1024
+
+// Elements of a job of generate_random_data on the thread pool.
+#define RANDOM_DATA_JOB_ELEMENTS (64 * RANDOM_DATA_BLOCK)
+
+// Random bits used by an element of type, in the order of the old MT19937
+// fill: types of less than 32 bits take them from the low bits of the words
+// first, 64-bit types take the low half from the first word.
+static size_t get_random_data_bits(ExplicitType type)
+{
+    switch (type)
+    {
+        case kBool: return 1;
+        case kChar:
+        case kUChar:
+        case kUnsignedChar: return 8;
+        case kShort:
+        case kUShort:
+        case kUnsignedShort:
+        case kHalf: return 16;
+        case kInt:
+        case kUInt:
+        case kUnsignedInt:
+        case kFloat: return 32;
+        case kLong:
+        case kULong:
+        case kUnsignedLong:
+        case kDouble: return 64;
+        default: return 0;
+    }
+}
+
+template <typename T, typename Convert>
+static void decode_random_data(const cl_uint *words, size_t bits, size_t count,
+                               T *out, Convert convert)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t bit = i * bits;
+        cl_ulong value = words[bit / 32] >> (bit % 32);
+        if (bits == 64)
+            value |= (cl_ulong)words[bit / 32 + 1] << 32;
+        else if (bits < 32)
+            value &= (1u << bits) - 1;
+        out[i] = convert(value);
+    }
+}
+
+// Generate elements [first, first + count) of outData from the counter
+// stream of seed.  first must be a multiple of RANDOM_DATA_BLOCK.
+static void generate_counter_random_data(ExplicitType type, cl_ulong seed,
+                                         size_t first, size_t count,
+                                         void *outData)
+{
+    size_t bits = get_random_data_bits(type);
+    cl_uint words[RANDOM_DATA_BLOCK * 2];
+
+    for (size_t start = first; start < first + count;
+         start += RANDOM_DATA_BLOCK)
+    {
+        size_t n = std::min((size_t)RANDOM_DATA_BLOCK, first + count - start);
+        counter_random_fill(seed, (cl_ulong)start * bits / 32, words,
+                            (n * bits + 31) / 32);
+
+        switch (type)
+        {
+            case kBool:
+                decode_random_data(words, bits, n, (bool *)outData + start,
+                                   [](cl_ulong v) { return v != 0; });
+                break;
+            case kChar:
+                decode_random_data(
+                    words, bits, n, (cl_char *)outData + start,
+                    [](cl_ulong v) { return (cl_char)((cl_int)v - 127); });
+                break;
+            case kUChar:
+            case kUnsignedChar:
+                decode_random_data(words, bits, n, (cl_uchar *)outData + start,
+                                   [](cl_ulong v) { return (cl_uchar)v; });
+                break;
+            case kShort:
+                decode_random_data(
+                    words, bits, n, (cl_short *)outData + start,
+                    [](cl_ulong v) { return (cl_short)((cl_int)v - 32767); });
+                break;
+            case kUShort:
+            case kUnsignedShort:
+            case kHalf:
+                decode_random_data(words, bits, n,
+                                   (cl_ushort *)outData + start,
+                                   [](cl_ulong v) { return (cl_ushort)v; });
+                break;
+            case kInt:
+            case kUInt:
+            case kUnsignedInt:
+                memcpy((cl_uint *)outData + start, words, n * sizeof(cl_uint));
+                break;
+            case kLong:
+            case kULong:
+            case kUnsignedLong:
+                memcpy((cl_ulong *)outData + start, words,
+                       n * sizeof(cl_ulong));
+                break;
+            case kFloat:
+                decode_random_data(
+                    words, bits, n, (cl_float *)outData + start,
+                    [](cl_ulong v) {
+                        // [ -(double) 0x7fffffff, (double) 0x7fffffff ]
+                        double t = (double)v * (1.0 / 4294967295.0);
+                        return (float)((1.0 - t) * -(double)0x7fffffff
+                                       + t * (double)0x7fffffff);
+                    });
+                break;
+            case kDouble:
+                decode_random_data(
+                    words, bits, n, (cl_double *)outData + start,
+                    [](cl_ulong v) {
+                        // scale [-2**63, 2**63] to [-2**31, 2**31]
+                        return (double)(cl_long)v
+                            * MAKE_HEX_DOUBLE(0x1.0p-32, 0x1, -32);
+                    });
+                break;
+            default: break;
+        }
+    }
+}
+
+struct RandomDataJob
+{
+    ExplicitType type;
+    cl_ulong seed;
+    size_t count;
+    void *outData;
+};
+
+static cl_int random_data_job(cl_uint job_id, cl_uint thread_id,
+                              void *userInfo)
+{
+    const RandomDataJob *job = (const RandomDataJob *)userInfo;
+    size_t first = (size_t)job_id * RANDOM_DATA_JOB_ELEMENTS;
+    generate_counter_random_data(
+        job->type, job->seed, first,
+        std::min((size_t)RANDOM_DATA_JOB_ELEMENTS, job->count - first),
+        job->outData);
+    return CL_SUCCESS;
+}
+
+void generate_random_data(ExplicitType type, size_t count, MTdata d,
+                          void *outData)
+{
+    if (gMT19937Data)
+    {
+        generate_mt19937_random_data(type, count, d, outData);
+        return;
+    }
+
+    if (get_random_data_bits(type) == 0)
+    {
+        log_error("ERROR: Invalid type passed in to generate_random_data!\n");
+        return;
+    }
+
+    // Each element only depends on the seed and its index, so the jobs give
+    // the same data as a serial fill.
+    RandomDataJob job = { type, counter_random_seed(d), count, outData };
+    size_t jobCount =
+        (count + RANDOM_DATA_JOB_ELEMENTS - 1) / RANDOM_DATA_JOB_ELEMENTS;
+    if (jobCount < 2
+        || ThreadPool_Do(random_data_job, (cl_uint)jobCount, &job)
+            != CL_SUCCESS)
+    {
+        generate_counter_random_data(type, job.seed, 0, count, outData);
+    }
+}
+
 void *create_random_data(ExplicitType type, MTdata d, size_t count)
 {
     void *data = malloc(get_explicit_type_size(type) * count);
@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "counterRandom.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+
+const cl_uint kPhiloxM0 = 0xD2511F53;
+const cl_uint kPhiloxM1 = 0xCD9E8D57;
+const cl_uint kPhiloxW0 = 0x9E3779B9;
+const cl_uint kPhiloxW1 = 0xBB67AE85;
+
+// Blocks computed together by philox_blocks.  The rounds of the blocks are
+// independent, so that the loops over them vectorize.
+const size_t kPhiloxLanes = 8;
+
+// Words of a job of counter_random_fill_parallel.
+const size_t kFillJobWords = 1 << 16;
+
+// Write the 4 words of blocks [first, first + count) of the stream of seed.
+// Block b is Philox4x32-10 of the counter (b, 0) with the seed as key.
+void philox_blocks(cl_ulong seed, cl_ulong first, size_t count, cl_uint *out)
+{
+    for (size_t b = 0; b < count; b += kPhiloxLanes)
+    {
+        cl_uint c0[kPhiloxLanes], c1[kPhiloxLanes], c2[kPhiloxLanes],
+            c3[kPhiloxLanes];
+        for (size_t i = 0; i < kPhiloxLanes; i++)
+        {
+            cl_ulong block = first + b + i;
+            c0[i] = (cl_uint)block;
+            c1[i] = (cl_uint)(block >> 32);
+            c2[i] = 0;
+            c3[i] = 0;
+        }
+
+        cl_uint k0 = (cl_uint)seed;
+        cl_uint k1 = (cl_uint)(seed >> 32);
+        for (int round = 0; round < 10; round++)
+        {
+            for (size_t i = 0; i < kPhiloxLanes; i++)
+            {
+                cl_ulong p0 = (cl_ulong)kPhiloxM0 * c0[i];
+                cl_ulong p1 = (cl_ulong)kPhiloxM1 * c2[i];
+                c0[i] = (cl_uint)(p1 >> 32) ^ c1[i] ^ k0;
+                c1[i] = (cl_uint)p1;
+                c2[i] = (cl_uint)(p0 >> 32) ^ c3[i] ^ k1;
+                c3[i] = (cl_uint)p0;
+            }
+            k0 += kPhiloxW0;
+            k1 += kPhiloxW1;
+        }
+
+        size_t lanes = std::min(kPhiloxLanes, count - b);
+        for (size_t i = 0; i < lanes; i++)
+        {
+            cl_uint *words = out + 4 * (b + i);
+            words[0] = c0[i];
+            words[1] = c1[i];
+            words[2] = c2[i];
+            words[3] = c3[i];
+        }
+    }
+}
+
+struct FillJob
+{
+    cl_ulong seed;
+    cl_ulong first;
+    cl_uint *out;
+    size_t count;
+};
+
+cl_int fill_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    const FillJob *job = (const FillJob *)userInfo;
+    size_t start = (size_t)job_id * kFillJobWords;
+    counter_random_fill(job->seed, job->first + start, job->out + start,
+                        std::min(kFillJobWords, job->count - start));
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+cl_ulong counter_random_seed(MTdata d)
+{
+    cl_ulong seed = genrand_int32(d);
+    return (seed << 32) | genrand_int32(d);
+}
+
+cl_uint counter_random_uint(cl_ulong seed, cl_ulong index)
+{
+    cl_uint words[4];
+    philox_blocks(seed, index / 4, 1, words);
+    return words[index % 4];
+}
+
+void counter_random_fill(cl_ulong seed, cl_ulong first, cl_uint *out,
+                         size_t count)
+{
+    // Words before the first whole block.
+    while (count > 0 && first % 4 != 0)
+    {
+        *out++ = counter_random_uint(seed, first++);
+        count--;
+    }
+
+    size_t blocks = count / 4;
+    philox_blocks(seed, first / 4, blocks, out);
+    first += 4 * blocks;
+    out += 4 * blocks;
+    count -= 4 * blocks;
+
+    while (count > 0)
+    {
+        *out++ = counter_random_uint(seed, first++);
+        count--;
+    }
+}
+
+void counter_random_fill_parallel(cl_ulong seed, cl_ulong first, cl_uint *out,
+                                  size_t count)
+{
+    size_t jobCount = (count + kFillJobWords - 1) / kFillJobWords;
+    FillJob job = { seed, first, out, count };
+    if (jobCount < 2
+        || ThreadPool_Do(fill_job, (cl_uint)jobCount, &job) != CL_SUCCESS)
+    {
+        counter_random_fill(seed, first, out, count);
+    }
+}
@@ -0,0 +1,47 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _counterRandom_h
+#define _counterRandom_h
+
+#include "mt19937.h"
+
+#include <stddef.h>
+
+// Counter-based random numbers, from the Philox4x32-10 generator of Salmon et
+// al., "Parallel Random Numbers: As Easy as 1, 2, 3".  Word i of the stream of
+// a seed is a pure function of the seed and i, so that buffers can be filled
+// in parallel, or any part of them regenerated, with the values of a serial
+// fill.
+//
+// The random data fills of the harness use these streams, unless
+// --mt19937-data selects the serial MT19937 stream of their MTdata.
+
+// Seed of a new stream, drawn from d so that runs with the same random seed
+// generate the same data.
+cl_ulong counter_random_seed(MTdata d);
+
+// Word index of the stream of seed.
+cl_uint counter_random_uint(cl_ulong seed, cl_ulong index);
+
+// Fill out with words [first, first + count) of the stream of seed.
+void counter_random_fill(cl_ulong seed, cl_ulong first, cl_uint *out,
+                         size_t count);
+
+// Same as counter_random_fill, with large fills split over the thread pool.
+void counter_random_fill_parallel(cl_ulong seed, cl_ulong first, cl_uint *out,
+                                  size_t count);
+
+#endif // _counterRandom_h
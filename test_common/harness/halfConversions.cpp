@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "halfConversions.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HALF_CONVERSIONS_F16C 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <cl_half_rounding_mode rounding_mode>
+void float_array(cl_half *out, const float *in, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = half_from_float<rounding_mode>(in[i]);
+}
+
+template <cl_half_rounding_mode rounding_mode>
+void double_array(cl_half *out, const double *in, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = half_from_double<rounding_mode>(in[i]);
+}
+
+#if HALF_CONVERSIONS_F16C
+
+// vcvtps2ph takes its rounding mode as an immediate, and matches
+// cl_half_from_float except when denormals are flushed on input.  Only its
+// 128-bit form is used, the 256-bit one also needs the OS to save the AVX
+// registers.
+bool use_f16c()
+{
+    static const bool supported = __builtin_cpu_supports("f16c");
+    return supported && !(_mm_getcsr() & _MM_DENORMALS_ZERO_ON);
+}
+
+template <int imm>
+__attribute__((target("f16c"))) size_t f16c_array(cl_half *out,
+                                                  const float *in,
+                                                  size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 f = _mm_loadu_ps(in + i);
+        _mm_storel_epi64((__m128i *)(out + i), _mm_cvtps_ph(f, imm));
+    }
+    return i;
+}
+
+size_t f16c_float_array(cl_half *out, const float *in, size_t count,
+                        cl_half_rounding_mode rounding_mode)
+{
+    if (!use_f16c()) return 0;
+
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTZ:
+            return f16c_array<_MM_FROUND_TO_ZERO>(out, in, count);
+        case CL_HALF_RTP:
+            return f16c_array<_MM_FROUND_TO_POS_INF>(out, in, count);
+        case CL_HALF_RTN:
+            return f16c_array<_MM_FROUND_TO_NEG_INF>(out, in, count);
+        default:
+            return f16c_array<_MM_FROUND_TO_NEAREST_INT>(out, in, count);
+    }
+}
+
+// Rounds d to float to odd: truncated, with the low bit set when inexact.
+// The float keeps at least two more bits than the half results, so rounding it
+// to half in any mode gives the same result as rounding d directly.  Values
+// out of the half range are replaced with floats of the same sign that also
+// underflow or overflow.
+float float_round_to_odd(double d)
+{
+    cl_ulong u;
+    memcpy(&u, &d, sizeof(u));
+    cl_uint sign = (cl_uint)(u >> 32) & 0x80000000;
+    cl_ulong a = u & 0x7fffffffffffffffULL;
+    cl_uint e = (cl_uint)(a >> 52);
+
+    cl_uint f = (cl_uint)((a >> 29) - (896ULL << 23))
+        | ((a & 0x1fffffff) != 0);
+    f = e < 897 ? (a != 0) : f;
+    f = e >= 1151 ? 0x7f000000 : f;
+
+    cl_uint nan = 0x7f800000 | (cl_uint)((a >> 29) & 0x7fffff)
+        | ((a & 0xfffffffffffffULL) ? 0x400000 : 0);
+    f = e == 2047 ? nan : f;
+    f |= sign;
+
+    float result;
+    memcpy(&result, &f, sizeof(result));
+    return result;
+}
+
+size_t f16c_double_array(cl_half *out, const double *in, size_t count,
+                         cl_half_rounding_mode rounding_mode)
+{
+    if (!use_f16c()) return 0;
+
+    float buffer[256];
+    for (size_t i = 0; i < count; i += 256)
+    {
+        size_t chunk = count - i < 256 ? count - i : 256;
+        for (size_t j = 0; j < chunk; j++)
+            buffer[j] = float_round_to_odd(in[i + j]);
+        half_from_float_array(out + i, buffer, chunk, rounding_mode);
+    }
+    return count;
+}
+
+#else
+
+size_t f16c_float_array(cl_half *, const float *, size_t,
+                        cl_half_rounding_mode)
+{
+    return 0;
+}
+
+size_t f16c_double_array(cl_half *, const double *, size_t,
+                         cl_half_rounding_mode)
+{
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+void half_from_float_array(cl_half *out, const float *in, size_t count,
+                           cl_half_rounding_mode rounding_mode)
+{
+    size_t done = f16c_float_array(out, in, count, rounding_mode);
+    out += done;
+    in += done;
+    count -= done;
+
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTZ: float_array<CL_HALF_RTZ>(out, in, count); break;
+        case CL_HALF_RTP: float_array<CL_HALF_RTP>(out, in, count); break;
+        case CL_HALF_RTN: float_array<CL_HALF_RTN>(out, in, count); break;
+        default: float_array<CL_HALF_RTE>(out, in, count); break;
+    }
+}
+
+void half_from_double_array(cl_half *out, const double *in, size_t count,
+                            cl_half_rounding_mode rounding_mode)
+{
+    size_t done = f16c_double_array(out, in, count, rounding_mode);
+    out += done;
+    in += done;
+    count -= done;
+
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTZ: double_array<CL_HALF_RTZ>(out, in, count); break;
+        case CL_HALF_RTP: double_array<CL_HALF_RTP>(out, in, count); break;
+        case CL_HALF_RTN: double_array<CL_HALF_RTN>(out, in, count); break;
+        default: double_array<CL_HALF_RTE>(out, in, count); break;
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _halfConversions_h
+#define _halfConversions_h
+
+#include "compat.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <CL/cl_half.h>
+
+// Conversions of float and double to half in the four rounding modes of
+// cl_half.h.  The results are bit-exact with cl_half_from_float and
+// cl_half_from_double, NaN payloads included, and do not depend on the host
+// floating point state.
+//
+// The conversions are computed with integer operations and selects instead of
+// branches, so that the loops of the array versions vectorize.  On x86 hosts
+// with F16C, the array versions use its conversion instructions, doubles
+// going through floats rounded to odd.
+
+template <cl_half_rounding_mode rounding_mode>
+inline cl_uint half_round_up(bool sign, bool odd, bool above, bool halfway,
+                             bool inexact)
+{
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTE: return above | (halfway & odd);
+        case CL_HALF_RTP: return inexact & !sign;
+        case CL_HALF_RTN: return inexact & sign;
+        default: return 0;
+    }
+}
+
+// Half of the finite values too large for it: infinity, or the largest half
+// in the rounding modes toward zero.
+template <cl_half_rounding_mode rounding_mode>
+inline cl_uint half_overflow(bool sign)
+{
+    bool inf = rounding_mode == CL_HALF_RTE
+        || (rounding_mode == CL_HALF_RTP && !sign)
+        || (rounding_mode == CL_HALF_RTN && sign);
+    return 0x7bff + inf;
+}
+
+template <cl_half_rounding_mode rounding_mode>
+inline cl_half half_from_float(float f)
+{
+    cl_uint u;
+    memcpy(&u, &f, sizeof(u));
+    cl_uint sign = (u >> 16) & 0x8000;
+    cl_uint a = u & 0x7fffffff;
+    cl_uint e = a >> 23;
+
+    // Number of bits of the significand below the half result: 13 for normal
+    // results, more for subnormal ones, and all of them (31 is enough) below
+    // half of the smallest subnormal half.
+    int shift = 126 - (int)e;
+    shift = shift < 13 ? 13 : (shift > 31 ? 31 : shift);
+    int biased = (int)e - 113;
+    cl_uint m = (a & 0x7fffff) | (e ? 0x800000 : 0);
+    cl_uint h = ((cl_uint)(biased > 0 ? biased : 0) << 10) + (m >> shift);
+    cl_uint rem = m & ((1u << shift) - 1);
+    cl_uint halfway = 1u << (shift - 1);
+
+    // A carry out of the significand increments the exponent
+    h += half_round_up<rounding_mode>(sign, h & 1, rem > halfway,
+                                      rem == halfway, rem != 0);
+    h = e >= 143 ? half_overflow<rounding_mode>(sign) : h;
+
+    // Infinities, and NaNs quieted with the upper bits of their payload
+    cl_uint special =
+        0x7c00 | (a > 0x7f800000 ? 0x200 : 0) | ((a >> 13) & 0x3ff);
+    h = a >= 0x7f800000 ? special : h;
+    return (cl_half)(sign | h);
+}
+
+template <cl_half_rounding_mode rounding_mode>
+inline cl_half half_from_double(double d)
+{
+    cl_ulong u;
+    memcpy(&u, &d, sizeof(u));
+    cl_uint sign = (cl_uint)(u >> 48) & 0x8000;
+    cl_ulong a = u & 0x7fffffffffffffffULL;
+    cl_uint e = (cl_uint)(a >> 52);
+
+    int shift = 1051 - (int)e;
+    shift = shift < 42 ? 42 : (shift > 63 ? 63 : shift);
+    int biased = (int)e - 1009;
+    cl_ulong m = (a & 0xfffffffffffffULL) | (e ? 0x10000000000000ULL : 0);
+    cl_uint h =
+        ((cl_uint)(biased > 0 ? biased : 0) << 10) + (cl_uint)(m >> shift);
+    cl_ulong rem = m & ((1ULL << shift) - 1);
+    cl_ulong halfway = 1ULL << (shift - 1);
+
+    h += half_round_up<rounding_mode>(sign, h & 1, rem > halfway,
+                                      rem == halfway, rem != 0);
+    h = e >= 1039 ? half_overflow<rounding_mode>(sign) : h;
+
+    cl_uint special = 0x7c00 | (a > 0x7ff0000000000000ULL ? 0x200 : 0)
+        | ((cl_uint)(a >> 42) & 0x3ff);
+    h = a >= 0x7ff0000000000000ULL ? special : h;
+    return (cl_half)(sign | h);
+}
+
+inline cl_half half_from_float(float f, cl_half_rounding_mode rounding_mode)
+{
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTZ: return half_from_float<CL_HALF_RTZ>(f);
+        case CL_HALF_RTP: return half_from_float<CL_HALF_RTP>(f);
+        case CL_HALF_RTN: return half_from_float<CL_HALF_RTN>(f);
+        default: return half_from_float<CL_HALF_RTE>(f);
+    }
+}
+
+inline cl_half half_from_double(double d, cl_half_rounding_mode rounding_mode)
+{
+    switch (rounding_mode)
+    {
+        case CL_HALF_RTZ: return half_from_double<CL_HALF_RTZ>(d);
+        case CL_HALF_RTP: return half_from_double<CL_HALF_RTP>(d);
+        case CL_HALF_RTN: return half_from_double<CL_HALF_RTN>(d);
+        default: return half_from_double<CL_HALF_RTE>(d);
+    }
+}
+
+// Convert count floats or doubles of in to half in out.
+void half_from_float_array(cl_half *out, const float *in, size_t count,
+                           cl_half_rounding_mode rounding_mode);
+void half_from_double_array(cl_half *out, const double *in, size_t count,
+                            cl_half_rounding_mode rounding_mode);
+
+#endif // _halfConversions_h
@@ -14,6 +14,8 @@
 // limitations under the License.
 //
 #include "imageHelpers.h"
+#include "counterRandom.h"
+#include "parseParameters.h"
 #include <limits.h>
 #include <assert.h>
 #if defined(__APPLE__)
@@ -25,10 +27,15 @@
 #include <algorithm>
 #include <cinttypes>
 #include <iterator>
+#include <mutex>
 #if !defined(_WIN32)
 #include <cmath>
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 RoundingMode gFloatToHalfRoundingMode = kDefaultRoundingMode;
 
 cl_device_type gDeviceType = CL_DEVICE_TYPE_DEFAULT;
@@ -483,145 +490,233 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
 size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
                          const char *bPtr)
 {
-    size_t pixel_size = get_pixel_size(imageInfo->format);
-    size_t column;
+    return ScanlineComparator(imageInfo->format)
+        .compare(aPtr, bPtr, imageInfo->width);
+}
+
+ScanlineComparator::ScanlineComparator(const cl_image_format *format)
+    : dataType(format->image_channel_data_type),
+      channelCount(get_format_channel_count(format)),
+      pixelSize(get_pixel_size(format)),
+      maskSize(SCANLINE_MASK_PIXELS * pixelSize)
+{
+    // Significant bits of one pixel, in the byte order of the host like the
+    // pixels compared.
+    unsigned char pixelMask[16];
+    memset(pixelMask, 0xff, sizeof(pixelMask));
+    cl_ushort channelMask = 0xffff;
+    switch (dataType)
+    {
+        case CL_UNORM_INT_101010: {
+            cl_uint bits = 0x3fffffff;
+            memcpy(pixelMask, &bits, sizeof(bits));
+        }
+        break;
+        case CL_UNORM_SHORT_555: {
+            cl_ushort bits = 0x7fff;
+            memcpy(pixelMask, &bits, sizeof(bits));
+        }
+        break;
+        case CL_UNSIGNED_INT10X6_EXT:
+        case CL_UNORM_INT10X6_EXT: channelMask = 0xffc0; break;
+        case CL_UNSIGNED_INT12X4_EXT:
+        case CL_UNORM_INT12X4_EXT: channelMask = 0xfff0; break;
+        case CL_UNSIGNED_INT14X2_EXT:
+        case CL_UNORM_INT14X2_EXT: channelMask = 0xfffc; break;
+        default: break;
+    }
+    if (channelMask != 0xffff)
+    {
+        for (size_t chan = 0; chan < channelCount; ++chan)
+            memcpy(pixelMask + chan * sizeof(cl_ushort), &channelMask,
+                   sizeof(channelMask));
+    }
+
+    for (size_t i = 0; i < SCANLINE_MASK_PIXELS; i++)
+        memcpy(mask + i * pixelSize, pixelMask, pixelSize);
+}
+
+// Whether the bits of mask match in the size bytes of aPtr and bPtr.  size is
+// a multiple of 16.
+static bool masked_bytes_match(const char *aPtr, const char *bPtr,
+                               const unsigned char *mask, size_t size)
+{
+#ifdef __SSE2__
+    __m128i diff = _mm_setzero_si128();
+    for (size_t i = 0; i < size; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(aPtr + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(bPtr + i));
+        __m128i m = _mm_loadu_si128((const __m128i *)(mask + i));
+        diff = _mm_or_si128(diff, _mm_and_si128(_mm_xor_si128(a, b), m));
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128()))
+        == 0xffff;
+#else
+    cl_ulong diff = 0;
+    for (size_t i = 0; i < size; i += sizeof(cl_ulong))
+    {
+        cl_ulong a, b, m;
+        memcpy(&a, aPtr + i, sizeof(a));
+        memcpy(&b, bPtr + i, sizeof(b));
+        memcpy(&m, mask + i, sizeof(m));
+        diff |= (a ^ b) & m;
+    }
+    return diff == 0;
+#endif
+}
 
-    for (column = 0; column < imageInfo->width; column++)
+size_t ScanlineComparator::compare(const char *aPtr, const char *bPtr,
+                                   size_t width) const
+{
+    size_t column = 0;
+    for (; column + SCANLINE_MASK_PIXELS <= width;
+         column += SCANLINE_MASK_PIXELS)
     {
-        switch (imageInfo->format->image_channel_data_type)
+        const char *a = aPtr + column * pixelSize;
+        const char *b = bPtr + column * pixelSize;
+        if (masked_bytes_match(a, b, mask, maskSize)) continue;
+
+        // Find the pixel that differs.  There may be none, as the two
+        // encodings of -1.0 of the SNORM formats differ in their bits.
+        for (size_t i = 0; i < SCANLINE_MASK_PIXELS; i++)
         {
-            // If the data type is 101010, then ignore bits 31 and 32 when
-            // comparing the row
-            case CL_UNORM_INT_101010: {
-                cl_uint aPixel = 0;
-                cl_uint bPixel = 0;
-                memcpy(&aPixel, aPtr, sizeof(aPixel));
-                memcpy(&bPixel, bPtr, sizeof(bPixel));
-                if ((aPixel & 0x3fffffff) != (bPixel & 0x3fffffff))
-                    return column;
-            }
-            break;
+            if (!pixels_match(a + i * pixelSize, b + i * pixelSize))
+                return column + i;
+        }
+    }
 
-            // If the data type is 555, ignore bit 15 when comparing the row
-            case CL_UNORM_SHORT_555: {
-                cl_ushort aPixel = 0;
-                cl_ushort bPixel = 0;
-                memcpy(&aPixel, aPtr, sizeof(aPixel));
-                memcpy(&bPixel, bPtr, sizeof(bPixel));
-                if ((aPixel & 0x7fff) != (bPixel & 0x7fff)) return column;
-            }
-            break;
+    for (; column < width; column++)
+    {
+        if (!pixels_match(aPtr + column * pixelSize, bPtr + column * pixelSize))
+            return column;
+    }
 
-            // 16-bit per-channel formats with LSB padding (per spec); compare
-            // defined bits only.
-            case CL_UNSIGNED_INT10X6_EXT:
-            case CL_UNORM_INT10X6_EXT: {
-                const size_t channel_count =
-                    get_format_channel_count(imageInfo->format);
-                for (size_t chan = 0; chan < channel_count; ++chan)
-                {
-                    cl_ushort aChanVal = 0;
-                    cl_ushort bChanVal = 0;
-                    const char *aChan = aPtr + chan * sizeof(cl_ushort);
-                    const char *bChan = bPtr + chan * sizeof(cl_ushort);
-                    memcpy(&aChanVal, aChan, sizeof(aChanVal));
-                    memcpy(&bChanVal, bChan, sizeof(bChanVal));
-                    if ((aChanVal & 0xffc0) != (bChanVal & 0xffc0))
-                        return column;
-                }
+    // If we didn't find a difference, return the width of the image
+    return width;
+}
+
+bool ScanlineComparator::pixels_match(const char *aPtr,
+                                      const char *bPtr) const
+{
+    switch (dataType)
+    {
+        // If the data type is 101010, then ignore bits 31 and 32 when
+        // comparing the row
+        case CL_UNORM_INT_101010: {
+            cl_uint aPixel = 0;
+            cl_uint bPixel = 0;
+            memcpy(&aPixel, aPtr, sizeof(aPixel));
+            memcpy(&bPixel, bPtr, sizeof(bPixel));
+            if ((aPixel & 0x3fffffff) != (bPixel & 0x3fffffff))
+                return false;
+        }
+        break;
+
+        // If the data type is 555, ignore bit 15 when comparing the row
+        case CL_UNORM_SHORT_555: {
+            cl_ushort aPixel = 0;
+            cl_ushort bPixel = 0;
+            memcpy(&aPixel, aPtr, sizeof(aPixel));
+            memcpy(&bPixel, bPtr, sizeof(bPixel));
+            if ((aPixel & 0x7fff) != (bPixel & 0x7fff)) return false;
+        }
+        break;
+
+        // 16-bit per-channel formats with LSB padding (per spec); compare
+        // defined bits only.
+        case CL_UNSIGNED_INT10X6_EXT:
+        case CL_UNORM_INT10X6_EXT: {
+            for (size_t chan = 0; chan < channelCount; ++chan)
+            {
+                cl_ushort aChanVal = 0;
+                cl_ushort bChanVal = 0;
+                const char *aChan = aPtr + chan * sizeof(cl_ushort);
+                const char *bChan = bPtr + chan * sizeof(cl_ushort);
+                memcpy(&aChanVal, aChan, sizeof(aChanVal));
+                memcpy(&bChanVal, bChan, sizeof(bChanVal));
+                if ((aChanVal & 0xffc0) != (bChanVal & 0xffc0))
+                    return false;
             }
-            break;
-            case CL_UNSIGNED_INT12X4_EXT:
-            case CL_UNORM_INT12X4_EXT: {
-                const size_t channel_count =
-                    get_format_channel_count(imageInfo->format);
-                for (size_t chan = 0; chan < channel_count; ++chan)
-                {
-                    cl_ushort aChanVal = 0;
-                    cl_ushort bChanVal = 0;
-                    const char *aChan = aPtr + chan * sizeof(cl_ushort);
-                    const char *bChan = bPtr + chan * sizeof(cl_ushort);
-                    memcpy(&aChanVal, aChan, sizeof(aChanVal));
-                    memcpy(&bChanVal, bChan, sizeof(bChanVal));
-                    if ((aChanVal & 0xfff0) != (bChanVal & 0xfff0))
-                        return column;
-                }
+        }
+        break;
+        case CL_UNSIGNED_INT12X4_EXT:
+        case CL_UNORM_INT12X4_EXT: {
+            for (size_t chan = 0; chan < channelCount; ++chan)
+            {
+                cl_ushort aChanVal = 0;
+                cl_ushort bChanVal = 0;
+                const char *aChan = aPtr + chan * sizeof(cl_ushort);
+                const char *bChan = bPtr + chan * sizeof(cl_ushort);
+                memcpy(&aChanVal, aChan, sizeof(aChanVal));
+                memcpy(&bChanVal, bChan, sizeof(bChanVal));
+                if ((aChanVal & 0xfff0) != (bChanVal & 0xfff0))
+                    return false;
             }
-            break;
-            case CL_UNSIGNED_INT14X2_EXT:
-            case CL_UNORM_INT14X2_EXT: {
-                const size_t channel_count =
-                    get_format_channel_count(imageInfo->format);
-                for (size_t chan = 0; chan < channel_count; ++chan)
-                {
-                    cl_ushort aChanVal = 0;
-                    cl_ushort bChanVal = 0;
-                    const char *aChan = aPtr + chan * sizeof(cl_ushort);
-                    const char *bChan = bPtr + chan * sizeof(cl_ushort);
-                    memcpy(&aChanVal, aChan, sizeof(aChanVal));
-                    memcpy(&bChanVal, bChan, sizeof(bChanVal));
-                    if ((aChanVal & 0xfffc) != (bChanVal & 0xfffc))
-                        return column;
-                }
+        }
+        break;
+        case CL_UNSIGNED_INT14X2_EXT:
+        case CL_UNORM_INT14X2_EXT: {
+            for (size_t chan = 0; chan < channelCount; ++chan)
+            {
+                cl_ushort aChanVal = 0;
+                cl_ushort bChanVal = 0;
+                const char *aChan = aPtr + chan * sizeof(cl_ushort);
+                const char *bChan = bPtr + chan * sizeof(cl_ushort);
+                memcpy(&aChanVal, aChan, sizeof(aChanVal));
+                memcpy(&bChanVal, bChan, sizeof(bChanVal));
+                if ((aChanVal & 0xfffc) != (bChanVal & 0xfffc))
+                    return false;
             }
-            break;
+        }
+        break;
 
-            case CL_SNORM_INT8: {
-                const size_t channel_count =
-                    get_format_channel_count(imageInfo->format);
-                for (size_t chan = 0; chan < channel_count; ++chan)
+        case CL_SNORM_INT8: {
+            for (size_t chan = 0; chan < channelCount; ++chan)
+            {
+                cl_uchar aChanVal = 0;
+                cl_uchar bChanVal = 0;
+                const char *aChan = aPtr + chan * sizeof(cl_uchar);
+                const char *bChan = bPtr + chan * sizeof(cl_uchar);
+                memcpy(&aChanVal, aChan, sizeof(aChanVal));
+                memcpy(&bChanVal, bChan, sizeof(bChanVal));
+                // -1.0 is defined as 0x80 and 0x81
+                aChanVal = (aChanVal == 0x80) ? 0x81 : aChanVal;
+                bChanVal = (bChanVal == 0x80) ? 0x81 : bChanVal;
+                if (aChanVal != bChanVal)
                 {
-                    cl_uchar aChanVal = 0;
-                    cl_uchar bChanVal = 0;
-                    const char *aChan = aPtr + chan * sizeof(cl_uchar);
-                    const char *bChan = bPtr + chan * sizeof(cl_uchar);
-                    memcpy(&aChanVal, aChan, sizeof(aChanVal));
-                    memcpy(&bChanVal, bChan, sizeof(bChanVal));
-                    // -1.0 is defined as 0x80 and 0x81
-                    aChanVal = (aChanVal == 0x80) ? 0x81 : aChanVal;
-                    bChanVal = (bChanVal == 0x80) ? 0x81 : bChanVal;
-                    if (aChanVal != bChanVal)
-                    {
-                        return column;
-                    }
+                    return false;
                 }
             }
-            break;
+        }
+        break;
 
-            case CL_SNORM_INT16: {
-                const size_t channel_count =
-                    get_format_channel_count(imageInfo->format);
-                for (size_t chan = 0; chan < channel_count; ++chan)
+        case CL_SNORM_INT16: {
+            for (size_t chan = 0; chan < channelCount; ++chan)
+            {
+                cl_ushort aChanVal = 0;
+                cl_ushort bChanVal = 0;
+                const char *aChan = aPtr + chan * sizeof(cl_ushort);
+                const char *bChan = bPtr + chan * sizeof(cl_ushort);
+                memcpy(&aChanVal, aChan, sizeof(aChanVal));
+                memcpy(&bChanVal, bChan, sizeof(bChanVal));
+                // -1.0 is defined as 0x8000 and 0x8001
+                aChanVal = (aChanVal == 0x8000) ? 0x8001 : aChanVal;
+                bChanVal = (bChanVal == 0x8000) ? 0x8001 : bChanVal;
+                if (aChanVal != bChanVal)
                 {
-                    cl_ushort aChanVal = 0;
-                    cl_ushort bChanVal = 0;
-                    const char *aChan = aPtr + chan * sizeof(cl_ushort);
-                    const char *bChan = bPtr + chan * sizeof(cl_ushort);
-                    memcpy(&aChanVal, aChan, sizeof(aChanVal));
-                    memcpy(&bChanVal, bChan, sizeof(bChanVal));
-                    // -1.0 is defined as 0x8000 and 0x8001
-                    aChanVal = (aChanVal == 0x8000) ? 0x8001 : aChanVal;
-                    bChanVal = (bChanVal == 0x8000) ? 0x8001 : bChanVal;
-                    if (aChanVal != bChanVal)
-                    {
-                        return column;
-                    }
+                    return false;
                 }
             }
-            break;
-
-            default:
-                if (memcmp(aPtr, bPtr, pixel_size) != 0) return column;
-                break;
         }
+        break;
 
-        aPtr += pixel_size;
-        bPtr += pixel_size;
+        default:
+            if (memcmp(aPtr, bPtr, pixelSize) != 0) return false;
+            break;
     }
 
-    // If we didn't find a difference, return the width of the image
-    assert(column == imageInfo->width);
-    return column;
+    return true;
 }
 
 int random_log_in_range(int minV, int maxV, MTdata d)
@@ -667,7 +762,6 @@ AddressFn ClampToEdgeLinearFn = ClampToEdgeNearestFn;
 
 // Note: normalized coords get repeated in normalized space, not unnormalized
 // space! hence the special case here
-volatile float gFloatHome;
 float RepeatNormalizedAddressFn(float fValue, size_t maxValue)
 {
 #ifndef _MSC_VER // Use original if not the VS compiler.
@@ -675,9 +769,10 @@ float RepeatNormalizedAddressFn(float fValue, size_t maxValue)
     return (fValue - floorf(fValue)) * (float)maxValue; // Reduce to [0, 1.f]
 #else // Otherwise, use this instead:
     // Home the subtraction to a float to break up the sequence of x87
-    // instructions emitted by the VS compiler.
-    gFloatHome = fValue - floorf(fValue);
-    return gFloatHome * (float)maxValue;
+    // instructions emitted by the VS compiler.  The home is local as
+    // validation samples from several threads.
+    volatile float floatHome = fValue - floorf(fValue);
+    return floatHome * (float)maxValue;
 #endif
 }
 
@@ -724,7 +819,7 @@ struct AddressingTable
               [CL_FILTER_LINEAR - CL_FILTER_NEAREST] = MirroredRepeatAddressFn;
     }
 
-    AddressFn operator[](image_sampler_data *sampler)
+    AddressFn operator[](const image_sampler_data *sampler)
     {
         return mTable[(int)sampler->addressing_mode - CL_ADDRESS_NONE]
                      [(int)sampler->filter_mode - CL_FILTER_NEAREST];
@@ -1386,9 +1481,22 @@ char *generate_random_image_data(image_descriptor *imageInfo,
 
     // Otherwise, we should be able to just fill with random bits no matter what
     cl_uint *p = (cl_uint *)data;
-    for (i = 0; i + 4 <= allocSize; i += 4) p[i / 4] = genrand_int32(d);
+    if (gMT19937Data)
+    {
+        for (i = 0; i + 4 <= allocSize; i += 4) p[i / 4] = genrand_int32(d);
 
-    for (; i < allocSize; i++) data[i] = genrand_int32(d);
+        for (; i < allocSize; i++) data[i] = genrand_int32(d);
+    }
+    else
+    {
+        cl_ulong seed = counter_random_seed(d);
+        size_t words = allocSize / 4;
+        counter_random_fill_parallel(seed, 0, p, words);
+
+        // The last bytes come from the next word of the stream.
+        cl_uint tail = counter_random_uint(seed, words);
+        memcpy(data + 4 * words, &tail, allocSize - 4 * words);
+    }
 
     // Note: inf or nan float values would cause problems, although we don't
     // know this will actually be a float, so we just know what to look for
@@ -1460,315 +1568,275 @@ char *generate_random_image_data(image_descriptor *imageInfo,
 #define CLAMP_FLOAT(v) (fmaxf(fminf(v, 1.f), -1.f))
 
 
-void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
-                            int y, int z, float *outData, int lod)
-{
-    size_t width_lod = imageInfo->width, height_lod = imageInfo->height,
-           depth_lod = imageInfo->depth;
-    size_t slice_pitch_lod = 0, row_pitch_lod = 0;
-
-    if (imageInfo->num_mip_levels > 1)
-    {
-        switch (imageInfo->type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                depth_lod =
-                    (imageInfo->depth >> lod) ? (imageInfo->depth >> lod) : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                height_lod =
-                    (imageInfo->height >> lod) ? (imageInfo->height >> lod) : 1;
-            default:
-                width_lod =
-                    (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
-        }
-        row_pitch_lod = width_lod * get_pixel_size(imageInfo->format);
-        if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
-            slice_pitch_lod = row_pitch_lod;
-        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D
-                 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
-            slice_pitch_lod = row_pitch_lod * height_lod;
-    }
-    else
-    {
-        row_pitch_lod = imageInfo->rowPitch;
-        slice_pitch_lod = imageInfo->slicePitch;
-    }
-    if (x < 0 || y < 0 || z < 0 || x >= (int)width_lod
-        || (height_lod != 0 && y >= (int)height_lod)
-        || (depth_lod != 0 && z >= (int)depth_lod)
-        || (imageInfo->arraySize != 0 && z >= (int)imageInfo->arraySize))
-    {
-        outData[0] = outData[1] = outData[2] = outData[3] = 0;
-        if (!has_alpha(imageInfo->format)) outData[3] = 1;
-        return;
-    }
-
-    const cl_image_format *format = imageInfo->format;
-
-    unsigned int i;
-    float tempData[4];
-
-    // Advance to the right spot
-    char *ptr = (char *)imageData;
-    size_t pixelSize = get_pixel_size(format);
-
-    ptr += z * slice_pitch_lod + y * row_pitch_lod + x * pixelSize;
-
-    // OpenCL only supports reading floats from certain formats
-    size_t channelCount = get_format_channel_count(format);
-    switch (format->image_channel_data_type)
-    {
-        case CL_SNORM_INT8: {
-            cl_char *dPtr = (cl_char *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = CLAMP_FLOAT((float)dPtr[i] / 127.0f);
-            break;
-        }
-
-        case CL_UNORM_INT8: {
-            unsigned char *dPtr = (unsigned char *)ptr;
-            for (i = 0; i < channelCount; i++)
-            {
-                if ((is_sRGBA_order(imageInfo->format->image_channel_order))
-                    && i < 3) // only RGB need to be converted for sRGBA
-                    tempData[i] = (float)sRGBunmap((float)dPtr[i] / 255.0f);
-                else
-                    tempData[i] = (float)dPtr[i] / 255.0f;
-            }
-            break;
-        }
-
-        case CL_SIGNED_INT8: {
-            cl_char *dPtr = (cl_char *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_UNSIGNED_INT8: {
-            cl_uchar *dPtr = (cl_uchar *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_SNORM_INT16: {
-            cl_short *dPtr = (cl_short *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = CLAMP_FLOAT((float)dPtr[i] / 32767.0f);
-            break;
-        }
-
-        case CL_UNORM_INT16: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = (float)dPtr[i] / 65535.0f;
-            break;
-        }
+namespace {
 
-        case CL_SIGNED_INT16: {
-            cl_short *dPtr = (cl_short *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
+typedef void (*TexelDecodeFn)(const char *ptr, float *tempData);
 
-        case CL_UNSIGNED_INT16: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
-
-        case CL_HALF_FLOAT: {
-            cl_half *dPtr = (cl_half *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = cl_half_to_float(dPtr[i]);
-            break;
-        }
-
-        case CL_SIGNED_INT32: {
-            cl_int *dPtr = (cl_int *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
+// Channel converters of the formats with one element per channel
+float snorm_int8_to_float(cl_char v) { return CLAMP_FLOAT((float)v / 127.0f); }
+float unorm_int8_to_float(cl_uchar v) { return (float)v / 255.0f; }
+float srgb_int8_to_float(cl_uchar v)
+{
+    return (float)sRGBunmap((float)v / 255.0f);
+}
+float snorm_int16_to_float(cl_short v)
+{
+    return CLAMP_FLOAT((float)v / 32767.0f);
+}
+float unorm_int16_to_float(cl_ushort v) { return (float)v / 65535.0f; }
+float unorm_int10x6_to_float(cl_ushort v)
+{
+    return CLAMP_FLOAT((float)((v >> 6) & 0x3ff) / 1023.0f);
+}
+float unorm_int12x4_to_float(cl_ushort v)
+{
+    return CLAMP_FLOAT((float)((v >> 4) & 0xfff) / 4095.0f);
+}
+float unorm_int14x2_to_float(cl_ushort v)
+{
+    return CLAMP_FLOAT((float)((v >> 2) & 0x3fff) / 16383.0f);
+}
+#ifdef CL_SFIXED14_APPLE
+float sfixed14_to_float(cl_ushort v) { return ((int)v - 16384) * 0x1.0p-14f; }
+#endif
+template <typename T> float int_to_float(T v) { return (float)v; }
 
-        case CL_UNSIGNED_INT32: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
+template <typename T, float (*Convert)(T), int Channels>
+void decode_channels(const char *ptr, float *tempData)
+{
+    const T *dPtr = (const T *)ptr;
+    for (int i = 0; i < Channels; i++) tempData[i] = Convert(dPtr[i]);
+}
 
-        case CL_UNORM_SHORT_565: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            tempData[0] = (float)(dPtr[0] >> 11) / (float)31;
-            tempData[1] = (float)((dPtr[0] >> 5) & 63) / (float)63;
-            tempData[2] = (float)(dPtr[0] & 31) / (float)31;
-            break;
-        }
+// Only RGB are converted for the sRGB orders, not alpha
+template <int Channels>
+void decode_srgb_channels(const char *ptr, float *tempData)
+{
+    const cl_uchar *dPtr = (const cl_uchar *)ptr;
+    for (int i = 0; i < Channels; i++)
+        tempData[i] =
+            i < 3 ? srgb_int8_to_float(dPtr[i]) : unorm_int8_to_float(dPtr[i]);
+}
 
-        case CL_UNORM_SHORT_555: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 10) & 31) / (float)31;
-            tempData[1] = (float)((dPtr[0] >> 5) & 31) / (float)31;
-            tempData[2] = (float)(dPtr[0] & 31) / (float)31;
-            break;
-        }
+void decode_unorm_short_565(const char *ptr, float *tempData)
+{
+    const cl_ushort *dPtr = (const cl_ushort *)ptr;
+    tempData[0] = (float)(dPtr[0] >> 11) / (float)31;
+    tempData[1] = (float)((dPtr[0] >> 5) & 63) / (float)63;
+    tempData[2] = (float)(dPtr[0] & 31) / (float)31;
+}
 
-        case CL_UNORM_INT_101010: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 20) & 0x3ff) / (float)1023;
-            tempData[1] = (float)((dPtr[0] >> 10) & 0x3ff) / (float)1023;
-            tempData[2] = (float)(dPtr[0] & 0x3ff) / (float)1023;
-            break;
-        }
+void decode_unorm_short_555(const char *ptr, float *tempData)
+{
+    const cl_ushort *dPtr = (const cl_ushort *)ptr;
+    tempData[0] = (float)((dPtr[0] >> 10) & 31) / (float)31;
+    tempData[1] = (float)((dPtr[0] >> 5) & 31) / (float)31;
+    tempData[2] = (float)(dPtr[0] & 31) / (float)31;
+}
 
-        case CL_UNORM_INT_101010_2: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 22) & 0x3ff) / (float)1023;
-            tempData[1] = (float)((dPtr[0] >> 12) & 0x3ff) / (float)1023;
-            tempData[2] = (float)(dPtr[0] >> 2 & 0x3ff) / (float)1023;
-            tempData[3] = (float)(dPtr[0] >> 0 & 3) / (float)3;
-            break;
-        }
+void decode_unorm_int_101010(const char *ptr, float *tempData)
+{
+    const cl_uint *dPtr = (const cl_uint *)ptr;
+    tempData[0] = (float)((dPtr[0] >> 20) & 0x3ff) / (float)1023;
+    tempData[1] = (float)((dPtr[0] >> 10) & 0x3ff) / (float)1023;
+    tempData[2] = (float)(dPtr[0] & 0x3ff) / (float)1023;
+}
 
-        case CL_UNORM_INT_2_101010_EXT: {
-            cl_uint *dPtr = (cl_uint *)ptr;
-            tempData[0] = (float)((dPtr[0] >> 30) & 0x3) / (float)3;
-            tempData[1] = (float)((dPtr[0] >> 20) & 0x3ff) / (float)1023;
-            tempData[2] = (float)(dPtr[0] >> 10 & 0x3ff) / (float)1023;
-            tempData[3] = (float)(dPtr[0] >> 0 & 0x3ff) / (float)1023;
-            break;
-        }
+void decode_unorm_int_101010_2(const char *ptr, float *tempData)
+{
+    const cl_uint *dPtr = (const cl_uint *)ptr;
+    tempData[0] = (float)((dPtr[0] >> 22) & 0x3ff) / (float)1023;
+    tempData[1] = (float)((dPtr[0] >> 12) & 0x3ff) / (float)1023;
+    tempData[2] = (float)(dPtr[0] >> 2 & 0x3ff) / (float)1023;
+    tempData[3] = (float)(dPtr[0] >> 0 & 3) / (float)3;
+}
 
-        case CL_UNORM_INT10X6_EXT: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] =
-                    CLAMP_FLOAT((float)((dPtr[i] >> 6) & 0x3ff) / 1023.0f);
-            break;
-        }
+void decode_unorm_int_2_101010(const char *ptr, float *tempData)
+{
+    const cl_uint *dPtr = (const cl_uint *)ptr;
+    tempData[0] = (float)((dPtr[0] >> 30) & 0x3) / (float)3;
+    tempData[1] = (float)((dPtr[0] >> 20) & 0x3ff) / (float)1023;
+    tempData[2] = (float)(dPtr[0] >> 10 & 0x3ff) / (float)1023;
+    tempData[3] = (float)(dPtr[0] >> 0 & 0x3ff) / (float)1023;
+}
 
-        case CL_UNORM_INT12X4_EXT: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] =
-                    CLAMP_FLOAT((float)((dPtr[i] >> 4) & 0xfff) / 4095.0f);
-            break;
-        }
+// OpenCL only supports reading floats from certain formats, the others
+// read as zeroes.
+void decode_nothing(const char *ptr, float *tempData) {}
 
-        case CL_UNORM_INT14X2_EXT: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] =
-                    CLAMP_FLOAT((float)((dPtr[i] >> 2) & 0x3fff) / 16383.0f);
-            break;
-        }
+template <typename T, float (*Convert)(T)>
+TexelDecodeFn get_channels_decoder(size_t channelCount)
+{
+    switch (channelCount)
+    {
+        case 1: return decode_channels<T, Convert, 1>;
+        case 2: return decode_channels<T, Convert, 2>;
+        case 3: return decode_channels<T, Convert, 3>;
+        case 4: return decode_channels<T, Convert, 4>;
+        default: return decode_nothing;
+    }
+}
 
-        case CL_FLOAT: {
-            float *dPtr = (float *)ptr;
-            for (i = 0; i < channelCount; i++) tempData[i] = (float)dPtr[i];
-            break;
-        }
+TexelDecodeFn get_texel_decoder(const cl_image_format *format)
+{
+    size_t channelCount = get_format_channel_count(format);
+    switch (format->image_channel_data_type)
+    {
+        case CL_SNORM_INT8:
+            return get_channels_decoder<cl_char, snorm_int8_to_float>(
+                channelCount);
+        case CL_UNORM_INT8:
+            if (is_sRGBA_order(format->image_channel_order))
+            {
+                switch (channelCount)
+                {
+                    case 3: return decode_srgb_channels<3>;
+                    case 4: return decode_srgb_channels<4>;
+                }
+            }
+            return get_channels_decoder<cl_uchar, unorm_int8_to_float>(
+                channelCount);
+        case CL_SIGNED_INT8:
+            return get_channels_decoder<cl_char, int_to_float<cl_char>>(
+                channelCount);
+        case CL_UNSIGNED_INT8:
+            return get_channels_decoder<cl_uchar, int_to_float<cl_uchar>>(
+                channelCount);
+        case CL_SNORM_INT16:
+            return get_channels_decoder<cl_short, snorm_int16_to_float>(
+                channelCount);
+        case CL_UNORM_INT16:
+            return get_channels_decoder<cl_ushort, unorm_int16_to_float>(
+                channelCount);
+        case CL_SIGNED_INT16:
+            return get_channels_decoder<cl_short, int_to_float<cl_short>>(
+                channelCount);
+        case CL_UNSIGNED_INT16:
+            return get_channels_decoder<cl_ushort, int_to_float<cl_ushort>>(
+                channelCount);
+        case CL_HALF_FLOAT:
+            return get_channels_decoder<cl_half, cl_half_to_float>(
+                channelCount);
+        case CL_SIGNED_INT32:
+            return get_channels_decoder<cl_int, int_to_float<cl_int>>(
+                channelCount);
+        case CL_UNSIGNED_INT32:
+            return get_channels_decoder<cl_uint, int_to_float<cl_uint>>(
+                channelCount);
+        case CL_UNORM_SHORT_565: return decode_unorm_short_565;
+        case CL_UNORM_SHORT_555: return decode_unorm_short_555;
+        case CL_UNORM_INT_101010: return decode_unorm_int_101010;
+        case CL_UNORM_INT_101010_2: return decode_unorm_int_101010_2;
+        case CL_UNORM_INT_2_101010_EXT: return decode_unorm_int_2_101010;
+        case CL_UNORM_INT10X6_EXT:
+            return get_channels_decoder<cl_ushort, unorm_int10x6_to_float>(
+                channelCount);
+        case CL_UNORM_INT12X4_EXT:
+            return get_channels_decoder<cl_ushort, unorm_int12x4_to_float>(
+                channelCount);
+        case CL_UNORM_INT14X2_EXT:
+            return get_channels_decoder<cl_ushort, unorm_int14x2_to_float>(
+                channelCount);
+        case CL_FLOAT:
+            return get_channels_decoder<float, int_to_float<float>>(
+                channelCount);
 #ifdef CL_SFIXED14_APPLE
-        case CL_SFIXED14_APPLE: {
-            cl_ushort *dPtr = (cl_ushort *)ptr;
-            for (i = 0; i < channelCount; i++)
-                tempData[i] = ((int)dPtr[i] - 16384) * 0x1.0p-14f;
-            break;
-        }
+        case CL_SFIXED14_APPLE:
+            return get_channels_decoder<cl_ushort, sfixed14_to_float>(
+                channelCount);
 #endif
+        default: return decode_nothing;
     }
+}
 
+// Indices in the decoded channels of TexelReader::read of the constants 0 and
+// 1.
+const int kZero = 4;
+const int kOne = 5;
 
-    outData[0] = outData[1] = outData[2] = 0;
-    outData[3] = 1;
+void set_texel_swizzle(int *swizzle, int r, int g, int b, int a)
+{
+    swizzle[0] = r;
+    swizzle[1] = g;
+    swizzle[2] = b;
+    swizzle[3] = a;
+}
 
-    switch (format->image_channel_order)
+// Where the red, green, blue and alpha components of a texel come from for
+// an order.  Returns false if the order is invalid.
+bool get_texel_swizzle(cl_channel_order order, int *swizzle)
+{
+    switch (order)
     {
-        case CL_A: outData[3] = tempData[0]; break;
+        case CL_A: set_texel_swizzle(swizzle, kZero, kZero, kZero, 0); break;
         case CL_R:
-        case CL_Rx: outData[0] = tempData[0]; break;
-        case CL_RA:
-            outData[0] = tempData[0];
-            outData[3] = tempData[1];
-            break;
+        case CL_Rx:
+        case CL_DEPTH: set_texel_swizzle(swizzle, 0, kZero, kZero, kOne); break;
+        case CL_RA: set_texel_swizzle(swizzle, 0, kZero, kZero, 1); break;
         case CL_RG:
-        case CL_RGx:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            break;
+        case CL_RGx: set_texel_swizzle(swizzle, 0, 1, kZero, kOne); break;
         case CL_RGB:
         case CL_RGBx:
         case CL_sRGB:
-        case CL_sRGBx:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            outData[2] = tempData[2];
-            break;
+        case CL_sRGBx: set_texel_swizzle(swizzle, 0, 1, 2, kOne); break;
         case CL_RGBA:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            outData[2] = tempData[2];
-            outData[3] = tempData[3];
-            break;
-        case CL_ARGB:
-            outData[0] = tempData[1];
-            outData[1] = tempData[2];
-            outData[2] = tempData[3];
-            outData[3] = tempData[0];
-            break;
-        case CL_ABGR:
-            outData[0] = tempData[3];
-            outData[1] = tempData[2];
-            outData[2] = tempData[1];
-            outData[3] = tempData[0];
-            break;
+        case CL_sRGBA: set_texel_swizzle(swizzle, 0, 1, 2, 3); break;
+        case CL_ARGB: set_texel_swizzle(swizzle, 1, 2, 3, 0); break;
+        case CL_ABGR: set_texel_swizzle(swizzle, 3, 2, 1, 0); break;
         case CL_BGRA:
-        case CL_sBGRA:
-            outData[0] = tempData[2];
-            outData[1] = tempData[1];
-            outData[2] = tempData[0];
-            outData[3] = tempData[3];
-            break;
-        case CL_INTENSITY:
-            outData[0] = tempData[0];
-            outData[1] = tempData[0];
-            outData[2] = tempData[0];
-            outData[3] = tempData[0];
-            break;
-        case CL_LUMINANCE:
-            outData[0] = tempData[0];
-            outData[1] = tempData[0];
-            outData[2] = tempData[0];
-            break;
+        case CL_sBGRA: set_texel_swizzle(swizzle, 2, 1, 0, 3); break;
+        case CL_INTENSITY: set_texel_swizzle(swizzle, 0, 0, 0, 0); break;
+        case CL_LUMINANCE: set_texel_swizzle(swizzle, 0, 0, 0, kOne); break;
 #ifdef CL_1RGB_APPLE
-        case CL_1RGB_APPLE:
-            outData[0] = tempData[1];
-            outData[1] = tempData[2];
-            outData[2] = tempData[3];
-            outData[3] = 1.0f;
-            break;
+        case CL_1RGB_APPLE: set_texel_swizzle(swizzle, 1, 2, 3, kOne); break;
 #endif
 #ifdef CL_BGR1_APPLE
-        case CL_BGR1_APPLE:
-            outData[0] = tempData[2];
-            outData[1] = tempData[1];
-            outData[2] = tempData[0];
-            outData[3] = 1.0f;
-            break;
+        case CL_BGR1_APPLE: set_texel_swizzle(swizzle, 2, 1, 0, kOne); break;
 #endif
-        case CL_sRGBA:
-            outData[0] = tempData[0];
-            outData[1] = tempData[1];
-            outData[2] = tempData[2];
-            outData[3] = tempData[3];
-            break;
-        case CL_DEPTH: outData[0] = tempData[0]; break;
         default:
-            log_error("Invalid format:");
-            print_header(format, true);
-            break;
+            set_texel_swizzle(swizzle, kZero, kZero, kZero, kOne);
+            return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TexelReader::TexelReader(const image_descriptor *imageInfo, int lod)
+    : width(imageInfo->width), height(imageInfo->height),
+      depth(imageInfo->depth), arraySize(imageInfo->arraySize),
+      pixelSize(get_pixel_size(imageInfo->format)),
+      borderAlpha(has_alpha(imageInfo->format) ? 0.0f : 1.0f),
+      decode(get_texel_decoder(imageInfo->format))
+{
+    if (imageInfo->num_mip_levels > 1)
+    {
+        image_mip_level level = get_image_mip_level(imageInfo, lod);
+        width = level.width;
+        height = level.height;
+        depth = level.depth;
+        rowPitch = level.rowPitch;
+        slicePitch = level.slicePitch;
+    }
+    else
+    {
+        rowPitch = imageInfo->rowPitch;
+        slicePitch = imageInfo->slicePitch;
+    }
+
+    if (!get_texel_swizzle(imageInfo->format->image_channel_order, swizzle))
+    {
+        log_error("Invalid format:");
+        print_header(imageInfo->format, true);
     }
 }
 
+void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
+                            int y, int z, float *outData, int lod)
+{
+    TexelReader(imageInfo, lod).read(imageData, x, y, z, outData);
+}
+
 void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
                             int y, int z, float *outData)
 {
@@ -2087,45 +2155,22 @@ FloatPixel sample_image_pixel_float(void *imageData,
                                            0.0f, 0.0f, imageSampler, outData,
                                            verbose, containsDenorms, lod);
 }
-FloatPixel sample_image_pixel_float_offset(
-    void *imageData, image_descriptor *imageInfo, float x, float y, float z,
-    float xAddressOffset, float yAddressOffset, float zAddressOffset,
-    image_sampler_data *imageSampler, float *outData, int verbose,
-    int *containsDenorms, int lod)
+TexelSampler::TexelSampler(const image_descriptor *imageInfo,
+                           const image_sampler_data *imageSampler, int lod)
+    : imageInfo(imageInfo), imageSampler(imageSampler),
+      adFn(sAddressingTable[imageSampler]), reader(imageInfo, lod)
+{}
+
+FloatPixel TexelSampler::sample(const void *imageData, float x, float y,
+                                float z, float xAddressOffset,
+                                float yAddressOffset, float zAddressOffset,
+                                float *outData, int verbose,
+                                int *containsDenorms) const
 {
-    AddressFn adFn = sAddressingTable[imageSampler];
     FloatPixel returnVal;
-    size_t width_lod = imageInfo->width, height_lod = imageInfo->height,
-           depth_lod = imageInfo->depth;
-    size_t slice_pitch_lod = 0, row_pitch_lod = 0;
-
-    if (imageInfo->num_mip_levels > 1)
-    {
-        switch (imageInfo->type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                depth_lod =
-                    (imageInfo->depth >> lod) ? (imageInfo->depth >> lod) : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                height_lod =
-                    (imageInfo->height >> lod) ? (imageInfo->height >> lod) : 1;
-            default:
-                width_lod =
-                    (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
-        }
-        row_pitch_lod = width_lod * get_pixel_size(imageInfo->format);
-        if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
-            slice_pitch_lod = row_pitch_lod;
-        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D
-                 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
-            slice_pitch_lod = row_pitch_lod * height_lod;
-    }
-    else
-    {
-        slice_pitch_lod = imageInfo->slicePitch;
-        row_pitch_lod = imageInfo->rowPitch;
-    }
+    size_t width_lod = reader.width, height_lod = reader.height,
+           depth_lod = reader.depth;
+    size_t slice_pitch_lod = reader.slicePitch;
 
     if (containsDenorms) *containsDenorms = 0;
 
@@ -2239,7 +2284,7 @@ FloatPixel sample_image_pixel_float_offset(
                          ix, iy);
         }
 
-        read_image_pixel_float(imageData, imageInfo, ix, iy, iz, outData, lod);
+        reader.read(imageData, ix, iy, iz, outData);
         check_for_denorms(outData, containsDenorms);
         for (int i = 0; i < 4; i++) returnVal.p[i] = fabsf(outData[i]);
         return returnVal;
@@ -2302,17 +2347,17 @@ FloatPixel sample_image_pixel_float_offset(
             }
 
             // Walk to beginning of the 'correct' slice, if needed.
-            char *imgPtr = ((char *)imageData) + layer_offset;
+            const char *imgPtr = ((const char *)imageData) + layer_offset;
 
             float upLeft[4], upRight[4], lowLeft[4], lowRight[4];
             float maxUp[4], maxLow[4];
-            read_image_pixel_float(imgPtr, imageInfo, x1, y1, 0, upLeft, lod);
-            read_image_pixel_float(imgPtr, imageInfo, x2, y1, 0, upRight, lod);
+            reader.read(imgPtr, x1, y1, 0, upLeft);
+            reader.read(imgPtr, x2, y1, 0, upRight);
             check_for_denorms(upLeft, containsDenorms);
             check_for_denorms(upRight, containsDenorms);
             pixelMax(upLeft, upRight, maxUp);
-            read_image_pixel_float(imgPtr, imageInfo, x1, y2, 0, lowLeft, lod);
-            read_image_pixel_float(imgPtr, imageInfo, x2, y2, 0, lowRight, lod);
+            reader.read(imgPtr, x1, y2, 0, lowLeft);
+            reader.read(imgPtr, x2, y2, 0, lowRight);
             check_for_denorms(lowLeft, containsDenorms);
             check_for_denorms(lowRight, containsDenorms);
             pixelMax(lowLeft, lowRight, maxLow);
@@ -2384,32 +2429,24 @@ FloatPixel sample_image_pixel_float_offset(
             float upLeftA[4], upRightA[4], lowLeftA[4], lowRightA[4];
             float upLeftB[4], upRightB[4], lowLeftB[4], lowRightB[4];
             float pixelMaxA[4], pixelMaxB[4];
-            read_image_pixel_float(imageData, imageInfo, x1, y1, z1, upLeftA,
-                                   lod);
-            read_image_pixel_float(imageData, imageInfo, x2, y1, z1, upRightA,
-                                   lod);
+            reader.read(imageData, x1, y1, z1, upLeftA);
+            reader.read(imageData, x2, y1, z1, upRightA);
             check_for_denorms(upLeftA, containsDenorms);
             check_for_denorms(upRightA, containsDenorms);
             pixelMax(upLeftA, upRightA, pixelMaxA);
-            read_image_pixel_float(imageData, imageInfo, x1, y2, z1, lowLeftA,
-                                   lod);
-            read_image_pixel_float(imageData, imageInfo, x2, y2, z1, lowRightA,
-                                   lod);
+            reader.read(imageData, x1, y2, z1, lowLeftA);
+            reader.read(imageData, x2, y2, z1, lowRightA);
             check_for_denorms(lowLeftA, containsDenorms);
             check_for_denorms(lowRightA, containsDenorms);
             pixelMax(lowLeftA, lowRightA, pixelMaxB);
             pixelMax(pixelMaxA, pixelMaxB, returnVal.p);
-            read_image_pixel_float(imageData, imageInfo, x1, y1, z2, upLeftB,
-                                   lod);
-            read_image_pixel_float(imageData, imageInfo, x2, y1, z2, upRightB,
-                                   lod);
+            reader.read(imageData, x1, y1, z2, upLeftB);
+            reader.read(imageData, x2, y1, z2, upRightB);
             check_for_denorms(upLeftB, containsDenorms);
             check_for_denorms(upRightB, containsDenorms);
             pixelMax(upLeftB, upRightB, pixelMaxA);
-            read_image_pixel_float(imageData, imageInfo, x1, y2, z2, lowLeftB,
-                                   lod);
-            read_image_pixel_float(imageData, imageInfo, x2, y2, z2, lowRightB,
-                                   lod);
+            reader.read(imageData, x1, y2, z2, lowLeftB);
+            reader.read(imageData, x2, y2, z2, lowRightB);
             check_for_denorms(lowLeftB, containsDenorms);
             check_for_denorms(lowRightB, containsDenorms);
             pixelMax(lowLeftB, lowRightB, pixelMaxB);
@@ -2501,6 +2538,17 @@ FloatPixel sample_image_pixel_float_offset(
     }
 }
 
+FloatPixel sample_image_pixel_float_offset(
+    void *imageData, image_descriptor *imageInfo, float x, float y, float z,
+    float xAddressOffset, float yAddressOffset, float zAddressOffset,
+    image_sampler_data *imageSampler, float *outData, int verbose,
+    int *containsDenorms, int lod)
+{
+    return TexelSampler(imageInfo, imageSampler, lod)
+        .sample(imageData, x, y, z, xAddressOffset, yAddressOffset,
+                zAddressOffset, outData, verbose, containsDenorms);
+}
+
 FloatPixel sample_image_pixel_float_offset(
     void *imageData, image_descriptor *imageInfo, float x, float y, float z,
     float xAddressOffset, float yAddressOffset, float zAddressOffset,
@@ -3325,11 +3373,14 @@ void pack_image_pixel_error(const float *srcVector,
 //
 //  Autodetect which rounding mode is used for image writes to CL_HALF_FLOAT
 //  This should be called lazily before attempting to verify image writes,
-//  otherwise an error will occur.
+//  otherwise an error will occur.  Tests running concurrently wait for the
+//  first one to detect it.
 //
 int DetectFloatToHalfRoundingMode(
     cl_command_queue q) // Returns CL_SUCCESS on success
 {
+    static std::mutex detectMutex;
+    std::lock_guard<std::mutex> lock(detectMutex);
     cl_int err = CL_SUCCESS;
 
     if (gFloatToHalfRoundingMode == kDefaultRoundingMode)
@@ -3880,43 +3931,24 @@ void copy_image_data(image_descriptor *srcImageInfo,
 
     if (srcImageInfo->num_mip_levels > 1)
     {
-        size_t src_width_lod = 1 /*srcImageInfo->width*/;
-        size_t src_height_lod = 1 /*srcImageInfo->height*/;
-
         switch (srcImageInfo->type)
         {
             case CL_MEM_OBJECT_IMAGE1D_BUFFER:
             case CL_MEM_OBJECT_IMAGE1D:
                 src_lod = sourcePos[1];
                 sourcePos_lod[1] = sourcePos_lod[2] = 0;
-                src_width_lod = (srcImageInfo->width >> src_lod)
-                    ? (srcImageInfo->width >> src_lod)
-                    : 1;
                 break;
             case CL_MEM_OBJECT_IMAGE1D_ARRAY:
             case CL_MEM_OBJECT_IMAGE2D:
                 src_lod = sourcePos[2];
                 sourcePos_lod[1] = sourcePos[1];
                 sourcePos_lod[2] = 0;
-                src_width_lod = (srcImageInfo->width >> src_lod)
-                    ? (srcImageInfo->width >> src_lod)
-                    : 1;
-                if (srcImageInfo->type == CL_MEM_OBJECT_IMAGE2D)
-                    src_height_lod = (srcImageInfo->height >> src_lod)
-                        ? (srcImageInfo->height >> src_lod)
-                        : 1;
                 break;
             case CL_MEM_OBJECT_IMAGE2D_ARRAY:
             case CL_MEM_OBJECT_IMAGE3D:
                 src_lod = sourcePos[3];
                 sourcePos_lod[1] = sourcePos[1];
                 sourcePos_lod[2] = sourcePos[2];
-                src_width_lod = (srcImageInfo->width >> src_lod)
-                    ? (srcImageInfo->width >> src_lod)
-                    : 1;
-                src_height_lod = (srcImageInfo->height >> src_lod)
-                    ? (srcImageInfo->height >> src_lod)
-                    : 1;
                 break;
             default:
                 log_error("ERROR: Invalid srcImageInfo->type = %d\n",
@@ -3924,50 +3956,32 @@ void copy_image_data(image_descriptor *srcImageInfo,
                 src_lod = 0;
                 break;
         }
-        src_mip_level_offset = compute_mip_level_offset(srcImageInfo, src_lod);
-        src_row_pitch_lod =
-            src_width_lod * get_pixel_size(srcImageInfo->format);
-        src_slice_pitch_lod = src_row_pitch_lod * src_height_lod;
+        image_mip_level level = get_image_mip_level(srcImageInfo, src_lod);
+        src_mip_level_offset = level.offset;
+        src_row_pitch_lod = level.rowPitch;
+        src_slice_pitch_lod = level.slicePitch;
     }
 
     if (dstImageInfo->num_mip_levels > 1)
     {
-        size_t dst_width_lod = 1 /*dstImageInfo->width*/;
-        size_t dst_height_lod = 1 /*dstImageInfo->height*/;
         switch (dstImageInfo->type)
         {
             case CL_MEM_OBJECT_IMAGE1D_BUFFER:
             case CL_MEM_OBJECT_IMAGE1D:
                 dst_lod = destPos[1];
                 destPos_lod[1] = destPos_lod[2] = 0;
-                dst_width_lod = (dstImageInfo->width >> dst_lod)
-                    ? (dstImageInfo->width >> dst_lod)
-                    : 1;
                 break;
             case CL_MEM_OBJECT_IMAGE1D_ARRAY:
             case CL_MEM_OBJECT_IMAGE2D:
                 dst_lod = destPos[2];
                 destPos_lod[1] = destPos[1];
                 destPos_lod[2] = 0;
-                dst_width_lod = (dstImageInfo->width >> dst_lod)
-                    ? (dstImageInfo->width >> dst_lod)
-                    : 1;
-                if (dstImageInfo->type == CL_MEM_OBJECT_IMAGE2D)
-                    dst_height_lod = (dstImageInfo->height >> dst_lod)
-                        ? (dstImageInfo->height >> dst_lod)
-                        : 1;
                 break;
             case CL_MEM_OBJECT_IMAGE2D_ARRAY:
             case CL_MEM_OBJECT_IMAGE3D:
                 dst_lod = destPos[3];
                 destPos_lod[1] = destPos[1];
                 destPos_lod[2] = destPos[2];
-                dst_width_lod = (dstImageInfo->width >> dst_lod)
-                    ? (dstImageInfo->width >> dst_lod)
-                    : 1;
-                dst_height_lod = (dstImageInfo->height >> dst_lod)
-                    ? (dstImageInfo->height >> dst_lod)
-                    : 1;
                 break;
             default:
                 log_error("ERROR: Invalid dstImageInfo->num_mip_levels = %d\n",
@@ -3975,10 +3989,10 @@ void copy_image_data(image_descriptor *srcImageInfo,
                 dst_lod = 0;
                 break;
         }
-        dst_mip_level_offset = compute_mip_level_offset(dstImageInfo, dst_lod);
-        dst_row_pitch_lod =
-            dst_width_lod * get_pixel_size(dstImageInfo->format);
-        dst_slice_pitch_lod = dst_row_pitch_lod * dst_height_lod;
+        image_mip_level level = get_image_mip_level(dstImageInfo, dst_lod);
+        dst_mip_level_offset = level.offset;
+        dst_row_pitch_lod = level.rowPitch;
+        dst_slice_pitch_lod = level.slicePitch;
     }
 
     // Get initial pointers
@@ -4385,106 +4399,168 @@ cl_uint compute_max_mip_levels(size_t width, size_t height, size_t depth)
     return retMaxMipLevels;
 }
 
-cl_ulong compute_mipmapped_image_size(image_descriptor imageInfo)
+namespace {
+
+constexpr cl_uint kMipLayoutLevels = 32;
+
+// Layout of the mip chain of an image, with the fields of the image it was
+// built from.  levelCount is 0 until it is built.
+struct image_mip_layout
 {
-    cl_ulong retSize = 0;
-    size_t curr_width, curr_height, curr_depth, curr_array_size;
-    curr_width = imageInfo.width;
-    curr_height = imageInfo.height;
-    curr_depth = imageInfo.depth;
-    curr_array_size = imageInfo.arraySize;
-
-    for (int i = 0; i < (int)imageInfo.num_mip_levels; i++)
-    {
-        switch (imageInfo.type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                retSize += (cl_ulong)curr_width * curr_height * curr_depth
-                    * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retSize += (cl_ulong)curr_width * curr_height
-                    * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D:
-                retSize +=
-                    (cl_ulong)curr_width * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retSize += (cl_ulong)curr_width * curr_array_size
-                    * get_pixel_size(imageInfo.format);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retSize += (cl_ulong)curr_width * curr_height * curr_array_size
-                    * get_pixel_size(imageInfo.format);
-                break;
-        }
+    size_t width;
+    size_t height;
+    size_t depth;
+    size_t arraySize;
+    size_t pixelSize;
+    cl_mem_object_type type;
+    cl_uint num_mip_levels;
+    cl_uint levelCount;
+    cl_ulong size;
+    image_mip_level levels[kMipLayoutLevels];
+};
 
-        switch (imageInfo.type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                curr_depth = curr_depth >> 1 ? curr_depth >> 1 : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                curr_height = curr_height >> 1 ? curr_height >> 1 : 1;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D:
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                curr_width = curr_width >> 1 ? curr_width >> 1 : 1;
-        }
+// Bytes of mip level level of an image of the given type.
+cl_ulong mip_level_size(cl_mem_object_type type, size_t arraySize,
+                        size_t pixelSize, const image_mip_level &level)
+{
+    switch (type)
+    {
+        case CL_MEM_OBJECT_IMAGE3D:
+            return (cl_ulong)level.width * level.height * level.depth
+                * pixelSize;
+        case CL_MEM_OBJECT_IMAGE2D:
+            return (cl_ulong)level.width * level.height * pixelSize;
+        case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+        case CL_MEM_OBJECT_IMAGE1D:
+            return (cl_ulong)level.width * pixelSize;
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            return (cl_ulong)level.width * arraySize * pixelSize;
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            return (cl_ulong)level.width * level.height * arraySize
+                * pixelSize;
     }
+    return 0;
+}
+
+// Set the pitches of level from its dimensions.
+void set_mip_level_pitches(cl_mem_object_type type, size_t pixelSize,
+                           image_mip_level &level)
+{
+    level.rowPitch = level.width * pixelSize;
+    level.slicePitch = 0;
+    if (type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+        level.slicePitch = level.rowPitch;
+    else if (type == CL_MEM_OBJECT_IMAGE3D
+             || type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+        level.slicePitch = level.rowPitch * level.height;
+}
 
-    return retSize;
+// Layout of the mip level following level.
+image_mip_level next_mip_level(const image_mip_layout &layout,
+                               const image_mip_level &level)
+{
+    image_mip_level next = level;
+    next.offset += (size_t)mip_level_size(layout.type, layout.arraySize,
+                                          layout.pixelSize, level);
+    switch (layout.type)
+    {
+        case CL_MEM_OBJECT_IMAGE3D:
+            next.depth = (next.depth >> 1) ? (next.depth >> 1) : 1;
+        case CL_MEM_OBJECT_IMAGE2D:
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            next.height = (next.height >> 1) ? (next.height >> 1) : 1;
+        case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+        case CL_MEM_OBJECT_IMAGE1D:
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            next.width = (next.width >> 1) ? (next.width >> 1) : 1;
+    }
+    set_mip_level_pitches(layout.type, layout.pixelSize, next);
+    return next;
 }
 
-size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod)
+// Mip chain layout of imageInfo.  The layouts of the images last used by
+// each thread are cached, keyed by the fields of the image they depend on, so
+// that image descriptors can be copied and shared between threads freely.
+// The layout returned stays valid until the thread's next lookups.
+const image_mip_layout &get_image_mip_layout(const image_descriptor *imageInfo)
 {
-    size_t retOffset = 0;
-    size_t width, height, depth;
-    width = imageInfo->width;
-    height = imageInfo->height;
-    depth = imageInfo->depth;
+    constexpr size_t kCachedLayouts = 4;
+    thread_local image_mip_layout layouts[kCachedLayouts];
+    thread_local size_t nextLayout = 0;
 
-    for (size_t i = 0; i < lod; i++)
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+    for (const image_mip_layout &layout : layouts)
     {
-        switch (imageInfo->type)
+        if (layout.levelCount != 0 && layout.width == imageInfo->width
+            && layout.height == imageInfo->height
+            && layout.depth == imageInfo->depth
+            && layout.arraySize == imageInfo->arraySize
+            && layout.pixelSize == pixelSize && layout.type == imageInfo->type
+            && layout.num_mip_levels == imageInfo->num_mip_levels)
         {
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retOffset += (size_t)width * height * imageInfo->arraySize
-                    * get_pixel_size(imageInfo->format);
-                break;
-            case CL_MEM_OBJECT_IMAGE3D:
-                retOffset += (size_t)width * height * depth
-                    * get_pixel_size(imageInfo->format);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retOffset += (size_t)width * imageInfo->arraySize
-                    * get_pixel_size(imageInfo->format);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retOffset +=
-                    (size_t)width * height * get_pixel_size(imageInfo->format);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D:
-                retOffset += (size_t)width * get_pixel_size(imageInfo->format);
-                break;
+            return layout;
         }
+    }
 
-        // Compute next lod dimensions
-        switch (imageInfo->type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D: depth = (depth >> 1) ? (depth >> 1) : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                height = (height >> 1) ? (height >> 1) : 1;
-            case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-            case CL_MEM_OBJECT_IMAGE1D: width = (width >> 1) ? (width >> 1) : 1;
-        }
+    image_mip_layout &layout = layouts[nextLayout];
+    nextLayout = (nextLayout + 1) % kCachedLayouts;
+    layout.width = imageInfo->width;
+    layout.height = imageInfo->height;
+    layout.depth = imageInfo->depth;
+    layout.arraySize = imageInfo->arraySize;
+    layout.pixelSize = pixelSize;
+    layout.type = imageInfo->type;
+    layout.num_mip_levels = imageInfo->num_mip_levels;
+
+    // Level 0 is kept for images without mip levels, so that there is always
+    // a level to look up.
+    image_mip_level level;
+    level.width = imageInfo->width;
+    level.height = imageInfo->height;
+    level.depth = imageInfo->depth;
+    level.offset = 0;
+    set_mip_level_pitches(layout.type, pixelSize, level);
+
+    cl_uint levelCount = imageInfo->num_mip_levels > 1
+        ? imageInfo->num_mip_levels
+        : 1;
+    layout.levelCount =
+        levelCount < kMipLayoutLevels ? levelCount : kMipLayoutLevels;
+    layout.size = 0;
+    for (cl_uint i = 0; i < levelCount; i++)
+    {
+        if (i < layout.levelCount) layout.levels[i] = level;
+        if (i < imageInfo->num_mip_levels)
+            layout.size += mip_level_size(layout.type, layout.arraySize,
+                                          pixelSize, level);
+        level = next_mip_level(layout, level);
     }
-    return retOffset;
+    return layout;
+}
+
+} // anonymous namespace
+
+image_mip_level get_image_mip_level(const image_descriptor *imageInfo,
+                                    size_t lod)
+{
+    const image_mip_layout &layout = get_image_mip_layout(imageInfo);
+    if (lod < layout.levelCount) return layout.levels[lod];
+
+    // Levels past the end of the table are stepped to from its last level.
+    image_mip_level level = layout.levels[layout.levelCount - 1];
+    for (size_t i = layout.levelCount - 1; i < lod; i++)
+        level = next_mip_level(layout, level);
+    return level;
+}
+
+cl_ulong compute_mipmapped_image_size(const image_descriptor &imageInfo)
+{
+    return get_image_mip_layout(&imageInfo).size;
+}
+
+size_t compute_mip_level_offset(const image_descriptor *imageInfo, size_t lod)
+{
+    return get_image_mip_level(imageInfo, lod).offset;
 }
 
 const char *convert_image_type_to_string(cl_mem_object_type image_type)
@@ -115,6 +115,20 @@ extern int get_32_bit_image_format(cl_context context,
 int random_in_range(int minV, int maxV, MTdata d);
 int random_log_in_range(int minV, int maxV, MTdata d);
 
+// Layout of a mip level of an image.  The dimensions the image type does not
+// mip keep the values of the image.  The pitches are those of a tightly packed
+// level, and offset is the byte offset of the level in the host copy of the
+// mip chain.
+typedef struct
+{
+    size_t width;
+    size_t height;
+    size_t depth;
+    size_t rowPitch;
+    size_t slicePitch;
+    size_t offset;
+} image_mip_level;
+
 typedef struct
 {
     size_t width;
@@ -143,6 +157,31 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
 size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
                          const char *bPtr);
 
+// Scanline comparator of a format.  The significant bits of the pixels are
+// resolved once into a mask repeating every SCANLINE_MASK_PIXELS pixels, so
+// that whole scanlines are compared with wide AND/XOR passes and pixels are
+// only looked at one by one in a block that differs.  compare() returns the
+// same column as compare_scanlines.
+#define SCANLINE_MASK_PIXELS 16
+
+class ScanlineComparator {
+public:
+    explicit ScanlineComparator(const cl_image_format *format);
+
+    // Column of the first pixel that differs in the width pixels of aPtr and
+    // bPtr, or width if they all match.
+    size_t compare(const char *aPtr, const char *bPtr, size_t width) const;
+
+private:
+    bool pixels_match(const char *aPtr, const char *bPtr) const;
+
+    cl_channel_type dataType;
+    size_t channelCount;
+    size_t pixelSize;
+    size_t maskSize;
+    unsigned char mask[SCANLINE_MASK_PIXELS * 16];
+};
+
 void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
                    size_t sizes[][3], size_t maxWidth, size_t maxHeight,
                    size_t maxDepth, size_t maxArraySize,
@@ -158,6 +197,10 @@ extern cl_ulong get_image_size_mb(image_descriptor const *imageInfo);
 extern char *generate_random_image_data(image_descriptor *imageInfo,
                                         BufferOwningPtr<char> &Owner, MTdata d);
 
+// Replace the float and half values of data that are infinite, NaN or
+// subnormal, as generate_random_image_data does with its random bits.
+extern void escape_inf_nan_subnormal_values(char *data, size_t allocSize);
+
 extern int debug_find_vector_in_image(void *imagePtr,
                                       image_descriptor *imageInfo,
                                       void *vectorToFind, size_t vectorSize,
@@ -189,15 +232,20 @@ extern bool is_sRGBA_order(cl_channel_order image_channel_order);
 inline float calculate_array_index(float coord, float extent);
 
 cl_uint compute_max_mip_levels(size_t width, size_t height, size_t depth);
-cl_ulong compute_mipmapped_image_size(image_descriptor imageInfo);
-size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod);
+cl_ulong compute_mipmapped_image_size(const image_descriptor &imageInfo);
+size_t compute_mip_level_offset(const image_descriptor *imageInfo, size_t lod);
+
+// Layout of mip level lod of imageInfo, looked up in a per-thread cache of the
+// mip chain layouts of the images last used.
+image_mip_level get_image_mip_level(const image_descriptor *imageInfo,
+                                    size_t lod);
 
 constexpr size_t RAW10_EXT_CLUMP_SIZE = 5;
 constexpr size_t RAW10_EXT_CLUMP_NUM_PIXELS = 4;
 constexpr size_t RAW12_EXT_CLUMP_SIZE = 3;
 constexpr size_t RAW12_EXT_CLUMP_NUM_PIXELS = 2;
 
-inline bool is_width_compatible(image_descriptor imageInfo)
+inline bool is_width_compatible(const image_descriptor &imageInfo)
 {
     if (imageInfo.format->image_channel_data_type == CL_UNSIGNED_INT_RAW10_EXT
         && (imageInfo.width % RAW10_EXT_CLUMP_NUM_PIXELS) != 0)
@@ -212,7 +260,8 @@ inline bool is_width_compatible(image_descriptor imageInfo)
     return true;
 }
 
-inline size_t calculate_row_pitch(image_descriptor imageInfo, size_t pixelSize)
+inline size_t calculate_row_pitch(const image_descriptor &imageInfo,
+                                  size_t pixelSize)
 {
     if (imageInfo.format->image_channel_data_type == CL_UNSIGNED_INT_RAW10_EXT)
     {
@@ -707,6 +756,76 @@ FloatPixel sample_image_pixel_float_offset(
     image_sampler_data *imageSampler, float *outData, int verbose,
     int *containsDenorms, int lod);
 
+// Float texel reader of an image at a mip level.  The format and the geometry
+// of the level are resolved once when it is constructed, so that reading a
+// texel neither switches on the channel order and data type nor recomputes
+// the pitches.  read() returns the same values as read_image_pixel_float.
+class TexelReader {
+public:
+    TexelReader(const image_descriptor *imageInfo, int lod = 0);
+
+    void read(const void *imageData, int x, int y, int z, float *outData) const
+    {
+        if (x < 0 || y < 0 || z < 0 || x >= (int)width
+            || (height != 0 && y >= (int)height)
+            || (depth != 0 && z >= (int)depth)
+            || (arraySize != 0 && z >= (int)arraySize))
+        {
+            outData[0] = outData[1] = outData[2] = 0;
+            outData[3] = borderAlpha;
+            return;
+        }
+
+        const char *ptr = (const char *)imageData + z * slicePitch
+            + y * rowPitch + x * pixelSize;
+
+        // The decoded channels, followed by the constants 0 and 1 the
+        // channels missing from the order are set to.
+        float tempData[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        decode(ptr, tempData);
+        for (int i = 0; i < 4; i++) outData[i] = tempData[swizzle[i]];
+    }
+
+    // Geometry of the mip level
+    size_t width, height, depth;
+    size_t rowPitch, slicePitch;
+
+private:
+    size_t arraySize;
+    size_t pixelSize;
+    float borderAlpha;
+    void (*decode)(const char *ptr, float *tempData);
+    int swizzle[4];
+};
+
+// Float sampler of an image at a mip level, resolving the texel reader and the
+// addressing function once.  sample() returns the same values as
+// sample_image_pixel_float_offset.  imageInfo and imageSampler must outlive
+// it.
+class TexelSampler {
+public:
+    TexelSampler(const image_descriptor *imageInfo,
+                 const image_sampler_data *imageSampler, int lod = 0);
+
+    FloatPixel sample(const void *imageData, float x, float y, float z,
+                      float xAddressOffset, float yAddressOffset,
+                      float zAddressOffset, float *outData, int verbose,
+                      int *containsDenorms) const;
+
+    FloatPixel sample(const void *imageData, float x, float y, float z,
+                      float *outData, int verbose, int *containsDenorms) const
+    {
+        return sample(imageData, x, y, z, 0.0f, 0.0f, 0.0f, outData, verbose,
+                      containsDenorms);
+    }
+
+private:
+    const image_descriptor *imageInfo;
+    const image_sampler_data *imageSampler;
+    int (*adFn)(int value, size_t maxValue);
+    TexelReader reader;
+};
+
 
 extern void pack_image_pixel(unsigned int *srcVector,
                              const cl_image_format *imageFormat, void *outData);
@@ -21,6 +21,7 @@
 #include "typeWrappers.h"
 #include "testHarness.h"
 #include "parseParameters.h"
+#include "programCache.h"
 
 #include <cassert>
 #include <vector>
@@ -37,7 +38,13 @@ std::string slash = "\\";
 std::string slash = "/";
 #endif
 
-static std::mutex gCompilerMutex;
+// Serialize the creation of programs that share files in
+// gCompilationCachePath, i.e. that have the same file name prefix.  Programs
+// with different prefixes are created concurrently.
+static std::mutex gCompilerMutexes[16];
+
+// Serializes the writes of the CL device info file shared by all programs.
+static std::mutex gDeviceInfoFileMutex;
 
 static cl_int get_first_device_id(const cl_context context,
                                   cl_device_id &device);
@@ -374,6 +381,7 @@ static int write_cl_device_info(const cl_device_id device,
 
     clDeviceInfoFilename = clDeviceInfoFilenameStream.str();
 
+    std::lock_guard<std::mutex> lock(gDeviceInfoFileMutex);
     if ((size_t)get_file_size(clDeviceInfoFilename) == clDeviceInfo.size())
     {
         /* The CL device info file has already been created.
@@ -683,10 +691,11 @@ int create_single_kernel_helper_create_program(cl_context context,
                                                const char **kernelProgram,
                                                const char *buildOptions)
 {
-    std::lock_guard<std::mutex> compiler_lock(gCompilerMutex);
-
     std::string filePrefix =
         get_unique_filename_prefix(numKernelLines, kernelProgram, buildOptions);
+    std::lock_guard<std::mutex> compiler_lock(
+        gCompilerMutexes[crc32(filePrefix.data(), filePrefix.size())
+                         % (sizeof(gCompilerMutexes) / sizeof(std::mutex))]);
     bool shouldSaveToDisk = should_save_kernel_source_to_disk(
         gCompilationMode, gCompilationCacheMode, gCompilationCachePath,
         filePrefix);
@@ -723,6 +732,90 @@ int create_single_kernel_helper_create_program(cl_context context,
     }
 }
 
+std::string get_cl_std_build_option(cl_context context)
+{
+    auto version = get_max_OpenCL_C_for_context(context);
+
+    if (version >= Version(3, 1))
+    {
+        return "-cl-std=CL3.1";
+    }
+    else if (version >= Version(3, 0))
+    {
+        return "-cl-std=CL3.0";
+    }
+    else if (version >= Version(2, 0))
+    {
+        return "-cl-std=CL2.0";
+    }
+    else
+    {
+        // If the -cl-std build option is not specified, the highest OpenCL
+        // C 1.x language version supported by each device is used when
+        // compiling the program for each device.
+        return "";
+    }
+}
+
+// Adds the -cl-std build option of the latest OpenCL C version supported by
+// the context to buildOptions if they have none.  This allows calling code to
+// force a particular CL C version if it is required, but also means that
+// callers need not specify a version if they want to assume the most recent
+// CL C.
+static std::string add_cl_std_build_option(cl_context context,
+                                           const char *buildOptions)
+{
+    std::string options{ buildOptions ? buildOptions : "" };
+    if (!strstr(options.c_str(), "-cl-std"))
+    {
+        options += ' ';
+        options += get_cl_std_build_option(context);
+    }
+    return options;
+}
+
+// Removes the build options only understood by the offline compilers.
+static std::string remove_offline_build_options(std::string options)
+{
+    std::string offlineCompierOptions[] = { "-cl-fp16-enable",
+                                            "-cl-fp64-enable",
+                                            "-cl-zero-init-local-mem-vars" };
+    for (auto &s : offlineCompierOptions)
+    {
+        std::string::size_type i = options.find(s);
+        if (i != std::string::npos) options.erase(i, s.length());
+    }
+    return options;
+}
+
+// Creates the program built from source with buildOptions before for
+// cacheDevice, the device of context if programs built for it are cached, if
+// the program cache has its binary.
+static cl_program find_cached_program(cl_context context,
+                                      cl_device_id cacheDevice,
+                                      const std::string &source,
+                                      const std::string &buildOptions)
+{
+    if (cacheDevice == nullptr) return NULL;
+
+    std::vector<unsigned char> binary;
+    if (!program_cache_find(cacheDevice, source, buildOptions, binary))
+        return NULL;
+
+    int error;
+    size_t length = binary.size();
+    const unsigned char *binaries[] = { binary.data() };
+    cl_program program = clCreateProgramWithBinary(
+        context, 1, &cacheDevice, &length, binaries, NULL, &error);
+    if (program != NULL && error != CL_SUCCESS)
+    {
+        // The binary was rejected, build from source instead
+        clReleaseProgram(program);
+        program = NULL;
+    }
+    return program;
+}
+
 // Creates and builds OpenCL C/C++ program, and creates a kernel
 int create_single_kernel_helper(cl_context context, cl_program *outProgram,
                                 cl_kernel *outKernel,
@@ -731,73 +824,74 @@ int create_single_kernel_helper(cl_context context, cl_program *outProgram,
                                 const char *kernelName,
                                 const char *buildOptions)
 {
-    // For the logic that automatically adds -cl-std it is much cleaner if the
-    // build options have RAII. This buffer will store the potentially updated
-    // build options, in which case buildOptions will point at the string owned
-    // by this buffer.
-    std::string build_options_internal{ buildOptions ? buildOptions : "" };
+    std::string options = add_cl_std_build_option(context, buildOptions);
+    std::string newBuildOptions = remove_offline_build_options(options);
 
-    // Check the build options for the -cl-std option.
-    if (!buildOptions || !strstr(buildOptions, "-cl-std"))
+    // Reuse the binary of an identical program built before, if any
+    cl_device_id cacheDevice = nullptr;
+    std::string source;
+    if (program_cache_enabled(context, cacheDevice))
+        source = get_kernel_content(numKernelLines, kernelProgram);
+    *outProgram =
+        find_cached_program(context, cacheDevice, source, newBuildOptions);
+    if (*outProgram != NULL)
     {
-        // If the build option isn't present add it using the latest OpenCL-C
-        // version supported by the device. This allows calling code to force a
-        // particular CL C version if it is required, but also means that
-        // callers need not specify a version if they want to assume the most
-        // recent CL C.
-
-        auto version = get_max_OpenCL_C_for_context(context);
-
-        std::string cl_std{};
-        if (version >= Version(3, 1))
-        {
-            cl_std = "-cl-std=CL3.1";
-        }
-        else if (version >= Version(3, 0))
-        {
-            cl_std = "-cl-std=CL3.0";
-        }
-        else if (version >= Version(2, 0) && version < Version(3, 0))
-        {
-            cl_std = "-cl-std=CL2.0";
-        }
-        else
-        {
-            // If the -cl-std build option is not specified, the highest OpenCL
-            // C 1.x language version supported by each device is used when
-            // compiling the program for each device.
-            cl_std = "";
-        }
-        build_options_internal += ' ';
-        build_options_internal += cl_std;
-        buildOptions = build_options_internal.c_str();
+        return build_program_create_kernel_helper(
+            context, outProgram, outKernel, numKernelLines, kernelProgram,
+            kernelName, newBuildOptions.c_str());
     }
+
     int error = create_single_kernel_helper_create_program(
-        context, outProgram, numKernelLines, kernelProgram, buildOptions);
+        context, outProgram, numKernelLines, kernelProgram, options.c_str());
     if (error != CL_SUCCESS)
     {
         log_error("Create program failed: %d, line: %d\n", error, __LINE__);
         return error;
     }
 
-    // Remove offline-compiler-only build options
-    std::string newBuildOptions;
-    if (buildOptions != NULL)
-    {
-        newBuildOptions = buildOptions;
-        std::string offlineCompierOptions[] = {
-            "-cl-fp16-enable", "-cl-fp64-enable", "-cl-zero-init-local-mem-vars"
-        };
-        for (auto &s : offlineCompierOptions)
-        {
-            std::string::size_type i = newBuildOptions.find(s);
-            if (i != std::string::npos) newBuildOptions.erase(i, s.length());
-        }
-    }
     // Build program and create kernel
-    return build_program_create_kernel_helper(
+    error = build_program_create_kernel_helper(
         context, outProgram, outKernel, numKernelLines, kernelProgram,
         kernelName, newBuildOptions.c_str());
+    if (error == CL_SUCCESS && cacheDevice != nullptr)
+    {
+        program_cache_add(cacheDevice, source, newBuildOptions, *outProgram);
+    }
+    return error;
+}
+
+int create_program_quiet_helper(cl_context context, cl_program *outProgram,
+                                unsigned int numKernelLines,
+                                const char **kernelProgram,
+                                const char *buildOptions)
+{
+    std::string options = remove_offline_build_options(
+        add_cl_std_build_option(context, buildOptions));
+
+    cl_device_id cacheDevice = nullptr;
+    std::string source;
+    if (program_cache_enabled(context, cacheDevice))
+        source = get_kernel_content(numKernelLines, kernelProgram);
+    *outProgram = find_cached_program(context, cacheDevice, source, options);
+    bool cached = *outProgram != NULL;
+
+    int error = CL_SUCCESS;
+    if (!cached)
+        *outProgram = clCreateProgramWithSource(context, numKernelLines,
+                                                kernelProgram, NULL, &error);
+    if (error == CL_SUCCESS)
+        error =
+            clBuildProgram(*outProgram, 0, NULL, options.c_str(), NULL, NULL);
+    if (error != CL_SUCCESS)
+    {
+        if (*outProgram != NULL) clReleaseProgram(*outProgram);
+        *outProgram = NULL;
+        return error;
+    }
+
+    if (!cached && cacheDevice != nullptr)
+        program_cache_add(cacheDevice, source, options, *outProgram);
+    return CL_SUCCESS;
 }
 
 // Builds OpenCL C/C++ program and creates
@@ -38,6 +38,7 @@
 #include "harness/alloc.h"
 
 #include <functional>
+#include <string>
 
 #ifndef STRINGIFY_VALUE
 #define STRINGIFY_VALUE(_x) STRINGIFY(_x)
@@ -56,6 +57,21 @@ create_single_kernel_helper(cl_context context, cl_program *outProgram,
                             const char **kernelProgram, const char *kernelName,
                             const char *buildOptions = NULL);
 
+/* Helper that creates and builds a program like create_single_kernel_helper,
+ * with the same build options and program cache, without creating a kernel.
+ * Returns a failure without logging it, for callers that fall back to another
+ * way of building the source.  Compiles online only. */
+extern int create_program_quiet_helper(cl_context context,
+                                       cl_program *outProgram,
+                                       unsigned int numKernelLines,
+                                       const char **kernelProgram,
+                                       const char *buildOptions = NULL);
+
+/* Returns the -cl-std build option of the latest OpenCL C version supported
+ * by all the devices of context, which create_single_kernel_helper adds to
+ * build options without one.  Empty for OpenCL C 1.x. */
+extern std::string get_cl_std_build_option(cl_context context);
+
 extern int create_single_kernel_helper_create_program(
     cl_context context, cl_program *outProgram, unsigned int numKernelLines,
     const char **kernelProgram, const char *buildOptions = NULL);
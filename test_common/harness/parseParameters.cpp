@@ -35,6 +35,10 @@ std::string gCompilationProgram = DEFAULT_COMPILATION_PROGRAM;
 bool gDisableSPIRVValidation = false;
 std::string gSPIRVValidator = DEFAULT_SPIRV_VALIDATOR;
 unsigned gNumWorkerThreads;
+std::string gTestHistoryPath;
+bool gProgramCache = false;
+std::string gProgramCachePath;
+bool gMT19937Data = false;
 unsigned gNumThreadPoolThreads = 0;
 bool gListTests = false;
 bool gWimpyMode = false;
@@ -52,6 +56,19 @@ void helpInfo()
             spir-v     Use SPIR-V offline compilation
     --num-worker-threads <num>
         Select parallel execution with the specified number of worker threads.
+    --test-history <file>
+        Record the duration of each sub-test in <file>. Parallel execution
+        then runs the sub-tests recorded as longest first.
+    --program-cache
+        Reuse the binaries of programs built from identical sources and build
+        options, instead of compiling them again (online compilation only).
+    --program-cache-path <path>
+        Enable --program-cache and also keep the binaries in <path> for later
+        runs.
+    --mt19937-data
+        Generate random test data from the serial MT19937 stream, as done
+        before the counter-based generator, to reproduce the data of older
+        runs.
     --list
         List sub-tests
     -w, --wimpy
@@ -226,6 +243,51 @@ int parseCommonParamAndGetRemovedArgs(int argc, const char *argv[],
             }
             removed_args.push_back(std::string(argv[i]) + " " + argv[i + 1]);
         }
+        else if (!strcmp(argv[i], "--test-history"))
+        {
+            delArg++;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                gTestHistoryPath = argv[i + 1];
+            }
+            else
+            {
+                log_error("Path argument for --test-history was not "
+                          "specified.\n");
+                return -1;
+            }
+            removed_args.push_back(std::string(argv[i]) + " " + argv[i + 1]);
+        }
+        else if (!strcmp(argv[i], "--program-cache"))
+        {
+            delArg++;
+            gProgramCache = true;
+            removed_args.push_back(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--mt19937-data"))
+        {
+            delArg++;
+            gMT19937Data = true;
+            removed_args.push_back(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--program-cache-path"))
+        {
+            delArg++;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                gProgramCache = true;
+                gProgramCachePath = argv[i + 1];
+            }
+            else
+            {
+                log_error("Path argument for --program-cache-path was not "
+                          "specified.\n");
+                return -1;
+            }
+            removed_args.push_back(std::string(argv[i]) + " " + argv[i + 1]);
+        }
         else if (!strcmp(argv[i], "--compilation-cache-mode"))
         {
             delArg++;
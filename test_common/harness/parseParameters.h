@@ -44,6 +44,10 @@ extern std::string gSPIRVValidator;
 extern bool gListTests;
 extern bool gWimpyMode;
 extern unsigned gNumWorkerThreads;
+extern std::string gTestHistoryPath;
+extern bool gProgramCache;
+extern std::string gProgramCachePath;
+extern bool gMT19937Data;
 extern unsigned gNumThreadPoolThreads;
 
 extern int
@@ -0,0 +1,279 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "programCache.h"
+#include "crc32.h"
+#include "errorHelpers.h"
+#include "parseParameters.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct CachedProgram
+{
+    std::string device;
+    std::string options;
+    std::string source;
+    std::vector<unsigned char> binary;
+};
+
+// The cache is split in shards, each with its own lock, so that threads
+// building different programs rarely wait on each other.
+constexpr size_t kShardCount = 16;
+
+struct CacheShard
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const CachedProgram>>
+        programs;
+};
+
+CacheShard gCacheShards[kShardCount];
+
+const char kFileMagic[] = "clprogramcache 1\n";
+
+// Identifies the compiler the binaries come from.
+std::string query_device_fingerprint(cl_device_id device)
+{
+    std::string fingerprint;
+    for (cl_device_info param : { CL_DEVICE_NAME, CL_DEVICE_VENDOR,
+                                  CL_DRIVER_VERSION, CL_DEVICE_VERSION })
+    {
+        size_t size = 0;
+        if (clGetDeviceInfo(device, param, 0, nullptr, &size) != CL_SUCCESS)
+            continue;
+        std::string value(size, '\0');
+        if (clGetDeviceInfo(device, param, size, &value[0], nullptr)
+            != CL_SUCCESS)
+            continue;
+        fingerprint += value.c_str();
+        fingerprint += '\n';
+    }
+    return fingerprint;
+}
+
+// The fingerprint of each device, queried once.
+const std::string &get_device_fingerprint(cl_device_id device)
+{
+    static std::mutex mutex;
+    static std::unordered_map<cl_device_id, std::string> fingerprints;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = fingerprints.find(device);
+    if (it == fingerprints.end())
+        it = fingerprints.emplace(device, query_device_fingerprint(device))
+                 .first;
+    return it->second;
+}
+
+std::string get_cache_key(const std::string &device, const std::string &source,
+                          const std::string &options)
+{
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(8)
+        << crc32(source.data(), source.size()) << std::setw(8)
+        << crc32(options.data(), options.size()) << std::setw(8)
+        << crc32(device.data(), device.size());
+    return oss.str();
+}
+
+CacheShard &get_shard(const std::string &key)
+{
+    return gCacheShards[std::hash<std::string>()(key) % kShardCount];
+}
+
+std::string get_cache_filename(const std::string &key)
+{
+#if defined(_WIN32)
+    return gProgramCachePath + "\\" + key + ".clbin";
+#else
+    return gProgramCachePath + "/" + key + ".clbin";
+#endif
+}
+
+bool matches(const CachedProgram &program, const std::string &device,
+             const std::string &source, const std::string &options)
+{
+    return program.device == device && program.options == options
+        && program.source == source;
+}
+
+// The file holds the magic, the sizes of the device fingerprint, options,
+// source and binary, and then each of them in that order.
+std::shared_ptr<const CachedProgram> read_cache_file(const std::string &key)
+{
+    FILE *file = fopen(get_cache_filename(key).c_str(), "rb");
+    if (file == nullptr) return nullptr;
+
+    auto program = std::make_shared<CachedProgram>();
+    char magic[sizeof(kFileMagic)] = {};
+    size_t deviceSize, optionsSize, sourceSize, binarySize;
+    bool ok = fread(magic, 1, sizeof(kFileMagic) - 1, file)
+            == sizeof(kFileMagic) - 1
+        && strcmp(magic, kFileMagic) == 0
+        && fscanf(file, "%zu %zu %zu %zu", &deviceSize, &optionsSize,
+                  &sourceSize, &binarySize)
+            == 4
+        && fgetc(file) == '\n';
+    if (ok)
+    {
+        program->device.resize(deviceSize);
+        program->options.resize(optionsSize);
+        program->source.resize(sourceSize);
+        program->binary.resize(binarySize);
+        ok = fread(&program->device[0], 1, deviceSize, file) == deviceSize
+            && fread(&program->options[0], 1, optionsSize, file) == optionsSize
+            && fread(&program->source[0], 1, sourceSize, file) == sourceSize
+            && fread(program->binary.data(), 1, binarySize, file) == binarySize
+            && binarySize > 0;
+    }
+    fclose(file);
+    return ok ? program : nullptr;
+}
+
+void write_cache_file(const std::string &key, const CachedProgram &program)
+{
+    // Write to a file of this process and thread first, so that concurrent
+    // writers and readers of the same program never see a partial file.
+    std::string fileName = get_cache_filename(key);
+    std::ostringstream tempName;
+    tempName << fileName << '.' << getpid() << '.'
+             << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    FILE *file = fopen(tempName.str().c_str(), "wb");
+    if (file == nullptr)
+    {
+        log_info("Can't write program cache file: %s\n",
+                 tempName.str().c_str());
+        return;
+    }
+    fputs(kFileMagic, file);
+    fprintf(file, "%zu %zu %zu %zu\n", program.device.size(),
+            program.options.size(), program.source.size(),
+            program.binary.size());
+    fwrite(program.device.data(), 1, program.device.size(), file);
+    fwrite(program.options.data(), 1, program.options.size(), file);
+    fwrite(program.source.data(), 1, program.source.size(), file);
+    fwrite(program.binary.data(), 1, program.binary.size(), file);
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+
+#if defined(_WIN32)
+    if (ok) remove(fileName.c_str());
+#endif
+    if (!ok || rename(tempName.str().c_str(), fileName.c_str()) != 0)
+    {
+        log_info("Can't write program cache file: %s\n", fileName.c_str());
+        remove(tempName.str().c_str());
+    }
+}
+
+} // anonymous namespace
+
+bool program_cache_enabled(cl_context context, cl_device_id &device)
+{
+    if (!gProgramCache || gCompilationMode != kOnline) return false;
+
+    // Binaries are per device, only cache programs built for a single one.
+    cl_uint numDevices = 0;
+    cl_int error = clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES,
+                                    sizeof(numDevices), &numDevices, nullptr);
+    if (error != CL_SUCCESS || numDevices != 1) return false;
+
+    error = clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(device),
+                             &device, nullptr);
+    return error == CL_SUCCESS;
+}
+
+bool program_cache_find(cl_device_id device, const std::string &source,
+                        const std::string &options,
+                        std::vector<unsigned char> &binary)
+{
+    const std::string &fingerprint = get_device_fingerprint(device);
+    std::string key = get_cache_key(fingerprint, source, options);
+    CacheShard &shard = get_shard(key);
+
+    std::shared_ptr<const CachedProgram> program;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.programs.find(key);
+        if (it != shard.programs.end()) program = it->second;
+    }
+
+    // Not in memory yet, try the files of earlier runs.  The shard isn't
+    // locked while reading so that other programs can be looked up.
+    if (program == nullptr && !gProgramCachePath.empty())
+    {
+        program = read_cache_file(key);
+        if (program != nullptr
+            && matches(*program, fingerprint, source, options))
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.programs.emplace(key, program);
+        }
+    }
+
+    if (program == nullptr || !matches(*program, fingerprint, source, options))
+        return false;
+
+    binary = program->binary;
+    return true;
+}
+
+void program_cache_add(cl_device_id device, const std::string &source,
+                       const std::string &options, cl_program program)
+{
+    size_t binarySize = 0;
+    cl_int error = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                                    sizeof(binarySize), &binarySize, nullptr);
+    if (error != CL_SUCCESS || binarySize == 0) return;
+
+    auto cached = std::make_shared<CachedProgram>();
+    cached->binary.resize(binarySize);
+    unsigned char *binaries[] = { cached->binary.data() };
+    error = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries),
+                             binaries, nullptr);
+    if (error != CL_SUCCESS) return;
+
+    cached->device = get_device_fingerprint(device);
+    cached->options = options;
+    cached->source = source;
+    std::string key = get_cache_key(cached->device, source, options);
+
+    {
+        CacheShard &shard = get_shard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.programs[key] = cached;
+    }
+
+    if (!gProgramCachePath.empty()) write_cache_file(key, *cached);
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _programCache_h
+#define _programCache_h
+
+#include "compat.h"
+
+#include <string>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+// Cache of the binaries of the programs built from source by
+// create_single_kernel_helper and create_program_quiet_helper, enabled by
+// --program-cache.  Binaries are looked up by the source, the build options
+// and the device, so that building the same program again, in another context
+// or in another run, skips the compiler.
+//
+// The cache is kept in memory and, if --program-cache-path is given, in
+// files in that directory that later runs reuse.  Lookups and insertions of
+// different programs don't block each other.
+
+// Whether programs built for context are cached, in which case device is set
+// to its only device.
+bool program_cache_enabled(cl_context context, cl_device_id &device);
+
+// Find the binary of the program built from source with options for device.
+// Returns false if there is none.
+bool program_cache_find(cl_device_id device, const std::string &source,
+                        const std::string &options,
+                        std::vector<unsigned char> &binary);
+
+// Add the binary of program, built from source with options for device.
+void program_cache_add(cl_device_id device, const std::string &source,
+                       const std::string &options, cl_program program);
+
+#endif // _programCache_h
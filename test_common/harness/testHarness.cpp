@@ -17,12 +17,14 @@
 #include "stringHelpers.h"
 #include "compat.h"
 #include <algorithm>
+#include <chrono>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <cassert>
 #include <deque>
 #include <filesystem>
+#include <limits>
 #include <mutex>
 #include <set>
 #include <stdexcept>
@@ -36,6 +38,7 @@
 #include "typeWrappers.h"
 #include "imageHelpers.h"
 #include "parseParameters.h"
+#include "testHistory.h"
 
 namespace fs = std::filesystem;
 
@@ -897,12 +900,39 @@ struct test_harness_state
     test_status *results;
     cl_device_id device;
     test_harness_config config;
+    TestHistory *history;
+};
+
+// What a worker thread did, for the schedule summary.
+struct test_worker_stats
+{
+    double busySeconds = 0.0;
+    double finishSeconds = 0.0;
+    unsigned testCount = 0;
 };
 
 static std::deque<int> gTestQueue;
 static std::mutex gTestStateMutex;
+static std::chrono::steady_clock::time_point gScheduleStart;
 
-void test_function_runner(test_harness_state *state)
+static test_status callAndTimeTestFunction(test_definition test,
+                                           cl_device_id deviceToUse,
+                                           const test_harness_config &config,
+                                           TestHistory *history,
+                                           double &seconds)
+{
+    auto start = std::chrono::steady_clock::now();
+    test_status status = callSingleTestFunction(test, deviceToUse, config);
+    auto finish = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration<double>(finish - start).count();
+    if (history != nullptr && status != TEST_SKIP)
+    {
+        history->record(test.name, seconds);
+    }
+    return status;
+}
+
+void test_function_runner(test_harness_state *state, test_worker_stats *stats)
 {
     int testID;
     test_definition test;
@@ -915,7 +945,7 @@ void test_function_runner(test_harness_state *state)
             // The queue is empty, we're done
             if (gTestQueue.size() == 0)
             {
-                return;
+                break;
             }
 
             // Get the test at the front of the queue
@@ -925,8 +955,11 @@ void test_function_runner(test_harness_state *state)
         }
 
         // Execute test
-        auto status =
-            callSingleTestFunction(test, state->device, state->config);
+        double seconds;
+        auto status = callAndTimeTestFunction(
+            test, state->device, state->config, state->history, seconds);
+        stats->busySeconds += seconds;
+        stats->testCount++;
 
         // Store result
         {
@@ -934,6 +967,67 @@ void test_function_runner(test_harness_state *state)
             state->results[testID] = status;
         }
     }
+
+    auto finish = std::chrono::steady_clock::now();
+    stats->finishSeconds =
+        std::chrono::duration<double>(finish - gScheduleStart).count();
+}
+
+// Order the queued tests longest expected first, which bounds the wall time
+// by the longest test plus the average load of a worker.  Tests with no
+// recorded duration go first as they may be long, and ties keep the
+// registration order.
+static void scheduleLongestFirst(test_definition testList[],
+                                 const TestHistory &history)
+{
+    std::vector<std::pair<double, int>> order;
+    for (int testID : gTestQueue)
+    {
+        double expected = history.expected(testList[testID].name);
+        if (expected < 0.0) expected = std::numeric_limits<double>::infinity();
+        order.emplace_back(expected, testID);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<double, int> &a,
+                        const std::pair<double, int> &b) {
+                         return a.first > b.first;
+                     });
+
+    gTestQueue.clear();
+    for (const auto &entry : order)
+    {
+        gTestQueue.push_back(entry.second);
+    }
+}
+
+static void printScheduleSummary(const std::vector<test_worker_stats> &stats,
+                                 double longestSeconds,
+                                 const char *longestName)
+{
+    double wallSeconds = 0.0;
+    double busySeconds = 0.0;
+    for (const auto &worker : stats)
+    {
+        wallSeconds = std::max(wallSeconds, worker.finishSeconds);
+        busySeconds += worker.busySeconds;
+    }
+
+    // No schedule can finish before the longest test or before the average
+    // worker is done.
+    double boundSeconds = std::max(longestSeconds, busySeconds / stats.size());
+    log_info("Ran tests in %.2f s on %zu workers, lower bound %.2f s\n",
+             wallSeconds, stats.size(), boundSeconds);
+    if (longestName != nullptr)
+    {
+        log_info("Critical path: %s took %.2f s\n", longestName,
+                 longestSeconds);
+    }
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        log_info("Worker %zu: %u tests, busy %.2f s, idle %.2f s\n", i,
+                 stats[i].testCount, stats[i].busySeconds,
+                 wallSeconds - stats[i].busySeconds);
+    }
 }
 
 void callTestFunctions(test_definition testList[],
@@ -942,6 +1036,13 @@ void callTestFunctions(test_definition testList[],
                        cl_device_id deviceToUse,
                        const test_harness_config &config)
 {
+    TestHistory history;
+    bool useHistory = !gTestHistoryPath.empty();
+    if (useHistory)
+    {
+        history.load(gTestHistoryPath);
+    }
+
     // Execute tests serially
     if (config.numWorkerThreads == 0)
     {
@@ -949,8 +1050,10 @@ void callTestFunctions(test_definition testList[],
         {
             if (selectedTestList[i])
             {
-                resultTestList[i] =
-                    callSingleTestFunction(testList[i], deviceToUse, config);
+                double seconds;
+                resultTestList[i] = callAndTimeTestFunction(
+                    testList[i], deviceToUse, config,
+                    useHistory ? &history : nullptr, seconds);
             }
         }
         // Execute tests in parallel with the specified number of worker threads
@@ -966,22 +1069,52 @@ void callTestFunctions(test_definition testList[],
             }
         }
 
+        // Without history, keep the registration order
+        if (!history.empty())
+        {
+            scheduleLongestFirst(testList, history);
+        }
+
         // Spawn thread pool
         std::vector<std::thread *> threads;
+        std::vector<test_worker_stats> stats(config.numWorkerThreads);
         test_harness_state state = { testList, resultTestList, deviceToUse,
-                                     config };
+                                     config, &history };
+        gScheduleStart = std::chrono::steady_clock::now();
         for (unsigned i = 0; i < config.numWorkerThreads; i++)
         {
             log_info("Spawning worker thread %u\n", i);
-            threads.push_back(new std::thread(test_function_runner, &state));
+            threads.push_back(
+                new std::thread(test_function_runner, &state, &stats[i]));
         }
 
         // Wait for all threads to complete
         for (auto th : threads)
         {
             th->join();
+            delete th;
         }
         assert(gTestQueue.size() == 0);
+
+        double longestSeconds = 0.0;
+        const char *longestName = nullptr;
+        for (int i = 0; i < testNum; ++i)
+        {
+            double seconds = selectedTestList[i]
+                ? history.expected(testList[i].name)
+                : -1.0;
+            if (seconds > longestSeconds)
+            {
+                longestSeconds = seconds;
+                longestName = testList[i].name;
+            }
+        }
+        printScheduleSummary(stats, longestSeconds, longestName);
+    }
+
+    if (useHistory)
+    {
+        history.save(gTestHistoryPath);
     }
 }
 
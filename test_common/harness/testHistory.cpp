@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testHistory.h"
+#include "errorHelpers.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+// The file has one "<seconds> <sub-test name>" line per sub-test.
+
+void TestHistory::load(const std::string &path)
+{
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        double seconds;
+        char name[1024];
+        if (sscanf(line, "%lf %1023s", &seconds, name) == 2 && seconds >= 0.0)
+        {
+            durations[name] = seconds;
+        }
+    }
+    fclose(file);
+}
+
+void TestHistory::save(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        log_error("Unable to write test history %s (%s)\n", path.c_str(),
+                  strerror(errno));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &duration : durations)
+    {
+        fprintf(file, "%.3f %s\n", duration.second, duration.first.c_str());
+    }
+    if (fclose(file) != 0)
+    {
+        log_error("Unable to write test history %s (%s)\n", path.c_str(),
+                  strerror(errno));
+    }
+}
+
+double TestHistory::expected(const std::string &name) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = durations.find(name);
+    return it == durations.end() ? -1.0 : it->second;
+}
+
+void TestHistory::record(const std::string &name, double seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    durations[name] = seconds;
+}
@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _testHistory_h
+#define _testHistory_h
+
+#include <map>
+#include <mutex>
+#include <string>
+
+// Durations of the sub-tests measured by earlier runs, kept in the file given
+// with --test-history.  Used to run the longest sub-tests first when they run
+// in parallel, which keeps a long sub-test registered last from determining
+// the wall time.
+class TestHistory {
+public:
+    // Read the durations from path.  A missing or unreadable file is an empty
+    // history.
+    void load(const std::string &path);
+
+    // Write the durations to path, including those of the sub-tests that
+    // didn't run this time.
+    void save(const std::string &path) const;
+
+    bool empty() const { return durations.empty(); }
+
+    // Expected duration of the sub-test in seconds, or a negative value if it
+    // never ran.
+    double expected(const std::string &name) const;
+
+    // Record the duration of a sub-test that just ran.  Thread-safe.
+    void record(const std::string &name, double seconds);
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, double> durations;
+};
+
+#endif // _testHistory_h
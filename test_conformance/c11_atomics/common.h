@@ -19,19 +19,26 @@
 #include "harness/testHarness.h"
 #include "harness/typeWrappers.h"
 #include "harness/ThreadPool.h"
+#include "harness/kernelHelpers.h"
+#include "harness/parseParameters.h"
 
 #include "host_atomics.h"
+#include "host_threads.h"
 
 #include "CL/cl_half.h"
 
 #include <algorithm>
 #include <iomanip>
 #include <limits>
+#include <map>
+#include <memory>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #define MAX_DEVICE_THREADS (gHost ? 0U : gMaxDeviceThreads)
-#define MAX_HOST_THREADS GetThreadCount()
+#define MAX_HOST_THREADS                                                       \
+    (gHostThreads > 0 ? (cl_uint)gHostThreads : GetThreadCount())
 
 #define EXECUTE_TEST(error, test)                                              \
     error |= test;                                                             \
@@ -71,6 +78,7 @@ extern bool
 extern bool gNoGenericAddressSpace; // disable cases with generic address space
 extern bool gUseHostPtr; // use malloc/free instead of clSVMAlloc/clSVMFree
 extern bool gDebug; // print OpenCL kernel code
+extern int gHostThreads; // number of host threads, 0 for one per CPU
 extern int gInternalIterations; // internal test iterations for atomic
                                 // operation, sufficient to verify atomicity
 extern int
@@ -241,6 +249,29 @@ public:
     }
     virtual int ExecuteSingleTest(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue);
+    // Runs executeAll twice: first only to collect the program source of each
+    // parameter set it visits, then for real, with the collected programs
+    // built a batch at a time instead of one program per parameter set.
+    template <typename ExecuteAll>
+    int ExecuteWithBatchedPrograms(cl_context context, ExecuteAll executeAll)
+    {
+        // The old API emulation defines macros that depend on the memory
+        // scope, which cannot share a program.  Offline compilation builds
+        // each program through the compiler as usual.
+        if (!gOldAPI && gCompilationMode == kOnline)
+        {
+            _collectingSources = true;
+            executeAll();
+            _collectingSources = false;
+            BuildBatchedPrograms(context);
+        }
+        int error = executeAll();
+        _batchedKernels.clear();
+        return error;
+    }
+    void BuildBatchedPrograms(cl_context context);
+    bool TakeBatchedKernel(const std::string &source,
+                           clProgramWrapper &program, clKernelWrapper &kernel);
     int ExecuteForEachPointerType(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue)
     {
@@ -441,6 +472,9 @@ public:
     }
     virtual bool SVMDataBufferAllSVMConsistent() { return false; }
     bool UseSVM() { return _useSVM; }
+    // Whether ExecuteSingleTest only collects the program source, overrides
+    // don't log anything then.
+    bool CollectingSources() { return _collectingSources; }
     void StartValue(HostDataType startValue) { _startValue = startValue; }
     HostDataType StartValue() { return _startValue; }
     void SetLocalMemory(bool local) { _localMemory = local; }
@@ -504,6 +538,14 @@ private:
     const cl_int _iterations;
     cl_uint _maxDeviceThreads;
     cl_uint _deviceThreads;
+
+    struct BatchedKernel
+    {
+        clProgramWrapper program;
+        std::string kernelName;
+    };
+    bool _collectingSources = false;
+    std::map<std::string, BatchedKernel> _batchedKernels;
 };
 
 template <typename HostAtomicType, typename HostDataType>
@@ -613,7 +655,6 @@ public:
         // repeat test for each reasonable memory order/scope combination
         std::vector<TExplicitMemoryOrderType> memoryOrder;
         std::vector<TExplicitMemoryScopeType> memoryScope;
-        int error = 0;
 
         // For OpenCL-3.0 and later some orderings and scopes are optional, so
         // here we query for the supported ones.
@@ -621,22 +662,25 @@ public:
                                                          memoryScope),
                        "getSupportedMemoryOrdersAndScopes failed\n", TEST_FAIL);
 
-        for (unsigned oi = 0; oi < memoryOrder.size(); oi++)
-        {
-            for (unsigned si = 0; si < memoryScope.size(); si++)
+        return this->ExecuteWithBatchedPrograms(context, [&]() {
+            int error = 0;
+            for (unsigned oi = 0; oi < memoryOrder.size(); oi++)
             {
-                if (memoryOrder[oi] == MEMORY_ORDER_EMPTY
-                    && memoryScope[si] != MEMORY_SCOPE_EMPTY)
-                    continue;
-                MemoryOrder(memoryOrder[oi]);
-                MemoryScope(memoryScope[si]);
-                EXECUTE_TEST(
-                    error,
-                    (CBasicTest<HostAtomicType, HostDataType>::
-                         ExecuteForEachParameterSet(deviceID, context, queue)));
+                for (unsigned si = 0; si < memoryScope.size(); si++)
+                {
+                    if (memoryOrder[oi] == MEMORY_ORDER_EMPTY
+                        && memoryScope[si] != MEMORY_SCOPE_EMPTY)
+                        continue;
+                    MemoryOrder(memoryOrder[oi]);
+                    MemoryScope(memoryScope[si]);
+                    EXECUTE_TEST(error,
+                                 (CBasicTest<HostAtomicType, HostDataType>::
+                                      ExecuteForEachParameterSet(
+                                          deviceID, context, queue)));
+                }
             }
-        }
-        return error;
+            return error;
+        });
     }
     void MemoryOrder(TExplicitMemoryOrderType memoryOrder)
     {
@@ -754,7 +798,6 @@ public:
         // repeat test for each reasonable memory order/scope combination
         std::vector<TExplicitMemoryOrderType> memoryOrder;
         std::vector<TExplicitMemoryScopeType> memoryScope;
-        int error = 0;
 
         // For OpenCL-3.0 and later some orderings and scopes are optional, so
         // here we query for the supported ones.
@@ -762,36 +805,40 @@ public:
                                                          memoryScope),
                        "getSupportedMemoryOrdersAndScopes failed\n", TEST_FAIL);
 
-        for (unsigned oi = 0; oi < memoryOrder.size(); oi++)
-        {
-            for (unsigned o2i = 0; o2i < memoryOrder.size(); o2i++)
+        return this->ExecuteWithBatchedPrograms(context, [&]() {
+            int error = 0;
+            for (unsigned oi = 0; oi < memoryOrder.size(); oi++)
             {
-                for (unsigned si = 0; si < memoryScope.size(); si++)
+                for (unsigned o2i = 0; o2i < memoryOrder.size(); o2i++)
                 {
-                    if (!checkValidity(memoryOrder[oi], memoryOrder[o2i],
-                                       memoryScope[si]))
-                        continue;
-
-                    MemoryOrder(memoryOrder[oi]);
-                    MemoryOrder2(memoryOrder[o2i]);
-                    MemoryScope(memoryScope[si]);
-
-                    if (CheckCapabilities(MemoryScope(), MemoryOrder())
-                        == TEST_SKIPPED_ITSELF)
-                        continue; // skip test - not applicable
-
-                    if (CheckCapabilities(MemoryScope(), MemoryOrder2())
-                        == TEST_SKIPPED_ITSELF)
-                        continue; // skip test - not applicable
-
-                    EXECUTE_TEST(error,
-                                 (CBasicTest<HostAtomicType, HostDataType>::
-                                      ExecuteForEachParameterSet(
-                                          deviceID, context, queue)));
+                    for (unsigned si = 0; si < memoryScope.size(); si++)
+                    {
+                        if (!checkValidity(memoryOrder[oi], memoryOrder[o2i],
+                                           memoryScope[si]))
+                            continue;
+
+                        MemoryOrder(memoryOrder[oi]);
+                        MemoryOrder2(memoryOrder[o2i]);
+                        MemoryScope(memoryScope[si]);
+
+                        if (CheckCapabilities(MemoryScope(), MemoryOrder())
+                            == TEST_SKIPPED_ITSELF)
+                            continue; // skip test - not applicable
+
+                        if (CheckCapabilities(MemoryScope(), MemoryOrder2())
+                            == TEST_SKIPPED_ITSELF)
+                            continue; // skip test - not applicable
+
+                        EXECUTE_TEST(
+                            error,
+                            (CBasicTest<HostAtomicType, HostDataType>::
+                                 ExecuteForEachParameterSet(deviceID, context,
+                                                            queue)));
+                    }
                 }
             }
-        }
-        return error;
+            return error;
+        });
     }
     void MemoryOrder2(TExplicitMemoryOrderType memoryOrderFail)
     {
@@ -1181,6 +1228,77 @@ CBasicTest<HostAtomicType, HostDataType>::KernelCode(cl_uint maxNumDestItems)
     return code;
 }
 
+template <typename HostAtomicType, typename HostDataType>
+void CBasicTest<HostAtomicType, HostDataType>::BuildBatchedPrograms(
+    cl_context context)
+{
+    // Program scope names, made unique for each parameter set in a batch
+    static const char *const renamed[] = { "test_atomic_kernel",
+                                           "test_atomic_function",
+                                           "destMemory", "finishedThreads" };
+    const size_t maxKernelsPerProgram = 32;
+
+    auto next = _batchedKernels.begin();
+    while (next != _batchedKernels.end())
+    {
+        std::vector<BatchedKernel *> batch;
+        std::string programSource;
+        for (; next != _batchedKernels.end()
+             && batch.size() < maxKernelsPerProgram;
+             ++next)
+        {
+            std::string suffix = "_" + std::to_string(batch.size());
+            for (const char *name : renamed)
+                programSource += std::string("#define ") + name + " " + name
+                    + suffix + "\n";
+            programSource += next->first;
+            for (const char *name : renamed)
+                programSource += std::string("#undef ") + name + "\n";
+
+            next->second.kernelName = renamed[0] + suffix;
+            batch.push_back(&next->second);
+        }
+
+        // Built quietly rather than with create_single_kernel_helper, which
+        // logs the build log of a failure as an error.  Parameter sets of a
+        // batch that fails are built one at a time, which reports the failure
+        // against the right one.
+        clProgramWrapper program;
+        const char *programLine = programSource.c_str();
+        cl_int error =
+            create_program_quiet_helper(context, &program, 1, &programLine);
+        if (error != CL_SUCCESS)
+        {
+            log_info("\t%s: batch of %zu programs failed to build (%s), "
+                     "building them one at a time\n",
+                     DataType().AtomicTypeName(), batch.size(),
+                     IGetErrorString(error));
+            continue;
+        }
+        for (BatchedKernel *batched : batch) batched->program = program;
+    }
+}
+
+template <typename HostAtomicType, typename HostDataType>
+bool CBasicTest<HostAtomicType, HostDataType>::TakeBatchedKernel(
+    const std::string &source, clProgramWrapper &program,
+    clKernelWrapper &kernel)
+{
+    auto batched = _batchedKernels.find(source);
+    if (batched == _batchedKernels.end() || !batched->second.program)
+        return false;
+
+    cl_int error;
+    kernel = clCreateKernel(batched->second.program,
+                            batched->second.kernelName.c_str(), &error);
+    if (error == CL_SUCCESS) program = batched->second.program;
+
+    // Program scope variables are only initialized when the program is built,
+    // so each kernel of a batch runs at most once.
+    _batchedKernels.erase(batched);
+    return error == CL_SUCCESS;
+}
+
 template <typename HostAtomicType, typename HostDataType>
 int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
     cl_device_id deviceID, cl_context context, cl_command_queue queue)
@@ -1207,17 +1325,17 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
 
     // log_info("\t%s %s%s...\n", local ? "local" : "global",
     // DataType().AtomicTypeName(), memoryOrderScope.c_str());
-    log_info("\t%s...\n", SingleTestName().c_str());
+    if (!_collectingSources) log_info("\t%s...\n", SingleTestName().c_str());
 
     if (!LocalMemory() && DeclaredInProgram()
         && gNoGlobalVariables) // no support for program scope global variables
     {
-        log_info("\t\tTest disabled\n");
+        if (!_collectingSources) log_info("\t\tTest disabled\n");
         return 0;
     }
     if (UsedInFunction() && GenericAddrSpace() && gNoGenericAddressSpace)
     {
-        log_info("\t\tTest disabled\n");
+        if (!_collectingSources) log_info("\t\tTest disabled\n");
         return 0;
     }
     if (!LocalMemory() && DeclaredInProgram())
@@ -1225,7 +1343,7 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         if (((gAtomicMemCap & CL_DEVICE_ATOMIC_SCOPE_DEVICE) == 0)
             || ((gAtomicMemCap & CL_DEVICE_ATOMIC_ORDER_ACQ_REL) == 0))
         {
-            log_info("\t\tTest disabled\n");
+            if (!_collectingSources) log_info("\t\tTest disabled\n");
             return 0;
         }
     }
@@ -1261,13 +1379,20 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         while ((CurrentGroupSize() > 1))
         {
             // Re-generate the kernel code with the current group size
-            if (kernel) clReleaseKernel(kernel);
-            if (program) clReleaseProgram(program);
+            kernel.reset();
+            program.reset();
             programSource = PragmaHeader(deviceID) + ProgramHeader(numDestItems)
                 + FunctionCode() + KernelCode(numDestItems);
             programLine = programSource.c_str();
-            if (create_single_kernel_helper(context, &program, &kernel, 1,
-                                            &programLine, "test_atomic_kernel"))
+            if (_collectingSources)
+            {
+                _batchedKernels.emplace(programSource, BatchedKernel());
+                return 0;
+            }
+            if (!TakeBatchedKernel(programSource, program, kernel)
+                && create_single_kernel_helper(context, &program, &kernel, 1,
+                                               &programLine,
+                                               "test_atomic_kernel"))
             {
                 return -1;
             }
@@ -1316,6 +1441,7 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
                 CurrentGroupSize() * CurrentGroupNum(deviceThreadCount);
         threadCount = deviceThreadCount + hostThreadCount;
     }
+    if (_collectingSources) return 0;
     if (gDebug && programLine != nullptr)
     {
         log_info("Program source:\n");
@@ -1472,6 +1598,11 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         hostThreadContexts[t].oldValues =
             UseSVM() ? svmDataBuffer : &refValues[0];
     }
+    /* Wake host threads, they wait for the kernel launch */
+    std::unique_ptr<HostThreadLaunch> hostThreads;
+    if (hostThreadCount > 0)
+        hostThreads.reset(new HostThreadLaunch(
+            HostThreadFunction, hostThreadCount, &hostThreadContexts[0]));
 
     if (deviceThreadCount > 0)
     {
@@ -1488,8 +1619,19 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
 
     /* Start host threads and wait for finish */
     if (hostThreadCount > 0)
-        ThreadPool_Do(HostThreadFunction, hostThreadCount,
-                      &hostThreadContexts[0]);
+    {
+        hostThreads->Start();
+        error = hostThreads->Finish();
+        test_error(error, "Host thread failed");
+        if (gDebug)
+        {
+            const auto &delays = hostThreads->StartDelays();
+            for (cl_uint t = 0; t < hostThreadCount; t++)
+                log_info("\t\tHost thread %u started %.1f us after the kernel "
+                         "launch\n",
+                         t, delays[t].count() / 1000.0);
+        }
+    }
 
     if (UseSVM())
     {
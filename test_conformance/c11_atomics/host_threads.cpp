@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "host_threads.h"
+
+#include "harness/errorHelpers.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// CPUs the process may run on, in the order host threads are pinned to them.
+std::vector<unsigned> AllowedCpus()
+{
+    std::vector<unsigned> cpus;
+#if defined(_WIN32)
+    DWORD_PTR processMask, systemMask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        for (unsigned cpu = 0; cpu < 8 * sizeof(processMask); cpu++)
+            if (processMask & (DWORD_PTR(1) << cpu)) cpus.push_back(cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    if (0 == sched_getaffinity(0, sizeof(set), &set))
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+#endif
+    return cpus;
+}
+
+void PinThread(std::thread &thread, unsigned index)
+{
+    static const std::vector<unsigned> cpus = AllowedCpus();
+    if (cpus.empty())
+    {
+        static bool warned = false;
+        if (!warned)
+            log_info("Host thread affinity is not supported on this "
+                     "platform\n");
+        warned = true;
+        return;
+    }
+
+    unsigned cpu = cpus[index % cpus.size()];
+#if defined(_WIN32)
+    bool pinned =
+        0 != SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    bool pinned =
+        0 == pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    bool pinned = false;
+#endif
+    if (!pinned)
+        log_info("Unable to pin host thread %u to CPU %u\n", index, cpu);
+}
+
+// The threads behind HostThreadLaunch.  They sleep between launches, and spin
+// from the moment they are woken until the launch is started.
+class HostThreadTeam {
+public:
+    static HostThreadTeam &Get()
+    {
+        static HostThreadTeam team;
+        return team;
+    }
+
+    ~HostThreadTeam()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _exiting = true;
+        }
+        _wake.notify_all();
+        for (std::thread &thread : _threads) thread.join();
+    }
+
+    void Wake(TPFuncPtr func, cl_uint count, void *userInfo)
+    {
+        while (_threads.size() < count)
+        {
+            cl_uint index = (cl_uint)_threads.size();
+            _threads.emplace_back(&HostThreadTeam::Worker, this, index);
+            if (gHostThreadAffinity) PinThread(_threads.back(), index);
+        }
+
+        _arrived = 0;
+        _done = 0;
+        _go = false;
+        _cancelled = false;
+        _result = CL_SUCCESS;
+        _threadStart.assign(count, Clock::time_point());
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _func = func;
+            _userInfo = userInfo;
+            _count = count;
+            _generation++;
+        }
+        _wake.notify_all();
+    }
+
+    // Releases the threads once all of them are spinning
+    Clock::time_point Release(bool cancel)
+    {
+        while (_arrived.load(std::memory_order_acquire) < _count)
+            std::this_thread::yield();
+        _cancelled = cancel;
+        Clock::time_point start = Clock::now();
+        _go.store(true, std::memory_order_release);
+        return start;
+    }
+
+    cl_int Wait(Clock::time_point start,
+                std::vector<std::chrono::nanoseconds> &startDelays)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _finished.wait(lock, [&] { return _done == _count; });
+        }
+        startDelays.resize(_count);
+        for (cl_uint i = 0; i < _count; i++)
+            startDelays[i] = _threadStart[i] - start;
+        return _result;
+    }
+
+    std::mutex launchLock;
+
+private:
+    void Worker(cl_uint index)
+    {
+        cl_uint seen = 0;
+        for (;;)
+        {
+            cl_uint count;
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+                _wake.wait(lock,
+                           [&] { return _exiting || _generation != seen; });
+                if (_exiting) return;
+                seen = _generation;
+                count = _count;
+            }
+            if (index >= count) continue;
+
+            // Spin barrier: wait without sleeping for the release
+            _arrived.fetch_add(1, std::memory_order_release);
+            while (!_go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            if (!_cancelled)
+            {
+                _threadStart[index] = Clock::now();
+                cl_int result = _func(index, index, _userInfo);
+                cl_int success = CL_SUCCESS;
+                if (result) _result.compare_exchange_strong(success, result);
+            }
+
+            std::lock_guard<std::mutex> lock(_lock);
+            if (++_done == count) _finished.notify_one();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::condition_variable _finished;
+    cl_uint _generation = 0;
+    bool _exiting = false;
+
+    // The current launch
+    TPFuncPtr _func = nullptr;
+    void *_userInfo = nullptr;
+    cl_uint _count = 0;
+    cl_uint _done = 0;
+    std::atomic<cl_uint> _arrived{ 0 };
+    std::atomic<bool> _go{ false };
+    std::atomic<bool> _cancelled{ false };
+    std::atomic<cl_int> _result{ CL_SUCCESS };
+    std::vector<Clock::time_point> _threadStart;
+};
+
+} // namespace
+
+HostThreadLaunch::HostThreadLaunch(TPFuncPtr func, cl_uint count,
+                                   void *userInfo)
+    : _launchLock(HostThreadTeam::Get().launchLock)
+{
+    HostThreadTeam::Get().Wake(func, count, userInfo);
+}
+
+HostThreadLaunch::~HostThreadLaunch()
+{
+    if (!_started) HostThreadTeam::Get().Release(true);
+    if (!_finished) Finish();
+}
+
+void HostThreadLaunch::Start()
+{
+    _startTime = HostThreadTeam::Get().Release(false);
+    _started = true;
+}
+
+cl_int HostThreadLaunch::Finish()
+{
+    if (!_finished)
+    {
+        _result = HostThreadTeam::Get().Wait(_startTime, _startDelays);
+        _finished = true;
+    }
+    return _result;
+}
@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HOST_THREADS_H_
+#define HOST_THREADS_H_
+
+#include "harness/ThreadPool.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+extern bool gHostThreadAffinity; // pin each host thread to its own CPU
+
+// Runs the host side of a test on dedicated threads instead of the shared
+// thread pool.  The threads are woken when the launch is constructed and spin
+// until Start() releases them all at once, so that they enter func together
+// right after the device work has been submitted.  A launch that is destroyed
+// before Start() never calls func.
+//
+// func is called with job_id and thread_id both set to the host thread index.
+// Only one launch may exist at a time; the constructor waits for the previous
+// one to be destroyed.
+class HostThreadLaunch {
+public:
+    HostThreadLaunch(TPFuncPtr func, cl_uint count, void *userInfo);
+    ~HostThreadLaunch();
+
+    HostThreadLaunch(const HostThreadLaunch &) = delete;
+    HostThreadLaunch &operator=(const HostThreadLaunch &) = delete;
+
+    void Start();
+
+    // Waits for all threads to return, and returns the first non-zero result
+    // of func, or CL_SUCCESS.
+    cl_int Finish();
+
+    // Time from Start() to the call of func on each thread, once finished.
+    const std::vector<std::chrono::nanoseconds> &StartDelays() const
+    {
+        return _startDelays;
+    }
+
+private:
+    std::unique_lock<std::mutex> _launchLock;
+    bool _started = false;
+    bool _finished = false;
+    std::chrono::steady_clock::time_point _startTime;
+    cl_int _result = CL_SUCCESS;
+    std::vector<std::chrono::nanoseconds> _startDelays;
+};
+
+#endif // HOST_THREADS_H_
@@ -29,6 +29,8 @@ bool gUseHostPtr = false; // use malloc/free with CL_MEM_USE_HOST_PTR instead of
 bool gDebug = false; // always print OpenCL kernel code
 int gInternalIterations = 10000; // internal test iterations for atomic operation, sufficient to verify atomicity
 int gMaxDeviceThreads = 1024; // maximum number of threads executed on OCL device
+int gHostThreads = 0; // number of host threads, 0 for one per CPU
+bool gHostThreadAffinity = false; // pin each host thread to its own CPU
 cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 bool gFloatAtomicsSupported = false;
@@ -213,7 +215,9 @@ int main(int argc, const char *argv[])
       log_info("  '-useHostPtr'              use malloc/free with CL_MEM_USE_HOST_PTR instead of clSVMAlloc/clSVMFree\n");
       log_info("  '-debug'                   always print OpenCL kernel code\n");
       log_info("  '-internalIterations <X>'  internal test iterations for atomic operation, sufficient to verify atomicity\n");
-      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device");
+      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device\n");
+      log_info("  '-hostThreads <X>'         number of host threads, 0 for one per CPU\n");
+      log_info("  '-hostThreadAffinity'      pin each host thread to its own CPU");
 
       break;
     }
@@ -266,6 +270,19 @@ int main(int argc, const char *argv[])
       argc--;
       noCert = true;
     }
+    else if(argc > 2 && std::string(argv[argc-2]) == "-hostThreads") // number of host threads, 0 for one per CPU
+    {
+      gHostThreads = atoi(argv[argc-1]);
+      if(gHostThreads < 0)
+      {
+        log_info("Invalid value: Number of host threads (%d) must be >= 0\n", gHostThreads);
+        return -1;
+      }
+      argc--;
+      noCert = true;
+    }
+    else if(std::string(argv[argc-1]) == "-hostThreadAffinity") // pin each host thread to its own CPU
+      gHostThreadAffinity = true;
     else
       break;
     argc--;
@@ -4515,6 +4515,8 @@ public:
                                   HostDataType>::MemoryOrderScopeStr;
     using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::UseSVM;
     using CBasicTestMemOrderScope<HostAtomicType, HostDataType>::LocalMemory;
+    using CBasicTestMemOrderScope<HostAtomicType,
+                                  HostDataType>::CollectingSources;
     CBasicTestFlag(TExplicitAtomicType dataType, bool useSVM)
         : CBasicTestMemOrderScope<HostAtomicType, HostDataType>(dataType,
                                                                 useSVM)
@@ -4555,9 +4557,11 @@ public:
             if (!LocalMemory()
                 && !(gAtomicFenceCap & CL_DEVICE_ATOMIC_SCOPE_DEVICE))
             {
-                log_info("Skipping atomic_flag test due to use of "
-                         "atomic_scope_device "
-                         "which is optionally not supported on this device\n");
+                if (!CollectingSources())
+                    log_info(
+                        "Skipping atomic_flag test due to use of "
+                        "atomic_scope_device "
+                        "which is optionally not supported on this device\n");
                 return 0; // skip test - not applicable
             }
         }
@@ -25,6 +25,7 @@
 #include <CL/cl_ext.h>
 
 #include "harness/conversions.h"
+#include "harness/halfConversions.h"
 #include "harness/mt19937.h"
 #include "harness/testHarness.h"
 #include "harness/typeWrappers.h"
@@ -178,7 +179,8 @@ template <typename T> inline float conv_to_flt(const T &val)
 template <typename T> inline half conv_to_half(const T &val)
 {
     if (std::is_floating_point<T>::value)
-        return cl_half_from_float(val, BaseFunctionTest::halfRoundingMode);
+        return half_from_float((float)val,
+                               BaseFunctionTest::halfRoundingMode);
     return 0;
 }
 
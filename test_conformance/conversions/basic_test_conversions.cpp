@@ -224,29 +224,6 @@ std::vector<double> DataInitInfo::specialValuesDouble = {
 };
 // clang-format on
 
-// Windows (since long double got deprecated) sets the x87 to 53-bit precision
-// (that's x87 default state).  This causes problems with the tests that
-// convert long and ulong to float and double or otherwise deal with values
-// that need more precision than 53-bit. So, set the x87 to 64-bit precision.
-static inline void Force64BitFPUPrecision(void)
-{
-#if __MINGW32__
-    // The usual method is to use _controlfp as follows:
-    //     #include <float.h>
-    //     _controlfp(_PC_64, _MCW_PC);
-    //
-    // _controlfp is available on MinGW32 but not on MinGW64. Instead of having
-    // divergent code just use inline assembly which works for both.
-    unsigned short int orig_cw = 0;
-    unsigned short int new_cw = 0;
-    __asm__ __volatile__("fstcw %0" : "=m"(orig_cw));
-    new_cw = orig_cw | 0x0300; // set precision to 64-bit
-    __asm__ __volatile__("fldcw  %0" ::"m"(new_cw));
-#else
-    /* Implement for other platforms if needed */
-#endif
-}
-
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
                                                                uint32_t count,
@@ -465,14 +442,45 @@ cl_int ConversionsTest::SetUp(int elements)
     return CL_SUCCESS;
 }
 
+// The number of tests of the conversions from inType to outType
+static int TestCountOfTypes(Type outType, Type inType)
+{
+    // skip longs on embedded
+    if (!gHasLong
+        && (inType == klong || outType == klong || inType == kulong
+            || outType == kulong))
+        return 0;
+
+    // saturated conversions to floating point types are not tested
+    if (outType == kfloat || outType == kdouble || outType == khalf)
+        return kRoundingModeCount;
+
+    return kSaturationModeCount * kRoundingModeCount;
+}
+
+// The number of the first test of the conversions from inType to outType.
+// Tests are numbered by output type, then input type, saturation and rounding
+// mode, independently of the order they run in.
+static int FirstTestNumber(Type outType, Type inType)
+{
+    int testNumber = 0;
+    for (int out = 0; out < outType; out++)
+        for (int in = 0; in < kTypeCount; in++)
+            testNumber += TestCountOfTypes((Type)out, (Type)in);
+    for (int in = 0; in < inType; in++)
+        testNumber += TestCountOfTypes(outType, (Type)in);
+    return testNumber;
+}
+
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 void ConversionsTest::TestTypesConversion(const Type &inType,
-                                          const Type &outType, int &testNumber,
+                                          const Type &outType,
+                                          ConversionBatch &batch,
                                           int startMinVectorSize)
 {
     SaturationMode sat;
     RoundingMode round;
-    int error;
+    int testNumber = FirstTestNumber(outType, inType) - 1;
 
     // skip longs on embedded
     if (!gHasLong
@@ -504,10 +512,6 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
                 if (gEndTestNumber > 0 && testNumber >= gEndTestNumber) return;
             }
 
-            vlog("%d) Testing convert_%sn%s%s( %sn ):\n", testNumber,
-                 gTypeNames[outType], gSaturationNames[sat],
-                 gRoundingModeNames[round], gTypeNames[inType]);
-
             // skip double if we don't have it
             if (!gTestDouble && (inType == kdouble || outType == kdouble))
             {
@@ -548,8 +552,8 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
                     gMinVectorSize = 0;
             }
 
-            if ((error = DoTest<InType, OutType, InFP, OutFP>(outType, inType,
-                                                              sat, round)))
+            if (AddTest<InType, OutType, InFP, OutFP>(batch, outType, sat,
+                                                      round, testNumber))
             {
                 vlog_error("\t *** %d) convert_%sn%s%s( %sn ) "
                            "FAILED ** \n",
@@ -565,27 +569,44 @@ template <typename InType, typename OutType, bool InFP, bool OutFP>
 int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
                             RoundingMode round)
 {
-#ifdef __APPLE__
-    cl_ulong wall_start = mach_absolute_time();
-#endif
+    ConversionBatch batch(inType);
+    int error;
+
+    if ((error = AddTest<InType, OutType, InFP, OutFP>(batch, outType, sat,
+                                                       round, -1)))
+        return error;
 
+    return RunBatch(batch);
+}
+
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+int ConversionsTest::AddTest(ConversionBatch &batch, Type outType,
+                             SaturationMode sat, RoundingMode round,
+                             int testNumber)
+{
+    Type inType = batch.inType;
     cl_uint threads = GetThreadCount();
 
     DataInitInfo info = { 0, 0, outType, inType, sat, round, threads };
-    DataInfoSpec<InType, OutType, InFP, OutFP> init_info(info);
-    WriteInputBufferInfo writeInputBufferInfo;
+    std::unique_ptr<ConversionCase> test(new ConversionCase());
+    auto *init_info = new DataInfoSpec<InType, OutType, InFP, OutFP>(info);
+    test->initInfo.reset(init_info);
+    WriteInputBufferInfo &writeInputBufferInfo = test->writeInputBufferInfo;
     int vectorSize;
     int error = 0;
-    uint64_t i;
+
+    test->outType = outType;
+    test->sat = sat;
+    test->round = round;
+    test->testNumber = testNumber;
+    test->minVectorSize = gMinVectorSize;
+    test->error = 0;
 
     gTestCount++;
-    size_t blockCount =
-        BUFFER_SIZE / std::max(gTypeSizes[inType], gTypeSizes[outType]);
-    size_t step = blockCount;
 
-    for (i = 0; i < threads; i++)
+    for (cl_uint i = 0; i < threads; i++)
     {
-        init_info.mdv.emplace_back(MTdataHolder(gRandomSeed));
+        init_info->mdv.emplace_back(MTdataHolder(gRandomSeed));
     }
 
     writeInputBufferInfo.outType = outType;
@@ -626,18 +647,210 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
     if (std::is_same<OutType, cl_float>::value)
     {
         if (round == kDefaultRoundingMode && gIsRTZ)
-            init_info.round = round = kRoundTowardZero;
+            init_info->round = kRoundTowardZero;
     }
     else if (std::is_same<OutType, cl_half>::value && OutFP)
     {
         if (round == kDefaultRoundingMode && gIsHalfRTZ)
-            init_info.round = round = kRoundTowardZero;
+            init_info->round = kRoundTowardZero;
+    }
+
+    batch.cases.push_back(std::move(test));
+
+    return error;
+}
+
+// Run the conversion test on the input block in gInBuffer and gIn. Returns
+// nonzero if the test could not be run; a failure of the test itself is
+// recorded in test.error.
+static int RunTestBlock(ConversionCase &test, cl_uint chunks, cl_uint count)
+{
+    WriteInputBufferInfo &writeInputBufferInfo = test.writeInputBufferInfo;
+    Type inType = writeInputBufferInfo.inType;
+    Type outType = test.outType;
+    int vectorSize;
+    int error;
+
+    writeInputBufferInfo.count = count;
+
+    // Crate a user event to represent the status of the reference value
+    // computation completion
+    writeInputBufferInfo.calcReferenceValues =
+        clCreateUserEvent(gContext, &error);
+    if (error || NULL == writeInputBufferInfo.calcReferenceValues)
+    {
+        vlog_error("ERROR: Unable to create user event. (%d)\n", error);
+        gFailCount++;
+        return error;
+    }
+
+    // retain for consumption by MapOutputBufferComplete
+    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
+    {
+        if ((error = clRetainEvent(writeInputBufferInfo.calcReferenceValues)))
+        {
+            vlog_error("ERROR: Unable to retain user event. (%d)\n", error);
+            gFailCount++;
+            return error;
+        }
+    }
+
+    // Crate a user event to represent when the callbacks are done verifying
+    // correctness
+    writeInputBufferInfo.doneBarrier = clCreateUserEvent(gContext, &error);
+    if (error || NULL == writeInputBufferInfo.doneBarrier)
+    {
+        vlog_error("ERROR: Unable to create user event for barrier. (%d)\n",
+                   error);
+        gFailCount++;
+        return error;
+    }
+
+    // retain for use by the callback that calls this
+    if ((error = clRetainEvent(writeInputBufferInfo.doneBarrier)))
+    {
+        vlog_error("ERROR: Unable to retain user event doneBarrier. (%d)\n",
+                   error);
+        gFailCount++;
+        return error;
+    }
+
+    // The input is already on the device: enqueue the rest of the work.
+    conv_test::WriteInputBufferComplete((void *)&writeInputBufferInfo);
+
+    // Make sure the work is actually running, so we don't deadlock
+    if ((error = clFlush(gQueue)))
+    {
+        vlog_error("clFlush failed with error %d\n", error);
+        gFailCount++;
+        return error;
+    }
+
+    ThreadPool_Do(conv_test::PrepareReference, chunks, test.initInfo.get());
+
+    // signal we are done calculating the reference results
+    if ((error = clSetUserEventStatus(writeInputBufferInfo.calcReferenceValues,
+                                      CL_COMPLETE)))
+    {
+        vlog_error(
+            "Error:  Failed to set user event status to CL_COMPLETE:  %d\n",
+            error);
+        gFailCount++;
+        return error;
+    }
+
+    // Wait for the event callbacks to finish verifying correctness.
+    if ((error = clWaitForEvents(
+             1, (cl_event *)&writeInputBufferInfo.doneBarrier)))
+    {
+        vlog_error("Error:  Failed to wait for barrier:  %d\n", error);
+        gFailCount++;
+        return error;
+    }
+
+    if ((error = clReleaseEvent(writeInputBufferInfo.calcReferenceValues)))
+    {
+        vlog_error("Error:  Failed to release calcReferenceValues:  %d\n",
+                   error);
+        gFailCount++;
+        return error;
+    }
+
+    if ((error = clReleaseEvent(writeInputBufferInfo.doneBarrier)))
+    {
+        vlog_error("Error:  Failed to release done barrier:  %d\n", error);
+        gFailCount++;
+        return error;
     }
 
+    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
+    {
+        if ((error = writeInputBufferInfo.calcInfo[vectorSize]->result))
+        {
+            switch (inType)
+            {
+                case kuchar:
+                case kchar:
+                    vlog("Input value: 0x%2.2x ",
+                         ((unsigned char *)gIn)[error - 1]);
+                    break;
+                case kushort:
+                case kshort:
+                    vlog("Input value: 0x%4.4x ",
+                         ((unsigned short *)gIn)[error - 1]);
+                    break;
+                case kuint:
+                case kint:
+                    vlog("Input value: 0x%8.8x ",
+                         ((unsigned int *)gIn)[error - 1]);
+                    break;
+                case khalf:
+                    vlog("Input value: %a ", HTF(((cl_half *)gIn)[error - 1]));
+                    break;
+                case kfloat:
+                    vlog("Input value: %a ", ((float *)gIn)[error - 1]);
+                    break;
+                case kulong:
+                case klong:
+                    vlog("Input value: 0x%16.16llx ",
+                         ((unsigned long long *)gIn)[error - 1]);
+                    break;
+                case kdouble:
+                    vlog("Input value: %a ", ((double *)gIn)[error - 1]);
+                    break;
+                default:
+                    vlog_error("Internal error at %s: %d\n", __FILE__,
+                               __LINE__);
+                    abort();
+                    break;
+            }
+
+            // tell the user which conversion it was.
+            if (0 == vectorSize)
+                vlog(" (implicit scalar conversion from %s to %s)\n",
+                     gTypeNames[inType], gTypeNames[outType]);
+            else
+                vlog(" (convert_%s%s%s%s( %s%s ))\n", gTypeNames[outType],
+                     sizeNames[vectorSize], gSaturationNames[test.sat],
+                     gRoundingModeNames[test.round], gTypeNames[inType],
+                     sizeNames[vectorSize]);
+
+            gFailCount++;
+            test.error = error;
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+int ConversionsTest::RunBatch(ConversionBatch &batch)
+{
+    if (batch.cases.empty()) return 0;
+
+#ifdef __APPLE__
+    cl_ulong wall_start = mach_absolute_time();
+#endif
+
+    Type inType = batch.inType;
+    cl_uint threads = GetThreadCount();
+    int startMinVectorSize = gMinVectorSize;
+    int error = 0;
+    uint64_t i;
+
+    // All the tests share the input blocks, so the blocks are sized for the
+    // largest output type of the batch.
+    size_t outTypeSize = 0;
+    for (const auto &test : batch.cases)
+        outTypeSize = std::max(outTypeSize, gTypeSizes[test->outType]);
+    size_t blockCount = BUFFER_SIZE / std::max(gTypeSizes[inType], outTypeSize);
+    size_t step = blockCount;
+    size_t blockSize = blockCount * gTypeSizes[inType];
+
     uint64_t nbInputs = (1ULL << 25);
-    if constexpr (sizeof(InType) <= 2)
+    if (gTypeSizes[inType] <= 2)
     {
-        nbInputs = (1ULL << (sizeof(InType) * 8));
+        nbInputs = (1ULL << (gTypeSizes[inType] * 8));
     }
     else
     {
@@ -661,7 +874,25 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
     // the wimpy or embedded reduction factor.
     nbInputs = std::max(nbInputs, (uint64_t)step);
 
-    vlog("Testing... ");
+    //      Call this in a multithreaded manner
+    cl_uint chunks = RoundUpToNextPowerOfTwo(threads) * 2;
+    cl_uint chunkSize = blockCount / chunks;
+    if (chunkSize < 16384)
+    {
+        chunks = RoundUpToNextPowerOfTwo(threads);
+        chunkSize = blockCount / chunks;
+        if (chunkSize < 16384)
+        {
+            chunkSize = blockCount;
+            chunks = 1;
+        }
+    }
+
+    // The unclamped input block, kept while gIn holds a clamped copy of it
+    std::vector<cl_uchar> unclamped(blockSize);
+
+    vlog("Testing %zu conversions from %s... ", batch.cases.size(),
+         gTypeNames[inType]);
     fflush(stdout);
     for (i = 0; i < (uint64_t)nbInputs; i += step)
     {
@@ -672,201 +903,99 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             fflush(stdout);
         }
 
-        writeInputBufferInfo.count =
-            std::min((uint64_t)blockCount, nbInputs - i);
+        cl_uint count = std::min((uint64_t)blockCount, nbInputs - i);
 
-        // Crate a user event to represent the status of the reference value
-        // computation completion
-        writeInputBufferInfo.calcReferenceValues =
-            clCreateUserEvent(gContext, &error);
-        if (error || NULL == writeInputBufferInfo.calcReferenceValues)
-        {
-            vlog_error("ERROR: Unable to create user event. (%d)\n", error);
-            gFailCount++;
-            return error;
-        }
+        // input and clamp keys of the data in gIn and gInBuffer
+        bool resident = false;
+        int inputKey = 0;
+        int clampKey = -1;
 
-        // retain for consumption by MapOutputBufferComplete
-        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
-             vectorSize++)
+        for (const auto &test : batch.cases)
         {
-            if ((error =
-                     clRetainEvent(writeInputBufferInfo.calcReferenceValues)))
-            {
-                vlog_error("ERROR: Unable to retain user event. (%d)\n", error);
-                gFailCount++;
-                return error;
-            }
-        }
+            if (test->error) continue;
 
-        // Crate a user event to represent when the callbacks are done verifying
-        // correctness
-        writeInputBufferInfo.doneBarrier = clCreateUserEvent(gContext, &error);
-        if (error || NULL == writeInputBufferInfo.doneBarrier)
-        {
-            vlog_error("ERROR: Unable to create user event for barrier. (%d)\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
+            DataInitBase *init_info = test->initInfo.get();
+            bool write = false;
 
-        // retain for use by the callback that calls this
-        if ((error = clRetainEvent(writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("ERROR: Unable to retain user event doneBarrier. (%d)\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
+            init_info->start = i;
+            init_info->size = chunkSize;
 
-        //      Call this in a multithreaded manner
-        cl_uint chunks = RoundUpToNextPowerOfTwo(threads) * 2;
-        init_info.start = i;
-        init_info.size = blockCount / chunks;
-        if (init_info.size < 16384)
-        {
-            chunks = RoundUpToNextPowerOfTwo(threads);
-            init_info.size = blockCount / chunks;
-            if (init_info.size < 16384)
+            if (!resident || init_info->input_key() != inputKey)
             {
-                init_info.size = blockCount;
-                chunks = 1;
+                ThreadPool_Do(conv_test::InitData, chunks, init_info);
+                inputKey = init_info->input_key();
+                clampKey = -1;
+                write = true;
             }
-        }
-
-        ThreadPool_Do(conv_test::InitData, chunks, &init_info);
-
-        // Copy the results to the device
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_TRUE, 0,
-                                          blockCount * gTypeSizes[inType], gIn,
-                                          0, NULL, NULL)))
-        {
-            vlog_error("ERROR: clEnqueueWriteBuffer failed. (%d)\n", error);
-            gFailCount++;
-            return error;
-        }
-
-        // Call completion callback for the write, which will enqueue the rest
-        // of the work.
-        conv_test::WriteInputBufferComplete((void *)&writeInputBufferInfo);
-
-        // Make sure the work is actually running, so we don't deadlock
-        if ((error = clFlush(gQueue)))
-        {
-            vlog_error("clFlush failed with error %d\n", error);
-            gFailCount++;
-            return error;
-        }
 
-        ThreadPool_Do(conv_test::PrepareReference, chunks, &init_info);
-
-        // signal we are done calculating the reference results
-        if ((error = clSetUserEventStatus(
-                 writeInputBufferInfo.calcReferenceValues, CL_COMPLETE)))
-        {
-            vlog_error(
-                "Error:  Failed to set user event status to CL_COMPLETE:  %d\n",
-                error);
-            gFailCount++;
-            return error;
-        }
-
-        // Wait for the event callbacks to finish verifying correctness.
-        if ((error = clWaitForEvents(
-                 1, (cl_event *)&writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("Error:  Failed to wait for barrier:  %d\n", error);
-            gFailCount++;
-            return error;
-        }
-
-        if ((error = clReleaseEvent(writeInputBufferInfo.calcReferenceValues)))
-        {
-            vlog_error("Error:  Failed to release calcReferenceValues:  %d\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
+            if (init_info->clamp_key() != clampKey)
+            {
+                if (clampKey < 0)
+                    memcpy(unclamped.data(), gIn, blockSize);
+                else
+                    memcpy(gIn, unclamped.data(), blockSize);
 
-        if ((error = clReleaseEvent(writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("Error:  Failed to release done barrier:  %d\n", error);
-            gFailCount++;
-            return error;
-        }
+                if (init_info->clamp_key() >= 0)
+                    ThreadPool_Do(conv_test::ClampData, chunks, init_info);
+                clampKey = init_info->clamp_key();
+                write = true;
+            }
 
-        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
-             vectorSize++)
-        {
-            if ((error = writeInputBufferInfo.calcInfo[vectorSize]->result))
+            // Copy the input to the device, for this test and the following
+            // ones with the same input.
+            if (write)
             {
-                switch (inType)
+                if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_TRUE, 0,
+                                                  blockSize, gIn, 0, NULL,
+                                                  NULL)))
                 {
-                    case kuchar:
-                    case kchar:
-                        vlog("Input value: 0x%2.2x ",
-                             ((unsigned char *)gIn)[error - 1]);
-                        break;
-                    case kushort:
-                    case kshort:
-                        vlog("Input value: 0x%4.4x ",
-                             ((unsigned short *)gIn)[error - 1]);
-                        break;
-                    case kuint:
-                    case kint:
-                        vlog("Input value: 0x%8.8x ",
-                             ((unsigned int *)gIn)[error - 1]);
-                        break;
-                    case khalf:
-                        vlog("Input value: %a ",
-                             HTF(((cl_half *)gIn)[error - 1]));
-                        break;
-                    case kfloat:
-                        vlog("Input value: %a ", ((float *)gIn)[error - 1]);
-                        break;
-                    case kulong:
-                    case klong:
-                        vlog("Input value: 0x%16.16llx ",
-                             ((unsigned long long *)gIn)[error - 1]);
-                        break;
-                    case kdouble:
-                        vlog("Input value: %a ", ((double *)gIn)[error - 1]);
-                        break;
-                    default:
-                        vlog_error("Internal error at %s: %d\n", __FILE__,
-                                   __LINE__);
-                        abort();
-                        break;
+                    vlog_error("ERROR: clEnqueueWriteBuffer failed. (%d)\n",
+                               error);
+                    gFailCount++;
+                    gMinVectorSize = startMinVectorSize;
+                    return error;
                 }
+                resident = true;
+            }
 
-                // tell the user which conversion it was.
-                if (0 == vectorSize)
-                    vlog(" (implicit scalar conversion from %s to %s)\n",
-                         gTypeNames[inType], gTypeNames[outType]);
-                else
-                    vlog(" (convert_%s%s%s%s( %s%s ))\n", gTypeNames[outType],
-                         sizeNames[vectorSize], gSaturationNames[sat],
-                         gRoundingModeNames[round], gTypeNames[inType],
-                         sizeNames[vectorSize]);
-
-                gFailCount++;
+            gMinVectorSize = test->minVectorSize;
+            if ((error = RunTestBlock(*test, chunks, count)))
+            {
+                gMinVectorSize = startMinVectorSize;
                 return error;
             }
         }
     }
+    gMinVectorSize = startMinVectorSize;
 
     log_info("done.\n");
 
-    if (gWimpyMode)
-        vlog("\tWimp pass");
-    else
-        vlog("\tpassed");
+    for (const auto &test : batch.cases)
+    {
+        if (test->error)
+        {
+            error = test->error;
+            if (test->testNumber >= 0)
+                vlog_error("\t *** %d) convert_%sn%s%s( %sn ) FAILED ** \n",
+                           test->testNumber, gTypeNames[test->outType],
+                           gSaturationNames[test->sat],
+                           gRoundingModeNames[test->round],
+                           gTypeNames[inType]);
+        }
+        else
+        {
+            if (test->testNumber >= 0) vlog("%d) ", test->testNumber);
+            vlog("convert_%sn%s%s( %sn ):\t%s\n", gTypeNames[test->outType],
+                 gSaturationNames[test->sat], gRoundingModeNames[test->round],
+                 gTypeNames[inType], gWimpyMode ? "Wimp pass" : "passed");
+        }
+    }
 
 #ifdef __APPLE__
     // record the run time
     vlog("\t(%f s)", 1e-9 * (mach_absolute_time() - wall_start));
 #endif
-    vlog("\n\n");
+    vlog("\n");
     fflush(stdout);
 
     return error;
@@ -1097,6 +1226,15 @@ cl_int InitData(cl_uint job_id, cl_uint thread_id, void *p)
     return CL_SUCCESS;
 }
 
+cl_int ClampData(cl_uint job_id, cl_uint thread_id, void *p)
+{
+    DataInitBase *info = (DataInitBase *)p;
+
+    info->clamp_input(job_id);
+
+    return CL_SUCCESS;
+}
+
 cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
 {
     DataInitBase *info = (DataInitBase *)p;
@@ -1104,9 +1242,8 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
     cl_uint count = info->size;
     Type inType = info->inType;
     Type outType = info->outType;
-    RoundingMode round = info->round;
-
-    Force64BitFPUPrecision();
+    RoundingMode round = conv_ref::resolve_rounding(
+        info->round, outType, ConversionsTest::defaultHalfRoundingMode);
 
     void *s = (cl_uchar *)gIn + job_id * count * gTypeSizes[info->inType];
     void *a = (cl_uchar *)gAllowZ + job_id * count;
@@ -1114,48 +1251,15 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
 
     if (outType != inType)
     {
-        // create the reference while we wait
-#if (defined(__arm__) || defined(__aarch64__)) && defined(__GNUC__)
-        /* ARM VFP doesn't have hardware instruction for converting from 64-bit
-         * integer to float types, hence GCC ARM uses the floating-point
-         * emulation code despite which -mfloat-abi setting it is. But the
-         * emulation code in libgcc.a has only one rounding mode (round to
-         * nearest even in this case) and ignores the user rounding mode setting
-         * in hardware. As a result setting rounding modes in hardware won't
-         * give correct rounding results for type covert from 64-bit integer to
-         * float using GCC for ARM compiler so for testing different rounding
-         * modes, we need to use alternative reference function. ARM64 does have
-         * an instruction, however we cannot guarantee the compiler will use it.
-         * On all ARM architechures use emulation to calculate reference.*/
-        switch (round)
-        {
-            /* conversions to floating-point type use the current rounding mode.
-             * The only default floating-point rounding mode supported is round
-             * to nearest even i.e the current rounding mode will be _rte for
-             * floating-point types. */
-            case kDefaultRoundingMode: qcom_rm = qcomRTE; break;
-            case kRoundToNearestEven: qcom_rm = qcomRTE; break;
-            case kRoundUp: qcom_rm = qcomRTP; break;
-            case kRoundDown: qcom_rm = qcomRTN; break;
-            case kRoundTowardZero: qcom_rm = qcomRTZ; break;
-            default:
-                vlog_error("ERROR: undefined rounding mode %d\n", round);
-                break;
-        }
-        qcom_sat = info->sat;
-#endif
-
-        RoundingMode oldRound;
+        // create the reference while we wait.  The rounding mode of the
+        // reference conversions is a template parameter, so the rounding mode
+        // of the host FPU is left alone; the half rounding mode is still used
+        // by the clamping of the input data.
         if (outType == khalf)
         {
-            oldRound = set_round(kRoundToNearestEven, kfloat);
             switch (round)
             {
                 default:
-                case kDefaultRoundingMode:
-                    DataInitInfo::halfRoundingMode =
-                        ConversionsTest::defaultHalfRoundingMode;
-                    break;
                 case kRoundToNearestEven:
                     DataInitInfo::halfRoundingMode = CL_HALF_RTE;
                     break;
@@ -1170,15 +1274,11 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
                     break;
             }
         }
-        else
-            oldRound = set_round(round, outType);
 
         if (info->sat)
-            info->conv_array_sat(d, s, count);
+            info->conv_array_sat(d, s, count, round);
         else
-            info->conv_array(d, s, count);
-
-        set_round(oldRound, outType);
+            info->conv_array(d, s, count, round);
 
         // Decide if we allow a zero result in addition to the correctly rounded
         // one
@@ -117,6 +117,7 @@ int GetTestCase(const char *name, Type *outType, Type *inType,
                 SaturationMode *sat, RoundingMode *round);
 
 cl_int InitData(cl_uint job_id, cl_uint thread_id, void *p);
+cl_int ClampData(cl_uint job_id, cl_uint thread_id, void *p);
 cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p);
 uint64_t GetTime(void);
 
@@ -163,6 +164,31 @@ struct WriteInputBufferInfo
     std::vector<std::unique_ptr<CalcRefValsBase>> calcInfo;
 };
 
+// A conversion test of a ConversionBatch
+struct ConversionCase
+{
+    Type outType; // the data type of the conversion result
+    SaturationMode sat;
+    RoundingMode round; // the rounding mode of the tested conversion
+    int testNumber; // -1 for tests selected on the command line
+    int minVectorSize; // gMinVectorSize for this test
+    int error; // nonzero once the test failed
+
+    std::unique_ptr<DataInitBase> initInfo;
+    WriteInputBufferInfo writeInputBufferInfo;
+};
+
+// The conversion tests from one input type.  Each block of input data is
+// generated and written to gInBuffer once, and the kernels and reference
+// values of all the tests sharing that data run against the resident buffer.
+struct ConversionBatch
+{
+    explicit ConversionBatch(Type inType): inType(inType) {}
+
+    Type inType;
+    std::vector<std::unique_ptr<ConversionCase>> cases;
+};
+
 // Must be aligned with Type enums!
 using TypeIter =
     std::tuple<cl_uchar, cl_char, cl_ushort, cl_short, cl_uint, cl_int, cl_half,
@@ -189,9 +215,16 @@ struct ConversionsTest
     int DoTest(Type outType, Type inType, SaturationMode sat,
                RoundingMode round);
 
+    // Add the conversions from InType to OutType to the batch
+    template <typename InType, typename OutType, bool InFP, bool OutFP>
+    void TestTypesConversion(const Type &inType, const Type &outType,
+                             ConversionBatch &batch, int startMinVectorSize);
+
     template <typename InType, typename OutType, bool InFP, bool OutFP>
-    void TestTypesConversion(const Type &inType, const Type &outType, int &tn,
-                             int startMinVectorSize);
+    int AddTest(ConversionBatch &batch, Type outType, SaturationMode sat,
+                RoundingMode round, int testNumber);
+
+    int RunBatch(ConversionBatch &batch);
 
 protected:
     cl_context context;
@@ -250,28 +283,34 @@ struct TestType
     }
 };
 
-// Helper structures to iterate over all tuple attributes of different types
+// Helper structures to iterate over all tuple attributes of different types.
+// The conversions are batched by input type.
 struct IterOverTypes : public TestType
 {
     IterOverTypes(const TypeIter &typeIter, ConversionsTest &test)
         : inType((Type)0), outType((Type)0), typeIter(typeIter), test(test),
-          testNumber(-1), startMinVectorSize(gMinVectorSize)
+          batch((Type)0), startMinVectorSize(gMinVectorSize)
     {}
 
-    void Run() { for_each_out_elem(typeIter); }
+    void Run() { for_each_in_elem(typeIter); }
 
 protected:
-    template <std::size_t Out = 0, typename OutType>
-    void iterate_out_type(const OutType &t)
+    template <std::size_t In = 0, typename InType>
+    void iterate_in_type(const InType &t)
     {
-        for_each_in_elem<0, Out, OutType>(typeIter);
-        outType = (Type)(outType + 1);
-        inType = (Type)0;
+        batch.inType = inType;
+        for_each_out_elem<0, In, InType>(typeIter);
+
+        // run the conversions
+        test.RunBatch(batch);
+        batch.cases.clear();
+        inType = (Type)(inType + 1);
+        outType = (Type)0;
     }
 
-    template <std::size_t In, std::size_t Out, typename OutType,
-              typename InType>
-    void iterate_in_type(const InType &t)
+    template <std::size_t Out, std::size_t In, typename InType,
+              typename OutType>
+    void iterate_out_type(const OutType &t)
     {
         if (!testType<InType, isTypeFp[In]>(inType))
             vlog_error("Unexpected data type!\n");
@@ -279,40 +318,39 @@ protected:
         if (!testType<OutType, isTypeFp[Out]>(outType))
             vlog_error("Unexpected data type!\n");
 
-        // run the conversions
         test.TestTypesConversion<InType, OutType, isTypeFp[In], isTypeFp[Out]>(
-            inType, outType, testNumber, startMinVectorSize);
-        inType = (Type)(inType + 1);
+            inType, outType, batch, startMinVectorSize);
+        outType = (Type)(outType + 1);
     }
 
-    template <std::size_t Out = 0, typename... Tp>
-    inline typename std::enable_if<Out == sizeof...(Tp), void>::type
-    for_each_out_elem(
+    template <std::size_t In = 0, typename... Tp>
+    inline typename std::enable_if<In == sizeof...(Tp), void>::type
+    for_each_in_elem(
         const std::tuple<Tp...> &) // Unused arguments are given no names.
     {}
 
-    template <std::size_t Out = 0, typename... Tp>
-        inline typename std::enable_if < Out<sizeof...(Tp), void>::type
-        for_each_out_elem(const std::tuple<Tp...> &t)
+    template <std::size_t In = 0, typename... Tp>
+        inline typename std::enable_if < In<sizeof...(Tp), void>::type
+        for_each_in_elem(const std::tuple<Tp...> &t)
     {
-        iterate_out_type<Out>(std::get<Out>(t));
-        for_each_out_elem<Out + 1, Tp...>(t);
+        iterate_in_type<In>(std::get<In>(t));
+        for_each_in_elem<In + 1, Tp...>(t);
     }
 
-    template <std::size_t In = 0, std::size_t Out, typename OutType,
+    template <std::size_t Out = 0, std::size_t In, typename InType,
               typename... Tp>
-    inline typename std::enable_if<In == sizeof...(Tp), void>::type
-    for_each_in_elem(
+    inline typename std::enable_if<Out == sizeof...(Tp), void>::type
+    for_each_out_elem(
         const std::tuple<Tp...> &) // Unused arguments are given no names.
     {}
 
-    template <std::size_t In = 0, std::size_t Out, typename OutType,
+    template <std::size_t Out = 0, std::size_t In, typename InType,
               typename... Tp>
-        inline typename std::enable_if < In<sizeof...(Tp), void>::type
-        for_each_in_elem(const std::tuple<Tp...> &t)
+        inline typename std::enable_if < Out<sizeof...(Tp), void>::type
+        for_each_out_elem(const std::tuple<Tp...> &t)
     {
-        iterate_in_type<In, Out, OutType>(std::get<In>(t));
-        for_each_in_elem<In + 1, Out, OutType, Tp...>(t);
+        iterate_out_type<Out, In, InType>(std::get<Out>(t));
+        for_each_out_elem<Out + 1, In, InType, Tp...>(t);
     }
 
 protected:
@@ -320,7 +358,7 @@ protected:
     Type outType;
     const TypeIter &typeIter;
     ConversionsTest &test;
-    int testNumber;
+    ConversionBatch batch;
     int startMinVectorSize;
 };
 
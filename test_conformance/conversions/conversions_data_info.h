@@ -22,12 +22,6 @@
 #include <CL/opencl.h>
 #endif
 
-#if (defined(__arm__) || defined(__aarch64__)) && defined(__GNUC__)
-#include "fplib.h"
-extern bool qcom_sat;
-extern roundingMode qcom_rm;
-#endif
-
 #include <CL/cl_half.h>
 
 #include "harness/conversions.h"
@@ -35,6 +29,8 @@ extern roundingMode qcom_rm;
 #include "harness/rounding_mode.h"
 #include "harness/typeWrappers.h"
 
+#include "conversions_reference.h"
+
 #include <climits>
 #include <cmath>
 #include <vector>
@@ -84,9 +80,18 @@ struct DataInitBase : public DataInitInfo
     virtual ~DataInitBase() = default;
 
     explicit DataInitBase(const DataInitInfo &agg): DataInitInfo(agg) {}
-    virtual void conv_array(void *out, void *in, size_t n) {}
-    virtual void conv_array_sat(void *out, void *in, size_t n) {}
+    virtual void conv_array(void *out, void *in, size_t n, RoundingMode round)
+    {}
+    virtual void conv_array_sat(void *out, void *in, size_t n,
+                                RoundingMode round)
+    {}
     virtual void init(const cl_uint &, const cl_uint &) {}
+    virtual void clamp_input(const cl_uint &) {}
+    // init() generates the same input data for tests of an input type with
+    // equal input keys; the clamp key tells which clamping clamp_input() does
+    // on it, -1 for none.
+    virtual int input_key() const { return 0; }
+    virtual int clamp_key() const { return -1; }
     virtual void set_allow_zero_array(uint8_t *allow, void *out, void *in,
                                       size_t n)
     {}
@@ -342,16 +347,6 @@ struct DataInfoSpec : public DataInitBase
 {
     explicit DataInfoSpec(const DataInitInfo &agg);
 
-    // helpers
-    float round_to_int(float f);
-    long long round_to_int_and_clamp(double d);
-
-    OutType absolute(const OutType &x);
-
-    // actual conversion of reference values
-    void conv(OutType *out, InType *in);
-    void conv_sat(OutType *out, InType *in);
-
     // Decide if we allow a zero result in addition to the correctly rounded one
     void set_allow_zero(uint8_t *allow, OutType *out, InType *in);
 
@@ -373,19 +368,38 @@ struct DataInfoSpec : public DataInitBase
         return (std::is_same<OutType, cl_half>::value && OutFP);
     }
 
-    void conv_array(void *out, void *in, size_t n) override
+    // Reference values, in the rounding mode round resolved by
+    // conv_ref::resolve_rounding
+    void conv_array(void *out, void *in, size_t n, RoundingMode round) override
     {
-        for (size_t i = 0; i < n; i++)
-            conv(&((OutType *)out)[i], &((InType *)in)[i]);
+        conv_ref::convert_array<InType, OutType, InFP, OutFP>(out, in, n, round,
+                                                              false);
     }
 
-    void conv_array_sat(void *out, void *in, size_t n) override
+    void conv_array_sat(void *out, void *in, size_t n,
+                        RoundingMode round) override
     {
-        for (size_t i = 0; i < n; i++)
-            conv_sat(&((OutType *)out)[i], &((InType *)in)[i]);
+        conv_ref::convert_array<InType, OutType, InFP, OutFP>(out, in, n, round,
+                                                              true);
     }
 
     void init(const cl_uint &, const cl_uint &) override;
+    void clamp_input(const cl_uint &) override;
+    int input_key() const override
+    {
+        // the special values of floating point inputs depend on the output
+        return std::is_floating_point<InType>::value ? (int)outType : 0;
+    }
+    int clamp_key() const override
+    {
+        // unsaturated conversions to integers are tested with inputs in the
+        // range of the output type, as rounded in the rounding mode
+        return kUnsaturated == sat
+                && (std::is_floating_point<InType>::value || is_in_half())
+                && std::is_integral<OutType>::value && !OutFP
+            ? (int)outType * kRoundingModeCount + (int)round
+            : -1;
+    }
     void set_allow_zero_array(uint8_t *allow, void *out, void *in,
                               size_t n) override
     {
@@ -581,407 +595,11 @@ DataInfoSpec<InType, OutType, InFP, OutFP>::DataInfoSpec(
     // clang-format on
 }
 
-template <typename InType, typename OutType, bool InFP, bool OutFP>
-float DataInfoSpec<InType, OutType, InFP, OutFP>::round_to_int(float f)
-{
-    static const float magic[2] = { MAKE_HEX_FLOAT(0x1.0p23f, 0x1, 23),
-                                    -MAKE_HEX_FLOAT(0x1.0p23f, 0x1, 23) };
-
-    // Round fractional values to integer in round towards nearest mode
-    if (fabsf(f) < MAKE_HEX_FLOAT(0x1.0p23f, 0x1, 23))
-    {
-        volatile float x = f;
-        float magicVal = magic[f < 0];
-
-#if defined(__SSE__) || _M_IX86_FP == 1
-        // Defeat x87 based arithmetic, which cant do FTZ, and will round this
-        // incorrectly
-        __m128 v = _mm_set_ss(x);
-        __m128 m = _mm_set_ss(magicVal);
-        v = _mm_add_ss(v, m);
-        v = _mm_sub_ss(v, m);
-        _mm_store_ss((float *)&x, v);
-#else
-        x += magicVal;
-        x -= magicVal;
-#endif
-        f = x;
-    }
-    return f;
-}
-
-template <typename InType, typename OutType, bool InFP, bool OutFP>
-long long
-DataInfoSpec<InType, OutType, InFP, OutFP>::round_to_int_and_clamp(double f)
-{
-    static const double magic[2] = { MAKE_HEX_DOUBLE(0x1.0p52, 0x1LL, 52),
-                                     MAKE_HEX_DOUBLE(-0x1.0p52, -0x1LL, 52) };
-
-    if (std::isnan(f)) return 0;
-
-    if (f >= -(double)LLONG_MIN) return LLONG_MAX;
-
-    if (f <= (double)LLONG_MIN) return LLONG_MIN;
-
-    // Round fractional values to integer in round towards nearest mode
-    if (fabs(f) < MAKE_HEX_DOUBLE(0x1.0p52, 0x1LL, 52))
-    {
-        volatile double x = f;
-        double magicVal = magic[f < 0];
-#if defined(__SSE2__) || _M_IX86_FP == 2 || defined(_M_X64)
-        // Defeat x87 based arithmetic, which cant do FTZ, and will round this
-        // incorrectly
-        __m128d v = _mm_set_sd(x);
-        __m128d m = _mm_set_sd(magicVal);
-        v = _mm_add_sd(v, m);
-        v = _mm_sub_sd(v, m);
-        _mm_store_sd((double *)&x, v);
-#else
-        x += magicVal;
-        x -= magicVal;
-#endif
-        f = x;
-    }
-    return (long long)f;
-}
-
-template <typename InType, typename OutType, bool InFP, bool OutFP>
-OutType DataInfoSpec<InType, OutType, InFP, OutFP>::absolute(const OutType &x)
-{
-    union {
-        cl_uint u;
-        OutType f;
-    } u;
-    u.f = x;
-    if (std::is_same<OutType, float>::value)
-        u.u &= 0x7fffffff;
-    else if (std::is_same<OutType, double>::value)
-        u.u &= 0x7fffffffffffffffULL;
-    else
-        log_error("Unexpected argument type of DataInfoSpec::absolute");
-
-    return u.f;
-}
-
 template <typename T, bool fp> constexpr bool is_half()
 {
     return (std::is_same<cl_half, T>::value && fp);
 }
 
-template <typename InType, typename OutType, bool InFP, bool OutFP>
-void DataInfoSpec<InType, OutType, InFP, OutFP>::conv(OutType *out, InType *in)
-{
-    if (std::is_same<cl_float, InType>::value || is_in_half())
-    {
-        cl_float inVal = *in;
-        if (std::is_same<cl_half, InType>::value)
-        {
-            inVal = HTF(*in);
-        }
-
-        if (std::is_floating_point<OutType>::value)
-        {
-            *out = (OutType)inVal;
-        }
-        else if (is_out_half())
-        {
-            *out = HFF(*in);
-        }
-        else if (std::is_same<cl_ulong, OutType>::value)
-        {
-#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-            // VS2005 (at least) on x86 uses fistp to store the float as a
-            // 64-bit int. However, fistp stores it as a signed int, and some of
-            // the test values won't fit into a signed int. (These test values
-            // are >= 2^63.) The result on VS2005 is that these end up silently
-            // (at least by default settings) clamped to the max lowest ulong.
-            cl_float x = round_to_int(inVal);
-            if (x >= 9223372036854775808.0f)
-            {
-                x -= 9223372036854775808.0f;
-                ((cl_ulong *)out)[0] = x;
-                ((cl_ulong *)out)[0] += 9223372036854775808ULL;
-            }
-            else
-            {
-                ((cl_ulong *)out)[0] = x;
-            }
-#else
-            *out = round_to_int(inVal);
-#endif
-        }
-        else if (std::is_same<cl_long, OutType>::value)
-        {
-            *out = round_to_int_and_clamp(inVal);
-        }
-        else
-            *out = round_to_int(inVal);
-    }
-    else if (std::is_same<cl_double, InType>::value)
-    {
-        if (std::is_same<cl_float, OutType>::value)
-            *out = (OutType)*in;
-        else if (is_out_half())
-            *out = static_cast<OutType>(HFD(*in));
-        else
-            *out = rint(*in);
-    }
-    else if (std::is_same<cl_ulong, InType>::value
-             || std::is_same<cl_long, InType>::value)
-    {
-        if (std::is_same<cl_double, OutType>::value)
-        {
-#if defined(_M_IX86) || defined(_M_X64)
-            double result;
-
-            if (std::is_same<cl_ulong, InType>::value)
-            {
-                cl_ulong l = ((cl_ulong *)in)[0];
-                cl_long sl = ((cl_long)l < 0) ? (cl_long)((l >> 1) | (l & 1))
-                                              : (cl_long)l;
-#if defined(_M_X64)
-                _mm_store_sd(&result, _mm_cvtsi64_sd(_mm_setzero_pd(), sl));
-#else
-                result = sl;
-#endif
-                ((double *)out)[0] =
-                    (l == 0 ? 0.0 : (((cl_long)l < 0) ? result * 2.0 : result));
-            }
-            else
-            {
-                cl_long l = ((cl_long *)in)[0];
-#if defined(_M_X64)
-                _mm_store_sd(&result, _mm_cvtsi64_sd(_mm_setzero_pd(), l));
-#else
-                result = l;
-#endif
-                ((double *)out)[0] =
-                    (l == 0 ? 0.0 : result); // Per IEEE-754-2008 5.4.1, 0's
-                                             // always convert to +0.0
-            }
-#else
-            // Use volatile to prevent optimization by Clang compiler
-            volatile InType vi = *in;
-            *out = (vi == 0 ? 0.0 : static_cast<OutType>(vi));
-#endif
-        }
-        else if (std::is_same<cl_float, OutType>::value || is_out_half())
-        {
-            cl_float outVal = 0.f;
-
-#if defined(_MSC_VER) && defined(_M_X64)
-            float result;
-            if (std::is_same<cl_ulong, InType>::value)
-            {
-                cl_ulong l = ((cl_ulong *)in)[0];
-                cl_long sl = ((cl_long)l < 0) ? (cl_long)((l >> 1) | (l & 1))
-                                              : (cl_long)l;
-                _mm_store_ss(&result, _mm_cvtsi64_ss(_mm_setzero_ps(), sl));
-                outVal = (l == 0 ? 0.0f
-                                 : (((cl_long)l < 0) ? result * 2.0f : result));
-            }
-            else
-            {
-                cl_long l = ((cl_long *)in)[0];
-                _mm_store_ss(&result, _mm_cvtsi64_ss(_mm_setzero_ps(), l));
-                outVal = (l == 0 ? 0.0f : result); // Per IEEE-754-2008 5.4.1,
-                                                   // 0's always convert to +0.0
-            }
-#else
-            InType l = ((InType *)in)[0];
-#if (defined(__arm__) || defined(__aarch64__)) && defined(__GNUC__)
-            /* ARM VFP doesn't have hardware instruction for converting from
-             * 64-bit integer to float types, hence GCC ARM uses the
-             * floating-point emulation code despite which -mfloat-abi setting
-             * it is. But the emulation code in libgcc.a has only one rounding
-             * mode (round to nearest even in this case) and ignores the user
-             * rounding mode setting in hardware. As a result setting rounding
-             * modes in hardware won't give correct rounding results for type
-             * covert from 64-bit integer to float using GCC for ARM compiler so
-             * for testing different rounding modes, we need to use alternative
-             * reference function. ARM64 does have an instruction, however we
-             * cannot guarantee the compiler will use it.  On all ARM
-             * architechures use emulation to calculate reference.*/
-            if (std::is_same<cl_ulong, InType>::value)
-                outVal = qcom_u64_2_f32(l, qcom_sat, qcom_rm);
-            else
-                outVal = (l == 0 ? 0.0f : qcom_s64_2_f32(l, qcom_sat, qcom_rm));
-#else
-            outVal = (l == 0 ? 0.0f : (float)l); // Per IEEE-754-2008 5.4.1, 0's
-                                                 // always convert to +0.0
-#endif
-#endif
-
-            *out = std::is_same<cl_half, OutType>::value
-                ? static_cast<OutType>(HFF(outVal))
-                : outVal;
-        }
-        else
-        {
-            *out = (OutType)*in;
-        }
-    }
-    else
-    {
-        if (std::is_same<cl_float, OutType>::value)
-        {
-            // Use volatile to prevent optimization by Clang compiler
-            volatile InType vi = *in;
-            // Per IEEE-754-2008 5.4.1, 0 always converts to +0.0
-            *out = (vi == 0 ? 0.0f : vi);
-        }
-        else if (std::is_same<cl_double, OutType>::value)
-        {
-            // Per IEEE-754-2008 5.4.1, 0 always converts to +0.0
-            *out = (*in == 0 ? 0.0 : *in);
-        }
-        else if (is_out_half())
-            *out = static_cast<OutType>(HFF(*in == 0 ? 0.f : *in));
-        else
-        {
-            *out = (OutType)*in;
-        }
-    }
-}
-
-#define CLAMP(_lo, _x, _hi)                                                    \
-    ((_x) < (_lo) ? (_lo) : ((_x) > (_hi) ? (_hi) : (_x)))
-
-template <typename InType, typename OutType, bool InFP, bool OutFP>
-void DataInfoSpec<InType, OutType, InFP, OutFP>::conv_sat(OutType *out,
-                                                          InType *in)
-{
-    if (std::is_floating_point<InType>::value || is_in_half())
-    {
-        cl_float inVal = *in;
-        if (is_in_half()) inVal = HTF(*in);
-
-        if (std::is_floating_point<OutType>::value || is_out_half())
-        { // in half/float/double, out half/float/double
-            if (is_out_half())
-                *out = static_cast<OutType>(HFF(inVal));
-            else
-                *out = (OutType)(is_in_half() ? inVal : *in);
-        }
-        else if ((std::is_same<InType, cl_float>::value || is_in_half())
-                 && std::is_same<cl_ulong, OutType>::value)
-        {
-            cl_float x = round_to_int(is_in_half() ? HTF(*in) : *in);
-
-#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-            // VS2005 (at least) on x86 uses fistp to store the float as a
-            // 64-bit int. However, fistp stores it as a signed int, and some of
-            // the test values won't fit into a signed int. (These test values
-            // are >= 2^63.) The result on VS2005 is that these end up silently
-            // (at least by default settings) clamped to the max lowest ulong.
-            if (x >= 18446744073709551616.0f)
-            { // 2^64
-                *out = 0xFFFFFFFFFFFFFFFFULL;
-            }
-            else if (x < 0)
-            {
-                *out = 0;
-            }
-            else if (x >= 9223372036854775808.0f)
-            { // 2^63
-                x -= 9223372036854775808.0f;
-                *out = x;
-                *out += 9223372036854775808ULL;
-            }
-            else
-            {
-                *out = x;
-            }
-#else
-            *out = x >= MAKE_HEX_DOUBLE(0x1.0p64, 0x1LL, 64)
-                ? (OutType)0xFFFFFFFFFFFFFFFFULL
-                : x < 0 ? 0
-                        : (OutType)x;
-#endif
-        }
-        else if ((std::is_same<InType, cl_float>::value || is_in_half())
-                 && std::is_same<cl_long, OutType>::value)
-        {
-            cl_float f = round_to_int(is_in_half() ? HTF(*in) : *in);
-            *out = f >= MAKE_HEX_DOUBLE(0x1.0p63, 0x1LL, 63)
-                ? (OutType)0x7FFFFFFFFFFFFFFFULL
-                : f < MAKE_HEX_DOUBLE(-0x1.0p63, -0x1LL, 63)
-                ? (OutType)0x8000000000000000LL
-                : (OutType)f;
-        }
-        else if (std::is_same<InType, cl_double>::value
-                 && std::is_same<cl_ulong, OutType>::value)
-        {
-            InType f = rint(*in);
-            *out = f >= MAKE_HEX_DOUBLE(0x1.0p64, 0x1LL, 64)
-                ? (OutType)0xFFFFFFFFFFFFFFFFULL
-                : f < 0 ? 0
-                        : (OutType)f;
-        }
-        else if (std::is_same<InType, cl_double>::value
-                 && std::is_same<cl_long, OutType>::value)
-        {
-            InType f = rint(*in);
-            *out = f >= MAKE_HEX_DOUBLE(0x1.0p63, 0x1LL, 63)
-                ? (OutType)0x7FFFFFFFFFFFFFFFULL
-                : f < MAKE_HEX_DOUBLE(-0x1.0p63, -0x1LL, 63)
-                ? (OutType)0x8000000000000000LL
-                : (OutType)f;
-        }
-        else
-        { // in half/float/double, out char/uchar/short/ushort/int/uint
-            *out = CLAMP(ranges.first,
-                         round_to_int_and_clamp(is_in_half() ? inVal : *in),
-                         ranges.second);
-        }
-    }
-    else if (std::is_integral<InType>::value
-             && std::is_integral<OutType>::value)
-    {
-        if (is_out_half())
-        {
-            *out = std::is_signed<InType>::value
-                ? static_cast<OutType>(HFF((cl_float)*in))
-                : absolute(static_cast<OutType>(HFF((cl_float)*in)));
-        }
-        else
-        {
-            if ((std::is_signed<InType>::value
-                 && std::is_signed<OutType>::value)
-                || (!std::is_signed<InType>::value
-                    && !std::is_signed<OutType>::value))
-            {
-                if (sizeof(InType) <= sizeof(OutType))
-                {
-                    *out = (OutType)*in;
-                }
-                else
-                {
-                    *out = CLAMP(ranges.first, *in, ranges.second);
-                }
-            }
-            else
-            { // mixed signed/unsigned types
-                if (sizeof(InType) < sizeof(OutType))
-                {
-                    *out = (!std::is_signed<InType>::value)
-                        ? (OutType)*in
-                        : CLAMP(0, *in, ranges.second); // *in < 0 ? 0 : *in
-                }
-                else
-                { // bigger/equal mixed signed/unsigned types - always clamp
-                    *out = CLAMP(0, *in, ranges.second);
-                }
-            }
-        }
-    }
-    else
-    { // InType integral, OutType floating
-        *out = std::is_signed<InType>::value ? (OutType)*in
-                                             : absolute((OutType)*in);
-    }
-}
-
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 void DataInfoSpec<InType, OutType, InFP, OutFP>::set_allow_zero(uint8_t *allow,
                                                                 OutType *out,
@@ -1028,13 +646,6 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
         {
             o[i] = (uint16_t)(i + ulStart);
         }
-        if (is_in_half() && kUnsaturated == sat)
-        {
-            for (uint32_t i = 0; i < size; i++)
-            {
-                o[i] = clamp(o[i]);
-            }
-        }
     }
     else if constexpr (std::is_integral<InType>::value)
     {
@@ -1101,11 +712,6 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
                 o[i] = genrand_int32(mdv[thread_id]);
             }
         }
-
-        if (kUnsaturated == sat)
-        {
-            for (uint32_t i = 0; i < size; i++) of[i] = clamp(of[i]);
-        }
     }
     else if constexpr (std::is_same<InType, cl_double>::value)
     {
@@ -1122,14 +728,19 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
         {
             o[i] = genrand_int64(mdv[thread_id]);
         }
-
-        if (kUnsaturated == sat)
-        {
-            for (uint32_t i = 0; i < size; i++) od[i] = clamp(od[i]);
-        }
     }
 }
 
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+void DataInfoSpec<InType, OutType, InFP, OutFP>::clamp_input(
+    const cl_uint &job_id)
+{
+    if (clamp_key() < 0) return;
+
+    InType *o = (InType *)((char *)gIn + job_id * size * gTypeSizes[inType]);
+    for (uint32_t i = 0; i < size; i++) o[i] = clamp(o[i]);
+}
+
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 InType DataInfoSpec<InType, OutType, InFP, OutFP>::clamp(const InType &in)
 {
@@ -0,0 +1,400 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef CONVERSIONS_REFERENCE_H
+#define CONVERSIONS_REFERENCE_H
+
+#if defined(__APPLE__)
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <CL/cl_half.h>
+
+#include "harness/conversions.h"
+#include "harness/rounding_mode.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Reference conversions of the conversions test.  The rounding mode is a
+// template parameter and every rounding is done with exact integer and
+// floating-point operations, so the results do not depend on the rounding
+// mode, precision or conversion instructions of the host FPU, and are the same
+// on all hosts.
+
+namespace conv_ref {
+
+// Rounding mode of the reference of a conversion to outType, with the default
+// rounding mode resolved: round toward zero for conversions to integers, round
+// to nearest even for conversions to float and double, and the default
+// rounding mode of the device for conversions to half.
+inline RoundingMode resolve_rounding(RoundingMode round, Type outType,
+                                     cl_half_rounding_mode defaultHalfRounding)
+{
+    if (round != kDefaultRoundingMode) return round;
+    switch (outType)
+    {
+        case kfloat:
+        case kdouble: return kRoundToNearestEven;
+        case khalf:
+            return defaultHalfRounding == CL_HALF_RTZ ? kRoundTowardZero
+                                                      : kRoundToNearestEven;
+        default: return kRoundTowardZero;
+    }
+}
+
+template <RoundingMode R> constexpr cl_half_rounding_mode half_rounding()
+{
+    return R == kRoundUp ? CL_HALF_RTP
+        : R == kRoundDown ? CL_HALF_RTN
+        : R == kRoundTowardZero ? CL_HALF_RTZ
+                                : CL_HALF_RTE;
+}
+
+// Whether a magnitude whose discarded part is rem, half being the discarded
+// part of a tie, is rounded up in mode R.  neg is the sign of the value and
+// odd the parity of the kept part.
+template <RoundingMode R, typename T>
+inline bool rounds_up(bool neg, bool odd, T rem, T half)
+{
+    if constexpr (R == kRoundUp)
+        return !neg && rem != 0;
+    else if constexpr (R == kRoundDown)
+        return neg && rem != 0;
+    else if constexpr (R == kRoundTowardZero)
+        return false;
+    else
+        return rem > half || (rem == half && odd);
+}
+
+// Integral value of x in rounding mode R.  Values that are not integral are
+// below 2^24 (float) or 2^53 (double) in magnitude, so x - trunc(x) and the
+// adjustments by one are exact.
+template <RoundingMode R, typename T> inline T round_integral(T x)
+{
+    T t = std::trunc(x);
+    if (t == x || std::isnan(x)) return x;
+    bool neg = x < 0;
+    T mag = std::fabs(t);
+    if (rounds_up<R>(neg, std::fmod(mag, (T)2) != 0, std::fabs(x - t),
+                     (T)0.5))
+        mag += 1;
+    return neg ? -mag : mag;
+}
+
+inline int highest_bit(cl_ulong v)
+{
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(v);
+#else
+    int bit = 0;
+    while (v >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Integer to floating-point conversion in rounding mode R.  The integer is
+// rounded to the precision of FP with integer arithmetic; the rounded value
+// is then exactly representable.  0 converts to +0.0.
+template <RoundingMode R, typename FP, typename IntType>
+inline FP int_to_fp(IntType v)
+{
+    constexpr int digits = std::numeric_limits<FP>::digits;
+    bool neg = v < 0;
+    cl_ulong mag = neg ? 0 - (cl_ulong)v : (cl_ulong)v;
+    if ((mag >> digits) == 0) return neg ? -(FP)mag : (FP)mag;
+
+    int shift = highest_bit(mag) + 1 - digits;
+    cl_ulong q = mag >> shift;
+    cl_ulong rem = mag & ((1ULL << shift) - 1);
+    if (rounds_up<R>(neg, (q & 1) != 0, rem, (cl_ulong)1 << (shift - 1)))
+        q++;
+    FP r = std::ldexp((FP)q, shift);
+    return neg ? -r : r;
+}
+
+// Double to float conversion in rounding mode R, rounding the significand to
+// the precision of the float result, including float subnormals.
+template <RoundingMode R> inline float double_to_float(double d)
+{
+    if (!std::isfinite(d) || d == 0.0) return (float)d; // exact
+    bool neg = std::signbit(d);
+    int e;
+    double m = std::frexp(std::fabs(d), &e); // |d| = m * 2^e, 0.5 <= m < 1
+
+    // Bits of the float significand at this exponent
+    int p = std::min(FLT_MANT_DIG, e - FLT_MIN_EXP + FLT_MANT_DIG);
+    double q, rem;
+    if (p > 0)
+    {
+        double s = std::ldexp(m, p);
+        q = std::trunc(s);
+        rem = s - q;
+    }
+    else
+    {
+        // Below the smallest subnormal: only how it compares to half of it
+        // matters.
+        q = 0.0;
+        rem = p == 0 ? m : 0.25;
+    }
+    if (rounds_up<R>(neg, std::fmod(q, 2.0) != 0, rem, 0.5)) q += 1.0;
+
+    double r = std::ldexp(q, e - p);
+    if (r > FLT_MAX)
+    {
+        bool away = R == kRoundToNearestEven || (R == kRoundUp && !neg)
+            || (R == kRoundDown && neg);
+        r = away ? INFINITY : FLT_MAX;
+    }
+    return neg ? -(float)r : (float)r;
+}
+
+// Saturating integer to integer conversion.
+template <typename OutType, typename InType>
+inline OutType saturate_int(InType v)
+{
+    using Limits = std::numeric_limits<OutType>;
+    if constexpr (std::is_signed<InType>::value)
+    {
+        if (v < 0)
+        {
+            if constexpr (!std::is_signed<OutType>::value)
+                return 0;
+            else
+                return (cl_long)v < (cl_long)Limits::min() ? Limits::min()
+                                                           : (OutType)v;
+        }
+    }
+    return (cl_ulong)v > (cl_ulong)Limits::max() ? Limits::max() : (OutType)v;
+}
+
+// Saturating conversion of an integral floating-point value to OutType.  NaN
+// converts to 0.
+template <typename OutType, typename T> inline OutType saturate_fp(T v)
+{
+    using Limits = std::numeric_limits<OutType>;
+    if (std::isnan(v)) return 0;
+    if (v >= std::ldexp((T)1, Limits::digits)) return Limits::max();
+    if (v < (T)Limits::min()) return Limits::min();
+    return (OutType)v;
+}
+
+// Reference conversion of InType to OutType in rounding mode R.  InFP and
+// OutFP tell cl_half from cl_ushort, as in DataInfoSpec.  Integers, and
+// doubles in saturated conversions, are converted to half through float
+// rounded to nearest even.
+template <typename InType, typename OutType, bool InFP, bool OutFP,
+          RoundingMode R>
+struct ReferenceConverter
+{
+    static constexpr bool in_half =
+        std::is_same<InType, cl_half>::value && InFP;
+    static constexpr bool out_half =
+        std::is_same<OutType, cl_half>::value && OutFP;
+    static constexpr bool out_int =
+        std::is_integral<OutType>::value && !out_half;
+
+    static OutType to_half(float f)
+    {
+        return cl_half_from_float(f, half_rounding<R>());
+    }
+
+    static OutType convert(InType in)
+    {
+        if constexpr (std::is_same<InType, cl_double>::value)
+        {
+            if constexpr (std::is_same<OutType, cl_float>::value)
+                return double_to_float<R>(in);
+            else if constexpr (out_half)
+                return cl_half_from_double(in, half_rounding<R>());
+            else if constexpr (!out_int)
+                return in;
+            else if constexpr (std::is_same<OutType, cl_long>::value)
+                return saturate_fp<OutType>(round_integral<R>(in));
+            else
+                return (OutType)round_integral<R>(in);
+        }
+        else if constexpr (std::is_same<InType, cl_float>::value || in_half)
+        {
+            cl_float f;
+            if constexpr (in_half)
+                f = cl_half_to_float(in);
+            else
+                f = in;
+
+            if constexpr (out_half)
+                return to_half(f);
+            else if constexpr (!out_int)
+                return (OutType)f;
+            else if constexpr (std::is_same<OutType, cl_long>::value)
+                return saturate_fp<OutType>(round_integral<R>((double)f));
+            else
+                return (OutType)round_integral<R>(f);
+        }
+        else
+        {
+            if constexpr (std::is_same<OutType, cl_float>::value)
+                return int_to_fp<R, cl_float>(in);
+            else if constexpr (std::is_same<OutType, cl_double>::value)
+                return int_to_fp<R, cl_double>(in);
+            else if constexpr (out_half)
+                return to_half(int_to_fp<kRoundToNearestEven, cl_float>(in));
+            else
+                return (OutType)in;
+        }
+    }
+
+    static OutType convert_sat(InType in)
+    {
+        if constexpr (std::is_same<InType, cl_double>::value
+                      || std::is_same<InType, cl_float>::value || in_half)
+        {
+            if constexpr (!out_int)
+            {
+                if constexpr (out_half
+                              && std::is_same<InType, cl_double>::value)
+                    return to_half(double_to_float<kRoundToNearestEven>(in));
+                else
+                    return convert(in);
+            }
+            else
+            {
+                // The rounding is done in the input type, except for half
+                // inputs, rounded as float.
+                using FP = typename std::conditional<
+                    std::is_same<InType, cl_double>::value, cl_double,
+                    cl_float>::type;
+                FP f;
+                if constexpr (in_half)
+                    f = cl_half_to_float(in);
+                else
+                    f = in;
+                return saturate_fp<OutType>(round_integral<R>(f));
+            }
+        }
+        else if constexpr (out_half)
+            return to_half(int_to_fp<kRoundToNearestEven, cl_float>(in));
+        else if constexpr (out_int)
+            return saturate_int<OutType>(in);
+        else
+            return convert(in);
+    }
+
+#if defined(__SSE2__)
+    // Leading elements converted with SSE2, using only exact conversions and
+    // truncation, which do not depend on the MXCSR rounding mode.  Returns the
+    // number of elements converted.
+    static size_t convert_sse2(OutType *out, const InType *in, size_t n,
+                               bool sat)
+    {
+        size_t i = 0;
+        if constexpr (std::is_same<InType, cl_float>::value
+                      && std::is_same<OutType, cl_double>::value)
+        {
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128 v = _mm_loadu_ps(in + i);
+                _mm_storeu_pd(out + i, _mm_cvtps_pd(v));
+                _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+            }
+        }
+        else if constexpr (std::is_same<InType, cl_int>::value
+                           && std::is_same<OutType, cl_double>::value)
+        {
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+                _mm_storeu_pd(out + i, _mm_cvtepi32_pd(v));
+                _mm_storeu_pd(out + i + 2,
+                              _mm_cvtepi32_pd(_mm_srli_si128(v, 8)));
+            }
+        }
+        else if constexpr (std::is_same<InType, cl_float>::value
+                           && std::is_same<OutType, cl_int>::value
+                           && R == kRoundTowardZero)
+        {
+            // Without saturation the inputs are clamped to the int range.
+            if (!sat)
+            {
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m128 v = _mm_loadu_ps(in + i);
+                    _mm_storeu_si128((__m128i *)(out + i),
+                                     _mm_cvttps_epi32(v));
+                }
+            }
+        }
+        return i;
+    }
+#endif
+
+    static void convert_array(OutType *out, const InType *in, size_t n,
+                              bool sat)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        i = convert_sse2(out, in, n, sat);
+#endif
+        if (sat)
+            for (; i < n; i++) out[i] = convert_sat(in[i]);
+        else
+            for (; i < n; i++) out[i] = convert(in[i]);
+    }
+};
+
+// Convert n elements of in to out in rounding mode round, which must not be
+// kDefaultRoundingMode (see resolve_rounding).
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+void convert_array(void *out, const void *in, size_t n, RoundingMode round,
+                   bool sat)
+{
+    OutType *o = (OutType *)out;
+    const InType *i = (const InType *)in;
+    switch (round)
+    {
+        case kRoundUp:
+            ReferenceConverter<InType, OutType, InFP, OutFP,
+                               kRoundUp>::convert_array(o, i, n, sat);
+            break;
+        case kRoundDown:
+            ReferenceConverter<InType, OutType, InFP, OutFP,
+                               kRoundDown>::convert_array(o, i, n, sat);
+            break;
+        case kRoundTowardZero:
+            ReferenceConverter<InType, OutType, InFP, OutFP,
+                               kRoundTowardZero>::convert_array(o, i, n, sat);
+            break;
+        default:
+            ReferenceConverter<InType, OutType, InFP, OutFP,
+                               kRoundToNearestEven>::convert_array(o, i, n,
+                                                                   sat);
+            break;
+    }
+}
+
+} // namespace conv_ref
+
+#endif /* CONVERSIONS_REFERENCE_H */
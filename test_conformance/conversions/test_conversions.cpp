@@ -56,17 +56,6 @@
 #include <climits>
 #include <cstring>
 
-#if (defined(__arm__) || defined(__aarch64__)) && defined(__GNUC__)
-#include "fplib.h"
-#endif
-
-#if (defined(__arm__) || defined(__aarch64__)) && defined(__GNUC__)
-/* Rounding modes and saturation for use with qcom 64 bit to float conversion
- * library */
-bool qcom_sat;
-roundingMode qcom_rm;
-#endif
-
 
 static test_status ParseArgs(int &argc, const char *argv[],
                              std::vector<std::string> &removed_args,
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "harness/compat.h"
+#include "harness/halfConversions.h"
 #include "harness/kernelHelpers.h"
 #include "harness/testHarness.h"
 #include "harness/parseParameters.h"
@@ -31,7 +32,7 @@ typedef struct ComputeReferenceInfoF_
 {
     float *x;
     cl_ushort *r;
-    f2h f;
+    cl_half_rounding_mode rounding_mode;
     cl_ulong i;
     cl_uint lim;
     cl_uint count;
@@ -41,7 +42,7 @@ typedef struct ComputeReferenceInfoD_
 {
     double *x;
     cl_ushort *r;
-    d2h f;
+    cl_half_rounding_mode rounding_mode;
     cl_ulong i;
     cl_uint lim;
     cl_uint count;
@@ -52,7 +53,7 @@ typedef struct CheckResultInfoF_
     const float *x;
     const cl_ushort *r;
     const cl_ushort *s;
-    f2h f;
+    cl_half_rounding_mode rounding_mode;
     const char *aspace;
     cl_uint lim;
     cl_uint count;
@@ -64,7 +65,7 @@ typedef struct CheckResultInfoD_
     const double *x;
     const cl_ushort *r;
     const cl_ushort *s;
-    d2h f;
+    cl_half_rounding_mode rounding_mode;
     const char *aspace;
     cl_uint lim;
     cl_uint count;
@@ -79,17 +80,13 @@ static cl_int ReferenceF(cl_uint jid, cl_uint tid, void *userInfo)
     cl_uint off = jid * count;
     float *x = cri->x + off;
     cl_ushort *r = cri->r + off;
-    f2h f = cri->f;
     cl_ulong i = cri->i + off;
     cl_uint j;
 
     if (off + count > lim) count = lim - off;
 
-    for (j = 0; j < count; ++j)
-    {
-        x[j] = as_float((cl_uint)(i + j));
-        r[j] = f(x[j]);
-    }
+    for (j = 0; j < count; ++j) x[j] = as_float((cl_uint)(i + j));
+    half_from_float_array(r, x, count, cri->rounding_mode);
 
     return 0;
 }
@@ -103,10 +100,9 @@ static cl_int CheckF(cl_uint jid, cl_uint tid, void *userInfo)
     const float *x = cri->x + off;
     const cl_ushort *r = cri->r + off;
     const cl_ushort *s = cri->s + off;
-    f2h f = cri->f;
     cl_uint j;
-    cl_ushort correct2 = f(0.0f);
-    cl_ushort correct3 = f(-0.0f);
+    cl_ushort correct2 = half_from_float(0.0f, cri->rounding_mode);
+    cl_ushort correct3 = half_from_float(-0.0f, cri->rounding_mode);
     cl_int ret = 0;
 
     if (off + count > lim) count = lim - off;
@@ -148,17 +144,14 @@ static cl_int ReferenceD(cl_uint jid, cl_uint tid, void *userInfo)
     cl_uint off = jid * count;
     double *x = cri->x + off;
     cl_ushort *r = cri->r + off;
-    d2h f = cri->f;
     cl_uint j;
     cl_ulong i = cri->i + off;
 
     if (off + count > lim) count = lim - off;
 
     for (j = 0; j < count; ++j)
-    {
         x[j] = as_double(DoubleFromUInt((cl_uint)(i + j)));
-        r[j] = f(x[j]);
-    }
+    half_from_double_array(r, x, count, cri->rounding_mode);
 
     return 0;
 }
@@ -172,10 +165,9 @@ static cl_int CheckD(cl_uint jid, cl_uint tid, void *userInfo)
     const double *x = cri->x + off;
     const cl_ushort *r = cri->r + off;
     const cl_ushort *s = cri->s + off;
-    d2h f = cri->f;
     cl_uint j;
-    cl_ushort correct2 = f(0.0);
-    cl_ushort correct3 = f(-0.0);
+    cl_ushort correct2 = half_from_double(0.0, cri->rounding_mode);
+    cl_ushort correct3 = half_from_double(-0.0, cri->rounding_mode);
     cl_int ret = 0;
 
     if (off + count > lim) count = lim - off;
@@ -208,81 +200,41 @@ static cl_int CheckD(cl_uint jid, cl_uint tid, void *userInfo)
     return ret;
 }
 
-static cl_half float2half_rte(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTE);
-}
-
-static cl_half float2half_rtz(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTZ);
-}
-
-static cl_half float2half_rtp(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTP);
-}
-
-static cl_half float2half_rtn(float f)
-{
-    return cl_half_from_float(f, CL_HALF_RTN);
-}
-
-static cl_half double2half_rte(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTE);
-}
-
-static cl_half double2half_rtz(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTZ);
-}
-
-static cl_half double2half_rtp(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTP);
-}
-
-static cl_half double2half_rtn(double f)
-{
-    return cl_half_from_double(f, CL_HALF_RTN);
-}
-
 REGISTER_TEST(vstore_half)
 {
     switch (get_default_rounding_mode(device))
     {
         case CL_FP_ROUND_TO_ZERO:
-            return Test_vStoreHalf_private(device, float2half_rtz,
-                                           double2half_rte, "");
+            return Test_vStoreHalf_private(device, CL_HALF_RTZ,
+                                           CL_HALF_RTE, "");
         case 0: return -1;
         default:
-            return Test_vStoreHalf_private(device, float2half_rte,
-                                           double2half_rte, "");
+            return Test_vStoreHalf_private(device, CL_HALF_RTE,
+                                           CL_HALF_RTE, "");
     }
 }
 
 REGISTER_TEST(vstore_half_rte)
 {
-    return Test_vStoreHalf_private(device, float2half_rte, double2half_rte,
+    return Test_vStoreHalf_private(device, CL_HALF_RTE, CL_HALF_RTE,
                                    "_rte");
 }
 
 REGISTER_TEST(vstore_half_rtz)
 {
-    return Test_vStoreHalf_private(device, float2half_rtz, double2half_rtz,
+    return Test_vStoreHalf_private(device, CL_HALF_RTZ, CL_HALF_RTZ,
                                    "_rtz");
 }
 
 REGISTER_TEST(vstore_half_rtp)
 {
-    return Test_vStoreHalf_private(device, float2half_rtp, double2half_rtp,
+    return Test_vStoreHalf_private(device, CL_HALF_RTP, CL_HALF_RTP,
                                    "_rtp");
 }
 
 REGISTER_TEST(vstore_half_rtn)
 {
-    return Test_vStoreHalf_private(device, float2half_rtn, double2half_rtn,
+    return Test_vStoreHalf_private(device, CL_HALF_RTN, CL_HALF_RTN,
                                    "_rtn");
 }
 
@@ -291,43 +243,45 @@ REGISTER_TEST(vstorea_half)
     switch (get_default_rounding_mode(device))
     {
         case CL_FP_ROUND_TO_ZERO:
-            return Test_vStoreaHalf_private(device, float2half_rtz,
-                                            double2half_rte, "");
+            return Test_vStoreaHalf_private(device, CL_HALF_RTZ,
+                                            CL_HALF_RTE, "");
         case 0: return -1;
         default:
-            return Test_vStoreaHalf_private(device, float2half_rte,
-                                            double2half_rte, "");
+            return Test_vStoreaHalf_private(device, CL_HALF_RTE,
+                                            CL_HALF_RTE, "");
     }
 }
 
 REGISTER_TEST(vstorea_half_rte)
 {
-    return Test_vStoreaHalf_private(device, float2half_rte, double2half_rte,
+    return Test_vStoreaHalf_private(device, CL_HALF_RTE, CL_HALF_RTE,
                                     "_rte");
 }
 
 REGISTER_TEST(vstorea_half_rtz)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtz, double2half_rtz,
+    return Test_vStoreaHalf_private(device, CL_HALF_RTZ, CL_HALF_RTZ,
                                     "_rtz");
 }
 
 REGISTER_TEST(vstorea_half_rtp)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtp, double2half_rtp,
+    return Test_vStoreaHalf_private(device, CL_HALF_RTP, CL_HALF_RTP,
                                     "_rtp");
 }
 
 REGISTER_TEST(vstorea_half_rtn)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtn, double2half_rtn,
+    return Test_vStoreaHalf_private(device, CL_HALF_RTN, CL_HALF_RTN,
                                     "_rtn");
 }
 
 #pragma mark -
 
-int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
-                            d2h doubleReferenceFunc, const char *roundName)
+int Test_vStoreHalf_private(cl_device_id device,
+                            cl_half_rounding_mode floatRoundingMode,
+                            cl_half_rounding_mode doubleRoundingMode,
+                            const char *roundName)
 {
     int vectorSize, error;
     cl_program programs[kVectorSizeCount + kStrangeVectorSizeCount][3];
@@ -864,7 +818,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     ComputeReferenceInfoF fref;
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
-    fref.f = referenceFunc;
+    fref.rounding_mode = floatRoundingMode;
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -872,14 +826,14 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     fchk.x = (const float *)gIn_single;
     fchk.r = (const cl_half *)gOut_half_reference;
     fchk.s = (const cl_half *)gOut_half;
-    fchk.f = referenceFunc;
+    fchk.rounding_mode = floatRoundingMode;
     fchk.lim = blockCount;
     fchk.count = (blockCount + threadCount - 1) / threadCount;
 
     ComputeReferenceInfoD dref;
     dref.x = (double *)gIn_double;
     dref.r = (cl_half *)gOut_half_reference_double;
-    dref.f = doubleReferenceFunc;
+    dref.rounding_mode = doubleRoundingMode;
     dref.lim = blockCount;
     dref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -887,7 +841,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.x = (const double *)gIn_double;
     dchk.r = (const cl_half *)gOut_half_reference_double;
     dchk.s = (const cl_half *)gOut_half;
-    dchk.f = doubleReferenceFunc;
+    dchk.rounding_mode = doubleRoundingMode;
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1210,8 +1164,10 @@ exit:
     return error;
 }
 
-int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
-                             d2h doubleReferenceFunc, const char *roundName)
+int Test_vStoreaHalf_private(cl_device_id device,
+                             cl_half_rounding_mode floatRoundingMode,
+                             cl_half_rounding_mode doubleRoundingMode,
+                             const char *roundName)
 {
     int vectorSize, error;
     cl_program programs[kVectorSizeCount + kStrangeVectorSizeCount][3];
@@ -1710,7 +1666,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     ComputeReferenceInfoF fref;
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
-    fref.f = referenceFunc;
+    fref.rounding_mode = floatRoundingMode;
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1718,14 +1674,14 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     fchk.x = (const float *)gIn_single;
     fchk.r = (const cl_half *)gOut_half_reference;
     fchk.s = (const cl_half *)gOut_half;
-    fchk.f = referenceFunc;
+    fchk.rounding_mode = floatRoundingMode;
     fchk.lim = blockCount;
     fchk.count = (blockCount + threadCount - 1) / threadCount;
 
     ComputeReferenceInfoD dref;
     dref.x = (double *)gIn_double;
     dref.r = (cl_half *)gOut_half_reference_double;
-    dref.f = doubleReferenceFunc;
+    dref.rounding_mode = doubleRoundingMode;
     dref.lim = blockCount;
     dref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1733,7 +1689,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.x = (const double *)gIn_double;
     dchk.r = (const cl_half *)gOut_half_reference_double;
     dchk.s = (const cl_half *)gOut_half;
-    dchk.f = doubleReferenceFunc;
+    dchk.rounding_mode = doubleRoundingMode;
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -40,12 +40,145 @@ static cl_int cleanup_mapped_image(cl_command_queue queue, cl_mem image,
     return CL_SUCCESS;
 }
 
+// Create the images of a streamed copy test, and write the source one with
+// contents generated from a new seed.
+static int test_copy_init_streamed_images(copy_image_env_t &env,
+                                          image_descriptor *srcImageInfo,
+                                          image_descriptor *dstImageInfo,
+                                          copy_image_buffers_t &buffers)
+{
+    int error;
+
+    if (env.ctx.debugTrace) log_info(" - Streaming source image...\n");
+
+    // Pitches would need host copies of the whole images.
+    buffers.srcSeed = genrand_int32(env.d);
+    buffers.srcData.reset(nullptr, nullptr, 0, 0);
+    buffers.srcImage =
+        create_image(env.context, env.queue, buffers.srcData, srcImageInfo,
+                     false, env.ctx.testMipmaps, env.ctx.debugTrace, &error);
+    if (buffers.srcImage == NULL) return error;
+
+    image_tile_fn generate = [&](const image_tile_t &tile, char *data) {
+        generate_image_tile(srcImageInfo, buffers.srcSeed, tile, data);
+    };
+    size_t levels = env.ctx.testMipmaps ? srcImageInfo->num_mip_levels : 1;
+    for (size_t lod = 0; lod < levels; lod++)
+    {
+        error = write_image_streamed(env.queue, buffers.srcImage, srcImageInfo,
+                                     lod, env.ctx.testMipmaps, env.ctx,
+                                     generate);
+        if (error != CL_SUCCESS) return error;
+    }
+
+    if (env.ctx.debugTrace) log_info(" - Creating destination image...\n");
+
+    buffers.dstData.reset(nullptr, nullptr, 0, 0);
+    buffers.dstImage =
+        create_image(env.context, env.queue, buffers.dstData, dstImageInfo,
+                     false, env.ctx.testMipmaps, env.ctx.debugTrace, &error);
+    if (buffers.dstImage == NULL) return error;
+
+    return CL_SUCCESS;
+}
+
+// Copy test for streamed images.  The destination level is reset to 0xff in
+// tiles, and the expected contents of each of its tiles are rebuilt from the
+// rows of the source regenerated from its seed.
+static int test_copy_image_streamed(copy_image_env_t &env,
+                                    image_descriptor *srcImageInfo,
+                                    image_descriptor *dstImageInfo,
+                                    copy_image_buffers_t &buffers,
+                                    const size_t sourcePos[],
+                                    const size_t destPos[],
+                                    const size_t regionSize[])
+{
+    bool mipmapped = env.ctx.testMipmaps;
+    size_t pixelSize = get_pixel_size(dstImageInfo->format);
+    size_t srcCoords[3], dstCoords[3], srcLod, dstLod;
+    get_image_position(srcImageInfo, sourcePos, mipmapped, srcCoords, &srcLod);
+    get_image_position(dstImageInfo, destPos, mipmapped, dstCoords, &dstLod);
+
+    if (env.ctx.debugTrace) log_info(" - Resetting destination image...\n");
+
+    image_tile_fn reset = [&](const image_tile_t &tile, char *data) {
+        memset(data, 0xff,
+               tile.region[0] * tile.region[1] * tile.region[2] * pixelSize);
+    };
+    int error = write_image_streamed(env.queue, buffers.dstImage, dstImageInfo,
+                                     dstLod, mipmapped, env.ctx, reset);
+    if (error != CL_SUCCESS) return error;
+
+    if (env.ctx.debugTrace)
+        log_info(" - Copying from %d,%d,%d to %d,%d,%d size %d,%d,%d\n",
+                 (int)sourcePos[0], (int)sourcePos[1], (int)sourcePos[2],
+                 (int)destPos[0], (int)destPos[1], (int)destPos[2],
+                 (int)regionSize[0], (int)regionSize[1], (int)regionSize[2]);
+
+    error = clEnqueueCopyImage(env.queue, buffers.srcImage, buffers.dstImage,
+                               sourcePos, destPos, regionSize, 0, NULL, NULL);
+    if (error != CL_SUCCESS)
+    {
+        log_error("ERROR: Unable to copy image from pos %d,%d,%d to %d,%d,%d "
+                  "size %d,%d,%d! (%s)\n",
+                  (int)sourcePos[0], (int)sourcePos[1], (int)sourcePos[2],
+                  (int)destPos[0], (int)destPos[1], (int)destPos[2],
+                  (int)regionSize[0], (int)regionSize[1], (int)regionSize[2],
+                  IGetErrorString(error));
+        return error;
+    }
+
+    if (env.ctx.debugTrace) log_info(" - Streaming verification...\n");
+
+    size_t srcSize[3];
+    get_image_level_size(srcImageInfo, srcLod, srcSize);
+    std::vector<char> srcRow(srcSize[0] * pixelSize);
+    image_tile_fn expected = [&](const image_tile_t &tile, char *data) {
+        reset(tile, data);
+        for (size_t z = 0; z < tile.region[2]; z++)
+        {
+            for (size_t y = 0; y < tile.region[1]; y++)
+            {
+                size_t dstY = tile.origin[1] + y;
+                size_t dstZ = tile.origin[2] + z;
+                if (dstY < dstCoords[1] || dstY >= dstCoords[1] + regionSize[1]
+                    || dstZ < dstCoords[2]
+                    || dstZ >= dstCoords[2] + regionSize[2])
+                    continue;
+
+                size_t srcY = srcCoords[1] + dstY - dstCoords[1];
+                size_t srcZ = srcCoords[2] + dstZ - dstCoords[2];
+                image_tile_t srcTile = { srcLod,
+                                         { 0, srcY, srcZ },
+                                         { srcSize[0], 1, 1 } };
+                generate_image_tile(srcImageInfo, buffers.srcSeed, srcTile,
+                                    srcRow.data());
+                memcpy(data
+                           + ((z * tile.region[1] + y) * tile.region[0]
+                              + dstCoords[0])
+                               * pixelSize,
+                       srcRow.data() + srcCoords[0] * pixelSize,
+                       regionSize[0] * pixelSize);
+            }
+        }
+    };
+    return verify_image_streamed(env.queue, buffers.dstImage, dstImageInfo,
+                                 dstLod, mipmapped, env.ctx, expected);
+}
+
 int test_copy_init_images(copy_image_env_t &env, image_descriptor *srcImageInfo,
                           image_descriptor *dstImageInfo,
                           copy_image_buffers_t &buffers)
 {
     int error;
 
+    cl_ulong hostBytes =
+        get_image_host_size(srcImageInfo) + get_image_host_size(dstImageInfo);
+    buffers.streamed = use_image_streaming(hostBytes, env.ctx);
+    if (buffers.streamed)
+        return test_copy_init_streamed_images(env, srcImageInfo, dstImageInfo,
+                                              buffers);
+
     // Generate some data to test against
     if (env.ctx.debugTrace) log_info(" - Resizing random image data...\n");
 
@@ -93,6 +226,11 @@ int test_copy_image_generic(copy_image_env_t &env,
 
     if (env.ctx.debugTrace) log_info(" ++ Entering inner test loop...\n");
 
+    if (buffers.streamed)
+        return test_copy_image_streamed(env, srcImageInfo, dstImageInfo,
+                                        buffers, sourcePos, destPos,
+                                        regionSize);
+
     memset(buffers.dstData, 0xff, buffers.dstData.getSize());
     error = init_image(env.queue, buffers.dstImage, dstImageInfo,
                        buffers.dstData, env.ctx.testMipmaps);
@@ -287,28 +425,26 @@ int test_copy_image_generic(copy_image_env_t &env,
                 break;
         }
     }
+    size_t pixel_size = get_pixel_size(dstImageInfo->format);
+    size_t scanlineWidth = scanlineSize / pixel_size;
+    ScanlineComparator comparator(dstImageInfo->format);
     for( size_t z = 0; z < thirdDim; z++ )
     {
         for( size_t y = 0; y < secondDim; y++ )
         {
-            if( memcmp( sourcePtr, destPtr, scanlineSize ) != 0 )
+            // Find the first differing pixel
+            size_t where =
+                comparator.compare(sourcePtr, destPtr, scanlineWidth);
+            if (where < scanlineWidth)
             {
-                // Find the first differing pixel
-                size_t pixel_size = get_pixel_size( dstImageInfo->format );
-                size_t where =
-                    compare_scanlines(dstImageInfo, sourcePtr, destPtr);
-
-                if (where < dstImageInfo->width)
-                {
-                    print_first_pixel_difference_error(
-                        where, sourcePtr + pixel_size * where,
-                        destPtr + pixel_size * where, dstImageInfo, y,
-                        dstImageInfo->depth);
-                    cl_int cleanup_error = cleanup_mapped_image(
-                        env.queue, buffers.dstImage, mapped);
-                    if (cleanup_error != CL_SUCCESS) return cleanup_error;
-                    return -1;
-                }
+                print_first_pixel_difference_error(
+                    where, sourcePtr + pixel_size * where,
+                    destPtr + pixel_size * where, dstImageInfo, y,
+                    dstImageInfo->depth);
+                cl_int cleanup_error =
+                    cleanup_mapped_image(env.queue, buffers.dstImage, mapped);
+                if (cleanup_error != CL_SUCCESS) return cleanup_error;
+                return -1;
             }
             sourcePtr += rowPitch;
             if((dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY || dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D))
@@ -24,6 +24,11 @@ struct copy_image_buffers_t
 {
     clMemWrapper srcImage, dstImage;
     BufferOwningPtr<char> srcData, dstData;
+    // Set when the images don't fit in host memory, in which case they are
+    // streamed, there is no srcData nor dstData and the source contents are
+    // generated from srcSeed.
+    bool streamed = false;
+    cl_uint srcSeed = 0;
 };
 struct copy_image_env_t
 {
@@ -292,32 +292,23 @@ int test_image_type(cl_device_id device, cl_context context,
                        ctx.channelOrderToUse);
 
         // Run the format list
+        std::vector<cl_image_format *> formats;
         for (unsigned int i = 0; i < formatList.size(); i++)
         {
-            int test_return = 0;
-            if (filterFlags[i])
-            {
-                continue;
-            }
-
-            print_header(&formatList[i], false);
-
-            gTestCount++;
-
-            test_return = test_fn(device, context, queue, test_config.src_flags,
-                                  test_config.src_type, test_config.dst_flags,
-                                  test_config.dst_type, &formatList[i], ctx);
-
-            if (test_return)
-            {
-                gFailCount++;
-                log_error("FAILED: ");
-                print_header(&formatList[i], true);
-                log_info("\n");
-            }
-
-            ret += test_return;
+            if (!filterFlags[i]) formats.push_back(&formatList[i]);
         }
+
+        ret += run_image_format_tests(
+            queue, ctx, formats.size(),
+            [&](size_t index, bool error) {
+                print_header(formats[index], error);
+            },
+            [&](cl_command_queue testQueue, size_t index) {
+                return test_fn(device, context, testQueue,
+                               test_config.src_flags, test_config.src_type,
+                               test_config.dst_flags, test_config.dst_type,
+                               formats[index], ctx);
+            });
     }
 
     return ret;
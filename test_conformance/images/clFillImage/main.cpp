@@ -15,6 +15,7 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../testBase.h"
 #include "../harness/compat.h"
@@ -56,6 +57,8 @@ static test_status parseArgs(int &argc, const char *argv[],
         small_images - Runs every format through a loop of widths 1-13 and heights 1-9, instead of random sizes
         max_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128
         use_pitches - Enables row and slice pitches
+        host_memory_budget <MiB> - Streams the images, in tiles, when the test would otherwise keep more than <MiB> MiB of image data in host memory
+        concurrent_queues <N> - Runs up to 2 * N format tests at once on N queues, overlapping the verification of each with the device work of the others. The output of the tests may interleave; not used with randomize
 
         You may also use appropriate CL_ channel type and ordering constants.
 )";
@@ -78,6 +81,16 @@ static test_status parseArgs(int &argc, const char *argv[],
             ctx.testMaxImages = true;
         else if (strcmp(argv[i], "use_pitches") == 0)
             ctx.enablePitch = true;
+        else if (strcmp(argv[i], "host_memory_budget") == 0 && i + 1 < argc)
+        {
+            removed_args.back() += std::string(" ") + argv[i + 1];
+            ctx.hostMemoryBudget = strtoull(argv[++i], nullptr, 10) << 20;
+        }
+        else if (strcmp(argv[i], "concurrent_queues") == 0 && i + 1 < argc)
+        {
+            removed_args.back() += std::string(" ") + argv[i + 1];
+            ctx.concurrentQueues = (cl_uint)strtoul(argv[++i], nullptr, 10);
+        }
         else if (strcmp(argv[i], "int") == 0)
             ctx.typesToTest |= kTestInt;
         else if (strcmp(argv[i], "uint") == 0)
@@ -49,6 +49,115 @@ static void fill_region_with_value( image_descriptor *imageInfo, void *imageValu
     free(fillColor);
 }
 
+// Fill test for an image streamed in tiles.  The image is written with
+// contents generated from a seed, the expected contents of each tile are
+// regenerated with the filled region replaced by the fill color.
+static int test_fill_image_streamed(cl_context context, cl_command_queue queue,
+                                    image_descriptor *imageInfo,
+                                    const size_t origin[],
+                                    const size_t region[],
+                                    ExplicitType outputType, MTdata d,
+                                    const image_test_context_t &ctx)
+{
+    int error;
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+    cl_uint seed = genrand_int32(d);
+    image_tile_fn generate = [&](const image_tile_t &tile, char *data) {
+        generate_image_tile(imageInfo, seed, tile, data);
+    };
+
+    if (ctx.debugTrace) log_info(" - Creating image...\n");
+
+    BufferOwningPtr<char> noData;
+    clMemWrapper image = create_image(context, queue, noData, imageInfo, false,
+                                      false, ctx.debugTrace, &error);
+    if (image == NULL) return error;
+
+    if (ctx.debugTrace) log_info(" - Streaming image...\n");
+
+    error = write_image_streamed(queue, image, imageInfo, 0, false, ctx,
+                                 generate);
+    if (error != CL_SUCCESS) return error;
+
+    // Fill with the pixel at origin, taken from its regenerated row.
+    image_tile_t originRow = { 0,
+                               { 0, origin[1], origin[2] },
+                               { imageInfo->width, 1, 1 } };
+    std::vector<char> rowData(imageInfo->width * pixelSize);
+    generate(originRow, rowData.data());
+
+    if (imageInfo->format->image_channel_data_type == CL_HALF_FLOAT)
+        DetectFloatToHalfRoundingMode(queue);
+
+    union {
+        cl_float f[4];
+        cl_int i[4];
+        cl_uint u[4];
+    } fillColor;
+    std::vector<char> fillValue(pixelSize);
+    if (outputType == kFloat)
+    {
+        read_image_pixel_float(rowData.data(), imageInfo, origin[0], 0, 0,
+                               fillColor.f);
+        pack_image_pixel(fillColor.f, imageInfo->format, fillValue.data());
+    }
+    else if (outputType == kInt)
+    {
+        read_image_pixel<cl_int>(rowData.data(), imageInfo, origin[0], 0, 0,
+                                 fillColor.i);
+        pack_image_pixel(fillColor.i, imageInfo->format, fillValue.data());
+    }
+    else
+    {
+        read_image_pixel<cl_uint>(rowData.data(), imageInfo, origin[0], 0, 0,
+                                  fillColor.u);
+        pack_image_pixel(fillColor.u, imageInfo->format, fillValue.data());
+    }
+
+    if (ctx.debugTrace)
+        log_info(" - Filling at %d,%d,%d size %d,%d,%d\n", (int)origin[0],
+                 (int)origin[1], (int)origin[2], (int)region[0],
+                 (int)region[1], (int)region[2]);
+
+    error = clEnqueueFillImage(queue, image, &fillColor, origin, region, 0,
+                               NULL, NULL);
+    if (error != CL_SUCCESS)
+    {
+        log_error("ERROR: Unable to fill image at %d,%d,%d size %d,%d,%d! "
+                  "(%s)\n",
+                  (int)origin[0], (int)origin[1], (int)origin[2],
+                  (int)region[0], (int)region[1], (int)region[2],
+                  IGetErrorString(error));
+        return error;
+    }
+
+    if (ctx.debugTrace) log_info(" - Streaming verification...\n");
+
+    size_t regionDepth = region[2] > 0 ? region[2] : 1;
+    image_tile_fn expected = [&](const image_tile_t &tile, char *data) {
+        generate(tile, data);
+        for (size_t z = 0; z < tile.region[2]; z++)
+        {
+            for (size_t y = 0; y < tile.region[1]; y++)
+            {
+                size_t imageY = tile.origin[1] + y;
+                size_t imageZ = tile.origin[2] + z;
+                if (imageY < origin[1] || imageY >= origin[1] + region[1]
+                    || imageZ < origin[2] || imageZ >= origin[2] + regionDepth)
+                    continue;
+
+                char *pixel = data
+                    + ((z * tile.region[1] + y) * tile.region[0] + origin[0])
+                        * pixelSize;
+                for (size_t x = 0; x < region[0]; x++, pixel += pixelSize)
+                    memcpy(pixel, fillValue.data(), pixelSize);
+            }
+        }
+    };
+    return verify_image_streamed(queue, image, imageInfo, 0, false, ctx,
+                                 expected);
+}
+
 int test_fill_image_generic(cl_context context, cl_command_queue queue,
                             image_descriptor *imageInfo, const size_t origin[],
                             const size_t region[], ExplicitType outputType,
@@ -62,6 +171,11 @@ int test_fill_image_generic(cl_context context, cl_command_queue queue,
 
     if (ctx.debugTrace) log_info(" ++ Entering inner test loop...\n");
 
+    // The image and its host verification copy don't fit in host memory.
+    if (use_image_streaming(2 * get_image_host_size(imageInfo), ctx))
+        return test_fill_image_streamed(context, queue, imageInfo, origin,
+                                        region, outputType, d, ctx);
+
     // Generate some data to test against
     size_t dataBytes = 0;
 
@@ -263,24 +377,22 @@ int test_fill_image_generic(cl_context context, cl_command_queue queue,
 
     // Count the number of bytes successfully matched
     size_t total_matched = 0;
+    size_t pixel_size = get_pixel_size(imageInfo->format);
+    ScanlineComparator comparator(imageInfo->format);
 
     for ( size_t z = 0; z < thirdDim; z++ )
     {
         for ( size_t y = 0; y < secondDim; y++ )
         {
-            if (memcmp( sourcePtr, destPtr, scanlineSize ) != 0)
+            // Find the first differing pixel
+            size_t where =
+                comparator.compare(sourcePtr, destPtr, imageInfo->width);
+            if (where < imageInfo->width)
             {
-                // Find the first differing pixel
-                size_t pixel_size = get_pixel_size( imageInfo->format );
-                size_t where = compare_scanlines(imageInfo, sourcePtr, destPtr);
-
-                if (where < imageInfo->width)
-                {
-                    print_first_pixel_difference_error(
-                        where, sourcePtr + pixel_size * where,
-                        destPtr + pixel_size * where, imageInfo, y, thirdDim);
-                    return -1;
-                }
+                print_first_pixel_difference_error(
+                    where, sourcePtr + pixel_size * where,
+                    destPtr + pixel_size * where, imageInfo, y, thirdDim);
+                return -1;
             }
 
             total_matched += scanlineSize;
@@ -123,30 +123,22 @@ int test_image_type(cl_device_id device, cl_context context,
             else
             {
                 // Run the format list
+                std::vector<cl_image_format *> formats;
                 for (unsigned int i = 0; i < formatList.size(); i++)
                 {
-                    if (filterFlags[i])
-                    {
-                        continue;
-                    }
-
-                    print_header(&formatList[i], false);
-
-                    gTestCount++;
-
-                    int test_return =
-                        test_fn(device, context, queue, &formatList[i], flags,
-                                test.explicitType, ctx);
-                    if (test_return)
-                    {
-                        gFailCount++;
-                        log_error("FAILED: ");
-                        print_header(&formatList[i], true);
-                        log_info("\n");
-                    }
-
-                    ret += test_return;
+                    if (!filterFlags[i]) formats.push_back(&formatList[i]);
                 }
+
+                ret += run_image_format_tests(
+                    queue, ctx, formats.size(),
+                    [&](size_t index, bool error) {
+                        print_header(formats[index], error);
+                    },
+                    [&](cl_command_queue testQueue, size_t index) {
+                        return test_fn(device, context, testQueue,
+                                       formats[index], flags,
+                                       test.explicitType, ctx);
+                    });
             }
         }
     }
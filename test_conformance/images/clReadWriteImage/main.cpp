@@ -15,6 +15,7 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../testBase.h"
 #include "../harness/compat.h"
@@ -64,6 +65,7 @@ static test_status parseArgs(int &argc, const char *argv[],
         max_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128
         randomize - Use random seed
         use_pitches - Enables row and slice pitches
+        host_memory_budget <MiB> - Streams the images, in tiles, when the test would otherwise keep more than <MiB> MiB of image data in host memory
 )";
 
     cl_channel_type chanType;
@@ -90,6 +92,11 @@ static test_status parseArgs(int &argc, const char *argv[],
             ctx.testMaxImages = true;
         else if (strcmp(argv[i], "use_pitches") == 0)
             ctx.enablePitch = true;
+        else if (strcmp(argv[i], "host_memory_budget") == 0 && i + 1 < argc)
+        {
+            removed_args.back() += std::string(" ") + argv[i + 1];
+            ctx.hostMemoryBudget = strtoull(argv[++i], nullptr, 10) << 20;
+        }
         else if ((chanType = get_channel_type_from_name(argv[i]))
                  != (cl_channel_type)-1)
             ctx.channelTypeToUse = chanType;
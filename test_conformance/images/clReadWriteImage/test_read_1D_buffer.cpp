@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 #include <CL/cl.h>
 
 int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
@@ -26,9 +27,13 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
     clMemWrapper image;
     clMemWrapper buffer;
 
-    // Generate some data to test against
+    // Generate some data to test against, unless the image and its read back
+    // copy don't fit in host memory, in which case the image is streamed.
+    bool streamed =
+        use_image_streaming(2 * get_image_host_size(imageInfo), ctx);
+    cl_uint seed = streamed ? genrand_int32(d) : 0;
     BufferOwningPtr<char> imageValues;
-    generate_random_image_data(imageInfo, imageValues, d);
+    if (!streamed) generate_random_image_data(imageInfo, imageValues, d);
 
     if (ctx.debugTrace)
     {
@@ -54,6 +59,10 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
         return -1;
     }
 
+    if (streamed)
+        return test_read_write_image_streamed(queue, image, imageInfo, seed,
+                                              ctx);
+
     if (ctx.debugTrace) log_info(" - Writing image...\n");
 
     size_t origin[3] = { 0, 0, 0 };
@@ -96,7 +105,9 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
     char *sourcePtr = (char *)imageValues + imgValMipLevelOffset;
     char *destPtr = resultValues;
 
-    if (memcmp(sourcePtr, destPtr, scanlineSize) != 0)
+    ScanlineComparator comparator(imageInfo->format);
+    if (comparator.compare(sourcePtr, destPtr, imageInfo->width)
+        != imageInfo->width)
     {
         log_error("ERROR: Scanline did not verify for image size %d pitch "
                   "%d (extra %d bytes)\n",
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 int test_read_image_2D(cl_context context, cl_command_queue queue,
                        image_descriptor *imageInfo, MTdata d,
@@ -23,9 +24,13 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
 
     clMemWrapper image;
 
-    // Generate some data to test against
+    // Generate some data to test against, unless the image and its read back
+    // copy don't fit in host memory, in which case the image is streamed.
+    bool streamed =
+        use_image_streaming(2 * get_image_host_size(imageInfo), ctx);
+    cl_uint seed = streamed ? genrand_int32(d) : 0;
     BufferOwningPtr<char> imageValues;
-    generate_random_image_data( imageInfo, imageValues, d );
+    if (!streamed) generate_random_image_data(imageInfo, imageValues, d);
 
     if (ctx.debugTrace)
     {
@@ -64,6 +69,11 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
             return error;
         }
     }
+
+    if (streamed)
+        return test_read_write_image_streamed(queue, image, imageInfo, seed,
+                                              ctx);
+
     if (ctx.debugTrace) log_info(" - Writing image...\n");
 
     size_t origin[ 3 ] = { 0, 0, 0 };
@@ -79,6 +89,7 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
     }
     BufferOwningPtr<char> resultValues(malloc(fullImageSize));
     size_t imgValMipLevelOffset = 0;
+    ScanlineComparator comparator( imageInfo->format );
 
     for (size_t lod = 0; (ctx.testMipmaps && lod < imageInfo->num_mip_levels)
          || (!ctx.testMipmaps && lod < 1);
@@ -131,7 +142,7 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
 
         for( size_t y = 0; y < height_lod; y++ )
         {
-            if( memcmp( sourcePtr, destPtr, scanlineSize ) != 0 )
+            if( comparator.compare( sourcePtr, destPtr, width_lod ) != width_lod )
             {
                 if (ctx.testMipmaps)
                 {
@@ -14,6 +14,12 @@
 // limitations under the License.
 //
 #include "common.h"
+#include "harness/counterRandom.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 cl_channel_type floatFormats[] = {
     CL_UNORM_SHORT_565,
@@ -626,3 +632,364 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
 
     return img;
 }
+
+cl_ulong get_image_host_size(const image_descriptor *imageInfo)
+{
+    return imageInfo->num_mip_levels > 1
+        ? compute_mipmapped_image_size(*imageInfo)
+        : get_image_size(imageInfo);
+}
+
+bool use_image_streaming(cl_ulong hostBytes, const image_test_context_t &ctx)
+{
+    return ctx.hostMemoryBudget != 0 && hostBytes > ctx.hostMemoryBudget;
+}
+
+void get_image_level_size(const image_descriptor *imageInfo, size_t lod,
+                          size_t size[3])
+{
+    image_mip_level level = get_image_mip_level(imageInfo, lod);
+    size[0] = level.width;
+    size[1] = size[2] = 1;
+    switch (imageInfo->type)
+    {
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY: size[1] = imageInfo->arraySize; break;
+        case CL_MEM_OBJECT_IMAGE2D: size[1] = level.height; break;
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            size[1] = level.height;
+            size[2] = imageInfo->arraySize;
+            break;
+        case CL_MEM_OBJECT_IMAGE3D:
+            size[1] = level.height;
+            size[2] = level.depth;
+            break;
+    }
+}
+
+// Number of coordinates of a position in the image, the mip level follows
+// them.
+static size_t get_image_coordinate_count(const image_descriptor *imageInfo)
+{
+    switch (imageInfo->type)
+    {
+        case CL_MEM_OBJECT_IMAGE1D:
+        case CL_MEM_OBJECT_IMAGE1D_BUFFER: return 1;
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+        case CL_MEM_OBJECT_IMAGE2D: return 2;
+        default: return 3;
+    }
+}
+
+void get_image_position(const image_descriptor *imageInfo, const size_t pos[],
+                        bool mipmapped, size_t coords[3], size_t *lod)
+{
+    size_t count = get_image_coordinate_count(imageInfo);
+    for (size_t i = 0; i < 3; i++) coords[i] = i < count ? pos[i] : 0;
+    *lod = mipmapped ? pos[count] : 0;
+}
+
+void generate_image_tile(const image_descriptor *imageInfo, cl_uint seed,
+                         const image_tile_t &tile, char *data)
+{
+    size_t size[3];
+    get_image_level_size(imageInfo, tile.lod, size);
+    size_t rowBytes = tile.region[0] * get_pixel_size(imageInfo->format);
+    std::vector<cl_uint> row((rowBytes + 3) / 4);
+
+    // Each level is its own counter stream, in which each row starts on a
+    // word, so that tiles of any shape regenerate the same contents.
+    cl_ulong stream = ((cl_ulong)seed << 32) ^ tile.lod;
+    for (size_t z = 0; z < tile.region[2]; z++)
+    {
+        for (size_t y = 0; y < tile.region[1]; y++)
+        {
+            cl_ulong first =
+                ((cl_ulong)(tile.origin[2] + z) * size[1] + tile.origin[1] + y)
+                * row.size();
+            counter_random_fill(stream, first, row.data(), row.size());
+
+            escape_inf_nan_subnormal_values((char *)row.data(), rowBytes);
+            memcpy(data, row.data(), rowBytes);
+            data += rowBytes;
+        }
+    }
+}
+
+// Largest number of bytes of each of the buffers a streaming function needs.
+static size_t get_tile_bytes(const image_test_context_t &ctx, size_t buffers)
+{
+    if (ctx.hostMemoryBudget == 0) return SIZE_MAX;
+    return (size_t)std::min<cl_ulong>(ctx.hostMemoryBudget / buffers,
+                                      SIZE_MAX);
+}
+
+// Call visit on each tile of level lod, from the first row to the last one.
+// Tiles hold at most tileBytes, but at least one row.
+static int
+for_each_image_tile(const image_descriptor *imageInfo, size_t lod,
+                    size_t tileBytes,
+                    const std::function<int(const image_tile_t &)> &visit)
+{
+    size_t size[3];
+    get_image_level_size(imageInfo, lod, size);
+    size_t rowBytes = size[0] * get_pixel_size(imageInfo->format);
+    size_t tileRows = std::max<size_t>(tileBytes / rowBytes, 1);
+
+    image_tile_t tile = { lod, { 0, 0, 0 }, { size[0], 1, 1 } };
+    for (size_t z = 0; z < size[2]; z += tile.region[2])
+    {
+        tile.origin[2] = z;
+        if (tileRows >= size[1])
+        {
+            tile.origin[1] = 0;
+            tile.region[1] = size[1];
+            tile.region[2] = std::min(tileRows / size[1], size[2] - z);
+            int error = visit(tile);
+            if (error) return error;
+            continue;
+        }
+
+        tile.region[2] = 1;
+        for (size_t y = 0; y < size[1]; y += tile.region[1])
+        {
+            tile.origin[1] = y;
+            tile.region[1] = std::min(tileRows, size[1] - y);
+            int error = visit(tile);
+            if (error) return error;
+        }
+    }
+    return CL_SUCCESS;
+}
+
+// Origin of tile for the clEnqueue*Image calls.
+static void get_tile_origin(const image_descriptor *imageInfo,
+                            const image_tile_t &tile, bool mipmapped,
+                            size_t origin[4])
+{
+    origin[0] = tile.origin[0];
+    origin[1] = tile.origin[1];
+    origin[2] = tile.origin[2];
+    origin[3] = 0;
+    if (mipmapped) origin[get_image_coordinate_count(imageInfo)] = tile.lod;
+}
+
+int write_image_streamed(cl_command_queue queue, cl_mem image,
+                         const image_descriptor *imageInfo, size_t lod,
+                         bool mipmapped, const image_test_context_t &ctx,
+                         const image_tile_fn &generate)
+{
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+    std::vector<char> data;
+    return for_each_image_tile(
+        imageInfo, lod, get_tile_bytes(ctx, 1), [&](const image_tile_t &tile) {
+            data.resize(tile.region[0] * tile.region[1] * tile.region[2]
+                        * pixelSize);
+            generate(tile, data.data());
+
+            size_t origin[4];
+            get_tile_origin(imageInfo, tile, mipmapped, origin);
+            cl_int error =
+                clEnqueueWriteImage(queue, image, CL_TRUE, origin, tile.region,
+                                    0, 0, data.data(), 0, nullptr, nullptr);
+            if (error != CL_SUCCESS)
+            {
+                log_error("ERROR: Unable to write rows %zu-%zu of slice %zu "
+                          "of mip level %zu: %s\n",
+                          tile.origin[1], tile.origin[1] + tile.region[1] - 1,
+                          tile.origin[2], lod, IGetErrorString(error));
+            }
+            return error;
+        });
+}
+
+int verify_image_streamed(cl_command_queue queue, cl_mem image,
+                          const image_descriptor *imageInfo, size_t lod,
+                          bool mipmapped, const image_test_context_t &ctx,
+                          const image_tile_fn &expected)
+{
+    size_t size[3];
+    get_image_level_size(imageInfo, lod, size);
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+    size_t rowBytes = size[0] * pixelSize;
+
+    // The tiles are packed, compare their rows as those of the level.
+    image_descriptor levelInfo = *imageInfo;
+    levelInfo.width = size[0];
+    levelInfo.rowPitch = rowBytes;
+    ScanlineComparator comparator(imageInfo->format);
+
+    std::vector<char> actualData, expectedData;
+    return for_each_image_tile(
+        imageInfo, lod, get_tile_bytes(ctx, 2), [&](const image_tile_t &tile) {
+            size_t tileBytes = rowBytes * tile.region[1] * tile.region[2];
+            actualData.resize(tileBytes);
+            expectedData.resize(tileBytes);
+
+            size_t origin[4];
+            get_tile_origin(imageInfo, tile, mipmapped, origin);
+            cl_int error = clEnqueueReadImage(
+                queue, image, CL_TRUE, origin, tile.region, 0, 0,
+                actualData.data(), 0, nullptr, nullptr);
+            if (error != CL_SUCCESS)
+            {
+                log_error("ERROR: Unable to read rows %zu-%zu of slice %zu "
+                          "of mip level %zu: %s\n",
+                          tile.origin[1], tile.origin[1] + tile.region[1] - 1,
+                          tile.origin[2], lod, IGetErrorString(error));
+                return error;
+            }
+            expected(tile, expectedData.data());
+
+            for (size_t i = 0; i < tile.region[1] * tile.region[2]; i++)
+            {
+                const char *expectedRow = expectedData.data() + i * rowBytes;
+                const char *actualRow = actualData.data() + i * rowBytes;
+                size_t where =
+                    comparator.compare(expectedRow, actualRow, levelInfo.width);
+                if (where < levelInfo.width)
+                {
+                    if (mipmapped)
+                        log_error("At mip level %zu\n", lod);
+                    log_error("At slice %zu\n",
+                              tile.origin[2] + i / tile.region[1]);
+                    print_first_pixel_difference_error(
+                        where, expectedRow + pixelSize * where,
+                        actualRow + pixelSize * where, &levelInfo,
+                        tile.origin[1] + i % tile.region[1], size[2]);
+                    return -1;
+                }
+            }
+            return CL_SUCCESS;
+        });
+}
+
+int test_read_write_image_streamed(cl_command_queue queue, cl_mem image,
+                                   const image_descriptor *imageInfo,
+                                   cl_uint seed,
+                                   const image_test_context_t &ctx)
+{
+    image_tile_fn generate = [&](const image_tile_t &tile, char *data) {
+        generate_image_tile(imageInfo, seed, tile, data);
+    };
+
+    size_t levels = ctx.testMipmaps ? imageInfo->num_mip_levels : 1;
+    for (size_t lod = 0; lod < levels; lod++)
+    {
+        if (ctx.debugTrace) log_info(" - Streaming mip level %zu...\n", lod);
+
+        int error = write_image_streamed(queue, image, imageInfo, lod,
+                                         ctx.testMipmaps, ctx, generate);
+        if (error) return error;
+
+        error = verify_image_streamed(queue, image, imageInfo, lod,
+                                      ctx.testMipmaps, ctx, generate);
+        if (error) return error;
+    }
+    return 0;
+}
+
+int run_image_format_tests(cl_command_queue queue,
+                           const image_test_context_t &ctx, size_t count,
+                           const image_test_header_fn &header,
+                           const image_test_run_fn &run)
+{
+    auto announce = [&](size_t index) {
+        header(index, false);
+        gTestCount++;
+    };
+    auto report = [&](size_t index, int result) {
+        if (result)
+        {
+            gFailCount++;
+            log_error("FAILED: ");
+            header(index, true);
+            log_info("\n");
+        }
+        return result;
+    };
+
+    // With randomize, each test seeds the next one, so they run in order.
+    size_t queueCount = std::min<size_t>(ctx.concurrentQueues, count);
+    if (queueCount < 2 || gReSeed)
+    {
+        int ret = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            announce(i);
+            ret += report(i, run(queue, i));
+        }
+        return ret;
+    }
+
+    cl_context context;
+    cl_int error = clGetCommandQueueInfo(queue, CL_QUEUE_CONTEXT,
+                                         sizeof(context), &context, nullptr);
+    test_error(error, "Unable to get the context of the queue");
+    cl_device_id device;
+    error = clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device),
+                                  &device, nullptr);
+    test_error(error, "Unable to get the device of the queue");
+    cl_command_queue_properties properties;
+    error = clGetCommandQueueInfo(queue, CL_QUEUE_PROPERTIES,
+                                  sizeof(properties), &properties, nullptr);
+    test_error(error, "Unable to get the properties of the queue");
+
+    std::vector<clCommandQueueWrapper> queues(queueCount);
+    for (auto &workerQueue : queues)
+    {
+        workerQueue = clCreateCommandQueue(context, device, properties, &error);
+        test_error(error, "Unable to create a test queue");
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<int> results(count);
+    std::vector<bool> done(count, false);
+    size_t next = 0;
+    size_t reported = 0;
+    const size_t window = 2 * queueCount;
+
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < queueCount; w++)
+    {
+        workers.emplace_back([&, w] {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;)
+            {
+                changed.wait(lock, [&] {
+                    return next >= count || next < reported + window;
+                });
+                if (next >= count) return;
+                size_t index = next++;
+
+                lock.unlock();
+                int result = run(queues[w], index);
+                lock.lock();
+
+                results[index] = result;
+                done[index] = true;
+                changed.notify_all();
+            }
+        });
+    }
+
+    int ret = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (size_t i = 0; i < count; i++)
+    {
+        changed.wait(lock, [&] { return done[i]; });
+        int result = results[i];
+
+        lock.unlock();
+        announce(i);
+        ret += report(i, result);
+        lock.lock();
+
+        reported = i + 1;
+        changed.notify_all();
+    }
+    lock.unlock();
+
+    for (auto &worker : workers) worker.join();
+    return ret;
+}
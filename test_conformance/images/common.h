@@ -22,6 +22,7 @@
 #include "harness/conversions.h"
 
 #include <array>
+#include <functional>
 #include <vector>
 
 extern cl_channel_type gChannelTypeToUse;
@@ -64,4 +65,81 @@ clMemWrapper create_image(cl_context context, cl_command_queue queue,
                           image_descriptor *imageInfo, bool enable_pitch,
                           bool create_mipmaps, bool debugTrace, int *error);
 
+// Streaming of images too large to keep copies of in host memory, used when
+// the host copies would exceed the budget given with host_memory_budget.  The
+// contents of a streamed image are generated row by row from a seed, so that
+// any part of it can be regenerated to verify it.  Images are written and
+// verified in tiles of whole rows, each of which fits in the budget.
+
+// A tile of level lod of an image, in image coordinates.  The tile is either
+// rows of one slice or whole slices, its pixels are packed.
+struct image_tile_t
+{
+    size_t lod;
+    size_t origin[3];
+    size_t region[3];
+};
+
+// Produce the pixels of tile in data.
+typedef std::function<void(const image_tile_t &tile, char *data)>
+    image_tile_fn;
+
+// Bytes of the host copy of an image made by generate_random_image_data.
+cl_ulong get_image_host_size(const image_descriptor *imageInfo);
+
+// Whether an image test keeping hostBytes of image data in host memory has to
+// stream its images.
+bool use_image_streaming(cl_ulong hostBytes, const image_test_context_t &ctx);
+
+// Width, height (or 1D array size) and depth (or 2D array size) of level lod.
+void get_image_level_size(const image_descriptor *imageInfo, size_t lod,
+                          size_t size[3]);
+
+// Split the position of a clEnqueue*Image call into the coordinates and the
+// mip level.
+void get_image_position(const image_descriptor *imageInfo, const size_t pos[],
+                        bool mipmapped, size_t coords[3], size_t *lod);
+
+// Generate the rows of tile of an image filled from seed.
+void generate_image_tile(const image_descriptor *imageInfo, cl_uint seed,
+                         const image_tile_t &tile, char *data);
+
+// Write level lod of image with the tiles made by generate.
+int write_image_streamed(cl_command_queue queue, cl_mem image,
+                         const image_descriptor *imageInfo, size_t lod,
+                         bool mipmapped, const image_test_context_t &ctx,
+                         const image_tile_fn &generate);
+
+// Read back level lod of image and compare it with the tiles made by expected.
+int verify_image_streamed(cl_command_queue queue, cl_mem image,
+                          const image_descriptor *imageInfo, size_t lod,
+                          bool mipmapped, const image_test_context_t &ctx,
+                          const image_tile_fn &expected);
+
+// Write every level of image with contents generated from seed, then read it
+// back and verify it.
+int test_read_write_image_streamed(cl_command_queue queue, cl_mem image,
+                                   const image_descriptor *imageInfo,
+                                   cl_uint seed,
+                                   const image_test_context_t &ctx);
+
+// Format loops of the image suites.  Each of the count tests of a loop is
+// announced with header(index, false) and run with run(queue, index).  A test
+// that fails is counted in gFailCount and reported with header(index, true).
+//
+// With concurrent_queues N, the tests run on N threads, each with its own
+// queue of the context of queue, so that the host verification of one test
+// overlaps the device work of the others.  Tests start at most 2 * N ahead of
+// the first one not reported yet, and their headers and results are reported
+// in the order of the loop as they complete.  The log output of the tests
+// themselves may interleave.
+typedef std::function<void(size_t index, bool error)> image_test_header_fn;
+typedef std::function<int(cl_command_queue queue, size_t index)>
+    image_test_run_fn;
+
+int run_image_format_tests(cl_command_queue queue,
+                           const image_test_context_t &ctx, size_t count,
+                           const image_test_header_fn &header,
+                           const image_test_run_fn &run);
+
 #endif // IMAGES_COMMON_H
@@ -15,6 +15,7 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../testBase.h"
 #include "../harness/compat.h"
@@ -345,6 +346,7 @@ static test_status parseArgs(int &argc, const char *argv[],
         extra_validate - Enables additional validation failure debug information
         use_pitches - Enables row and slice pitches
         test_mipmaps - Enables mipmapped images
+        concurrent_queues <N> - Runs up to 2 * N format tests at once on N queues, overlapping the verification of each with the device work of the others. The output of the tests may interleave; not used with randomize
 )";
 
     cl_channel_type chanType;
@@ -390,6 +392,11 @@ static test_status parseArgs(int &argc, const char *argv[],
             ctx.testMaxImages = true;
         else if( strcmp( argv[i], "use_pitches" ) == 0 )
             ctx.enablePitch = true;
+        else if( strcmp( argv[i], "concurrent_queues" ) == 0 && i + 1 < argc )
+        {
+            removed_args.back() += std::string( " " ) + argv[ i + 1 ];
+            ctx.concurrentQueues = (cl_uint)strtoul( argv[ ++i ], nullptr, 10 );
+        }
         else if( strcmp( argv[i], "rounding" ) == 0 )
             gTestRounding = true;
         else if( strcmp( argv[i], "extra_validate" ) == 0 )
@@ -17,6 +17,7 @@
 #include "test_common.h"
 
 #include <algorithm>
+#include <atomic>
 
 cl_sampler create_sampler(cl_context context, image_sampler_data *sdata, bool test_mipmaps, cl_int *error) {
     cl_sampler sampler = nullptr;
@@ -75,6 +76,24 @@ bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
     return get_image_dimensions(imageInfo, width, height, depth, ignoreMe);
 }
 
+// Dimensions of mip level lod of imageInfo, in the same order as
+// get_image_dimensions.
+static void get_mip_level_dimensions(image_descriptor *imageInfo, int lod,
+                                     size_t &width, size_t &height,
+                                     size_t &depth)
+{
+    get_image_dimensions(imageInfo, width, height, depth);
+    if (lod > 0)
+    {
+        image_mip_level level = get_image_mip_level(imageInfo, lod);
+        width = level.width;
+        if (imageInfo->type != CL_MEM_OBJECT_IMAGE1D
+            && imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY)
+            height = level.height;
+        if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D) depth = level.depth;
+    }
+}
+
 static bool InitFloatCoordsCommon(image_descriptor *imageInfo,
                                   image_sampler_data *imageSampler,
                                   float *xOffsets, float *yOffsets,
@@ -177,19 +196,9 @@ static bool InitFloatCoordsCommon(image_descriptor *imageInfo,
             }
             else if (ctx.testMipmaps)
             {
-                size_t width_lod =
-                    (width_loop >> lod) ? (width_loop >> lod) : 1;
-                size_t height_lod = height_loop;
-                size_t depth_lod = depth_loop;
-                if (imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY)
-                {
-                    height_lod =
-                        (height_loop >> lod) ? (height_loop >> lod) : 1;
-                }
-                if (imageInfo->type != CL_MEM_OBJECT_IMAGE2D_ARRAY)
-                {
-                    depth_lod = (depth_loop >> lod) ? (depth_loop >> lod) : 1;
-                }
+                size_t width_lod, height_lod, depth_lod;
+                get_mip_level_dimensions(imageInfo, lod, width_lod, height_lod,
+                                         depth_lod);
 
                 for (size_t z = 0; z < depth_lod; z++)
                 {
@@ -288,7 +297,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                           || (imageInfo->type == CL_MEM_OBJECT_IMAGE3D));
 
     int error;
-    static int initHalf = 0;
+    static std::atomic<int> initHalf(0);
     int num_dimensions;
 
     size_t image_size =
@@ -475,13 +484,16 @@ int test_read_image(cl_context context, cl_command_queue queue,
         }
         else
         {
-            int nextLevelOffset = 0;
             for (int i = 0; i < imageInfo->num_mip_levels; i++)
             {
+                get_mip_level_dimensions(imageInfo, i, region[0], region[1],
+                                         region[2]);
                 origin[num_dimensions] = i;
                 error = clEnqueueWriteImage(
                     queue, image, CL_TRUE, origin, region, 0, 0,
-                    ((char *)imageValues + nextLevelOffset), 0, NULL, NULL);
+                    ((char *)imageValues
+                     + get_image_mip_level(imageInfo, i).offset),
+                    0, NULL, NULL);
                 if (error != CL_SUCCESS)
                 {
                     log_error("ERROR: Unable to write to %d level mipmapped "
@@ -491,19 +503,6 @@ int test_read_image(cl_context context, cl_command_queue queue,
                               (int)imageInfo->arraySize, (int)imageInfo->depth);
                     return error;
                 }
-                nextLevelOffset += region[0] * region[1] * region[2]
-                    * get_pixel_size(imageInfo->format);
-                // Subsequent mip level dimensions keep halving
-                // Regions for unnecessary dimensions are already 1.
-                region[0] = region[0] >> 1 ? region[0] >> 1 : 1;
-                if (imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY)
-                {
-                    region[1] = region[1] >> 1 ? region[1] >> 1 : 1;
-                }
-                if (imageInfo->type != CL_MEM_OBJECT_IMAGE2D_ARRAY)
-                {
-                    region[2] = region[2] >> 1 ? region[2] >> 1 : 1;
-                }
             }
         }
     }
@@ -597,15 +596,14 @@ int test_read_image(cl_context context, cl_command_queue queue,
         }
     }
 
-    int nextLevelOffset = 0;
-    size_t width_lod = width_size, height_lod = height_size,
-           depth_lod = depth_size;
-
     // Loop over all mipmap levels, if we are testing mipmapped images.
     for (int lod = 0; (ctx.testMipmaps && lod < imageInfo->num_mip_levels)
          || (!ctx.testMipmaps && lod < 1);
          lod++)
     {
+        size_t width_lod, height_lod, depth_lod;
+        get_mip_level_dimensions(imageInfo, lod, width_lod, height_lod,
+                                 depth_lod);
         size_t image_lod_size = get_image_num_pixels(
             imageInfo, width_lod, height_lod, depth_lod, imageInfo->arraySize);
         test_assert_error(0 != image_lod_size, "Invalid image size");
@@ -621,6 +619,10 @@ int test_read_image(cl_context context, cl_command_queue queue,
             test_error(error, "Unable to set kernel arguments");
         }
 
+        // Resolve the format and the geometry of the level once for all the
+        // reference samples below.
+        TexelSampler texelSampler(imageInfo, imageSampler, lod);
+
         for (int q = 0; q < loopCount; q++)
         {
             float offset = float_offsets[q % float_offset_count];
@@ -676,7 +678,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
             if (ctx.debugTrace) log_info("    results read\n");
 
             // Validate results element by element
-            char *imagePtr = (char *)imageValues + nextLevelOffset;
+            char *imagePtr = (char *)imageValues
+                + get_image_mip_level(imageInfo, lod).offset;
             if (((imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
                  && (imageInfo->format->image_channel_order == CL_DEPTH))
                 && (outputType == kFloat))
@@ -688,113 +691,115 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     imageInfo->format, imageSampler, image_type_3D,
                     CL_FILTER_LINEAR == imageSampler->filter_mode);
 
-                for (size_t z = 0, j = 0; z < depth_lod; z++)
-                {
-                    for (size_t y = 0; y < height_lod; y++)
-                    {
-                        for (size_t x = 0; x < width_lod; x++, j++)
-                        {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
-                            int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            float offset = NORM_OFFSET;
-                            if (!imageSampler->normalized_coords
-                                || imageSampler->filter_mode
-                                    != CL_FILTER_NEAREST
-                                || NORM_OFFSET == 0
+                float offset = NORM_OFFSET;
+                if (!imageSampler->normalized_coords
+                    || imageSampler->filter_mode != CL_FILTER_NEAREST
+                    || NORM_OFFSET == 0
 #if defined(__APPLE__)
-                                // Apple requires its CPU implementation to do
-                                // correctly rounded address arithmetic in all
-                                // modes
-                                || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+                    // Apple requires its CPU implementation to do correctly
+                    // rounded address arithmetic in all modes
+                    || !(gDeviceType & CL_DEVICE_TYPE_GPU)
 #endif
-                            )
-                                offset = 0.0f; // Loop only once
-
-                            for (float norm_offset_x = -offset;
-                                 norm_offset_x <= offset && !found_pixel;
-                                 norm_offset_x += NORM_OFFSET)
+                )
+                    offset = 0.0f; // Loop only once
+
+                // Step 1: go through and see if the results verify for the
+                // pixel For the normalized case on a GPU we put in offsets to
+                // the X, Y and Z to see if we land on the right pixel. This
+                // addresses the significant inaccuracy in GPU normalization in
+                // OpenCL 1.0.
+                auto verify = [&](size_t j) {
+                    const float *resultPtr =
+                        (const float *)(char *)resultValues + j;
+                    float expected[4];
+                    int found_pixel = 0;
+
+                    for (float norm_offset_x = -offset;
+                         norm_offset_x <= offset && !found_pixel;
+                         norm_offset_x += NORM_OFFSET)
+                    {
+                        for (float norm_offset_y = -offset;
+                             norm_offset_y <= offset && !found_pixel;
+                             norm_offset_y += NORM_OFFSET)
+                        {
+                            for (float norm_offset_z = -offset;
+                                 norm_offset_z <= NORM_OFFSET
+                                 && !found_pixel;
+                                 norm_offset_z += NORM_OFFSET)
                             {
-                                for (float norm_offset_y = -offset;
-                                     norm_offset_y <= offset && !found_pixel;
-                                     norm_offset_y += NORM_OFFSET)
+
+                                int hasDenormals = 0;
+                                FloatPixel maxPixel =
+                                    texelSampler.sample(
+                                        imagePtr, xOffsetValues[j],
+                                        yOffsetValues[j],
+                                        zOffsetValues[j], norm_offset_x,
+                                        norm_offset_y, norm_offset_z,
+                                        expected, 0, &hasDenormals);
+
+                                float err1 = ABS_ERROR(resultPtr[0],
+                                                       expected[0]);
+                                // Clamp to the minimum absolute error for the
+                                // format
+                                if (err1 > 0
+                                    && err1 < formatAbsoluteError)
                                 {
-                                    for (float norm_offset_z = -offset;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
+                                    err1 = 0.0f;
+                                }
+                                float maxErr1 = std::max(
+                                    maxErr * maxPixel.p[0], FLT_MIN);
 
-                                        int hasDenormals = 0;
-                                        FloatPixel maxPixel =
-                                            sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
+                                if (!(err1 <= maxErr1))
+                                {
+                                    // Try flushing the denormals
+                                    if (hasDenormals)
+                                    {
+                                        // If implementation decide to flush
+                                        // subnormals to zero, max error needs
+                                        // to be adjusted
+                                        maxErr1 += 4 * FLT_MIN;
+
+                                        maxPixel =
+                                            texelSampler.sample(
+                                                imagePtr,
                                                 xOffsetValues[j],
                                                 yOffsetValues[j],
-                                                zOffsetValues[j], norm_offset_x,
-                                                norm_offset_y, norm_offset_z,
-                                                imageSampler, expected, 0,
-                                                &hasDenormals, lod);
-
-                                        float err1 = ABS_ERROR(resultPtr[0],
-                                                               expected[0]);
-                                        // Clamp to the minimum absolute error
-                                        // for the format
-                                        if (err1 > 0
-                                            && err1 < formatAbsoluteError)
-                                        {
-                                            err1 = 0.0f;
-                                        }
-                                        float maxErr1 = std::max(
-                                            maxErr * maxPixel.p[0], FLT_MIN);
-
-                                        if (!(err1 <= maxErr1))
-                                        {
-                                            // Try flushing the denormals
-                                            if (hasDenormals)
-                                            {
-                                                // If implementation decide to
-                                                // flush subnormals to zero, max
-                                                // error needs to be adjusted
-                                                maxErr1 += 4 * FLT_MIN;
-
-                                                maxPixel =
-                                                    sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
-                                                        xOffsetValues[j],
-                                                        yOffsetValues[j],
-                                                        zOffsetValues[j],
-                                                        norm_offset_x,
-                                                        norm_offset_y,
-                                                        norm_offset_z,
-                                                        imageSampler, expected,
-                                                        0, NULL, lod);
-
-                                                err1 = ABS_ERROR(resultPtr[0],
-                                                                 expected[0]);
-                                            }
-                                        }
-
-                                        found_pixel = (err1 <= maxErr1);
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                                                zOffsetValues[j],
+                                                norm_offset_x,
+                                                norm_offset_y,
+                                                norm_offset_z, expected,
+                                                0, NULL);
+
+                                        err1 = ABS_ERROR(resultPtr[0],
+                                                         expected[0]);
+                                    }
+                                }
+
+                                found_pixel = (err1 <= maxErr1);
+                            } // norm_offset_z
+                        } // norm_offset_y
+                    } // norm_offset_x
+                    return found_pixel != 0;
+                };
+                ValidationTiles tiles(width_lod * height_lod * depth_lod,
+                                      width_lod, verify);
 
+                for (size_t z = 0, j = 0; z < depth_lod; z++)
+                {
+                    for (size_t y = 0; y < height_lod; y++)
+                    {
+                        for (size_t x = 0; x < width_lod; x++, j++)
+                        {
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
-                            if (!found_pixel)
+                            if (tiles.needs_check(j) && !verify(j))
                             {
                                 // For the normalized case on a GPU we put in
                                 // offsets to the X and Y to see if we land on
                                 // the right pixel. This addresses the
                                 // significant inaccuracy in GPU normalization
                                 // in OpenCL 1.0.
-                                checkOnlyOnePixel = 0;
+                                int checkOnlyOnePixel = 0;
                                 int shouldReturn = 0;
                                 for (float norm_offset_x = -offset;
                                      norm_offset_x <= offset
@@ -814,16 +819,14 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                             int hasDenormals = 0;
                                             FloatPixel maxPixel =
-                                                sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
-                                                    xOffsetValues[j],
+                                                texelSampler.sample(
+                                                    imagePtr, xOffsetValues[j],
                                                     yOffsetValues[j],
                                                     zOffsetValues[j],
                                                     norm_offset_x,
                                                     norm_offset_y,
-                                                    norm_offset_z, imageSampler,
-                                                    expected, 0, &hasDenormals,
-                                                    lod);
+                                                    norm_offset_z, expected, 0,
+                                                    &hasDenormals);
 
                                             float err1 = ABS_ERROR(resultPtr[0],
                                                                    expected[0]);
@@ -840,14 +843,12 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     maxErr1 += 4 * FLT_MIN;
 
                                                     maxPixel =
-                                                        sample_image_pixel_float(
-                                                            imagePtr, imageInfo,
+                                                        texelSampler.sample(
+                                                            imagePtr,
                                                             xOffsetValues[j],
                                                             yOffsetValues[j],
                                                             zOffsetValues[j],
-                                                            imageSampler,
-                                                            expected, 0, NULL,
-                                                            lod);
+                                                            expected, 0, NULL);
 
                                                     err1 =
                                                         ABS_ERROR(resultPtr[0],
@@ -880,16 +881,15 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                         numTries, numClamped,
                                                         true, lod, ctx);
                                                 log_error("Step by step:\n");
-                                                sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
-                                                    xOffsetValues[j],
+                                                texelSampler.sample(
+                                                    imagePtr, xOffsetValues[j],
                                                     yOffsetValues[j],
                                                     zOffsetValues[j],
                                                     norm_offset_x,
                                                     norm_offset_y,
-                                                    norm_offset_z, imageSampler,
-                                                    tempOut, 1 /*verbose*/,
-                                                    &hasDenormals, lod);
+                                                    norm_offset_z, tempOut,
+                                                    1 /*verbose*/,
+                                                    &hasDenormals);
                                                 log_error(
                                                     "\tulps: %2.2f  (max "
                                                     "allowed: %2.2f)\n\n",
@@ -932,167 +932,169 @@ int test_read_image(cl_context context, cl_command_queue queue,
                 float *resultPtr = (float *)(char *)resultValues;
                 float expected[4], error = 0.0f;
 
-                for (size_t z = 0, j = 0; z < depth_lod; z++)
-                {
-                    for (size_t y = 0; y < height_lod; y++)
-                    {
-                        for (size_t x = 0; x < width_lod; x++, j++)
-                        {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
-                            int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            float offset = NORM_OFFSET;
-                            if (!imageSampler->normalized_coords
-                                || imageSampler->filter_mode
-                                    != CL_FILTER_NEAREST
-                                || NORM_OFFSET == 0
+                float offset = NORM_OFFSET;
+                if (!imageSampler->normalized_coords
+                    || imageSampler->filter_mode != CL_FILTER_NEAREST
+                    || NORM_OFFSET == 0
 #if defined(__APPLE__)
-                                // Apple requires its CPU implementation to do
-                                // correctly rounded address arithmetic in all
-                                // modes
-                                || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+                    // Apple requires its CPU implementation to do correctly
+                    // rounded address arithmetic in all modes
+                    || !(gDeviceType & CL_DEVICE_TYPE_GPU)
 #endif
-                            )
-                                offset = 0.0f; // Loop only once
-
-                            for (float norm_offset_x = -offset;
-                                 norm_offset_x <= offset && !found_pixel;
-                                 norm_offset_x += NORM_OFFSET)
+                )
+                    offset = 0.0f; // Loop only once
+
+                // Step 1: go through and see if the results verify for the
+                // pixel For the normalized case on a GPU we put in offsets to
+                // the X, Y and Z to see if we land on the right pixel. This
+                // addresses the significant inaccuracy in GPU normalization in
+                // OpenCL 1.0.
+                auto verify = [&](size_t j) {
+                    const float *resultPtr =
+                        (const float *)(char *)resultValues + 4 * j;
+                    float expected[4];
+                    int found_pixel = 0;
+
+                    for (float norm_offset_x = -offset;
+                         norm_offset_x <= offset && !found_pixel;
+                         norm_offset_x += NORM_OFFSET)
+                    {
+                        for (float norm_offset_y = -offset;
+                             norm_offset_y <= offset && !found_pixel;
+                             norm_offset_y += NORM_OFFSET)
+                        {
+                            for (float norm_offset_z = -offset;
+                                 norm_offset_z <= NORM_OFFSET
+                                 && !found_pixel;
+                                 norm_offset_z += NORM_OFFSET)
                             {
-                                for (float norm_offset_y = -offset;
-                                     norm_offset_y <= offset && !found_pixel;
-                                     norm_offset_y += NORM_OFFSET)
+
+                                int hasDenormals = 0;
+                                FloatPixel maxPixel =
+                                    texelSampler.sample(
+                                        imagePtr, xOffsetValues[j],
+                                        (num_dimensions > 1)
+                                            ? yOffsetValues[j]
+                                            : 0.0f,
+                                        image_type_3D ? zOffsetValues[j]
+                                                      : 0.0f,
+                                        norm_offset_x,
+                                        (num_dimensions > 1)
+                                            ? norm_offset_y
+                                            : 0.0f,
+                                        image_type_3D ? norm_offset_z
+                                                      : 0.0f,
+                                        expected, 0, &hasDenormals);
+
+                                float err1 =
+                                    ABS_ERROR(sRGBmap(resultPtr[0]),
+                                              sRGBmap(expected[0]));
+                                float err2 =
+                                    ABS_ERROR(sRGBmap(resultPtr[1]),
+                                              sRGBmap(expected[1]));
+                                float err3 =
+                                    ABS_ERROR(sRGBmap(resultPtr[2]),
+                                              sRGBmap(expected[2]));
+                                float err4 = ABS_ERROR(resultPtr[3],
+                                                       expected[3]);
+                                // Clamp to the minimum absolute error for the
+                                // format
+                                if (err1 > 0
+                                    && err1 < formatAbsoluteError)
                                 {
-                                    for (float norm_offset_z = -offset;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel;
-                                         norm_offset_z += NORM_OFFSET)
+                                    err1 = 0.0f;
+                                }
+                                if (err2 > 0
+                                    && err2 < formatAbsoluteError)
+                                {
+                                    err2 = 0.0f;
+                                }
+                                if (err3 > 0
+                                    && err3 < formatAbsoluteError)
+                                {
+                                    err3 = 0.0f;
+                                }
+                                if (err4 > 0
+                                    && err4 < formatAbsoluteError)
+                                {
+                                    err4 = 0.0f;
+                                }
+                                float maxErr = 0.5;
+
+                                if (!(err1 <= maxErr)
+                                    || !(err2 <= maxErr)
+                                    || !(err3 <= maxErr)
+                                    || !(err4 <= maxErr))
+                                {
+                                    // Try flushing the denormals
+                                    if (hasDenormals)
                                     {
-
-                                        int hasDenormals = 0;
-                                        FloatPixel maxPixel =
-                                            sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
+                                        // If implementation decide to flush
+                                        // subnormals to zero, max error needs
+                                        // to be adjusted
+                                        maxErr += 4 * FLT_MIN;
+
+                                        maxPixel =
+                                            texelSampler.sample(
+                                                imagePtr,
                                                 xOffsetValues[j],
                                                 (num_dimensions > 1)
                                                     ? yOffsetValues[j]
                                                     : 0.0f,
-                                                image_type_3D ? zOffsetValues[j]
-                                                              : 0.0f,
+                                                image_type_3D
+                                                    ? zOffsetValues[j]
+                                                    : 0.0f,
                                                 norm_offset_x,
                                                 (num_dimensions > 1)
                                                     ? norm_offset_y
                                                     : 0.0f,
-                                                image_type_3D ? norm_offset_z
-                                                              : 0.0f,
-                                                imageSampler, expected, 0,
-                                                &hasDenormals, lod);
-
-                                        float err1 =
-                                            ABS_ERROR(sRGBmap(resultPtr[0]),
-                                                      sRGBmap(expected[0]));
-                                        float err2 =
-                                            ABS_ERROR(sRGBmap(resultPtr[1]),
-                                                      sRGBmap(expected[1]));
-                                        float err3 =
-                                            ABS_ERROR(sRGBmap(resultPtr[2]),
-                                                      sRGBmap(expected[2]));
-                                        float err4 = ABS_ERROR(resultPtr[3],
-                                                               expected[3]);
-                                        // Clamp to the minimum absolute error
-                                        // for the format
-                                        if (err1 > 0
-                                            && err1 < formatAbsoluteError)
-                                        {
-                                            err1 = 0.0f;
-                                        }
-                                        if (err2 > 0
-                                            && err2 < formatAbsoluteError)
-                                        {
-                                            err2 = 0.0f;
-                                        }
-                                        if (err3 > 0
-                                            && err3 < formatAbsoluteError)
-                                        {
-                                            err3 = 0.0f;
-                                        }
-                                        if (err4 > 0
-                                            && err4 < formatAbsoluteError)
-                                        {
-                                            err4 = 0.0f;
-                                        }
-                                        float maxErr = 0.5;
-
-                                        if (!(err1 <= maxErr)
-                                            || !(err2 <= maxErr)
-                                            || !(err3 <= maxErr)
-                                            || !(err4 <= maxErr))
-                                        {
-                                            // Try flushing the denormals
-                                            if (hasDenormals)
-                                            {
-                                                // If implementation decide to
-                                                // flush subnormals to zero, max
-                                                // error needs to be adjusted
-                                                maxErr += 4 * FLT_MIN;
-
-                                                maxPixel =
-                                                    sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
-                                                        xOffsetValues[j],
-                                                        (num_dimensions > 1)
-                                                            ? yOffsetValues[j]
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? zOffsetValues[j]
-                                                            : 0.0f,
-                                                        norm_offset_x,
-                                                        (num_dimensions > 1)
-                                                            ? norm_offset_y
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? norm_offset_z
-                                                            : 0.0f,
-                                                        imageSampler, expected,
-                                                        0, NULL, lod);
-
-                                                err1 = ABS_ERROR(
-                                                    sRGBmap(resultPtr[0]),
-                                                    sRGBmap(expected[0]));
-                                                err2 = ABS_ERROR(
-                                                    sRGBmap(resultPtr[1]),
-                                                    sRGBmap(expected[1]));
-                                                err3 = ABS_ERROR(
-                                                    sRGBmap(resultPtr[2]),
-                                                    sRGBmap(expected[2]));
-                                                err4 = ABS_ERROR(resultPtr[3],
-                                                                 expected[3]);
-                                            }
-                                        }
-
-                                        found_pixel = (err1 <= maxErr)
-                                            && (err2 <= maxErr)
-                                            && (err3 <= maxErr)
-                                            && (err4 <= maxErr);
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                                                image_type_3D
+                                                    ? norm_offset_z
+                                                    : 0.0f,
+                                                expected, 0, NULL);
+
+                                        err1 = ABS_ERROR(
+                                            sRGBmap(resultPtr[0]),
+                                            sRGBmap(expected[0]));
+                                        err2 = ABS_ERROR(
+                                            sRGBmap(resultPtr[1]),
+                                            sRGBmap(expected[1]));
+                                        err3 = ABS_ERROR(
+                                            sRGBmap(resultPtr[2]),
+                                            sRGBmap(expected[2]));
+                                        err4 = ABS_ERROR(resultPtr[3],
+                                                         expected[3]);
+                                    }
+                                }
+
+                                found_pixel = (err1 <= maxErr)
+                                    && (err2 <= maxErr)
+                                    && (err3 <= maxErr)
+                                    && (err4 <= maxErr);
+                            } // norm_offset_z
+                        } // norm_offset_y
+                    } // norm_offset_x
+                    return found_pixel != 0;
+                };
+                ValidationTiles tiles(width_lod * height_lod * depth_lod,
+                                      width_lod, verify);
 
+                for (size_t z = 0, j = 0; z < depth_lod; z++)
+                {
+                    for (size_t y = 0; y < height_lod; y++)
+                    {
+                        for (size_t x = 0; x < width_lod; x++, j++)
+                        {
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
-                            if (!found_pixel)
+                            if (tiles.needs_check(j) && !verify(j))
                             {
                                 // For the normalized case on a GPU we put in
                                 // offsets to the X and Y to see if we land on
                                 // the right pixel. This addresses the
                                 // significant inaccuracy in GPU normalization
                                 // in OpenCL 1.0.
-                                checkOnlyOnePixel = 0;
+                                int checkOnlyOnePixel = 0;
                                 int shouldReturn = 0;
                                 for (float norm_offset_x = -offset;
                                      norm_offset_x <= offset
@@ -1126,9 +1128,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                             int hasDenormals = 0;
                                             FloatPixel maxPixel =
-                                                sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
-                                                    xOffsetValues[j],
+                                                texelSampler.sample(
+                                                    imagePtr, xOffsetValues[j],
                                                     (num_dimensions > 1)
                                                         ? yOffsetValues[j]
                                                         : 0.0f,
@@ -1142,8 +1143,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     image_type_3D
                                                         ? norm_offset_z
                                                         : 0.0f,
-                                                    imageSampler, expected, 0,
-                                                    &hasDenormals, lod);
+                                                    expected, 0, &hasDenormals);
 
                                             float err1 =
                                                 ABS_ERROR(sRGBmap(resultPtr[0]),
@@ -1173,8 +1173,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     maxErr += 4 * FLT_MIN;
 
                                                     maxPixel =
-                                                        sample_image_pixel_float(
-                                                            imagePtr, imageInfo,
+                                                        texelSampler.sample(
+                                                            imagePtr,
                                                             xOffsetValues[j],
                                                             (num_dimensions > 1)
                                                                 ? yOffsetValues
@@ -1184,9 +1184,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                                 ? zOffsetValues
                                                                     [j]
                                                                 : 0.0f,
-                                                            imageSampler,
-                                                            expected, 0, NULL,
-                                                            lod);
+                                                            expected, 0, NULL);
 
                                                     err1 = ABS_ERROR(
                                                         sRGBmap(resultPtr[0]),
@@ -1239,9 +1237,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                         j, numTries, numClamped,
                                                         true, lod, ctx);
                                                 log_error("Step by step:\n");
-                                                sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
-                                                    xOffsetValues[j],
+                                                texelSampler.sample(
+                                                    imagePtr, xOffsetValues[j],
                                                     (num_dimensions > 1)
                                                         ? yOffsetValues[j]
                                                         : 0.0f,
@@ -1255,9 +1252,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     image_type_3D
                                                         ? norm_offset_z
                                                         : 0.0f,
-                                                    imageSampler, tempOut,
-                                                    1 /*verbose*/,
-                                                    &hasDenormals, lod);
+                                                    tempOut, 1 /*verbose*/,
+                                                    &hasDenormals);
                                                 log_error(
                                                     "\tulps: %2.2f, %2.2f, "
                                                     "%2.2f, %2.2f  (max "
@@ -1309,171 +1305,173 @@ int test_read_image(cl_context context, cl_command_queue queue,
                     imageInfo->format, imageSampler, image_type_3D,
                     CL_FILTER_LINEAR == imageSampler->filter_mode);
 
-                for (size_t z = 0, j = 0; z < depth_lod; z++)
-                {
-                    for (size_t y = 0; y < height_lod; y++)
-                    {
-                        for (size_t x = 0; x < width_lod; x++, j++)
-                        {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
-                            int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            float offset = NORM_OFFSET;
-                            if (!imageSampler->normalized_coords
-                                || imageSampler->filter_mode
-                                    != CL_FILTER_NEAREST
-                                || NORM_OFFSET == 0
+                float offset = NORM_OFFSET;
+                if (!imageSampler->normalized_coords
+                    || imageSampler->filter_mode != CL_FILTER_NEAREST
+                    || NORM_OFFSET == 0
 #if defined(__APPLE__)
-                                // Apple requires its CPU implementation to do
-                                // correctly rounded address arithmetic in all
-                                // modes
-                                || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+                    // Apple requires its CPU implementation to do correctly
+                    // rounded address arithmetic in all modes
+                    || !(gDeviceType & CL_DEVICE_TYPE_GPU)
 #endif
-                            )
-                                offset = 0.0f; // Loop only once
-
-                            for (float norm_offset_x = -offset;
-                                 norm_offset_x <= offset && !found_pixel;
-                                 norm_offset_x += NORM_OFFSET)
+                )
+                    offset = 0.0f; // Loop only once
+
+                // Step 1: go through and see if the results verify for the
+                // pixel For the normalized case on a GPU we put in offsets to
+                // the X, Y and Z to see if we land on the right pixel. This
+                // addresses the significant inaccuracy in GPU normalization in
+                // OpenCL 1.0.
+                auto verify = [&](size_t j) {
+                    const float *resultPtr =
+                        (const float *)(char *)resultValues + 4 * j;
+                    float expected[4];
+                    int found_pixel = 0;
+
+                    for (float norm_offset_x = -offset;
+                         norm_offset_x <= offset && !found_pixel;
+                         norm_offset_x += NORM_OFFSET)
+                    {
+                        for (float norm_offset_y = -offset;
+                             norm_offset_y <= offset && !found_pixel;
+                             norm_offset_y += NORM_OFFSET)
+                        {
+                            for (float norm_offset_z = -offset;
+                                 norm_offset_z <= NORM_OFFSET
+                                 && !found_pixel;
+                                 norm_offset_z += NORM_OFFSET)
                             {
-                                for (float norm_offset_y = -offset;
-                                     norm_offset_y <= offset && !found_pixel;
-                                     norm_offset_y += NORM_OFFSET)
+
+                                int hasDenormals = 0;
+                                FloatPixel maxPixel =
+                                    texelSampler.sample(
+                                        imagePtr, xOffsetValues[j],
+                                        (num_dimensions > 1)
+                                            ? yOffsetValues[j]
+                                            : 0.0f,
+                                        image_type_3D ? zOffsetValues[j]
+                                                      : 0.0f,
+                                        norm_offset_x,
+                                        (num_dimensions > 1)
+                                            ? norm_offset_y
+                                            : 0.0f,
+                                        image_type_3D ? norm_offset_z
+                                                      : 0.0f,
+                                        expected, 0, &hasDenormals);
+
+                                float err1 = ABS_ERROR(resultPtr[0],
+                                                       expected[0]);
+                                float err2 = ABS_ERROR(resultPtr[1],
+                                                       expected[1]);
+                                float err3 = ABS_ERROR(resultPtr[2],
+                                                       expected[2]);
+                                float err4 = ABS_ERROR(resultPtr[3],
+                                                       expected[3]);
+                                // Clamp to the minimum absolute error for the
+                                // format
+                                if (err1 > 0
+                                    && err1 < formatAbsoluteError)
+                                {
+                                    err1 = 0.0f;
+                                }
+                                if (err2 > 0
+                                    && err2 < formatAbsoluteError)
                                 {
-                                    for (float norm_offset_z = -offset;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel;
-                                         norm_offset_z += NORM_OFFSET)
+                                    err2 = 0.0f;
+                                }
+                                if (err3 > 0
+                                    && err3 < formatAbsoluteError)
+                                {
+                                    err3 = 0.0f;
+                                }
+                                if (err4 > 0
+                                    && err4 < formatAbsoluteError)
+                                {
+                                    err4 = 0.0f;
+                                }
+                                float maxErr1 = std::max(
+                                    maxErr * maxPixel.p[0], FLT_MIN);
+                                float maxErr2 = std::max(
+                                    maxErr * maxPixel.p[1], FLT_MIN);
+                                float maxErr3 = std::max(
+                                    maxErr * maxPixel.p[2], FLT_MIN);
+                                float maxErr4 = std::max(
+                                    maxErr * maxPixel.p[3], FLT_MIN);
+
+                                if (!(err1 <= maxErr1)
+                                    || !(err2 <= maxErr2)
+                                    || !(err3 <= maxErr3)
+                                    || !(err4 <= maxErr4))
+                                {
+                                    // Try flushing the denormals
+                                    if (hasDenormals)
                                     {
-
-                                        int hasDenormals = 0;
-                                        FloatPixel maxPixel =
-                                            sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
+                                        // If implementation decide to flush
+                                        // subnormals to zero, max error needs
+                                        // to be adjusted
+                                        maxErr1 += 4 * FLT_MIN;
+                                        maxErr2 += 4 * FLT_MIN;
+                                        maxErr3 += 4 * FLT_MIN;
+                                        maxErr4 += 4 * FLT_MIN;
+
+                                        maxPixel =
+                                            texelSampler.sample(
+                                                imagePtr,
                                                 xOffsetValues[j],
                                                 (num_dimensions > 1)
                                                     ? yOffsetValues[j]
                                                     : 0.0f,
-                                                image_type_3D ? zOffsetValues[j]
-                                                              : 0.0f,
+                                                image_type_3D
+                                                    ? zOffsetValues[j]
+                                                    : 0.0f,
                                                 norm_offset_x,
                                                 (num_dimensions > 1)
                                                     ? norm_offset_y
                                                     : 0.0f,
-                                                image_type_3D ? norm_offset_z
-                                                              : 0.0f,
-                                                imageSampler, expected, 0,
-                                                &hasDenormals, lod);
-
-                                        float err1 = ABS_ERROR(resultPtr[0],
-                                                               expected[0]);
-                                        float err2 = ABS_ERROR(resultPtr[1],
-                                                               expected[1]);
-                                        float err3 = ABS_ERROR(resultPtr[2],
-                                                               expected[2]);
-                                        float err4 = ABS_ERROR(resultPtr[3],
-                                                               expected[3]);
-                                        // Clamp to the minimum absolute error
-                                        // for the format
-                                        if (err1 > 0
-                                            && err1 < formatAbsoluteError)
-                                        {
-                                            err1 = 0.0f;
-                                        }
-                                        if (err2 > 0
-                                            && err2 < formatAbsoluteError)
-                                        {
-                                            err2 = 0.0f;
-                                        }
-                                        if (err3 > 0
-                                            && err3 < formatAbsoluteError)
-                                        {
-                                            err3 = 0.0f;
-                                        }
-                                        if (err4 > 0
-                                            && err4 < formatAbsoluteError)
-                                        {
-                                            err4 = 0.0f;
-                                        }
-                                        float maxErr1 = std::max(
-                                            maxErr * maxPixel.p[0], FLT_MIN);
-                                        float maxErr2 = std::max(
-                                            maxErr * maxPixel.p[1], FLT_MIN);
-                                        float maxErr3 = std::max(
-                                            maxErr * maxPixel.p[2], FLT_MIN);
-                                        float maxErr4 = std::max(
-                                            maxErr * maxPixel.p[3], FLT_MIN);
-
-                                        if (!(err1 <= maxErr1)
-                                            || !(err2 <= maxErr2)
-                                            || !(err3 <= maxErr3)
-                                            || !(err4 <= maxErr4))
-                                        {
-                                            // Try flushing the denormals
-                                            if (hasDenormals)
-                                            {
-                                                // If implementation decide to
-                                                // flush subnormals to zero, max
-                                                // error needs to be adjusted
-                                                maxErr1 += 4 * FLT_MIN;
-                                                maxErr2 += 4 * FLT_MIN;
-                                                maxErr3 += 4 * FLT_MIN;
-                                                maxErr4 += 4 * FLT_MIN;
-
-                                                maxPixel =
-                                                    sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
-                                                        xOffsetValues[j],
-                                                        (num_dimensions > 1)
-                                                            ? yOffsetValues[j]
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? zOffsetValues[j]
-                                                            : 0.0f,
-                                                        norm_offset_x,
-                                                        (num_dimensions > 1)
-                                                            ? norm_offset_y
-                                                            : 0.0f,
-                                                        image_type_3D
-                                                            ? norm_offset_z
-                                                            : 0.0f,
-                                                        imageSampler, expected,
-                                                        0, NULL, lod);
-
-                                                err1 = ABS_ERROR(resultPtr[0],
-                                                                 expected[0]);
-                                                err2 = ABS_ERROR(resultPtr[1],
-                                                                 expected[1]);
-                                                err3 = ABS_ERROR(resultPtr[2],
-                                                                 expected[2]);
-                                                err4 = ABS_ERROR(resultPtr[3],
-                                                                 expected[3]);
-                                            }
-                                        }
-
-                                        found_pixel = (err1 <= maxErr1)
-                                            && (err2 <= maxErr2)
-                                            && (err3 <= maxErr3)
-                                            && (err4 <= maxErr4);
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                                                image_type_3D
+                                                    ? norm_offset_z
+                                                    : 0.0f,
+                                                expected, 0, NULL);
+
+                                        err1 = ABS_ERROR(resultPtr[0],
+                                                         expected[0]);
+                                        err2 = ABS_ERROR(resultPtr[1],
+                                                         expected[1]);
+                                        err3 = ABS_ERROR(resultPtr[2],
+                                                         expected[2]);
+                                        err4 = ABS_ERROR(resultPtr[3],
+                                                         expected[3]);
+                                    }
+                                }
+
+                                found_pixel = (err1 <= maxErr1)
+                                    && (err2 <= maxErr2)
+                                    && (err3 <= maxErr3)
+                                    && (err4 <= maxErr4);
+                            } // norm_offset_z
+                        } // norm_offset_y
+                    } // norm_offset_x
+                    return found_pixel != 0;
+                };
+                ValidationTiles tiles(width_lod * height_lod * depth_lod,
+                                      width_lod, verify);
 
+                for (size_t z = 0, j = 0; z < depth_lod; z++)
+                {
+                    for (size_t y = 0; y < height_lod; y++)
+                    {
+                        for (size_t x = 0; x < width_lod; x++, j++)
+                        {
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
-                            if (!found_pixel)
+                            if (tiles.needs_check(j) && !verify(j))
                             {
                                 // For the normalized case on a GPU we put in
                                 // offsets to the X and Y to see if we land on
                                 // the right pixel. This addresses the
                                 // significant inaccuracy in GPU normalization
                                 // in OpenCL 1.0.
-                                checkOnlyOnePixel = 0;
+                                int checkOnlyOnePixel = 0;
                                 int shouldReturn = 0;
                                 for (float norm_offset_x = -offset;
                                      norm_offset_x <= offset
@@ -1507,9 +1505,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                             int hasDenormals = 0;
                                             FloatPixel maxPixel =
-                                                sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
-                                                    xOffsetValues[j],
+                                                texelSampler.sample(
+                                                    imagePtr, xOffsetValues[j],
                                                     (num_dimensions > 1)
                                                         ? yOffsetValues[j]
                                                         : 0.0f,
@@ -1523,8 +1520,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     image_type_3D
                                                         ? norm_offset_z
                                                         : 0.0f,
-                                                    imageSampler, expected, 0,
-                                                    &hasDenormals, lod);
+                                                    expected, 0, &hasDenormals);
 
                                             float err1 = ABS_ERROR(resultPtr[0],
                                                                    expected[0]);
@@ -1562,8 +1558,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     maxErr4 += 4 * FLT_MIN;
 
                                                     maxPixel =
-                                                        sample_image_pixel_float(
-                                                            imagePtr, imageInfo,
+                                                        texelSampler.sample(
+                                                            imagePtr,
                                                             xOffsetValues[j],
                                                             (num_dimensions > 1)
                                                                 ? yOffsetValues
@@ -1573,9 +1569,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                                 ? zOffsetValues
                                                                     [j]
                                                                 : 0.0f,
-                                                            imageSampler,
-                                                            expected, 0, NULL,
-                                                            lod);
+                                                            expected, 0, NULL);
 
                                                     err1 =
                                                         ABS_ERROR(resultPtr[0],
@@ -1628,9 +1622,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                         j, numTries, numClamped,
                                                         true, lod, ctx);
                                                 log_error("Step by step:\n");
-                                                sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
-                                                    xOffsetValues[j],
+                                                texelSampler.sample(
+                                                    imagePtr, xOffsetValues[j],
                                                     (num_dimensions > 1)
                                                         ? yOffsetValues[j]
                                                         : 0.0f,
@@ -1644,9 +1637,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                     image_type_3D
                                                         ? norm_offset_z
                                                         : 0.0f,
-                                                    imageSampler, tempOut,
-                                                    1 /*verbose*/,
-                                                    &hasDenormals, lod);
+                                                    tempOut, 1 /*verbose*/,
+                                                    &hasDenormals);
                                                 log_error(
                                                     "\tulps: %2.2f, %2.2f, "
                                                     "%2.2f, %2.2f  (max "
@@ -1695,92 +1687,99 @@ int test_read_image(cl_context context, cl_command_queue queue,
                 unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
                 unsigned int expected[4];
                 float error;
+                // Step 1: go through and see if the results verify for the
+                // pixel For the normalized case on a GPU we put in offsets to
+                // the X, Y and Z to see if we land on the right pixel. This
+                // addresses the significant inaccuracy in GPU normalization in
+                // OpenCL 1.0.
+                auto verify = [&](size_t j) {
+                    const unsigned int *resultPtr =
+                        (const unsigned int *)(char *)resultValues + 4 * j;
+                    unsigned int expected[4];
+                    float error;
+                    int checkOnlyOnePixel = 0;
+                    int found_pixel = 0;
+                    for (float norm_offset_x = -NORM_OFFSET;
+                         norm_offset_x <= NORM_OFFSET && !found_pixel
+                         && !checkOnlyOnePixel;
+                         norm_offset_x += NORM_OFFSET)
+                    {
+                        for (float norm_offset_y = -NORM_OFFSET;
+                             norm_offset_y <= NORM_OFFSET
+                             && !found_pixel && !checkOnlyOnePixel;
+                             norm_offset_y += NORM_OFFSET)
+                        {
+                            for (float norm_offset_z = -NORM_OFFSET;
+                                 norm_offset_z <= NORM_OFFSET
+                                 && !found_pixel && !checkOnlyOnePixel;
+                                 norm_offset_z += NORM_OFFSET)
+                            {
+
+                                // If we are not on a GPU, or we are not
+                                // normalized, then only test with offsets (0.0,
+                                // 0.0) E.g., test one pixel.
+                                if (!imageSampler->normalized_coords
+                                    || !(gDeviceType
+                                         & CL_DEVICE_TYPE_GPU)
+                                    || NORM_OFFSET == 0)
+                                {
+                                    norm_offset_x = 0.0f;
+                                    norm_offset_y = 0.0f;
+                                    norm_offset_z = 0.0f;
+                                    checkOnlyOnePixel = 1;
+                                }
+
+                                sample_image_pixel_offset<unsigned int>(
+                                    imagePtr, imageInfo,
+                                    xOffsetValues[j],
+                                    (num_dimensions > 1)
+                                        ? yOffsetValues[j]
+                                        : 0.0f,
+                                    image_type_3D ? zOffsetValues[j]
+                                                  : 0.0f,
+                                    norm_offset_x,
+                                    (num_dimensions > 1) ? norm_offset_y
+                                                         : 0.0f,
+                                    image_type_3D ? norm_offset_z
+                                                  : 0.0f,
+                                    imageSampler, expected, lod);
+
+                                error = errMax(
+                                    errMax(abs_diff_uint(expected[0],
+                                                         resultPtr[0]),
+                                           abs_diff_uint(expected[1],
+                                                         resultPtr[1])),
+                                    errMax(
+                                        abs_diff_uint(expected[2],
+                                                      resultPtr[2]),
+                                        abs_diff_uint(expected[3],
+                                                      resultPtr[3])));
+
+                                if (error < MAX_ERR) found_pixel = 1;
+                            } // norm_offset_z
+                        } // norm_offset_y
+                    } // norm_offset_x
+                    return found_pixel != 0;
+                };
+                ValidationTiles tiles(width_lod * height_lod * depth_lod,
+                                      width_lod, verify);
+
                 for (size_t z = 0, j = 0; z < depth_lod; z++)
                 {
                     for (size_t y = 0; y < height_lod; y++)
                     {
                         for (size_t x = 0; x < width_lod; x++, j++)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
-                            int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            for (float norm_offset_x = -NORM_OFFSET;
-                                 norm_offset_x <= NORM_OFFSET && !found_pixel
-                                 && !checkOnlyOnePixel;
-                                 norm_offset_x += NORM_OFFSET)
-                            {
-                                for (float norm_offset_y = -NORM_OFFSET;
-                                     norm_offset_y <= NORM_OFFSET
-                                     && !found_pixel && !checkOnlyOnePixel;
-                                     norm_offset_y += NORM_OFFSET)
-                                {
-                                    for (float norm_offset_z = -NORM_OFFSET;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel && !checkOnlyOnePixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
-
-                                        // If we are not on a GPU, or we are not
-                                        // normalized, then only test with
-                                        // offsets (0.0, 0.0) E.g., test one
-                                        // pixel.
-                                        if (!imageSampler->normalized_coords
-                                            || !(gDeviceType
-                                                 & CL_DEVICE_TYPE_GPU)
-                                            || NORM_OFFSET == 0)
-                                        {
-                                            norm_offset_x = 0.0f;
-                                            norm_offset_y = 0.0f;
-                                            norm_offset_z = 0.0f;
-                                            checkOnlyOnePixel = 1;
-                                        }
-
-                                        sample_image_pixel_offset<unsigned int>(
-                                            imagePtr, imageInfo,
-                                            xOffsetValues[j],
-                                            (num_dimensions > 1)
-                                                ? yOffsetValues[j]
-                                                : 0.0f,
-                                            image_type_3D ? zOffsetValues[j]
-                                                          : 0.0f,
-                                            norm_offset_x,
-                                            (num_dimensions > 1) ? norm_offset_y
-                                                                 : 0.0f,
-                                            image_type_3D ? norm_offset_z
-                                                          : 0.0f,
-                                            imageSampler, expected, lod);
-
-                                        error = errMax(
-                                            errMax(abs_diff_uint(expected[0],
-                                                                 resultPtr[0]),
-                                                   abs_diff_uint(expected[1],
-                                                                 resultPtr[1])),
-                                            errMax(
-                                                abs_diff_uint(expected[2],
-                                                              resultPtr[2]),
-                                                abs_diff_uint(expected[3],
-                                                              resultPtr[3])));
-
-                                        if (error < MAX_ERR) found_pixel = 1;
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
-
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
-                            if (!found_pixel)
+                            if (tiles.needs_check(j) && !verify(j))
                             {
                                 // For the normalized case on a GPU we put in
                                 // offsets to the X and Y to see if we land on
                                 // the right pixel. This addresses the
                                 // significant inaccuracy in GPU normalization
                                 // in OpenCL 1.0.
-                                checkOnlyOnePixel = 0;
+                                int checkOnlyOnePixel = 0;
                                 int shouldReturn = 0;
                                 for (float norm_offset_x = -NORM_OFFSET;
                                      norm_offset_x <= NORM_OFFSET
@@ -1902,91 +1901,98 @@ int test_read_image(cl_context context, cl_command_queue queue,
                 int *resultPtr = (int *)(char *)resultValues;
                 int expected[4];
                 float error;
-                for (size_t z = 0, j = 0; z < depth_lod; z++)
-                {
-                    for (size_t y = 0; y < height_lod; y++)
+                // Step 1: go through and see if the results verify for the
+                // pixel For the normalized case on a GPU we put in offsets to
+                // the X, Y and Z to see if we land on the right pixel. This
+                // addresses the significant inaccuracy in GPU normalization in
+                // OpenCL 1.0.
+                auto verify = [&](size_t j) {
+                    const int *resultPtr =
+                        (const int *)(char *)resultValues + 4 * j;
+                    int expected[4];
+                    float error;
+                    int checkOnlyOnePixel = 0;
+                    int found_pixel = 0;
+                    for (float norm_offset_x = -NORM_OFFSET;
+                         norm_offset_x <= NORM_OFFSET && !found_pixel
+                         && !checkOnlyOnePixel;
+                         norm_offset_x += NORM_OFFSET)
                     {
-                        for (size_t x = 0; x < width_lod; x++, j++)
+                        for (float norm_offset_y = -NORM_OFFSET;
+                             norm_offset_y <= NORM_OFFSET
+                             && !found_pixel && !checkOnlyOnePixel;
+                             norm_offset_y += NORM_OFFSET)
                         {
-                            // Step 1: go through and see if the results verify
-                            // for the pixel For the normalized case on a GPU we
-                            // put in offsets to the X, Y and Z to see if we
-                            // land on the right pixel. This addresses the
-                            // significant inaccuracy in GPU normalization in
-                            // OpenCL 1.0.
-                            int checkOnlyOnePixel = 0;
-                            int found_pixel = 0;
-                            for (float norm_offset_x = -NORM_OFFSET;
-                                 norm_offset_x <= NORM_OFFSET && !found_pixel
-                                 && !checkOnlyOnePixel;
-                                 norm_offset_x += NORM_OFFSET)
+                            for (float norm_offset_z = -NORM_OFFSET;
+                                 norm_offset_z <= NORM_OFFSET
+                                 && !found_pixel && !checkOnlyOnePixel;
+                                 norm_offset_z += NORM_OFFSET)
                             {
-                                for (float norm_offset_y = -NORM_OFFSET;
-                                     norm_offset_y <= NORM_OFFSET
-                                     && !found_pixel && !checkOnlyOnePixel;
-                                     norm_offset_y += NORM_OFFSET)
+
+                                // If we are not on a GPU, or we are not
+                                // normalized, then only test with offsets (0.0,
+                                // 0.0) E.g., test one pixel.
+                                if (!imageSampler->normalized_coords
+                                    || !(gDeviceType
+                                         & CL_DEVICE_TYPE_GPU)
+                                    || NORM_OFFSET == 0)
                                 {
-                                    for (float norm_offset_z = -NORM_OFFSET;
-                                         norm_offset_z <= NORM_OFFSET
-                                         && !found_pixel && !checkOnlyOnePixel;
-                                         norm_offset_z += NORM_OFFSET)
-                                    {
+                                    norm_offset_x = 0.0f;
+                                    norm_offset_y = 0.0f;
+                                    norm_offset_z = 0.0f;
+                                    checkOnlyOnePixel = 1;
+                                }
+
+                                sample_image_pixel_offset<int>(
+                                    imagePtr, imageInfo,
+                                    xOffsetValues[j],
+                                    (num_dimensions > 1)
+                                        ? yOffsetValues[j]
+                                        : 0.0f,
+                                    image_type_3D ? zOffsetValues[j]
+                                                  : 0.0f,
+                                    norm_offset_x,
+                                    (num_dimensions > 1) ? norm_offset_y
+                                                         : 0.0f,
+                                    image_type_3D ? norm_offset_z
+                                                  : 0.0f,
+                                    imageSampler, expected, lod);
+
+                                error = errMax(
+                                    errMax(abs_diff_int(expected[0],
+                                                        resultPtr[0]),
+                                           abs_diff_int(expected[1],
+                                                        resultPtr[1])),
+                                    errMax(abs_diff_int(expected[2],
+                                                        resultPtr[2]),
+                                           abs_diff_int(expected[3],
+                                                        resultPtr[3])));
 
-                                        // If we are not on a GPU, or we are not
-                                        // normalized, then only test with
-                                        // offsets (0.0, 0.0) E.g., test one
-                                        // pixel.
-                                        if (!imageSampler->normalized_coords
-                                            || !(gDeviceType
-                                                 & CL_DEVICE_TYPE_GPU)
-                                            || NORM_OFFSET == 0)
-                                        {
-                                            norm_offset_x = 0.0f;
-                                            norm_offset_y = 0.0f;
-                                            norm_offset_z = 0.0f;
-                                            checkOnlyOnePixel = 1;
-                                        }
-
-                                        sample_image_pixel_offset<int>(
-                                            imagePtr, imageInfo,
-                                            xOffsetValues[j],
-                                            (num_dimensions > 1)
-                                                ? yOffsetValues[j]
-                                                : 0.0f,
-                                            image_type_3D ? zOffsetValues[j]
-                                                          : 0.0f,
-                                            norm_offset_x,
-                                            (num_dimensions > 1) ? norm_offset_y
-                                                                 : 0.0f,
-                                            image_type_3D ? norm_offset_z
-                                                          : 0.0f,
-                                            imageSampler, expected, lod);
-
-                                        error = errMax(
-                                            errMax(abs_diff_int(expected[0],
-                                                                resultPtr[0]),
-                                                   abs_diff_int(expected[1],
-                                                                resultPtr[1])),
-                                            errMax(abs_diff_int(expected[2],
-                                                                resultPtr[2]),
-                                                   abs_diff_int(expected[3],
-                                                                resultPtr[3])));
-
-                                        if (error < MAX_ERR) found_pixel = 1;
-                                    } // norm_offset_z
-                                } // norm_offset_y
-                            } // norm_offset_x
+                                if (error < MAX_ERR) found_pixel = 1;
+                            } // norm_offset_z
+                        } // norm_offset_y
+                    } // norm_offset_x
+                    return found_pixel != 0;
+                };
+                ValidationTiles tiles(width_lod * height_lod * depth_lod,
+                                      width_lod, verify);
 
+                for (size_t z = 0, j = 0; z < depth_lod; z++)
+                {
+                    for (size_t y = 0; y < height_lod; y++)
+                    {
+                        for (size_t x = 0; x < width_lod; x++, j++)
+                        {
                             // Step 2: If we did not find a match, then print
                             // out debugging info.
-                            if (!found_pixel)
+                            if (tiles.needs_check(j) && !verify(j))
                             {
                                 // For the normalized case on a GPU we put in
                                 // offsets to the X and Y to see if we land on
                                 // the right pixel. This addresses the
                                 // significant inaccuracy in GPU normalization
                                 // in OpenCL 1.0.
-                                checkOnlyOnePixel = 0;
+                                int checkOnlyOnePixel = 0;
                                 int shouldReturn = 0;
                                 for (float norm_offset_x = -NORM_OFFSET;
                                      norm_offset_x <= NORM_OFFSET
@@ -2100,20 +2106,6 @@ int test_read_image(cl_context context, cl_command_queue queue,
                 }
             }
         }
-        {
-            nextLevelOffset +=
-                image_lod_size * get_pixel_size(imageInfo->format);
-            // Any unnecessary dimensions will already be 1.
-            width_lod = (width_lod >> 1) ? (width_lod >> 1) : 1;
-            if (imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY)
-            {
-                height_lod = (height_lod >> 1) ? (height_lod >> 1) : 1;
-            }
-            if (imageInfo->type != CL_MEM_OBJECT_IMAGE2D_ARRAY)
-            {
-                depth_lod = (depth_lod >> 1) ? (depth_lod >> 1) : 1;
-            }
-        }
     }
 
     return numTries != MAX_TRIES || numClamped != MAX_CLAMPED;
@@ -15,6 +15,10 @@
 //
 
 #include "../testBase.h"
+#include "harness/ThreadPool.h"
+
+#include <algorithm>
+#include <vector>
 
 #define ABS_ERROR(result, expected) (fabs(expected - result))
 #define CLAMP(_val, _min, _max)                                                \
@@ -24,6 +28,64 @@
 #define MAX_TRIES 1
 #define MAX_CLAMPED 1
 
+// Minimum number of pixels verified by a job of ValidationTiles.
+#define VALIDATION_TILE_PIXELS 4096
+
+// First pixels of the tiles of an image level that don't verify.  The tiles
+// are runs of whole rows, verified in parallel on the thread pool with
+// verify(j), which returns whether pixel j matches its reference.  The
+// validation loops then only check and report the pixels from the first
+// failure of each tile on, in order, so that the errors they log are the
+// same as if every pixel were checked serially.
+class ValidationTiles {
+public:
+    template <typename Verify>
+    ValidationTiles(size_t pixelCount, size_t rowPixels, Verify &verify)
+        : tilePixels(rowPixels
+                     * std::max<size_t>(1, VALIDATION_TILE_PIXELS / rowPixels)),
+          firstFailures((pixelCount + tilePixels - 1) / tilePixels)
+    {
+        TileJob<Verify> job = { this, pixelCount, &verify };
+        if (ThreadPool_Do(TileJob<Verify>::run, (cl_uint)firstFailures.size(),
+                          &job)
+            != CL_SUCCESS)
+        {
+            // Check every pixel serially.
+            for (size_t i = 0; i < firstFailures.size(); i++)
+                firstFailures[i] = i * tilePixels;
+        }
+    }
+
+    // Whether pixel j needs to be checked by the validation loop.
+    bool needs_check(size_t j) const
+    {
+        return j >= firstFailures[j / tilePixels];
+    }
+
+private:
+    template <typename Verify> struct TileJob
+    {
+        ValidationTiles *tiles;
+        size_t pixelCount;
+        Verify *verify;
+
+        static cl_int run(cl_uint job_id, cl_uint thread_id, void *userInfo)
+        {
+            TileJob *job = (TileJob *)userInfo;
+            size_t start = job_id * job->tiles->tilePixels;
+            size_t end =
+                std::min(start + job->tiles->tilePixels, job->pixelCount);
+            size_t j = start;
+            while (j < end && (*job->verify)(j)) j++;
+            job->tiles->firstFailures[job_id] = j;
+            return CL_SUCCESS;
+        }
+    };
+
+    size_t tilePixels;
+    std::vector<size_t> firstFailures;
+};
+
 extern cl_sampler create_sampler(cl_context context, image_sampler_data *sdata, bool test_mipmaps, cl_int *error);
 extern void read_image_pixel_float(void *imageData, image_descriptor *imageInfo,
                                    int x, int y, int z, float *outData);
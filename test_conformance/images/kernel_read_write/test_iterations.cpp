@@ -17,6 +17,7 @@
 #include <float.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 
 #if defined( __APPLE__ )
@@ -297,13 +298,8 @@ static void InitFloatCoords(image_descriptor *imageInfo,
                             const image_test_context_t &ctx)
 {
     size_t i = 0;
-    size_t width_lod = imageInfo->width, height_lod = imageInfo->height;
-
-    if (ctx.testMipmaps)
-    {
-        width_lod = (imageInfo->width >> lod)?(imageInfo->width >> lod):1;
-        height_lod = (imageInfo->height >> lod)?(imageInfo->height >> lod):1;
-    }
+    image_mip_level level = get_image_mip_level( imageInfo, ctx.testMipmaps ? lod : 0 );
+    size_t width_lod = level.width, height_lod = level.height;
     if (ctx.disableOffsets)
     {
         for( size_t y = 0; y < height_lod; y++ )
@@ -362,8 +358,8 @@ int validate_image_2D_depth_results(
     const image_test_context_t &ctx)
 {
     // Validate results element by element
-    size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
-    size_t height_lod = (imageInfo->height >> lod ) ?(imageInfo->height >> lod ) : 1;
+    image_mip_level level = get_image_mip_level( imageInfo, lod );
+    size_t width_lod = level.width, height_lod = level.height;
     /*
      * FLOAT output type
      */
@@ -373,6 +369,7 @@ int validate_image_2D_depth_results(
         float *resultPtr = (float *)(char *)resultValues;
         float expected[4], error=0.0f;
         float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
+        TexelSampler texelSampler( imageInfo, imageSampler );
         for( size_t y = 0, j = 0; y < height_lod; y++ )
         {
             for( size_t x = 0; x < width_lod; x++, j++ )
@@ -400,9 +397,9 @@ int validate_image_2D_depth_results(
                         // Try sampling the pixel, without flushing denormals.
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
-                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                        maxPixel = texelSampler.sample( imageValues,
                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                    imageSampler, expected, 0, &containsDenormals );
+                                                                    expected, 0, &containsDenormals );
 
                         float err1 = ABS_ERROR(resultPtr[0], expected[0]);
                         // Clamp to the minimum absolute error for the format
@@ -420,9 +417,9 @@ int validate_image_2D_depth_results(
                                 // max error needs to be adjusted
                                 maxErr1 += 4 * FLT_MIN;
 
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                maxPixel = texelSampler.sample( imageValues,
                                                                              xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                             imageSampler, expected, 0, NULL );
+                                                                             expected, 0, NULL );
 
                                 err1 = ABS_ERROR(resultPtr[0], expected[0]);
                             }
@@ -456,9 +453,9 @@ int validate_image_2D_depth_results(
 
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                            maxPixel = texelSampler.sample( imageValues,
                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                    imageSampler, expected, 0, &containsDenormals );
+                                                                                    expected, 0, &containsDenormals );
 
                             float err1 = ABS_ERROR(resultPtr[0], expected[0]);
                             float maxErr1 =
@@ -472,9 +469,9 @@ int validate_image_2D_depth_results(
                                 {
                                     maxErr1 += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                    maxPixel = texelSampler.sample( imageValues,
                                                                                  xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL );
+                                                                                 expected, 0, NULL );
 
                                     err1 = ABS_ERROR(resultPtr[0], expected[0]);
                                 }
@@ -494,9 +491,9 @@ int validate_image_2D_depth_results(
 
                                 log_error( "Step by step:\n" );
                                 FloatPixel temp;
-                                temp = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                temp = texelSampler.sample( imageValues,
                                                                                xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                               imageSampler, tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/ );
+                                                                               tempOut, 1 /* verbose */, &containsDenormals /*dont flush while error reporting*/ );
                                 log_error( "\tulps: %2.2f  (max allowed: %2.2f)\n\n",
                                                     Ulp_Error( resultPtr[0], expected[0] ),
                                                     Ulp_Error( MAKE_HEX_FLOAT(0x1.000002p0f, 0x1000002L, -24) + maxErr, MAKE_HEX_FLOAT(0x1.000002p0f, 0x1000002L, -24) ) );
@@ -532,8 +529,8 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
                               char *imagePtr, const image_test_context_t &ctx)
 {
     // Validate results element by element
-    size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
-    size_t height_lod = (imageInfo->height >> lod ) ?(imageInfo->height >> lod ) : 1;
+    image_mip_level level = get_image_mip_level( imageInfo, lod );
+    size_t width_lod = level.width, height_lod = level.height;
     /*
      * FLOAT output type
      */
@@ -543,102 +540,107 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
         float *resultPtr = (float *)(char *)resultValues;
         float expected[4], error=0.0f;
         float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
-        for( size_t y = 0, j = 0; y < height_lod; y++ )
-        {
-            for( size_t x = 0; x < width_lod; x++, j++ )
-            {
-                // Step 1: go through and see if the results verify for the pixel
-                // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
-                // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
-                int checkOnlyOnePixel = 0;
-                int found_pixel = 0;
-                float offset = NORM_OFFSET;
-                if (!imageSampler->normalized_coords
-                    || imageSampler->filter_mode != CL_FILTER_NEAREST
-                    || NORM_OFFSET == 0
+        TexelSampler texelSampler( imageInfo, imageSampler, lod );
+        float offset = NORM_OFFSET;
+        if (!imageSampler->normalized_coords
+            || imageSampler->filter_mode != CL_FILTER_NEAREST
+            || NORM_OFFSET == 0
 #if defined( __APPLE__ )
-                    // Apple requires its CPU implementation to do correctly
-                    // rounded address arithmetic in all modes
-                    || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+            // Apple requires its CPU implementation to do correctly
+            // rounded address arithmetic in all modes
+            || !(gDeviceType & CL_DEVICE_TYPE_GPU)
 #endif
-                )
-                    offset = 0.0f;          // Loop only once
-
-                for (float norm_offset_x = -offset; norm_offset_x <= offset && !found_pixel; norm_offset_x += NORM_OFFSET) {
-                    for (float norm_offset_y = -offset; norm_offset_y <= offset && !found_pixel; norm_offset_y += NORM_OFFSET) {
-
-
-                        // Try sampling the pixel, without flushing denormals.
-                        int containsDenormals = 0;
-                        FloatPixel maxPixel;
-                        if (ctx.testMipmaps)
-                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals, lod );
-                        else
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals );
-
-                        float err1 = ABS_ERROR(resultPtr[0], expected[0]);
-                        float err2 = ABS_ERROR(resultPtr[1], expected[1]);
-                        float err3 = ABS_ERROR(resultPtr[2], expected[2]);
-                        float err4 = ABS_ERROR(resultPtr[3], expected[3]);
-                        // Clamp to the minimum absolute error for the format
-                        if (err1 > 0 && err1 < formatAbsoluteError) { err1 = 0.0f; }
-                        if (err2 > 0 && err2 < formatAbsoluteError) { err2 = 0.0f; }
-                        if (err3 > 0 && err3 < formatAbsoluteError) { err3 = 0.0f; }
-                        if (err4 > 0 && err4 < formatAbsoluteError) { err4 = 0.0f; }
-                        float maxErr1 =
-                            std::max(maxErr * maxPixel.p[0], FLT_MIN);
-                        float maxErr2 =
-                            std::max(maxErr * maxPixel.p[1], FLT_MIN);
-                        float maxErr3 =
-                            std::max(maxErr * maxPixel.p[2], FLT_MIN);
-                        float maxErr4 =
-                            std::max(maxErr * maxPixel.p[3], FLT_MIN);
-
-                        // Check if the result matches.
-                        if( ! (err1 <= maxErr1) || ! (err2 <= maxErr2)    ||
-                           ! (err3 <= maxErr3) || ! (err4 <= maxErr4)    )
+        )
+            offset = 0.0f;          // Loop only once
+
+        // Step 1: go through and see if the results verify for the pixel
+        // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
+        // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
+        auto verify = [&]( size_t j ) {
+            const float *resultPtr = (const float *)(char *)resultValues + 4 * j;
+            float expected[4];
+            int found_pixel = 0;
+
+            for (float norm_offset_x = -offset; norm_offset_x <= offset && !found_pixel; norm_offset_x += NORM_OFFSET) {
+                for (float norm_offset_y = -offset; norm_offset_y <= offset && !found_pixel; norm_offset_y += NORM_OFFSET) {
+
+
+                    // Try sampling the pixel, without flushing denormals.
+                    int containsDenormals = 0;
+                    FloatPixel maxPixel;
+                    if (ctx.testMipmaps)
+                        maxPixel = texelSampler.sample( imagePtr,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                    expected, 0, &containsDenormals );
+                    else
+                        maxPixel = texelSampler.sample( imageValues,
+                                                                    xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                    expected, 0, &containsDenormals );
+
+                    float err1 = ABS_ERROR(resultPtr[0], expected[0]);
+                    float err2 = ABS_ERROR(resultPtr[1], expected[1]);
+                    float err3 = ABS_ERROR(resultPtr[2], expected[2]);
+                    float err4 = ABS_ERROR(resultPtr[3], expected[3]);
+                    // Clamp to the minimum absolute error for the format
+                    if (err1 > 0 && err1 < formatAbsoluteError) { err1 = 0.0f; }
+                    if (err2 > 0 && err2 < formatAbsoluteError) { err2 = 0.0f; }
+                    if (err3 > 0 && err3 < formatAbsoluteError) { err3 = 0.0f; }
+                    if (err4 > 0 && err4 < formatAbsoluteError) { err4 = 0.0f; }
+                    float maxErr1 =
+                        std::max(maxErr * maxPixel.p[0], FLT_MIN);
+                    float maxErr2 =
+                        std::max(maxErr * maxPixel.p[1], FLT_MIN);
+                    float maxErr3 =
+                        std::max(maxErr * maxPixel.p[2], FLT_MIN);
+                    float maxErr4 =
+                        std::max(maxErr * maxPixel.p[3], FLT_MIN);
+
+                    // Check if the result matches.
+                    if( ! (err1 <= maxErr1) || ! (err2 <= maxErr2)    ||
+                       ! (err3 <= maxErr3) || ! (err4 <= maxErr4)    )
+                    {
+                        //try flushing the denormals, if there is a failure.
+                        if( containsDenormals )
                         {
-                            //try flushing the denormals, if there is a failure.
-                            if( containsDenormals )
-                            {
-                               // If implementation decide to flush subnormals to zero,
-                               // max error needs to be adjusted
-                                maxErr1 += 4 * FLT_MIN;
-                                maxErr2 += 4 * FLT_MIN;
-                                maxErr3 += 4 * FLT_MIN;
-                                maxErr4 += 4 * FLT_MIN;
+                           // If implementation decide to flush subnormals to zero,
+                           // max error needs to be adjusted
+                            maxErr1 += 4 * FLT_MIN;
+                            maxErr2 += 4 * FLT_MIN;
+                            maxErr3 += 4 * FLT_MIN;
+                            maxErr4 += 4 * FLT_MIN;
 
-                                if (ctx.testMipmaps)
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL,lod );
-                                else
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL );
+                            if (ctx.testMipmaps)
+                                maxPixel = texelSampler.sample( imagePtr,
+                                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                             expected, 0, NULL );
+                            else
+                                maxPixel = texelSampler.sample( imageValues,
+                                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                             expected, 0, NULL );
 
-                                err1 = ABS_ERROR(resultPtr[0], expected[0]);
-                                err2 = ABS_ERROR(resultPtr[1], expected[1]);
-                                err3 = ABS_ERROR(resultPtr[2], expected[2]);
-                                err4 = ABS_ERROR(resultPtr[3], expected[3]);
-                            }
+                            err1 = ABS_ERROR(resultPtr[0], expected[0]);
+                            err2 = ABS_ERROR(resultPtr[1], expected[1]);
+                            err3 = ABS_ERROR(resultPtr[2], expected[2]);
+                            err4 = ABS_ERROR(resultPtr[3], expected[3]);
                         }
+                    }
 
-                        // If the final result DOES match, then we've found a valid result and we're done with this pixel.
-                        found_pixel = (err1 <= maxErr1) && (err2 <= maxErr2)  && (err3 <= maxErr3) && (err4 <= maxErr4);
-                    }//norm_offset_x
-                }//norm_offset_y
-
-
+                    // If the final result DOES match, then we've found a valid result and we're done with this pixel.
+                    found_pixel = (err1 <= maxErr1) && (err2 <= maxErr2)  && (err3 <= maxErr3) && (err4 <= maxErr4);
+                }//norm_offset_x
+            }//norm_offset_y
+            return found_pixel != 0;
+        };
+        ValidationTiles tiles( width_lod * height_lod, width_lod, verify );
+        for( size_t y = 0, j = 0; y < height_lod; y++ )
+        {
+            for( size_t x = 0; x < width_lod; x++, j++ )
+            {
                 // Step 2: If we did not find a match, then print out debugging info.
-                if (!found_pixel) {
+                if (tiles.needs_check(j) && !verify(j)) {
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
                     // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
-                    checkOnlyOnePixel = 0;
+                    int checkOnlyOnePixel = 0;
                     int shouldReturn = 0;
                     for (float norm_offset_x = -offset; norm_offset_x <= offset && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
                         for (float norm_offset_y = -offset; norm_offset_y <= offset && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
@@ -657,13 +659,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
                             if (ctx.testMipmaps)
-                                maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
+                                maxPixel = texelSampler.sample( imagePtr,
                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                                                                        expected, 0, &containsDenormals );
                             else
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                maxPixel = texelSampler.sample( imageValues,
                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals );
+                                                                                        expected, 0, &containsDenormals );
 
                             float err1 = ABS_ERROR(resultPtr[0], expected[0]);
                             float err2 = ABS_ERROR(resultPtr[1], expected[1]);
@@ -691,13 +693,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
                                     maxErr4 += 4 * FLT_MIN;
 
                                     if (ctx.testMipmaps)
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
+                                        maxPixel = texelSampler.sample( imagePtr,
                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
+                                                                                     expected, 0, NULL );
                                     else
-                                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                        maxPixel = texelSampler.sample( imageValues,
                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL );
+                                                                                     expected, 0, NULL );
 
                                     err1 = ABS_ERROR(resultPtr[0], expected[0]);
                                     err2 = ABS_ERROR(resultPtr[1], expected[1]);
@@ -722,22 +724,20 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
                                 log_error( "Step by step:\n" );
                                 FloatPixel temp;
                                 if (ctx.testMipmaps)
-                                    temp = sample_image_pixel_float_offset(
-                                        imagePtr, imageInfo, xOffsetValues[j],
+                                    temp = texelSampler.sample(
+                                        imagePtr, xOffsetValues[j],
                                         yOffsetValues[j], 0.f, norm_offset_x,
-                                        norm_offset_y, 0.0f, imageSampler,
+                                        norm_offset_y, 0.0f,
                                         tempOut, 1 /* verbose */,
                                         &containsDenormals /*dont flush while
-                                                              error reporting*/
-                                        ,
-                                        lod);
+                                                              error reporting*/);
                                 else
                                     temp =
-                                        sample_image_pixel_float_offset(
-                                            imageValues, imageInfo,
+                                        texelSampler.sample(
+                                            imageValues,
                                             xOffsetValues[j], yOffsetValues[j],
                                             0.f, norm_offset_x, norm_offset_y,
-                                            0.0f, imageSampler, tempOut,
+                                            0.0f, tempOut,
                                             1 /* verbose */, &containsDenormals /*dont flush while error reporting*/);
                                 log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                     Ulp_Error( resultPtr[0], expected[0] ),
@@ -769,52 +769,58 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
         unsigned int *resultPtr = (unsigned int *)(char *)resultValues;
         unsigned int expected[4];
         float error;
-        for( size_t y = 0, j = 0; y < height_lod ; y++ )
-        {
-            for( size_t x = 0; x < width_lod ; x++, j++ )
-            {
-                // Step 1: go through and see if the results verify for the pixel
-                // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
-                // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
-                int checkOnlyOnePixel = 0;
-                int found_pixel = 0;
-                for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
-                    for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
-
-                        // If we are not on a GPU, or we are not normalized, then only test with offsets (0.0, 0.0)
-                        // E.g., test one pixel.
-                        if (!imageSampler->normalized_coords
-                            || !(gDeviceType & CL_DEVICE_TYPE_GPU)
-                            || NORM_OFFSET == 0)
-                        {
-                            norm_offset_x = 0.0f;
-                            norm_offset_y = 0.0f;
-                            checkOnlyOnePixel = 1;
-                        }
-
-                        if (ctx.testMipmaps)
-                            sample_image_pixel_offset<unsigned int>( (char*)imagePtr, imageInfo,
-                                                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                             imageSampler, expected, lod );
-                        else
-                            sample_image_pixel_offset<unsigned int>( imagePtr, imageInfo,
-                                                                                             xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                             imageSampler, expected);
+        // Step 1: go through and see if the results verify for the pixel
+        // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
+        // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
+        auto verify = [&]( size_t j ) {
+            const unsigned int *resultPtr = (const unsigned int *)(char *)resultValues + 4 * j;
+            unsigned int expected[4];
+            float error;
+            int checkOnlyOnePixel = 0;
+            int found_pixel = 0;
+            for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
+                for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
+
+                    // If we are not on a GPU, or we are not normalized, then only test with offsets (0.0, 0.0)
+                    // E.g., test one pixel.
+                    if (!imageSampler->normalized_coords
+                        || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+                        || NORM_OFFSET == 0)
+                    {
+                        norm_offset_x = 0.0f;
+                        norm_offset_y = 0.0f;
+                        checkOnlyOnePixel = 1;
+                    }
 
+                    if (ctx.testMipmaps)
+                        sample_image_pixel_offset<unsigned int>( (char*)imagePtr, imageInfo,
+                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                                         imageSampler, expected, lod );
+                    else
+                        sample_image_pixel_offset<unsigned int>( imagePtr, imageInfo,
+                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                                                         imageSampler, expected);
 
-                        error = errMax( errMax( abs_diff_uint(expected[ 0 ], resultPtr[ 0 ]), abs_diff_uint(expected[ 1 ], resultPtr[ 1 ]) ),
-                                       errMax( abs_diff_uint(expected[ 2 ], resultPtr[ 2 ]), abs_diff_uint(expected[ 3 ], resultPtr[ 3 ]) ) );
 
-                        if (error <= MAX_ERR)
-                            found_pixel = 1;
-                    }//norm_offset_x
-                }//norm_offset_y
+                    error = errMax( errMax( abs_diff_uint(expected[ 0 ], resultPtr[ 0 ]), abs_diff_uint(expected[ 1 ], resultPtr[ 1 ]) ),
+                                   errMax( abs_diff_uint(expected[ 2 ], resultPtr[ 2 ]), abs_diff_uint(expected[ 3 ], resultPtr[ 3 ]) ) );
 
+                    if (error <= MAX_ERR)
+                        found_pixel = 1;
+                }//norm_offset_x
+            }//norm_offset_y
+            return found_pixel != 0;
+        };
+        ValidationTiles tiles( width_lod * height_lod, width_lod, verify );
+        for( size_t y = 0, j = 0; y < height_lod ; y++ )
+        {
+            for( size_t x = 0; x < width_lod ; x++, j++ )
+            {
                 // Step 2: If we did not find a match, then print out debugging info.
-                if (!found_pixel) {
+                if (tiles.needs_check(j) && !verify(j)) {
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
                     // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
-                    checkOnlyOnePixel = 0;
+                    int checkOnlyOnePixel = 0;
                     int shouldReturn = 0;
                     for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
                         for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
@@ -876,52 +882,58 @@ int validate_image_2D_results(void *imageValues, void *resultValues,
         int *resultPtr = (int *)(char *)resultValues;
         int expected[4];
         float error;
-        for( size_t y = 0, j = 0; y < height_lod ; y++ )
-        {
-            for( size_t x = 0; x < width_lod; x++, j++ )
-            {
-                // Step 1: go through and see if the results verify for the pixel
-                // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
-                // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
-                int checkOnlyOnePixel = 0;
-                int found_pixel = 0;
-                for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
-                    for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
-
-                        // If we are not on a GPU, or we are not normalized, then only test with offsets (0.0, 0.0)
-                        // E.g., test one pixel.
-                        if (!imageSampler->normalized_coords
-                            || !(gDeviceType & CL_DEVICE_TYPE_GPU)
-                            || NORM_OFFSET == 0)
-                        {
-                            norm_offset_x = 0.0f;
-                            norm_offset_y = 0.0f;
-                            checkOnlyOnePixel = 1;
-                        }
-
-                        if (ctx.testMipmaps)
-                            sample_image_pixel_offset<int>( imagePtr, imageInfo,
-                                                            xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                            imageSampler, expected , lod);
-                        else
-                            sample_image_pixel_offset<int>( imageValues, imageInfo,
-                                                            xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                            imageSampler, expected );
+        // Step 1: go through and see if the results verify for the pixel
+        // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
+        // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
+        auto verify = [&]( size_t j ) {
+            const int *resultPtr = (const int *)(char *)resultValues + 4 * j;
+            int expected[4];
+            float error;
+            int checkOnlyOnePixel = 0;
+            int found_pixel = 0;
+            for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
+                for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET && !found_pixel && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
+
+                    // If we are not on a GPU, or we are not normalized, then only test with offsets (0.0, 0.0)
+                    // E.g., test one pixel.
+                    if (!imageSampler->normalized_coords
+                        || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+                        || NORM_OFFSET == 0)
+                    {
+                        norm_offset_x = 0.0f;
+                        norm_offset_y = 0.0f;
+                        checkOnlyOnePixel = 1;
+                    }
 
+                    if (ctx.testMipmaps)
+                        sample_image_pixel_offset<int>( imagePtr, imageInfo,
+                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                        imageSampler, expected , lod);
+                    else
+                        sample_image_pixel_offset<int>( imageValues, imageInfo,
+                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
+                                                        imageSampler, expected );
 
-                        error = errMax( errMax( abs_diff_int(expected[ 0 ], resultPtr[ 0 ]), abs_diff_int(expected[ 1 ], resultPtr[ 1 ]) ),
-                                       errMax( abs_diff_int(expected[ 2 ], resultPtr[ 2 ]), abs_diff_int(expected[ 3 ], resultPtr[ 3 ]) ) );
 
-                        if (error <= MAX_ERR)
-                            found_pixel = 1;
-                    }//norm_offset_x
-                }//norm_offset_y
+                    error = errMax( errMax( abs_diff_int(expected[ 0 ], resultPtr[ 0 ]), abs_diff_int(expected[ 1 ], resultPtr[ 1 ]) ),
+                                   errMax( abs_diff_int(expected[ 2 ], resultPtr[ 2 ]), abs_diff_int(expected[ 3 ], resultPtr[ 3 ]) ) );
 
+                    if (error <= MAX_ERR)
+                        found_pixel = 1;
+                }//norm_offset_x
+            }//norm_offset_y
+            return found_pixel != 0;
+        };
+        ValidationTiles tiles( width_lod * height_lod, width_lod, verify );
+        for( size_t y = 0, j = 0; y < height_lod ; y++ )
+        {
+            for( size_t x = 0; x < width_lod; x++, j++ )
+            {
                 // Step 2: If we did not find a match, then print out debugging info.
-                if (!found_pixel) {
+                if (tiles.needs_check(j) && !verify(j)) {
                     // For the normalized case on a GPU we put in offsets to the X and Y to see if we land on the
                     // right pixel. This addresses the significant inaccuracy in GPU normalization in OpenCL 1.0.
-                    checkOnlyOnePixel = 0;
+                    int checkOnlyOnePixel = 0;
                     int shouldReturn = 0;
                     for (float norm_offset_x = -NORM_OFFSET; norm_offset_x <= NORM_OFFSET && !checkOnlyOnePixel; norm_offset_x += NORM_OFFSET) {
                         for (float norm_offset_y = -NORM_OFFSET; norm_offset_y <= NORM_OFFSET && !checkOnlyOnePixel; norm_offset_y += NORM_OFFSET) {
@@ -984,8 +996,8 @@ int validate_image_2D_sRGB_results(
     const image_test_context_t &ctx)
 {
     // Validate results element by element
-    size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
-    size_t height_lod = (imageInfo->height >> lod ) ?(imageInfo->height >> lod ) : 1;
+    image_mip_level level = get_image_mip_level( imageInfo, lod );
+    size_t width_lod = level.width, height_lod = level.height;
     /*
      * FLOAT output type
      */
@@ -994,6 +1006,7 @@ int validate_image_2D_sRGB_results(
         // Validate float results
         float *resultPtr = (float *)(char *)resultValues;
         float expected[4], error=0.0f;
+        TexelSampler texelSampler( imageInfo, imageSampler, lod );
 
         for( size_t y = 0, j = 0; y < height_lod; y++ )
         {
@@ -1024,13 +1037,13 @@ int validate_image_2D_sRGB_results(
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
                         if (ctx.testMipmaps)
-                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
+                            maxPixel = texelSampler.sample( imagePtr,
                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                                                        expected, 0, &containsDenormals );
                         else
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                            maxPixel = texelSampler.sample( imageValues,
                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals );
+                                                                        expected, 0, &containsDenormals );
                         float err1 = ABS_ERROR(sRGBmap(resultPtr[0]),
                                                sRGBmap(expected[0]));
                         float err2 = ABS_ERROR(sRGBmap(resultPtr[1]),
@@ -1052,13 +1065,13 @@ int validate_image_2D_sRGB_results(
                                 maxErr += 4 * FLT_MIN;
 
                                 if (ctx.testMipmaps)
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
+                                    maxPixel = texelSampler.sample( imagePtr,
                                                                                  xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL,lod );
+                                                                                 expected, 0, NULL );
                                 else
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                    maxPixel = texelSampler.sample( imageValues,
                                                                                  xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL );
+                                                                                 expected, 0, NULL );
 
                                 err1 = ABS_ERROR(sRGBmap(resultPtr[0]),
                                                  sRGBmap(expected[0]));
@@ -1099,13 +1112,13 @@ int validate_image_2D_sRGB_results(
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
                             if (ctx.testMipmaps)
-                                maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
+                                maxPixel = texelSampler.sample( imagePtr,
                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
+                                                                                        expected, 0, &containsDenormals );
                             else
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                maxPixel = texelSampler.sample( imageValues,
                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals );
+                                                                                        expected, 0, &containsDenormals );
 
                             float err1 = ABS_ERROR(sRGBmap(resultPtr[0]),
                                                    sRGBmap(expected[0]));
@@ -1126,13 +1139,13 @@ int validate_image_2D_sRGB_results(
                                     // max error needs to be adjusted
                                     maxErr += 4 * FLT_MIN;
                                     if (ctx.testMipmaps)
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
+                                        maxPixel = texelSampler.sample( imagePtr,
                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
+                                                                                     expected, 0, NULL );
                                     else
-                                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                        maxPixel = texelSampler.sample( imageValues,
                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL );
+                                                                                     expected, 0, NULL );
 
                                     err1 = ABS_ERROR(sRGBmap(resultPtr[0]),
                                                      sRGBmap(expected[0]));
@@ -1160,22 +1173,20 @@ int validate_image_2D_sRGB_results(
                                 log_error( "Step by step:\n" );
                                 FloatPixel temp;
                                 if (ctx.testMipmaps)
-                                    temp = sample_image_pixel_float_offset(
-                                        imagePtr, imageInfo, xOffsetValues[j],
+                                    temp = texelSampler.sample(
+                                        imagePtr, xOffsetValues[j],
                                         yOffsetValues[j], 0.f, norm_offset_x,
-                                        norm_offset_y, 0.0f, imageSampler,
+                                        norm_offset_y, 0.0f,
                                         tempOut, 1 /* verbose */,
                                         &containsDenormals /*dont flush while
-                                                              error reporting*/
-                                        ,
-                                        lod);
+                                                              error reporting*/);
                                 else
                                     temp =
-                                        sample_image_pixel_float_offset(
-                                            imageValues, imageInfo,
+                                        texelSampler.sample(
+                                            imageValues,
                                             xOffsetValues[j], yOffsetValues[j],
                                             0.f, norm_offset_x, norm_offset_y,
-                                            0.0f, imageSampler, tempOut,
+                                            0.0f, tempOut,
                                             1 /* verbose */, &containsDenormals /*dont flush while error reporting*/);
                                 log_error( "\tulps: %2.2f, %2.2f, %2.2f, %2.2f  (max allowed: %2.2f)\n\n",
                                                     Ulp_Error( resultPtr[0], expected[0] ),
@@ -1256,7 +1267,7 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
                        const image_test_context_t &ctx)
 {
     int error;
-    static int initHalf = 0;
+    static std::atomic<int> initHalf(0);
     cl_mem imageBuffer = nullptr;
     cl_mem_flags    image_read_write_flags = CL_MEM_READ_ONLY;
     size_t threads[2];
@@ -1467,19 +1478,18 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
         }
         else
         {
-            size_t tmpNextLevelOffset = 0;
             for(size_t level = 0; level < imageInfo->num_mip_levels; level++)
             {
+                image_mip_level mipLevel = get_image_mip_level( imageInfo, level );
                 origin[2] = level;
+                region[0] = mipLevel.width;
+                region[1] = mipLevel.height;
                 error = clEnqueueWriteImage(
                     queue, image, CL_TRUE, origin, region,
                     ((ctx.enablePitch || ctx.testImage2DFromBuffer)
                          ? imageInfo->rowPitch
                          : 0),
-                    0, (char *)imageValues + tmpNextLevelOffset, 0, NULL, NULL);
-                tmpNextLevelOffset += region[0]*region[1]*get_pixel_size(imageInfo->format);
-                region[0] = (region[0] >> 1) ? (region[0] >> 1) : 1;
-                region[1] = (region[1] >> 1) ? (region[1] >> 1) : 1;
+                    0, (char *)imageValues + mipLevel.offset, 0, NULL, NULL);
             }
         }
     }
@@ -1553,12 +1563,13 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
         }
     }
 
-    size_t nextLevelOffset = 0;
-    size_t width_lod = imageInfo->width, height_lod = imageInfo->height;
     for (size_t lod = 0; (ctx.testMipmaps && (lod < imageInfo->num_mip_levels))
          || (!ctx.testMipmaps && lod < 1);
          lod++)
     {
+        image_mip_level level = get_image_mip_level( imageInfo, lod );
+        size_t nextLevelOffset = level.offset;
+        size_t width_lod = level.width, height_lod = level.height;
         size_t resultValuesSize = width_lod * height_lod * get_explicit_type_size( outputType ) * 4;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
         float lod_float = (float)lod;
@@ -1632,12 +1643,6 @@ int test_read_image_2D(cl_context context, cl_command_queue queue,
             if (retCode)
                 return retCode;
         }
-        if (ctx.testMipmaps)
-        {
-            nextLevelOffset += width_lod * height_lod * get_pixel_size( imageInfo->format );
-            width_lod = (width_lod >> 1) ? (width_lod >> 1) : 1;
-            height_lod = (height_lod >> 1) ? (height_lod >> 1) : 1;
-        }
     }
 
     if (ctx.testImage2DFromBuffer) clReleaseMemObject(imageBuffer);
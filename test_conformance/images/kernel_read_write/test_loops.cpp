@@ -15,6 +15,7 @@
 //
 #include "../testBase.h"
 #include "../common.h"
+#include "harness/fpcontrol.h"
 
 extern int test_read_image_set_1D(cl_device_id device, cl_context context,
                                   cl_command_queue queue,
@@ -43,34 +44,36 @@ extern int test_read_image_set_2D_array(
     const cl_image_format *format, image_sampler_data *imageSampler,
     bool floatCoords, ExplicitType outputType, const image_test_context_t &ctx);
 
-int test_read_image_type(cl_device_id device, cl_context context,
-                         cl_command_queue queue, const cl_image_format *format,
-                         bool floatCoords, image_sampler_data *imageSampler,
-                         ExplicitType outputType, cl_mem_object_type imageType,
-                         const image_test_context_t &ctx)
+// Append to addressModes the addressing modes the reads of format are tested
+// with.
+static void
+get_read_addressing_modes(const cl_image_format *format,
+                          const image_sampler_data *imageSampler,
+                          const image_test_context_t &ctx,
+                          std::vector<cl_addressing_mode> &addressModes)
 {
-    int ret = 0;
-    cl_addressing_mode *addressModes = NULL;
+    const cl_addressing_mode *modesToTest = NULL;
 
     // The sampler-less read image functions behave exactly as the corresponding
     // read image functions described in section 6.13.14.2 that take integer
     // coordinates and a sampler with filter mode set to CLK_FILTER_NEAREST,
     // normalized coordinates set to CLK_NORMALIZED_COORDS_FALSE and addressing
     // mode to CLK_ADDRESS_NONE
-    cl_addressing_mode addressModes_rw[] = { CL_ADDRESS_NONE,
-                                             (cl_addressing_mode)-1 };
-    cl_addressing_mode addressModes_ro[] = {
+    static const cl_addressing_mode addressModes_rw[] = {
+        CL_ADDRESS_NONE, (cl_addressing_mode)-1
+    };
+    static const cl_addressing_mode addressModes_ro[] = {
         /* CL_ADDRESS_CLAMP_NONE,*/ CL_ADDRESS_CLAMP_TO_EDGE, CL_ADDRESS_CLAMP,
         CL_ADDRESS_REPEAT, CL_ADDRESS_MIRRORED_REPEAT, (cl_addressing_mode)-1
     };
 
     if (ctx.testTypesToRun & kReadWriteTests)
     {
-        addressModes = addressModes_rw;
+        modesToTest = addressModes_rw;
     }
     else
     {
-        addressModes = addressModes_ro;
+        modesToTest = addressModes_ro;
     }
 
 #if defined(__APPLE__)
@@ -85,23 +88,21 @@ int test_read_image_type(cl_device_id device, cl_context context,
     {
         log_info("--- Skipping CL_RGB CL_UNORM_INT_101010 format with "
                  "CL_FILTER_LINEAR on GPU.\n");
-        return 0;
+        return;
     }
 #endif
 
-    for (int adMode = 0; addressModes[adMode] != (cl_addressing_mode)-1;
+    for (int adMode = 0; modesToTest[adMode] != (cl_addressing_mode)-1;
          adMode++)
     {
-        imageSampler->addressing_mode = addressModes[adMode];
-
-        if ((addressModes[adMode] == CL_ADDRESS_REPEAT
-             || addressModes[adMode] == CL_ADDRESS_MIRRORED_REPEAT)
+        if ((modesToTest[adMode] == CL_ADDRESS_REPEAT
+             || modesToTest[adMode] == CL_ADDRESS_MIRRORED_REPEAT)
             && !(imageSampler->normalized_coords))
             continue; // Repeat doesn't make sense for non-normalized coords
 
         // Use this run if we were told to only run a certain filter mode
         if (ctx.addressModeToUse != (cl_addressing_mode)-1
-            && imageSampler->addressing_mode != ctx.addressModeToUse)
+            && modesToTest[adMode] != ctx.addressModeToUse)
             continue;
 
         /*
@@ -111,50 +112,46 @@ int test_read_image_type(cl_device_id device, cl_context context,
          imageSampler->addressing_mode == CL_ADDRESS_REPEAT ) continue; //repeat
          mode requires normalized coordinates
          */
-        print_read_header(format, imageSampler, false);
-
-        gTestCount++;
-
-        int retCode = 0;
-        switch (imageType)
-        {
-            case CL_MEM_OBJECT_IMAGE1D:
-                retCode = test_read_image_set_1D(device, context, queue, format,
-                                                 imageSampler, floatCoords,
-                                                 outputType, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retCode = test_read_image_set_1D_array(
-                    device, context, queue, format, imageSampler, floatCoords,
-                    outputType, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retCode = test_read_image_set_2D(device, context, queue, format,
-                                                 imageSampler, floatCoords,
-                                                 outputType, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retCode = test_read_image_set_2D_array(
-                    device, context, queue, format, imageSampler, floatCoords,
-                    outputType, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE3D:
-                retCode = test_read_image_set_3D(device, context, queue, format,
-                                                 imageSampler, floatCoords,
-                                                 outputType, ctx);
-                break;
-        }
-        if (retCode != 0)
-        {
-            gFailCount++;
-            log_error("FAILED: ");
-            print_read_header(format, imageSampler, true);
-            log_info("\n");
-        }
-        ret |= retCode;
+        addressModes.push_back(modesToTest[adMode]);
     }
+}
 
-    return ret;
+int test_read_image_type(cl_device_id device, cl_context context,
+                         cl_command_queue queue, const cl_image_format *format,
+                         bool floatCoords, image_sampler_data *imageSampler,
+                         ExplicitType outputType, cl_mem_object_type imageType,
+                         const image_test_context_t &ctx)
+{
+    int retCode = 0;
+    switch (imageType)
+    {
+        case CL_MEM_OBJECT_IMAGE1D:
+            retCode = test_read_image_set_1D(device, context, queue, format,
+                                             imageSampler, floatCoords,
+                                             outputType, ctx);
+            break;
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            retCode = test_read_image_set_1D_array(
+                device, context, queue, format, imageSampler, floatCoords,
+                outputType, ctx);
+            break;
+        case CL_MEM_OBJECT_IMAGE2D:
+            retCode = test_read_image_set_2D(device, context, queue, format,
+                                             imageSampler, floatCoords,
+                                             outputType, ctx);
+            break;
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            retCode = test_read_image_set_2D_array(
+                device, context, queue, format, imageSampler, floatCoords,
+                outputType, ctx);
+            break;
+        case CL_MEM_OBJECT_IMAGE3D:
+            retCode = test_read_image_set_3D(device, context, queue, format,
+                                             imageSampler, floatCoords,
+                                             outputType, ctx);
+            break;
+    }
+    return retCode;
 }
 
 int test_read_image_formats(cl_device_id device, cl_context context,
@@ -221,17 +218,43 @@ int test_read_image_formats(cl_device_id device, cl_context context,
                                              : "integer",
                      get_explicit_type_name(outputType));
 
+            // Each format is tested with each of its addressing modes
+            std::vector<const cl_image_format *> formats;
+            std::vector<cl_addressing_mode> addressModes;
             for (unsigned int i = 0; i < formatList.size(); i++)
             {
                 if (filterFlags[i]) continue;
 
-                const cl_image_format &imageFormat = formatList[i];
-
-                ret |=
-                    test_read_image_type(device, context, queue, &imageFormat,
-                                         flipFlop[floatCoordIdx], imageSampler,
-                                         outputType, imageType, ctx);
+                get_read_addressing_modes(&formatList[i], imageSampler, ctx,
+                                          addressModes);
+                formats.resize(addressModes.size(), &formatList[i]);
             }
+
+            auto get_sampler = [&](size_t index) {
+                image_sampler_data sampler = *imageSampler;
+                sampler.addressing_mode = addressModes[index];
+                return sampler;
+            };
+            bool floatCoords = flipFlop[floatCoordIdx];
+            ret |= run_image_format_tests(
+                queue, ctx, formats.size(),
+                [&](size_t index, bool error) {
+                    image_sampler_data sampler = get_sampler(index);
+                    print_read_header(formats[index], &sampler, error);
+                },
+                [&](cl_command_queue testQueue, size_t index) {
+                    image_sampler_data sampler = get_sampler(index);
+
+                    // Compute the references without flushing denorms, as
+                    // main does, on whichever thread runs the test.
+                    FPU_mode_type oldMode;
+                    DisableFTZ(&oldMode);
+                    int retCode = test_read_image_type(
+                        device, context, testQueue, formats[index],
+                        floatCoords, &sampler, outputType, imageType, ctx);
+                    RestoreFPState(&oldMode);
+                    return retCode;
+                });
         }
     }
     return ret;
@@ -296,7 +296,6 @@ int test_write_image_1D_array(cl_device_id device, cl_context context,
         error = clSetKernelArg( kernel, 1, sizeof( cl_mem ), &image );
         test_error( error, "Unable to set kernel arguments" );
 
-        size_t width_lod = imageInfo->width, nextLevelOffset = 0;
         size_t origin[ 3 ] = { 0, 0, 0 };
         size_t region[ 3 ] = { imageInfo->width, imageInfo->arraySize, 1 };
         size_t resultSize;
@@ -305,6 +304,8 @@ int test_write_image_1D_array(cl_device_id device, cl_context context,
              || (!ctx.testMipmaps && lod < 1);
              lod++)
         {
+            image_mip_level level = get_image_mip_level( imageInfo, lod );
+            size_t width_lod = level.width, nextLevelOffset = level.offset;
             if (ctx.testMipmaps)
             {
                 error = clSetKernelArg( kernel, 2, sizeof( int ), &lod );
@@ -616,10 +617,6 @@ int test_write_image_1D_array(cl_device_id device, cl_context context,
                     resultPtr += pixelSize;
                 }
             }
-            {
-                nextLevelOffset += width_lod * imageInfo->arraySize * get_pixel_size(imageInfo->format);
-                width_lod = (width_lod >> 1) ? (width_lod >> 1) : 1;
-            }
         }
     }
 
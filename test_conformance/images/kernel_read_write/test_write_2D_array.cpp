@@ -319,7 +319,6 @@ int test_write_image_2D_array(cl_device_id device, cl_context context,
         error = clSetKernelArg( kernel, 1, sizeof( cl_mem ), &image );
         test_error( error, "Unable to set kernel arguments" );
 
-        size_t width_lod = imageInfo->width, height_lod = imageInfo->height, nextLevelOffset = 0;
         size_t origin[ 4 ] = { 0, 0, 0, 0 };
         size_t region[ 3 ] = { imageInfo->width, imageInfo->height, imageInfo->arraySize };
         size_t resultSize;
@@ -327,6 +326,8 @@ int test_write_image_2D_array(cl_device_id device, cl_context context,
         int num_lod_loops = (ctx.testMipmaps) ? imageInfo->num_mip_levels : 1;
         for( int lod = 0; lod < num_lod_loops; lod++)
         {
+            image_mip_level level = get_image_mip_level( imageInfo, lod );
+            size_t width_lod = level.width, height_lod = level.height, nextLevelOffset = level.offset;
             if (ctx.testMipmaps)
             {
                 error = clSetKernelArg( kernel, 2, sizeof( int ), &lod );
@@ -657,11 +658,6 @@ int test_write_image_2D_array(cl_device_id device, cl_context context,
                     }
                 }
             }
-            {
-                nextLevelOffset += width_lod*height_lod*imageInfo->arraySize*pixelSize;
-                width_lod = (width_lod >> 1) ? (width_lod >> 1) : 1;
-                height_lod = (height_lod >> 1) ? (height_lod >> 1) : 1;
-            }
         }
     }
     // All done!
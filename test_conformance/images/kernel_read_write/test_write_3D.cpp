@@ -321,16 +321,17 @@ int test_write_image_3D(cl_device_id device, cl_context context,
         error = clSetKernelArg( kernel, 1, sizeof( cl_mem ), &image );
         test_error( error, "Unable to set kernel arguments" );
 
-        size_t width_lod = imageInfo->width;
-        size_t height_lod = imageInfo->height;
-        size_t depth_lod = imageInfo->depth;
-        size_t nextLevelOffset = 0;
         size_t origin[ 4 ] = { 0, 0, 0, 0 };
         size_t region[ 3 ] = { imageInfo->width, imageInfo->height, imageInfo->depth };
 
         int num_lod_loops = (ctx.testMipmaps) ? imageInfo->num_mip_levels : 1;
         for( int lod = 0; lod < num_lod_loops; lod++)
         {
+            image_mip_level level = get_image_mip_level( imageInfo, lod );
+            size_t width_lod = level.width;
+            size_t height_lod = level.height;
+            size_t depth_lod = level.depth;
+            size_t nextLevelOffset = level.offset;
             if (ctx.testMipmaps)
             {
                 error = clSetKernelArg( kernel, 2, sizeof( int ), &lod );
@@ -662,12 +663,6 @@ int test_write_image_3D(cl_device_id device, cl_context context,
                     }
                 }
             }
-            {
-                nextLevelOffset += width_lod * height_lod * depth_lod * pixelSize;
-                width_lod = ( width_lod >> 1 ) ? ( width_lod >> 1 ) : 1;
-                height_lod = ( height_lod >> 1 ) ? ( height_lod >> 1 ) : 1;
-                depth_lod = ( depth_lod >> 1 ) ? ( depth_lod >> 1 ) : 1;
-            }
         }
     }
     // All done!
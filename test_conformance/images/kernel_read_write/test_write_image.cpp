@@ -16,6 +16,7 @@
 #include "../testBase.h"
 #include "../common.h"
 #include "test_common.h"
+#include "harness/fpcontrol.h"
 
 #if !defined(_WIN32)
 #include <sys/mman.h>
@@ -363,7 +364,6 @@ int test_write_image(cl_device_id device, cl_context context,
         error = clSetKernelArg( kernel, 1, sizeof( cl_mem ), &image );
         test_error( error, "Unable to set kernel arguments" );
 
-        size_t width_lod = imageInfo->width, height_lod = imageInfo->height, nextLevelOffset = 0;
         size_t origin[ 3 ] = { 0, 0, 0 };
         size_t region[ 3 ] = { imageInfo->width, imageInfo->height, 1 };
         size_t resultSize;
@@ -371,6 +371,8 @@ int test_write_image(cl_device_id device, cl_context context,
         int num_lod_loops = (ctx.testMipmaps) ? imageInfo->num_mip_levels : 1;
         for( int lod = 0; lod < num_lod_loops; lod++)
         {
+            image_mip_level level = get_image_mip_level( imageInfo, lod );
+            size_t width_lod = level.width, height_lod = level.height, nextLevelOffset = level.offset;
             if (ctx.testMipmaps)
             {
                 error = clSetKernelArg( kernel, 2, sizeof( int ), &lod );
@@ -683,11 +685,6 @@ int test_write_image(cl_device_id device, cl_context context,
                     resultPtr += get_pixel_size( imageInfo->format );
                 }
             }
-            {
-                nextLevelOffset += width_lod * height_lod * get_pixel_size( imageInfo->format);
-                width_lod = (width_lod >> 1) ?(width_lod >> 1) : 1;
-                height_lod = (height_lod >> 1) ?(height_lod >> 1) : 1;
-            }
         }
 
         if (ctx.testImage2DFromBuffer) clReleaseMemObject(imageBuffer);
@@ -932,50 +929,64 @@ int test_write_image_formats(cl_device_id device, cl_context context,
 
     RandomSeed seed( gRandomSeed );
 
+    std::vector<const cl_image_format *> formats;
     for (unsigned int i = 0; i < formatList.size(); i++)
     {
-        const cl_image_format &imageFormat = formatList[i];
-
-        if( filterFlags[ i ] )
-            continue;
+        if( !filterFlags[ i ] )
+            formats.push_back( &formatList[ i ] );
+    }
 
-        gTestCount++;
+    // Concurrent tests can't share the random stream, each draws from its own
+    std::vector<cl_uint> testSeeds;
+    if( ctx.concurrentQueues > 1 )
+    {
+        for( size_t i = 0; i < formats.size(); i++ )
+            testSeeds.push_back( genrand_int32( seed ) );
+    }
 
-        print_write_header( &imageFormat, false );
-        int retCode = 0;
-        switch (imageType)
-        {
-            case CL_MEM_OBJECT_IMAGE1D:
-                retCode = test_write_image_1D_set(
-                    device, context, queue, &imageFormat, inputType, seed, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D:
-                retCode = test_write_image_set(
-                    device, context, queue, &imageFormat, inputType, seed, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE3D:
-                retCode = test_write_image_3D_set(
-                    device, context, queue, &imageFormat, inputType, seed, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-                retCode = test_write_image_1D_array_set(
-                    device, context, queue, &imageFormat, inputType, seed, ctx);
-                break;
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                retCode = test_write_image_2D_array_set(
-                    device, context, queue, &imageFormat, inputType, seed, ctx);
-                break;
-        }
+    ret += run_image_format_tests(
+        queue, ctx, formats.size(),
+        [&]( size_t index, bool error ) { print_write_header( formats[ index ], error ); },
+        [&]( cl_command_queue testQueue, size_t index ) {
+            MTdataHolder testSeed;
+            MTdata d = seed;
+            if( !testSeeds.empty() )
+            {
+                testSeed = MTdataHolder( testSeeds[ index ] );
+                d = testSeed;
+            }
 
-        if( retCode != 0 )
-        {
-            gFailCount++;
-            log_error( "FAILED: " );
-            print_write_header( &imageFormat, true );
-            log_info( "\n" );
-        }
-        ret += retCode;
-    }
+            // Compute the references without flushing denorms, as main does,
+            // on whichever thread runs the test.
+            FPU_mode_type oldMode;
+            DisableFTZ( &oldMode );
+            int retCode = 0;
+            switch (imageType)
+            {
+                case CL_MEM_OBJECT_IMAGE1D:
+                    retCode = test_write_image_1D_set(
+                        device, context, testQueue, formats[index], inputType, d, ctx);
+                    break;
+                case CL_MEM_OBJECT_IMAGE2D:
+                    retCode = test_write_image_set(
+                        device, context, testQueue, formats[index], inputType, d, ctx);
+                    break;
+                case CL_MEM_OBJECT_IMAGE3D:
+                    retCode = test_write_image_3D_set(
+                        device, context, testQueue, formats[index], inputType, d, ctx);
+                    break;
+                case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+                    retCode = test_write_image_1D_array_set(
+                        device, context, testQueue, formats[index], inputType, d, ctx);
+                    break;
+                case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+                    retCode = test_write_image_2D_array_set(
+                        device, context, testQueue, formats[index], inputType, d, ctx);
+                    break;
+            }
+            RestoreFPState( &oldMode );
+            return retCode;
+        } );
     return ret;
 }
 
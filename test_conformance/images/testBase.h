@@ -45,6 +45,8 @@ struct image_test_context_t
     cl_filter_mode filterModeToUse = (cl_filter_mode)-1;
     cl_channel_type channelTypeToUse = (cl_channel_type)-1;
     cl_channel_order channelOrderToUse = (cl_channel_order)-1;
+    cl_ulong hostMemoryBudget = 0;
+    cl_uint concurrentQueues = 0;
 };
 
 enum TypesToTest
@@ -62,10 +62,12 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     dptr func = job->f->dfunc;
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     const char *name = job->f->name;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     int isNextafter = job->isNextafter;
     cl_ulong *t;
     cl_double *r;
@@ -251,7 +253,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     // Verify data
     t = (cl_ulong *)r;
-    for (size_t j = 0; j < buffer_elements; j++)
+    FindMismatches(t, out, buffer_elements, tinfo->mismatches);
+    for (auto j : tinfo->mismatches)
     {
         for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
@@ -411,6 +414,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -520,6 +525,8 @@ int TestFunc_Double_Double_Double(const Func *f, MTdata d, bool relaxedMode)
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "double", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
@@ -545,6 +552,8 @@ int TestFunc_Double_Double_Double(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
@@ -37,6 +37,13 @@ cl_int BuildKernelFn(cl_uint job_id, cl_uint thread_id UNUSED, void *p)
     return BuildKernels(info, job_id, generator);
 }
 
+// Slot specific data, which also keeps the overflow flags of the reference
+// results until they are verified.
+struct ThreadInfo : public ThreadInfoBinary
+{
+    std::vector<bool> overflow;
+};
+
 struct TestInfo : public TestInfoBase
 {
     // Programs for various vector sizes.
@@ -46,44 +53,40 @@ struct TestInfo : public TestInfoBase
     // k[vector_size][thread_id]
     KernelMatrix k;
 
-    // Array of thread specific information
-    std::vector<ThreadInfoBinary> tinfo;
+    // Array of slot specific information, see RunPipelined
+    std::vector<ThreadInfo> tinfo;
 };
 
-cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
+cl_int Submit(cl_uint job_id, cl_uint thread_id, cl_uint slot, void *data)
 {
     TestInfo *job = (TestInfo *)data;
     size_t buffer_elements = job->subBufferSize;
     size_t buffer_size = buffer_elements * sizeof(cl_float);
     cl_uint base = job_id * (cl_uint)job->step;
-    ThreadInfoBinary *tinfo = &(job->tinfo[thread_id]);
+    ThreadInfo *tinfo = &(job->tinfo[slot]);
     fptr func = job->f->func;
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
-    float ulps = getAllowedUlpError(job->f, kfloat, relaxedMode);
-    MTdata d = tinfo->d;
+    bptr bfunc = GetBatchReference(job->f, relaxedMode);
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
-    std::vector<bool> overflow(buffer_elements, false);
+    std::vector<bool> &overflow = tinfo->overflow;
     const char *name = job->f->name;
     int isFDim = job->isFDim;
     int skipNanInf = job->skipNanInf;
-    int isNextafter = job->isNextafter;
-    cl_uint *t = 0;
     cl_float *r = 0;
     cl_float *s = 0;
     cl_float *s2 = 0;
     cl_int copysign_test = 0;
     RoundingMode oldRoundMode;
-    int skipVerification = 0;
+
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
+    PhaseClock clock(tinfo->times);
 
     if (relaxedMode)
     {
         func = job->f->rfunc;
-        if (strcmp(name, "pow") == 0 && gFastRelaxedDerived)
-        {
-            ulps = INFINITY;
-            skipVerification = 1;
-        }
     }
 
     cl_event e[VECTOR_SIZE_COUNT];
@@ -109,8 +112,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     // Init input array
-    cl_uint *p = (cl_uint *)gIn + thread_id * buffer_elements;
-    cl_uint *p2 = (cl_uint *)gIn2 + thread_id * buffer_elements;
+    cl_uint *p = (cl_uint *)gIn + slot * buffer_elements;
+    cl_uint *p2 = (cl_uint *)gIn2 + slot * buffer_elements;
     cl_uint idx = 0;
 
     const std::vector<float> &specialValues = getFloatSpecialValues();
@@ -162,6 +165,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
     }
+    clock.Lap(Phase::Fill);
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
@@ -206,6 +210,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        clock.Lap(Phase::Fill, j);
+
         // Run the kernel
         size_t vectorCount =
             (buffer_elements + sizeValues[j] - 1) / sizeValues[j];
@@ -227,10 +233,12 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             vlog_error("FAILED -- could not execute kernel\n");
             return error;
         }
+        clock.Lap(Phase::Enqueue, j);
     }
 
     // Get that moving
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 2 failed\n");
+    clock.Lap(Phase::Enqueue);
 
     if (gSkipCorrectnessTesting)
     {
@@ -259,9 +267,9 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 #define ref_func(s, s2) (copysign_test ? func.f_ff_f(s, s2) : func.f_ff(s, s2))
 
     // Calculate the correctly rounded reference result
-    r = (float *)gOut_Ref + thread_id * buffer_elements;
-    s = (float *)gIn + thread_id * buffer_elements;
-    s2 = (float *)gIn2 + thread_id * buffer_elements;
+    r = (float *)gOut_Ref + slot * buffer_elements;
+    s = (float *)gIn + slot * buffer_elements;
+    s2 = (float *)gIn2 + slot * buffer_elements;
     if (skipNanInf)
     {
         for (size_t j = 0; j < buffer_elements; j++)
@@ -272,6 +280,10 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                 FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
         }
     }
+    else if (bfunc.p)
+    {
+        bfunc.f_ff(s, s2, r, buffer_elements);
+    }
     else
     {
         for (size_t j = 0; j < buffer_elements; j++)
@@ -279,9 +291,62 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     if (isFDim && ftz) RestoreFPState(&oldMode);
+    if (isFDim && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    clock.Lap(Phase::Reference);
+
+    return CL_SUCCESS;
+}
+
+cl_int Complete(cl_uint job_id, cl_uint thread_id UNUSED, cl_uint slot,
+                void *data)
+{
+    TestInfo *job = (TestInfo *)data;
+    size_t buffer_elements = job->subBufferSize;
+    size_t buffer_size = buffer_elements * sizeof(cl_float);
+    cl_uint base = job_id * (cl_uint)job->step;
+    ThreadInfo *tinfo = &(job->tinfo[slot]);
+    fptr func = job->f->func;
+    int ftz = job->ftz;
+    bool relaxedMode = job->relaxedMode;
+    float ulps = getAllowedUlpError(job->f, kfloat, relaxedMode);
+    cl_int error;
+    const std::vector<bool> &overflow = tinfo->overflow;
+    const char *name = job->f->name;
+    int isFDim = job->isFDim;
+    int skipNanInf = job->skipNanInf;
+    int isNextafter = job->isNextafter;
+    cl_uint *t = 0;
+    cl_float *r = (float *)gOut_Ref + slot * buffer_elements;
+    cl_float *s = (float *)gIn + slot * buffer_elements;
+    cl_float *s2 = (float *)gIn2 + slot * buffer_elements;
+    cl_int copysign_test = !strcmp(name, "copysign");
+    RoundingMode oldRoundMode = kRoundToNearestEven;
+    int skipVerification = 0;
+
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
+    if (relaxedMode)
+    {
+        func = job->f->rfunc;
+        if (job->f->relaxed_policy == RelaxedPolicy::Derived
+            && gFastRelaxedDerived)
+        {
+            ulps = INFINITY;
+            skipVerification = 1;
+        }
+    }
+
+    if (gSkipCorrectnessTesting) return CL_SUCCESS;
+
+    // Set the rounding mode to match the device
+    if (isFDim && gIsInRTZMode)
+        oldRoundMode = set_round(kRoundTowardZero, kfloat);
+
+    PhaseClock clock(tinfo->times);
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
+    cl_uint *out[VECTOR_SIZE_COUNT];
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
         cl_bool blocking = (j + 1 < gMaxVectorSizeIndex) ? CL_FALSE : CL_TRUE;
@@ -294,13 +359,15 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                        error);
             return error;
         }
+        clock.Lap(Phase::Map, j);
     }
 
     if (!skipVerification)
     {
         // Verify data
         t = (cl_uint *)r;
-        for (size_t j = 0; j < buffer_elements; j++)
+        FindMismatches(t, out, buffer_elements, tinfo->mismatches);
+        for (auto j : tinfo->mismatches)
         {
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
@@ -545,7 +612,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                     {
                         vlog_error(
                             "\nERROR: %s%s: %f ulp error at {%a (0x%x), %a "
-                            "(0x%x)}: *%a vs. %a (0x%8.8x) at index: %zu\n",
+                            "(0x%x)}: *%a vs. %a (0x%8.8x) at index: %u\n",
                             name, sizeNames[k], err, s[j], ((cl_uint *)s)[j],
                             s2[j], ((cl_uint *)s2)[j], r[j], test,
                             ((cl_uint *)&test)[0], j);
@@ -558,6 +625,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     if (isFDim && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
 
+    clock.Lap(Phase::Verify);
+
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
         if ((error = clEnqueueUnmapMemObject(tinfo->tQueue, tinfo->outBuf[j],
@@ -570,8 +639,12 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
+    clock.Lap(Phase::Map);
+    tinfo->times.values += buffer_elements;
 
 
+    MarkJobDone(*job, job_id, slot, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -605,8 +678,9 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
     // Init test_info
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
-        / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
+    cl_uint slotCount = GetPipelineSlotCount(test_info.threadCount);
+    test_info.subBufferSize =
+        BUFFER_SIZE / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(slotCount));
     test_info.scale = getTestScale(sizeof(cl_float));
 
     test_info.step = (cl_uint)test_info.subBufferSize * test_info.scale;
@@ -629,8 +703,8 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
     test_info.skipNanInf = test_info.isFDim && !gInfNanSupport;
     test_info.isNextafter = 0 == strcmp("nextafter", f->nameInCode);
 
-    test_info.tinfo.resize(test_info.threadCount);
-    for (cl_uint i = 0; i < test_info.threadCount; i++)
+    test_info.tinfo.resize(slotCount);
+    for (cl_uint i = 0; i < slotCount; i++)
     {
         cl_buffer_region region = {
             i * test_info.subBufferSize * sizeof(cl_float),
@@ -679,9 +753,14 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         }
 
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
+        test_info.tinfo[i].overflow.resize(test_info.subBufferSize);
     }
 
+    InitJobs(test_info, "float", slotCount);
+
     // Init the kernels
+    FunctionTiming timing(f, "float", relaxedMode, test_info.tinfo,
+                          test_info.threadCount);
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
                                 relaxedMode };
@@ -689,15 +768,17 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                gMaxVectorSizeIndex - gMinVectorSizeIndex,
                                &build_info)))
         return error;
+    timing.BuildDone();
 
     // Run the kernels
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(Test, test_info.jobCount, &test_info);
+        error = RunPipelined({ Submit, Complete }, test_info.threadCount,
+                             test_info.jobCount, &test_info);
         if (error) return error;
 
         // Accumulate the arithmetic errors
-        for (cl_uint i = 0; i < test_info.threadCount; i++)
+        for (cl_uint i = 0; i < slotCount; i++)
         {
             if (test_info.tinfo[i].maxError > maxError)
             {
@@ -706,6 +787,8 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
@@ -717,5 +800,7 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
     vlog("\n");
 
+    timing.Passed();
+
     return CL_SUCCESS;
 }
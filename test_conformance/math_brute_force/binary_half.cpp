@@ -62,16 +62,18 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     float ulps = job->ulps;
     fptr func = job->f->func;
     int ftz = job->ftz;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     const char *name = job->f->name;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     int isFDim = job->isFDim;
     int skipNanInf = job->skipNanInf;
     int isNextafter = job->isNextafter;
     cl_ushort *t;
     cl_half *r;
-    std::vector<float> s(0), s2(0);
+    std::vector<float> s(0), s2(0), ref(0);
     cl_uint j = 0;
 
     RoundingMode oldRoundMode;
@@ -245,16 +247,17 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     t = (cl_ushort *)r;
     s.resize(buffer_elements);
     s2.resize(buffer_elements);
+    ref.resize(buffer_elements);
     for (j = 0; j < buffer_elements; j++)
     {
         s[j] = cl_half_to_float(p[j]);
         s2[j] = cl_half_to_float(p2[j]);
         if (isNextafter)
-            r[j] = cl_half_from_float(reference_nextafterh(s[j], s2[j]),
-                                      halfRoundingMode);
+            ref[j] = reference_nextafterh(s[j], s2[j]);
         else
-            r[j] = cl_half_from_float(ref_func(s[j], s2[j]), halfRoundingMode);
+            ref[j] = ref_func(s[j], s2[j]);
     }
+    half_from_float_array(r, ref.data(), buffer_elements, halfRoundingMode);
 
     if (isFDim && ftz) RestoreFPState(&oldMode);
     // Read the data back -- no need to wait for the first N-1 buffers. This is
@@ -274,8 +277,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     // Verify data
-
-    for (j = 0; j < buffer_elements; j++)
+    FindMismatches(t, out, buffer_elements, tinfo->mismatches);
+    for (auto j : tinfo->mismatches)
     {
         for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
@@ -561,6 +564,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
+    if (error == CL_SUCCESS) MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -671,6 +676,8 @@ int TestFunc_Half_Half_Half_common(const Func *f, MTdata d, int isNextafter,
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "half", test_info.threadCount);
+
     // Init the kernels
     {
         BuildKernelInfo build_info = { test_info.threadCount, test_info.k,
@@ -694,6 +701,8 @@ int TestFunc_Half_Half_Half_common(const Func *f, MTdata d, int isNextafter,
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         test_error(error, "ThreadPool_Do: TestHalf failed\n");
 
@@ -62,7 +62,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     dptr func = job->f->dfunc;
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     const char *name = job->f->name;
     cl_ulong *t;
@@ -70,6 +70,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_double *s;
     cl_int *s2;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     Force64BitFPUPrecision();
 
     cl_event e[VECTOR_SIZE_COUNT];
@@ -324,6 +326,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -432,6 +436,8 @@ int TestFunc_Double_Double_Int(const Func *f, MTdata d, bool relaxedMode)
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "double", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
@@ -457,6 +463,8 @@ int TestFunc_Double_Double_Int(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
@@ -62,7 +62,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
     float ulps = job->ulps;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     const char *name = job->f->name;
     cl_uint *t = 0;
@@ -70,6 +70,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_float *s = 0;
     cl_int *s2 = 0;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     cl_event e[VECTOR_SIZE_COUNT];
     cl_uint *out[VECTOR_SIZE_COUNT];
     if (gHostFill)
@@ -326,6 +328,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -435,6 +439,8 @@ int TestFunc_Float_Float_Int(const Func *f, MTdata d, bool relaxedMode)
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "float", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
@@ -460,6 +466,8 @@ int TestFunc_Float_Float_Int(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
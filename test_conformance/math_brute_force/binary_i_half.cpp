@@ -58,15 +58,17 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     float ulps = job->ulps;
     fptr func = job->f->func;
     int ftz = job->ftz;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_uint j, k;
     cl_int error;
     const char *name = job->f->name;
     cl_ushort *t;
     cl_half *r;
-    std::vector<float> s;
+    std::vector<float> s, ref;
     cl_int *s2;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     // start the map of the output arrays
     cl_event e[VECTOR_SIZE_COUNT];
     cl_ushort *out[VECTOR_SIZE_COUNT];
@@ -215,11 +217,13 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     t = (cl_ushort *)r;
     s.resize(buffer_elements);
     s2 = (cl_int *)gIn2 + thread_id * buffer_elements;
+    ref.resize(buffer_elements);
     for (j = 0; j < buffer_elements; j++)
     {
         s[j] = cl_half_to_float(p[j]);
-        r[j] = HFF(func.f_fi(s[j], s2[j]));
+        ref[j] = func.f_fi(s[j], s2[j]);
     }
+    half_from_float_array(r, ref.data(), buffer_elements, gHalfRoundingMode);
 
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
@@ -329,6 +333,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
+    if (error == CL_SUCCESS) MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -438,6 +444,8 @@ int TestFunc_Half_Half_Int(const Func *f, MTdata d, bool relaxedMode)
     }
 
 
+    InitJobs(test_info, "half", test_info.threadCount);
+
     // Init the kernels
     {
         BuildKernelInfo build_info = { test_info.threadCount, test_info.k,
@@ -463,6 +471,8 @@ int TestFunc_Half_Half_Int(const Func *f, MTdata d, bool relaxedMode)
             maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
         }
     }
+    MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+    CompleteJobs(test_info);
 
     test_error(error, "ThreadPool_Do: TestHalf failed\n");
 
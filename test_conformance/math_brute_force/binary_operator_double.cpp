@@ -59,7 +59,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     dptr func = job->f->dfunc;
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     const char *name = job->f->name;
     cl_ulong *t;
@@ -67,6 +67,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_double *s;
     cl_double *s2;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     Force64BitFPUPrecision();
 
     cl_event e[VECTOR_SIZE_COUNT];
@@ -377,6 +379,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -482,6 +486,8 @@ int TestFunc_Double_Double_Double_Operator(const Func *f, MTdata d,
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "double", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
@@ -507,6 +513,8 @@ int TestFunc_Double_Double_Double_Operator(const Func *f, MTdata d,
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
@@ -59,16 +59,20 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
     float ulps = getAllowedUlpError(job->f, kfloat, relaxedMode);
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     std::vector<bool> overflow(buffer_elements, false);
     const char *name = job->f->name;
+    bool limitDomain =
+        relaxedMode && job->f->relaxed_policy == RelaxedPolicy::Divide;
     cl_uint *t = 0;
     cl_float *r = 0;
     cl_float *s = 0;
     cl_float *s2 = 0;
     RoundingMode oldRoundMode;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     if (relaxedMode)
     {
         func = job->f->rfunc;
@@ -125,7 +129,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                 y++;
                 if (y >= specialValuesCount) break;
             }
-            if (relaxedMode && strcmp(name, "divide") == 0)
+            if (limitDomain)
             {
                 cl_uint pj = p[idx] & 0x7fffffff;
                 cl_uint p2j = p2[idx] & 0x7fffffff;
@@ -142,7 +146,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         p[idx] = genrand_int32(d);
         p2[idx] = genrand_int32(d);
 
-        if (relaxedMode && strcmp(name, "divide") == 0)
+        if (limitDomain)
         {
             cl_uint pj = p[idx] & 0x7fffffff;
             cl_uint p2j = p2[idx] & 0x7fffffff;
@@ -255,8 +259,12 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     s2 = (float *)gIn2 + thread_id * buffer_elements;
     if (gInfNanSupport)
     {
-        for (size_t j = 0; j < buffer_elements; j++)
-            r[j] = (float)func.f_ff(s[j], s2[j]);
+        bptr bfunc = GetBatchReference(job->f, relaxedMode);
+        if (bfunc.p)
+            bfunc.f_ff(s, s2, r, buffer_elements);
+        else
+            for (size_t j = 0; j < buffer_elements; j++)
+                r[j] = (float)func.f_ff(s[j], s2[j]);
     }
     else
     {
@@ -511,6 +519,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -620,6 +630,8 @@ int TestFunc_Float_Float_Float_Operator(const Func *f, MTdata d,
 
     bool correctlyRounded = strcmp(f->name, "divide_cr") == 0;
 
+    InitJobs(test_info, "float", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs,    f->nameInCode,
@@ -645,6 +657,8 @@ int TestFunc_Float_Float_Float_Operator(const Func *f, MTdata d,
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
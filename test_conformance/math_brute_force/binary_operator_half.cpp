@@ -58,12 +58,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     float ulps = job->ulps;
     fptr func = job->f->func;
     int ftz = job->ftz;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     const char *name = job->f->name;
     cl_half *r = 0;
-    std::vector<float> s(0), s2(0);
+    std::vector<float> s(0), s2(0), ref(0);
     RoundingMode oldRoundMode;
 
     cl_event e[VECTOR_SIZE_COUNT];
@@ -220,13 +222,15 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
     s.resize(buffer_elements);
     s2.resize(buffer_elements);
+    ref.resize(buffer_elements);
 
     for (size_t j = 0; j < buffer_elements; j++)
     {
         s[j] = HTF(p[j]);
         s2[j] = HTF(p2[j]);
-        r[j] = HFF(func.f_ff(s[j], s2[j]));
+        ref[j] = func.f_ff(s[j], s2[j]);
     }
+    half_from_float_array(r, ref.data(), buffer_elements, gHalfRoundingMode);
 
     if (ftz) RestoreFPState(&oldMode);
 
@@ -453,6 +457,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -557,6 +563,8 @@ int TestFunc_Half_Half_Half_Operator(const Func *f, MTdata d, bool relaxedMode)
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "half", test_info.threadCount);
+
     // Init the kernels
     {
         BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
@@ -582,6 +590,8 @@ int TestFunc_Half_Half_Half_Operator(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal2 = test_info.tinfo[i].maxErrorValue2;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal, maxErrorVal2);
+        CompleteJobs(test_info);
 
         test_error(error, "ThreadPool_Do: TestHalf failed\n");
 
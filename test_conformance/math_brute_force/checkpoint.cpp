@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "checkpoint.h"
+#include "utility.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+uint32_t gShardIndex = 0;
+uint32_t gShardCount = 1;
+std::string gCheckpointPath;
+
+namespace {
+
+// Bump whenever the file format changes.
+constexpr int kCheckpointVersion = 1;
+
+// Inputs per block of the partition of the input space across shards.
+constexpr int kShardBlockBits = 20;
+
+// Time between saves while a test runs.
+constexpr std::chrono::seconds kSaveInterval(60);
+
+} // anonymous namespace
+
+bool IsInShard(uint32_t base)
+{
+    if (gShardCount <= 1) return true;
+
+    // Spread consecutive blocks evenly over the shards, also when the jobs
+    // only test some of the blocks as in wimpy mode.
+    uint32_t hash = (base >> kShardBlockBits) * 0x9e3779b1U;
+    return (uint32_t)(((uint64_t)hash * gShardCount) >> 32) == gShardIndex;
+}
+
+std::unique_ptr<Checkpoint> Checkpoint::Open(const std::string &key,
+                                             const std::string &layout,
+                                             uint32_t step, uint32_t jobCount,
+                                             size_t workerCount)
+{
+    if (gCheckpointPath.empty()) return nullptr;
+
+    std::unique_ptr<Checkpoint> checkpoint(new Checkpoint);
+    checkpoint->fileName = gCheckpointPath + "/" + key;
+    if (gShardCount > 1)
+        checkpoint->fileName += "_shard" + std::to_string(gShardIndex);
+    checkpoint->fileName += ".checkpoint";
+    checkpoint->header = "clbf-checkpoint " + std::to_string(kCheckpointVersion)
+        + " " + key + " step " + std::to_string(step) + " jobs "
+        + std::to_string(jobCount) + " " + layout;
+    checkpoint->resumedDone.assign(jobCount, 0);
+    checkpoint->workers.resize(workerCount);
+
+    if (!checkpoint->Load())
+    {
+        checkpoint->resumedDone.assign(jobCount, 0);
+        checkpoint->resumed = MaxError();
+    }
+
+    checkpoint->done = checkpoint->resumedDone;
+    checkpoint->lastSave = std::chrono::steady_clock::now();
+    return checkpoint;
+}
+
+Checkpoint::~Checkpoint()
+{
+    if (!complete) Save();
+}
+
+void Checkpoint::Complete()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    complete = true;
+    if (remove(fileName.c_str()) != 0 && errno != ENOENT)
+    {
+        vlog_error("Unable to remove checkpoint %s (%s).\n", fileName.c_str(),
+                   strerror(errno));
+    }
+}
+
+void Checkpoint::MarkDone(uint32_t job_id, size_t worker,
+                          const MaxError &maxError)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    done[job_id] = 1;
+    workers[worker] = maxError;
+    if (complete) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastSave >= kSaveInterval)
+    {
+        Save();
+        lastSave = now;
+    }
+}
+
+bool Checkpoint::Load()
+{
+    FILE *file = fopen(fileName.c_str(), "r");
+    if (file == NULL) return false;
+
+    // The file is small, read it whole.
+    std::string text;
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        text.append(buffer, count);
+    fclose(file);
+
+    size_t end = text.find('\n');
+    if (end == std::string::npos || text.compare(0, end, header) != 0)
+    {
+        vlog("Ignoring checkpoint %s from a run with other settings.\n",
+             fileName.c_str());
+        return false;
+    }
+
+    const char *p = text.c_str() + end + 1;
+    char *next;
+    if (strncmp(p, "maxerror ", 9) != 0) return false;
+    resumed.error = strtof(p + 9, &next);
+    resumed.value = strtod(next, &next);
+    resumed.value2 = strtod(next, &next);
+
+    p = strchr(next, '\n');
+    if (p == NULL || strncmp(p + 1, "done", 4) != 0) return false;
+    p += 5;
+
+    // Inclusive ranges of done jobs, "first-last" separated by spaces.
+    uint32_t jobCount = (uint32_t)resumedDone.size();
+    while (*p == ' ')
+    {
+        unsigned long first = strtoul(p + 1, &next, 10);
+        if (*next != '-') return false;
+        unsigned long last = strtoul(next + 1, &next, 10);
+        if (first > last || last >= jobCount) return false;
+        memset(&resumedDone[first], 1, last - first + 1);
+        p = next;
+    }
+
+    if (gVerboseBruteForce)
+        vlog("Resuming from checkpoint %s.\n", fileName.c_str());
+    return true;
+}
+
+void Checkpoint::Save()
+{
+    MaxError maxError = resumed;
+    for (const MaxError &worker : workers)
+        if (worker.error > maxError.error) maxError = worker;
+
+    std::string tempName = fileName + ".tmp";
+    FILE *file = fopen(tempName.c_str(), "w");
+    if (file == NULL)
+    {
+        vlog_error("Unable to write checkpoint %s (%s).\n", tempName.c_str(),
+                   strerror(errno));
+        return;
+    }
+
+    fprintf(file, "%s\nmaxerror %a %a %a\ndone", header.c_str(),
+            maxError.error, maxError.value, maxError.value2);
+    for (size_t first = 0; first < done.size();)
+    {
+        if (!done[first])
+        {
+            first++;
+            continue;
+        }
+        size_t last = first;
+        while (last + 1 < done.size() && done[last + 1]) last++;
+        fprintf(file, " %zu-%zu", first, last);
+        first = last + 1;
+    }
+    fprintf(file, "\n");
+
+    if (fclose(file) != 0)
+    {
+        vlog_error("Unable to write checkpoint %s (%s).\n", tempName.c_str(),
+                   strerror(errno));
+        return;
+    }
+
+    // Replace the previous checkpoint only once the new one is complete.
+#if defined(_WIN32)
+    remove(fileName.c_str());
+#endif
+    if (rename(tempName.c_str(), fileName.c_str()) != 0)
+    {
+        vlog_error("Unable to write checkpoint %s (%s).\n", fileName.c_str(),
+                   strerror(errno));
+    }
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Shard of the jobs run by this process out of gShardCount, see --shard.
+extern uint32_t gShardIndex;
+extern uint32_t gShardCount;
+
+// Directory holding the checkpoint files, empty if checkpoints are disabled.
+extern std::string gCheckpointPath;
+
+// Whether the job testing the inputs from base runs in this shard.  Jobs are
+// assigned to shards by blocks of 2^20 inputs rather than by job index, so
+// that the partition doesn't depend on the size of the jobs, which varies with
+// the number of worker threads of each process.
+bool IsInShard(uint32_t base);
+
+// Record of the jobs of a test done so far and of the max error they found.
+// It is saved to a file periodically and when the test stops early, so that a
+// run restarted after a crash skips the jobs already done.  The file is
+// removed once the test completes.
+//
+// The file is keyed by a caller provided name and stores the job layout of
+// the test.  If the layout doesn't match, the file is from a run with other
+// settings and is ignored.
+class Checkpoint {
+public:
+    // Max error found by some jobs and its position.
+    struct MaxError
+    {
+        float error = 0.0f;
+        double value = 0.0;
+        double value2 = 0.0;
+    };
+
+    // Saves the checkpoint, unless the test completed.
+    ~Checkpoint();
+
+    // Open the checkpoint for key in gCheckpointPath, for a test of jobCount
+    // jobs of step inputs run by workerCount workers.  layout identifies any
+    // other setting the results depend on.  Returns NULL if checkpoints are
+    // disabled.
+    static std::unique_ptr<Checkpoint> Open(const std::string &key,
+                                            const std::string &layout,
+                                            uint32_t step, uint32_t jobCount,
+                                            size_t workerCount);
+
+    // Whether an earlier run already did job_id.
+    bool IsDone(uint32_t job_id) const { return resumedDone[job_id] != 0; }
+
+    // Record that job_id is done, with maxError the max error found so far by
+    // the worker that ran it.
+    void MarkDone(uint32_t job_id, size_t worker, const MaxError &maxError);
+
+    // Max error found by the jobs done by earlier runs.
+    const MaxError &Resumed() const { return resumed; }
+
+    // Record that all the jobs are done: the file is removed, so that the next
+    // run of the test starts over.
+    void Complete();
+
+private:
+    Checkpoint() = default;
+    Checkpoint(const Checkpoint &) = delete;
+    Checkpoint &operator=(const Checkpoint &) = delete;
+
+    bool Load();
+    void Save();
+
+    std::string fileName;
+    std::string header;
+
+    // Jobs done by earlier runs, only read once opened.
+    std::vector<uint8_t> resumedDone;
+    MaxError resumed;
+
+    // Jobs done so far and max error per worker, guarded by mutex.
+    std::mutex mutex;
+    std::vector<uint8_t> done;
+    std::vector<MaxError> workers;
+    std::chrono::steady_clock::time_point lastSave;
+    bool complete = false;
+};
+
+#endif /* CHECKPOINT_H */
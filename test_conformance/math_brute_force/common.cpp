@@ -16,13 +16,29 @@
 
 #include "common.h"
 
+#include "function_list.h"
 #include "utility.h" // for sizeNames and sizeValues.
 
+#include "harness/benchmarkHelpers.h"
+#include "harness/crc32.h"
+#include "harness/deviceInfo.h"
+
+#include <atomic>
 #include <climits>
+#include <cstring>
 #include <vector>
 #include <sstream>
 #include <string>
 
+#if defined(__SSE2__) || defined(_M_X64)                                       \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAS_SSE2_COMPARE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HAS_NEON_COMPARE 1
+#endif
+
 namespace {
 
 const char *GetTypeName(ParameterType type)
@@ -611,6 +627,106 @@ cl_int BuildKernels(BuildKernelInfo &info, cl_uint job_id,
     return CL_SUCCESS;
 }
 
+namespace {
+
+struct PipelineInfo
+{
+    const PipelineStages &stages;
+    cl_uint jobCount;
+    void *data;
+
+    // Next job to be submitted by any thread.
+    std::atomic<cl_uint> nextJob{ 0 };
+
+    // Set once a stage fails so that no new jobs get submitted.
+    std::atomic<bool> failed{ false };
+};
+
+cl_int PipelineWorker(cl_uint job_id UNUSED, cl_uint thread_id, void *p)
+{
+    PipelineInfo &info = *(PipelineInfo *)p;
+    cl_uint depth = gPipelineDepth;
+    cl_uint firstSlot = thread_id * depth;
+
+    // Ring of the jobs in flight, oldest first.  Slot firstSlot + i holds the
+    // job jobs[i].
+    std::vector<cl_uint> jobs(depth);
+    cl_uint head = 0;
+    cl_uint pending = 0;
+    bool more = true;
+    cl_int error = CL_SUCCESS;
+
+    while (more || pending)
+    {
+        if (more && pending < depth)
+        {
+            cl_uint job = info.jobCount;
+            if (!info.failed) job = info.nextJob++;
+            if (job < info.jobCount)
+            {
+                cl_uint i = (head + pending) % depth;
+                error = info.stages.submit(job, thread_id, firstSlot + i,
+                                           info.data);
+                if (error) break;
+                jobs[i] = job;
+                pending++;
+            }
+            else
+            {
+                more = false;
+            }
+            continue;
+        }
+
+        error = info.stages.complete(jobs[head], thread_id, firstSlot + head,
+                                     info.data);
+        if (error) break;
+        head = (head + 1) % depth;
+        pending--;
+    }
+
+    if (error) info.failed = true;
+    return error;
+}
+
+} // anonymous namespace
+
+cl_int RunPipelined(const PipelineStages &stages, cl_uint threadCount,
+                    cl_uint jobCount, void *data)
+{
+    PipelineInfo info{ stages, jobCount, data };
+    if (threadCount == 1) return PipelineWorker(0, 0, &info);
+    return ThreadPool_Do(PipelineWorker, threadCount, &info);
+}
+
+void InitJobs(TestInfoBase &info, const char *typeName, size_t workerCount)
+{
+    std::string key = std::string(info.f->name) + "_" + typeName;
+    if (info.relaxedMode) key += "_relaxed";
+    info.jobSeed = gRandomSeed ^ crc32(key.data(), key.size());
+
+    // Anything else the inputs and results of the jobs depend on, the device
+    // and its driver included.
+    static const std::string device = get_device_name(gDevice) + " driver "
+        + get_device_info_string(gDevice, CL_DRIVER_VERSION);
+    std::string layout = "device " + device + " shard "
+        + std::to_string(gShardIndex) + "/" + std::to_string(gShardCount)
+        + " seed " + std::to_string(gRandomSeed)
+        + " vectors " + std::to_string(gMinVectorSizeIndex) + "-"
+        + std::to_string(gMaxVectorSizeIndex) + " ftz "
+        + std::to_string(info.ftz);
+
+    info.checkpoint =
+        Checkpoint::Open(key, layout, info.step, info.jobCount, workerCount);
+}
+
+MTdata SeedJob(const TestInfoBase &info, cl_uint base, MTdataHolder &d)
+{
+    if (gShardCount > 1 || info.checkpoint)
+        d = MTdataHolder(info.jobSeed ^ (base * 0x9e3779b1U));
+    return d;
+}
+
 static const std::vector<double> doubleSpecialValues = {
     -NAN,
     -INFINITY,
@@ -865,3 +981,178 @@ static const std::vector<int> int3SpecialValues = {
 };
 
 const std::vector<int> &getInt3SpecialValues() { return int3SpecialValues; }
+
+namespace {
+
+// Number of bytes of each buffer checked at once by BlockDiffers.
+constexpr size_t kCompareBlockSize = 64;
+
+// Return true if any of the out buffers differs from ref in the
+// kCompareBlockSize bytes starting at offset.
+bool BlockDiffers(const uint8_t *ref, const void *const *out, size_t offset)
+{
+#if defined(HAS_SSE2_COMPARE)
+    const __m128i *r = (const __m128i *)(ref + offset);
+    __m128i r0 = _mm_loadu_si128(r + 0);
+    __m128i r1 = _mm_loadu_si128(r + 1);
+    __m128i r2 = _mm_loadu_si128(r + 2);
+    __m128i r3 = _mm_loadu_si128(r + 3);
+    __m128i diff = _mm_setzero_si128();
+    for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+    {
+        const __m128i *q = (const __m128i *)((const uint8_t *)out[k] + offset);
+        diff = _mm_or_si128(diff, _mm_xor_si128(r0, _mm_loadu_si128(q + 0)));
+        diff = _mm_or_si128(diff, _mm_xor_si128(r1, _mm_loadu_si128(q + 1)));
+        diff = _mm_or_si128(diff, _mm_xor_si128(r2, _mm_loadu_si128(q + 2)));
+        diff = _mm_or_si128(diff, _mm_xor_si128(r3, _mm_loadu_si128(q + 3)));
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128()))
+        != 0xffff;
+#elif defined(HAS_NEON_COMPARE)
+    const uint8_t *r = ref + offset;
+    uint8x16_t r0 = vld1q_u8(r + 0);
+    uint8x16_t r1 = vld1q_u8(r + 16);
+    uint8x16_t r2 = vld1q_u8(r + 32);
+    uint8x16_t r3 = vld1q_u8(r + 48);
+    uint8x16_t diff = vdupq_n_u8(0);
+    for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+    {
+        const uint8_t *q = (const uint8_t *)out[k] + offset;
+        diff = vorrq_u8(diff, veorq_u8(r0, vld1q_u8(q + 0)));
+        diff = vorrq_u8(diff, veorq_u8(r1, vld1q_u8(q + 16)));
+        diff = vorrq_u8(diff, veorq_u8(r2, vld1q_u8(q + 32)));
+        diff = vorrq_u8(diff, veorq_u8(r3, vld1q_u8(q + 48)));
+    }
+    uint64x2_t diff64 = vreinterpretq_u64_u8(diff);
+    return (vgetq_lane_u64(diff64, 0) | vgetq_lane_u64(diff64, 1)) != 0;
+#else
+    uint64_t diff = 0;
+    for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+    {
+        const uint8_t *q = (const uint8_t *)out[k] + offset;
+        for (size_t i = 0; i < kCompareBlockSize; i += sizeof(uint64_t))
+        {
+            uint64_t a, b;
+            memcpy(&a, ref + offset + i, sizeof(a));
+            memcpy(&b, q + i, sizeof(b));
+            diff |= a ^ b;
+        }
+    }
+    return diff != 0;
+#endif
+}
+
+// Append the indices in [begin, end) at which any out buffer differs from ref.
+void AppendMismatches(const uint8_t *ref, const void *const *out,
+                      size_t elementSize, size_t begin, size_t end,
+                      std::vector<cl_uint> &mismatches)
+{
+    for (size_t j = begin; j < end; j++)
+    {
+        for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+        {
+            const uint8_t *q = (const uint8_t *)out[k];
+            if (memcmp(ref + j * elementSize, q + j * elementSize, elementSize))
+            {
+                mismatches.push_back((cl_uint)j);
+                break;
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+void FindMismatches(const void *ref, const void *const *out,
+                    size_t elementSize, size_t count,
+                    std::vector<cl_uint> &mismatches)
+{
+    static_assert(kCompareBlockSize % sizeof(cl_ulong) == 0,
+                  "blocks must hold whole elements");
+
+    const uint8_t *r = (const uint8_t *)ref;
+    size_t size = count * elementSize;
+    size_t offset = 0;
+
+    mismatches.clear();
+    for (; offset + kCompareBlockSize <= size; offset += kCompareBlockSize)
+    {
+        if (BlockDiffers(r, out, offset))
+            AppendMismatches(r, out, elementSize, offset / elementSize,
+                             (offset + kCompareBlockSize) / elementSize,
+                             mismatches);
+    }
+    AppendMismatches(r, out, elementSize, offset / elementSize, count,
+                     mismatches);
+}
+
+namespace {
+
+// The scan of the verify loops before FindMismatches: each vector size, then
+// each element.
+template <typename T>
+void ScanMismatches(const void *ref, const void *const *out, size_t count,
+                    std::vector<cl_uint> &mismatches)
+{
+    const T *t = (const T *)ref;
+    mismatches.clear();
+    for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+    {
+        const T *q = (const T *)out[k];
+        for (size_t j = 0; j < count; j++)
+            if (t[j] != q[j]) mismatches.push_back((cl_uint)j);
+    }
+}
+
+} // anonymous namespace
+
+int BenchmarkVerify()
+{
+    // Buffers of the size the tests verify at once, with an element that
+    // differs every 64 KiB of the last vector size, as in a run that fails.
+    std::vector<uint8_t> ref(BUFFER_SIZE);
+    for (size_t i = 0; i < ref.size(); i++)
+        ref[i] = (uint8_t)(i * 0x9e3779b1U >> 24);
+    std::vector<std::vector<uint8_t>> outs(VECTOR_SIZE_COUNT, ref);
+    for (size_t i = 0; i < ref.size(); i += 65536)
+        outs[gMaxVectorSizeIndex - 1][i] ^= 1;
+
+    const void *out[VECTOR_SIZE_COUNT];
+    for (int k = 0; k < VECTOR_SIZE_COUNT; k++) out[k] = outs[k].data();
+
+    std::vector<cl_uint> mismatches;
+    double bytes =
+        (double)BUFFER_SIZE * (gMaxVectorSizeIndex - gMinVectorSizeIndex);
+    const int runs = 10;
+    for (size_t elementSize : { 2, 4, 8 })
+    {
+        size_t count = BUFFER_SIZE / elementSize;
+        auto scanElements = [&] {
+            switch (elementSize)
+            {
+                case 2:
+                    ScanMismatches<cl_ushort>(ref.data(), out, count,
+                                              mismatches);
+                    break;
+                case 4:
+                    ScanMismatches<cl_uint>(ref.data(), out, count,
+                                            mismatches);
+                    break;
+                default:
+                    ScanMismatches<cl_ulong>(ref.data(), out, count,
+                                             mismatches);
+                    break;
+            }
+        };
+        auto findMismatches = [&] {
+            FindMismatches(ref.data(), out, elementSize, count, mismatches);
+        };
+        double scan = best_time(scanElements, runs);
+        double wide = best_time(findMismatches, runs);
+        vlog("%zu byte elements: %6.2f GB/s element by element, %6.2f GB/s "
+             "FindMismatches, %zu mismatches\n",
+             elementSize, bytes / scan * 1e-9, bytes / wide * 1e-9,
+             mismatches.size());
+    }
+    return 0;
+}
@@ -17,9 +17,12 @@
 #define COMMON_H
 
 #include "harness/typeWrappers.h"
+#include "checkpoint.h"
+#include "timing.h"
 #include "utility.h"
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -107,6 +110,13 @@ struct ThreadInfoUnary
 
     // Per thread command queue to improve performance.
     clCommandQueueWrapper tQueue;
+
+    // Indices of the results that differ from the reference, reused between
+    // jobs to avoid reallocating.
+    std::vector<cl_uint> mismatches;
+
+    // Time spent by the jobs of this thread in each phase.
+    PhaseTimes times;
 };
 
 // Thread specific data for a binary function worker thread.
@@ -171,6 +181,12 @@ struct TestInfoBase
 
     // Whether the test is being run in relaxed mode.
     bool relaxedMode = false;
+
+    // Jobs done by earlier runs, NULL if checkpoints are disabled.
+    std::unique_ptr<Checkpoint> checkpoint;
+
+    // Seed of the random inputs of the jobs, see SeedJob.
+    cl_uint jobSeed = 0;
 };
 
 using SourceGenerator = std::string (*)(const std::string &kernel_name,
@@ -181,6 +197,129 @@ using SourceGenerator = std::string (*)(const std::string &kernel_name,
 cl_int BuildKernels(BuildKernelInfo &info, cl_uint job_id,
                     SourceGenerator generator);
 
+/// Collect in "mismatches" the indices of the elements for which any of the
+/// out[gMinVectorSizeIndex..gMaxVectorSizeIndex) buffers differs bitwise from
+/// ref.  The buffers are compared in wide blocks so that results matching the
+/// reference don't go through the per element verification code.
+void FindMismatches(const void *ref, const void *const *out,
+                    size_t elementSize, size_t count,
+                    std::vector<cl_uint> &mismatches);
+
+template <typename RefTy, typename OutTy>
+void FindMismatches(const RefTy *ref, OutTy *const (&out)[VECTOR_SIZE_COUNT],
+                    size_t count, std::vector<cl_uint> &mismatches)
+{
+    static_assert(sizeof(RefTy) == sizeof(OutTy),
+                  "reference and result types must have the same size");
+    const void *outs[VECTOR_SIZE_COUNT];
+    for (int k = 0; k < VECTOR_SIZE_COUNT; k++) outs[k] = out[k];
+    FindMismatches(ref, outs, sizeof(RefTy), count, mismatches);
+}
+
+/// Time FindMismatches against the element by element scan it replaces on
+/// host buffers, for --benchmark-verify.  Needs no device.
+int BenchmarkVerify();
+
+// Stage of a job run by RunPipelined.  thread_id is the worker thread running
+// the stage and slot the index of the buffers and command queue the job uses.
+using PipelineStageFn = cl_int (*)(cl_uint job_id, cl_uint thread_id,
+                                   cl_uint slot, void *data);
+
+// A test job split so that consecutive jobs of a worker thread can overlap.
+struct PipelineStages
+{
+    // Fill the inputs, enqueue the kernels and compute the reference results
+    // without waiting for the device.
+    PipelineStageFn submit;
+
+    // Wait for the device results and verify them.
+    PipelineStageFn complete;
+};
+
+/// Number of buffer slots RunPipelined needs for threadCount worker threads.
+inline cl_uint GetPipelineSlotCount(cl_uint threadCount)
+{
+    return threadCount * gPipelineDepth;
+}
+
+/// Run jobs [0, jobCount) on threadCount worker threads, each of which keeps up
+/// to gPipelineDepth jobs in flight: a thread submits its next job before it
+/// completes its oldest one, so that filling the inputs and computing the
+/// reference results of a job overlap with the device execution of the
+/// previous ones.  Thread thread_id cycles through the slots
+/// [thread_id * gPipelineDepth, (thread_id + 1) * gPipelineDepth) and completes
+/// its jobs in submission order.  With a threadCount of 1 all jobs are run on
+/// the calling thread.
+cl_int RunPipelined(const PipelineStages &stages, cl_uint threadCount,
+                    cl_uint jobCount, void *data);
+
+/// Set up the sharding and the checkpoint of the jobs of the test of info.f on
+/// typeName, run by workerCount workers.  To be called once the job layout of
+/// info is set, before running the jobs.
+void InitJobs(TestInfoBase &info, const char *typeName, size_t workerCount);
+
+/// Whether job_id, testing the inputs from base, is to be skipped because it
+/// runs in another shard or an earlier run already did it.
+inline bool SkipJob(const TestInfoBase &info, cl_uint job_id, cl_uint base)
+{
+    return !IsInShard(base)
+        || (info.checkpoint && info.checkpoint->IsDone(job_id));
+}
+
+/// Random number generator d of a worker, for the job testing the inputs from
+/// base.  When jobs are sharded or checkpointed, d is reseeded for each job so
+/// that the inputs of a job don't depend on the jobs run before it.
+MTdata SeedJob(const TestInfoBase &info, cl_uint base, MTdataHolder &d);
+
+/// Record that job_id was done by worker, whose thread info is tinfo.
+inline void MarkJobDone(TestInfoBase &info, cl_uint job_id, cl_uint worker,
+                        const ThreadInfoUnary &tinfo)
+{
+    if (info.checkpoint)
+        info.checkpoint->MarkDone(
+            job_id, worker, { tinfo.maxError, tinfo.maxErrorValue, 0.0 });
+}
+
+template <typename Param2Ty>
+void MarkJobDone(TestInfoBase &info, cl_uint job_id, cl_uint worker,
+                 const ThreadInfoBinaryBase<Param2Ty> &tinfo)
+{
+    if (info.checkpoint)
+        info.checkpoint->MarkDone(job_id, worker,
+                                  { tinfo.maxError, tinfo.maxErrorValue,
+                                    (double)tinfo.maxErrorValue2 });
+}
+
+/// Record that all the jobs of info are done, so that its checkpoint is not
+/// resumed by the next run.
+inline void CompleteJobs(TestInfoBase &info)
+{
+    if (info.checkpoint) info.checkpoint->Complete();
+}
+
+/// Fold the max error found by the jobs done by earlier runs into maxError.
+inline void MergeResumedMaxError(const TestInfoBase &info, float &maxError,
+                                 double &maxErrorValue)
+{
+    if (info.checkpoint && info.checkpoint->Resumed().error > maxError)
+    {
+        maxError = info.checkpoint->Resumed().error;
+        maxErrorValue = info.checkpoint->Resumed().value;
+    }
+}
+
+template <typename Param2Ty>
+void MergeResumedMaxError(const TestInfoBase &info, float &maxError,
+                          double &maxErrorValue, Param2Ty &maxErrorValue2)
+{
+    if (info.checkpoint && info.checkpoint->Resumed().error > maxError)
+    {
+        maxError = info.checkpoint->Resumed().error;
+        maxErrorValue = info.checkpoint->Resumed().value;
+        maxErrorValue2 = (Param2Ty)info.checkpoint->Resumed().value2;
+    }
+}
+
 const std::vector<double> &getDoubleSpecialValues();
 const std::vector<float> &getFloatSpecialValues();
 const std::vector<cl_half> &getHalfSpecialValues();
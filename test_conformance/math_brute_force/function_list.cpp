@@ -37,11 +37,13 @@
             INFINITY, INFINITY, _rmode, RELAXED_OFF, _type                     \
     }
 #define ENTRY_EXT(_name, _ulp, _embedded_ulp, _half_ulp, _half_embedded_ulp,   \
-                  _relaxed_ulp, _rmode, _type, _relaxed_embedded_ulp)          \
+                  _relaxed_ulp, _rmode, _type, _relaxed_embedded_ulp,          \
+                  _relaxed_policy)                                             \
     {                                                                          \
         STRINGIFY(_name), STRINGIFY(_name), { NULL }, { NULL }, { NULL },      \
             _ulp, _ulp, _half_ulp, _half_embedded_ulp, _embedded_ulp,          \
-            _relaxed_ulp, _relaxed_embedded_ulp, _rmode, RELAXED_ON, _type     \
+            _relaxed_ulp, _relaxed_embedded_ulp, _rmode, RELAXED_ON, _type,    \
+            RelaxedPolicy::_relaxed_policy                                     \
     }
 #define HALF_ENTRY(_name, _ulp, _embedded_ulp, _rmode, _type)                  \
     {                                                                          \
@@ -56,6 +58,9 @@
             _half_ulp, _half_embedded_ulp, _embedded_ulp, INFINITY, INFINITY,  \
             _rmode, RELAXED_OFF, _type                                         \
     }
+#define ENTRY_BATCH ENTRY
+#define ENTRY_EXT_BATCH ENTRY_EXT
+#define OPERATOR_ENTRY_BATCH OPERATOR_ENTRY
 
 #define unaryF NULL
 #define unaryOF NULL
@@ -77,6 +82,7 @@
 
 #define reference_copysignf NULL
 #define reference_copysign NULL
+#define reference_copysign_batch NULL
 #define reference_sqrt NULL
 #define reference_sqrtl NULL
 #define reference_reciprocal NULL
@@ -98,13 +104,15 @@
             INFINITY, INFINITY, _rmode, RELAXED_OFF, _type                     \
     }
 #define ENTRY_EXT(_name, _ulp, _embedded_ulp, _half_ulp, _half_embedded_ulp,   \
-                  _relaxed_ulp, _rmode, _type, _relaxed_embedded_ulp)          \
+                  _relaxed_ulp, _rmode, _type, _relaxed_embedded_ulp,          \
+                  _relaxed_policy)                                             \
     {                                                                          \
         STRINGIFY(_name), STRINGIFY(_name), { (void*)reference_##_name },      \
             { (void*)reference_##_name##l },                                   \
             { (void*)reference_##relaxed_##_name }, _ulp, _ulp, _half_ulp,     \
             _half_embedded_ulp, _embedded_ulp, _relaxed_ulp,                   \
-            _relaxed_embedded_ulp, _rmode, RELAXED_ON, _type                   \
+            _relaxed_embedded_ulp, _rmode, RELAXED_ON, _type,                  \
+            RelaxedPolicy::_relaxed_policy                                     \
     }
 #define HALF_ENTRY(_name, _ulp, _embedded_ulp, _rmode, _type)                  \
     {                                                                          \
@@ -122,21 +130,55 @@
             RELAXED_OFF, _type                                                 \
     }
 
+// Variants of the above for functions with a batch reference function.
+#define ENTRY_BATCH(_name, _ulp, _embedded_ulp, _half_ulp, _half_embedded_ulp, \
+                    _rmode, _type)                                             \
+    {                                                                          \
+        STRINGIFY(_name), STRINGIFY(_name), { (void*)reference_##_name },      \
+            { (void*)reference_##_name##l }, { (void*)reference_##_name },     \
+            _ulp, _ulp, _half_ulp, _half_embedded_ulp, _embedded_ulp,          \
+            INFINITY, INFINITY, _rmode, RELAXED_OFF, _type,                    \
+            RelaxedPolicy::Unchecked, { (void*)reference_##_name##_batch }     \
+    }
+#define ENTRY_EXT_BATCH(_name, _ulp, _embedded_ulp, _half_ulp,                 \
+                        _half_embedded_ulp, _relaxed_ulp, _rmode, _type,       \
+                        _relaxed_embedded_ulp, _relaxed_policy)                \
+    {                                                                          \
+        STRINGIFY(_name), STRINGIFY(_name), { (void*)reference_##_name },      \
+            { (void*)reference_##_name##l },                                   \
+            { (void*)reference_##relaxed_##_name }, _ulp, _ulp, _half_ulp,     \
+            _half_embedded_ulp, _embedded_ulp, _relaxed_ulp,                   \
+            _relaxed_embedded_ulp, _rmode, RELAXED_ON, _type,                  \
+            RelaxedPolicy::_relaxed_policy,                                    \
+            { (void*)reference_##_name##_batch }                               \
+    }
+#define OPERATOR_ENTRY_BATCH(_name, _operator, _ulp, _embedded_ulp, _half_ulp, \
+                             _half_embedded_ulp, _rmode, _type)                \
+    {                                                                          \
+        STRINGIFY(_name), _operator, { (void*)reference_##_name },             \
+            { (void*)reference_##_name##l }, { NULL }, _ulp, _ulp, _half_ulp,  \
+            _half_embedded_ulp, _embedded_ulp, INFINITY, INFINITY, _rmode,     \
+            RELAXED_OFF, _type, RelaxedPolicy::Unchecked,                      \
+            { (void*)reference_##_name##_batch }                               \
+    }
+
 static constexpr vtbl _unary = {
     "unary",
     TestFunc_Float_Float,
     TestFunc_Double_Double,
     TestFunc_Half_Half,
+    true,
 };
 
 static constexpr vtbl _unaryof = { "unaryof", TestFunc_Float_Float, NULL,
-                                   NULL };
+                                   NULL, true };
 
 static constexpr vtbl _i_unary = {
     "i_unary",
     TestFunc_Int_Float,
     TestFunc_Int_Double,
     TestFunc_Int_Half,
+    false,
 };
 
 static constexpr vtbl _unary_u = {
@@ -144,6 +186,7 @@ static constexpr vtbl _unary_u = {
     TestFunc_Float_UInt,
     TestFunc_Double_ULong,
     TestFunc_Half_UShort,
+    false,
 };
 
 static constexpr vtbl _macro_unary = {
@@ -151,6 +194,7 @@ static constexpr vtbl _macro_unary = {
     TestMacro_Int_Float,
     TestMacro_Int_Double,
     TestMacro_Int_Half,
+    true,
 };
 
 static constexpr vtbl _binary = {
@@ -158,6 +202,7 @@ static constexpr vtbl _binary = {
     TestFunc_Float_Float_Float,
     TestFunc_Double_Double_Double,
     TestFunc_Half_Half_Half,
+    true,
 };
 
 static constexpr vtbl _binary_nextafter = {
@@ -165,16 +210,18 @@ static constexpr vtbl _binary_nextafter = {
     TestFunc_Float_Float_Float,
     TestFunc_Double_Double_Double,
     TestFunc_Half_Half_Half_nextafter,
+    true,
 };
 
 static constexpr vtbl _binaryof = { "binaryof", TestFunc_Float_Float_Float,
-                                    NULL, NULL };
+                                    NULL, NULL, true };
 
 static constexpr vtbl _binary_operator = {
     "binaryOperator",
     TestFunc_Float_Float_Float_Operator,
     TestFunc_Double_Double_Double_Operator,
     TestFunc_Half_Half_Half_Operator,
+    true,
 };
 
 static constexpr vtbl _binary_operator_of = {
@@ -182,6 +229,7 @@ static constexpr vtbl _binary_operator_of = {
     TestFunc_Float_Float_Float_Operator,
     nullptr,
     nullptr,
+    true,
 };
 
 static constexpr vtbl _binary_i = {
@@ -189,6 +237,7 @@ static constexpr vtbl _binary_i = {
     TestFunc_Float_Float_Int,
     TestFunc_Double_Double_Int,
     TestFunc_Half_Half_Int,
+    true,
 };
 
 static constexpr vtbl _macro_binary = {
@@ -196,6 +245,7 @@ static constexpr vtbl _macro_binary = {
     TestMacro_Int_Float_Float,
     TestMacro_Int_Double_Double,
     TestMacro_Int_Half_Half,
+    true,
 };
 
 static constexpr vtbl _ternary = {
@@ -203,6 +253,7 @@ static constexpr vtbl _ternary = {
     TestFunc_Float_Float_Float_Float,
     TestFunc_Double_Double_Double_Double,
     TestFunc_Half_Half_Half_Half,
+    false,
 };
 
 static constexpr vtbl _unary_two_results = {
@@ -210,6 +261,7 @@ static constexpr vtbl _unary_two_results = {
     TestFunc_Float2_Float,
     TestFunc_Double2_Double,
     TestFunc_Half2_Half,
+    false,
 };
 
 static constexpr vtbl _unary_two_results_i = {
@@ -217,6 +269,7 @@ static constexpr vtbl _unary_two_results_i = {
     TestFunc_FloatI_Float,
     TestFunc_DoubleI_Double,
     TestFunc_HalfI_Half,
+    false,
 };
 
 static constexpr vtbl _binary_two_results_i = {
@@ -224,6 +277,7 @@ static constexpr vtbl _binary_two_results_i = {
     TestFunc_FloatI_Float_Float,
     TestFunc_DoubleI_Double_Double,
     TestFunc_HalfI_Half_Half,
+    false,
 };
 
 static constexpr vtbl _mad_tbl = {
@@ -231,6 +285,7 @@ static constexpr vtbl _mad_tbl = {
     TestFunc_mad_Float,
     TestFunc_mad_Double,
     TestFunc_mad_Half,
+    false,
 };
 
 #define unaryF &_unary
@@ -255,13 +310,13 @@ static constexpr vtbl _mad_tbl = {
 
 // clang-format off
 const Func functionList[] = {
-    ENTRY_EXT(acos, 4.0f, 4.0f, 2.0f, 3.0f, 4096.0f, FTZ_OFF, unaryF, 4096.0f),
+    ENTRY_EXT(acos, 4.0f, 4.0f, 2.0f, 3.0f, 4096.0f, FTZ_OFF, unaryF, 4096.0f, Unchecked),
     ENTRY(acosh, 4.0f, 4.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(acospi, 5.0f, 5.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
-    ENTRY_EXT(asin, 4.0f, 4.0f, 2.0f, 3.0f, 4096.0f, FTZ_OFF, unaryF, 4096.0f),
+    ENTRY_EXT(asin, 4.0f, 4.0f, 2.0f, 3.0f, 4096.0f, FTZ_OFF, unaryF, 4096.0f, Unchecked),
     ENTRY(asinh, 4.0f, 4.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(asinpi, 5.0f, 5.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
-    ENTRY_EXT(atan, 5.0f, 5.0f, 2.0f, 3.0f, 4096.0f, FTZ_OFF, unaryF, 4096.0f),
+    ENTRY_EXT(atan, 5.0f, 5.0f, 2.0f, 3.0f, 4096.0f, FTZ_OFF, unaryF, 4096.0f, Unchecked),
     ENTRY(atanh, 5.0f, 5.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(atanpi, 5.0f, 5.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(atan2, 6.0f, 6.0f, 2.0f, 3.0f, FTZ_OFF, binaryF),
@@ -282,64 +337,66 @@ const Func functionList[] = {
       INFINITY,
       FTZ_OFF,
       RELAXED_OFF,
-      binaryF },
+      binaryF,
+      RelaxedPolicy::Unchecked,
+      { (void*)reference_copysign_batch } },
     ENTRY_EXT(cos, 4.0f, 4.0f, 2.0f, 2.0f, 0.00048828125f, FTZ_OFF, unaryF,
-              0.00048828125f), // relaxed ulp 2^-11
+              0.00048828125f, SinCos), // relaxed ulp 2^-11
     ENTRY(cosh, 4.0f, 4.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY_EXT(cospi, 4.0f, 4.0f, 2.0f, 2.0f, 0.00048828125f, FTZ_OFF, unaryF,
-              0.00048828125f), // relaxed ulp 2^-11
+              0.00048828125f, SinCosPi), // relaxed ulp 2^-11
     ENTRY(erfc, 16.0f, 16.0f, 4.0f, 4.0f, FTZ_OFF, unaryF),
     ENTRY(erf,  16.0f, 16.0f, 4.0f, 4.0f, FTZ_OFF, unaryF),
 
     // floor(fabs(2*x)) is added to the relaxed error in unary.c
-    ENTRY_EXT(exp, 3.0f, 4.0f, 2.0f, 3.0f, 3.0f, FTZ_OFF, unaryF, 4.0f),
+    ENTRY_EXT(exp, 3.0f, 4.0f, 2.0f, 3.0f, 3.0f, FTZ_OFF, unaryF, 4.0f, Exp),
 
     // floor(fabs(2*x)) is added to the relaxed error in unary.c
-    ENTRY_EXT(exp2, 3.0f, 4.0f, 2.0f, 3.0f, 3.0f, FTZ_OFF, unaryF, 4.0f),
+    ENTRY_EXT(exp2, 3.0f, 4.0f, 2.0f, 3.0f, 3.0f, FTZ_OFF, unaryF, 4.0f, Exp),
 
     // in non-derived mode it uses the ulp error for half_exp10.
-    ENTRY_EXT(exp10, 3.0f, 4.0f, 2.0f, 3.0f, 8192.0f, FTZ_OFF, unaryF, 8192.0f),
+    ENTRY_EXT(exp10, 3.0f, 4.0f, 2.0f, 3.0f, 8192.0f, FTZ_OFF, unaryF, 8192.0f, Derived),
 
     ENTRY(expm1, 3.0f, 4.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
-    ENTRY(fabs, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
+    ENTRY_BATCH(fabs, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
     ENTRY(fdim, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
     ENTRY(floor, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
     ENTRY(fma, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, ternaryF),
-    ENTRY(fmax, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
-    ENTRY(fmin, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
+    ENTRY_BATCH(fmax, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
+    ENTRY_BATCH(fmin, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
     ENTRY(fmod, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
     ENTRY(fract, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF_two_results),
     ENTRY(frexp, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF_two_results_i),
     ENTRY(hypot, 4.0f, 4.0f,  2.0f, 3.0f, FTZ_OFF, binaryF),
     ENTRY(ilogb, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, i_unaryF),
-    ENTRY(isequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
     ENTRY(isfinite, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_unaryF),
-    ENTRY(isgreater, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
-    ENTRY(isgreaterequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isgreater, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isgreaterequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
     ENTRY(isinf, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_unaryF),
-    ENTRY(isless, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
-    ENTRY(islessequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
-    ENTRY(islessgreater, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isless, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(islessequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(islessgreater, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
     ENTRY(isnan, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_unaryF),
     ENTRY(isnormal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_unaryF),
-    ENTRY(isnotequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
-    ENTRY(isordered, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
-    ENTRY(isunordered, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isnotequal, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isordered, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
+    ENTRY_BATCH(isunordered, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_binaryF),
     ENTRY(ldexp, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF_i),
     ENTRY(lgamma, INFINITY, INFINITY, INFINITY, INFINITY, FTZ_OFF, unaryF),
     ENTRY(lgamma_r, INFINITY, INFINITY, INFINITY, INFINITY, FTZ_OFF,
           unaryF_two_results_i),
     ENTRY_EXT(log, 3.0f, 4.0f, 2.0f, 3.0f, 4.76837158203125e-7f, FTZ_OFF, unaryF,
-              4.76837158203125e-7f), // relaxed ulp 2^-21
+              4.76837158203125e-7f, Log), // relaxed ulp 2^-21
     ENTRY_EXT(log2, 3.0f, 4.0f, 2.0f, 3.0f, 4.76837158203125e-7f, FTZ_OFF, unaryF,
-              4.76837158203125e-7f), // relaxed ulp 2^-21
+              4.76837158203125e-7f, Log), // relaxed ulp 2^-21
     ENTRY_EXT(log10, 3.0f, 4.0f, 2.0f, 3.0f, 4.76837158203125e-7f, FTZ_OFF, unaryF,
-              4.76837158203125e-7f), // relaxed ulp 2^-21
+              4.76837158203125e-7f, Log), // relaxed ulp 2^-21
     ENTRY(log1p, 2.0f, 4.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(logb, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
 
     // In fast-relaxed-math mode it has to be either exactly rounded fma or exactly rounded a*b+c
-    ENTRY_EXT(mad, INFINITY, INFINITY, INFINITY, INFINITY, INFINITY, FTZ_OFF, mad_function, INFINITY),
+    ENTRY_EXT_BATCH(mad, INFINITY, INFINITY, INFINITY, INFINITY, INFINITY, FTZ_OFF, mad_function, INFINITY, Unchecked),
 
     ENTRY(maxmag, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
     ENTRY(minmag, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
@@ -349,25 +406,25 @@ const Func functionList[] = {
 
     // In derived mode the ulp error is calculated as exp2(y*log2(x)).
     // In non-derived it is the same as half_pow.
-    ENTRY_EXT(pow, 16.0f, 16.0f, 4.0f, 5.0f, 8192.0f, FTZ_OFF, binaryF, 8192.0f),
+    ENTRY_EXT(pow, 16.0f, 16.0f, 4.0f, 5.0f, 8192.0f, FTZ_OFF, binaryF, 8192.0f, Derived),
 
     ENTRY(pown, 16.0f, 16.0f, 4.0f, 5.0f, FTZ_OFF, binaryF_i),
     ENTRY(powr, 16.0f, 16.0f, 4.0f, 5.0f, FTZ_OFF, binaryF),
     ENTRY(remainder, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF),
     ENTRY(remquo, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryF_two_results_i),
-    ENTRY(rint, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
+    ENTRY_BATCH(rint, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
     ENTRY(rootn, 16.0f, 16.0f, 4.0f, 5.0f, FTZ_OFF, binaryF_i),
-    ENTRY(round, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
+    ENTRY_BATCH(round, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
     ENTRY(rsqrt, 2.0f, 4.0f, 1.0f, 1.0f, FTZ_OFF, unaryF),
     ENTRY(signbit, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_unaryF),
     ENTRY_EXT(sin, 4.0f, 4.0f, 2.0f, 2.0f, 0.00048828125f, FTZ_OFF, unaryF,
-              0.00048828125f), // relaxed ulp 2^-11
+              0.00048828125f, SinCos), // relaxed ulp 2^-11
     ENTRY_EXT(sincos, 4.0f, 4.0f, 2.0f, 2.0f, 0.00048828125f, FTZ_OFF,
               unaryF_two_results,
-              0.00048828125f), // relaxed ulp 2^-11
+              0.00048828125f, SinCos), // relaxed ulp 2^-11
     ENTRY(sinh, 4.0f, 4.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY_EXT(sinpi, 4.0f, 4.0f, 2.0f, 2.0f, 0.00048828125f, FTZ_OFF, unaryF,
-              0.00048828125f), // relaxed ulp 2^-11
+              0.00048828125f, SinCosPi), // relaxed ulp 2^-11
     { "sqrt",
       "sqrt",
       { (void*)reference_sqrt },
@@ -401,12 +458,12 @@ const Func functionList[] = {
 
     // In derived mode it the ulp error is calculated as sin/cos.
     // In non-derived mode it is the same as half_tan.
-    ENTRY_EXT(tan, 5.0f, 5.0f, 2.5f, 3.0f, 8192.0f, FTZ_OFF, unaryF, 8192.0f),
+    ENTRY_EXT(tan, 5.0f, 5.0f, 2.5f, 3.0f, 8192.0f, FTZ_OFF, unaryF, 8192.0f, Derived),
 
     ENTRY(tanh, 5.0f, 5.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(tanpi, 6.0f, 6.0f, 2.0f, 3.0f, FTZ_OFF, unaryF),
     ENTRY(tgamma, 16.0f, 16.0f, 4.f, 4.f, FTZ_OFF, unaryF),
-    ENTRY(trunc, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
+    ENTRY_BATCH(trunc, 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryF),
 
     HALF_ENTRY(cos, 8192.0f, 8192.0f, FTZ_ON, unaryOF),
     HALF_ENTRY(divide, 8192.0f, 8192.0f, FTZ_ON, binaryOF),
@@ -424,7 +481,7 @@ const Func functionList[] = {
     HALF_ENTRY(tan, 8192.0f, 8192.0f, FTZ_ON, unaryOF),
 
     // basic operations
-    OPERATOR_ENTRY(add, "+", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryOperatorF),
+    OPERATOR_ENTRY_BATCH(add, "+", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryOperatorF),
     OPERATOR_ENTRY(subtract, "-", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryOperatorF),
     OPERATOR_ENTRY(negation, "-", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, unaryOF),
     { "reciprocal",
@@ -441,7 +498,8 @@ const Func functionList[] = {
       INFINITY,
       FTZ_OFF,
       RELAXED_ON,
-      unaryF},
+      unaryF,
+      RelaxedPolicy::Reciprocal },
     { "divide",
       "/",
       { (void*)reference_divide },
@@ -456,7 +514,8 @@ const Func functionList[] = {
       INFINITY,
       FTZ_OFF,
       RELAXED_ON,
-      binaryOperatorF },
+      binaryOperatorF,
+      RelaxedPolicy::Divide },
     { "divide_cr",
       "/",
       { (void*)reference_divide },
@@ -472,7 +531,7 @@ const Func functionList[] = {
       FTZ_OFF,
       RELAXED_OFF,
       binaryOperatorOF /* only for single precision */ },
-    OPERATOR_ENTRY(multiply, "*", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryOperatorF),
+    OPERATOR_ENTRY_BATCH(multiply, "*", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, binaryOperatorF),
     OPERATOR_ENTRY(assignment, "", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF,
                    unaryF), // A simple copy operation
     OPERATOR_ENTRY(not, "!", 0.0f, 0.0f, 0.0f, 0.0f, FTZ_OFF, macro_unaryF),
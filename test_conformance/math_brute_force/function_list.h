@@ -62,6 +62,42 @@ union dptr {
     long double (*f_fff)(long double, long double, long double);
 };
 
+// Batch versions of the float reference functions, computing the reference
+// results for n inputs at once.  The test loops use them instead of calling
+// func for each element when they are available.
+union bptr {
+    void *p;
+    void (*f_f)(const float *, float *, size_t);
+    void (*f_ff)(const float *, const float *, float *, size_t);
+    void (*i_ff)(const float *, const float *, cl_int *, size_t);
+    void (*f_fff)(const float *, const float *, const float *, float *,
+                  size_t);
+};
+
+// Special cases of relaxed math (-cl-fast-relaxed-math) testing.  The test
+// loops are instantiated for each policy they handle, so that no per function
+// dispatch remains in the per element code.
+enum class RelaxedPolicy
+{
+    // Any finite result is accepted.
+    Unchecked,
+    // sin, cos, sincos: inputs limited to [-pi, pi], absolute error.
+    SinCos,
+    // sinpi, cospi: absolute error for inputs in [-1, 1].
+    SinCosPi,
+    // reciprocal: inputs limited to [2^-126, 2^126], ulp error.
+    Reciprocal,
+    // divide: inputs limited to [2^-62, 2^62].
+    Divide,
+    // exp, exp2: ulp error increased by floor(fabs(2 * x)).
+    Exp,
+    // tan, exp10, pow: ulp error, unless derived implementations are tested.
+    Derived,
+    // log, log2, log10: absolute error for inputs in [0.5, 2], ulp error
+    // otherwise.
+    Log,
+};
+
 struct Func;
 
 struct vtbl
@@ -74,6 +110,7 @@ struct vtbl
     int (*HalfTestFunc)(
         const struct Func *, MTdata,
         bool); // may be NULL if function is single precision only
+    bool sharded; // whether the jobs of TestFunc honour --shard and --checkpoint
 };
 
 struct Func
@@ -94,8 +131,18 @@ struct Func
     int ftz;
     int relaxed;
     const vtbl *vtbl_ptr;
+    RelaxedPolicy relaxed_policy = RelaxedPolicy::Unchecked;
+    bptr bfunc = { NULL }; // may be NULL, batch version of func
 };
 
+// Batch reference function to use for f, or NULL.  The relaxed mode reference
+// functions that differ from func have no batch version.
+inline bptr GetBatchReference(const Func *f, bool relaxedMode)
+{
+    if (relaxedMode && f->rfunc.p != f->func.p) return bptr{ NULL };
+    return f->bfunc;
+}
+
 
 extern const Func functionList[];
 
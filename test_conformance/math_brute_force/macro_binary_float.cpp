@@ -58,7 +58,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     fptr func = job->f->func;
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_int error;
     const char *name = job->f->name;
     cl_int *t = 0;
@@ -66,6 +66,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_float *s = 0;
     cl_float *s2 = 0;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     cl_event e[VECTOR_SIZE_COUNT];
     cl_int *out[VECTOR_SIZE_COUNT];
     if (gHostFill)
@@ -218,7 +220,12 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     r = (cl_int *)gOut_Ref + thread_id * buffer_elements;
     s = (float *)gIn + thread_id * buffer_elements;
     s2 = (float *)gIn2 + thread_id * buffer_elements;
-    for (size_t j = 0; j < buffer_elements; j++) r[j] = func.i_ff(s[j], s2[j]);
+    bptr bfunc = job->f->bfunc;
+    if (bfunc.p)
+        bfunc.i_ff(s, s2, r, buffer_elements);
+    else
+        for (size_t j = 0; j < buffer_elements; j++)
+            r[j] = func.i_ff(s[j], s2[j]);
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
@@ -344,6 +351,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -446,6 +455,8 @@ int TestMacro_Int_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "float", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
@@ -57,13 +57,15 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     ThreadInfoBinary *tinfo = &(job->tinfo[thread_id]);
     fptr func = job->f->func;
     int ftz = job->ftz;
-    MTdata d = tinfo->d;
+    MTdata d = SeedJob(*job, base, tinfo->d);
     cl_uint j, k;
     cl_int error;
     const char *name = job->f->name;
     cl_short *t, *r;
     std::vector<float> s(0), s2(0);
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     // start the map of the output arrays
     cl_event e[VECTOR_SIZE_COUNT];
     cl_short *out[VECTOR_SIZE_COUNT];
@@ -353,6 +355,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    if (error == CL_SUCCESS) MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -456,6 +460,8 @@ int TestMacro_Int_Half_Half(const Func *f, MTdata d, bool relaxedMode)
         test_info.tinfo[i].d = MTdataHolder(genrand_int32(d));
     }
 
+    InitJobs(test_info, "half", test_info.threadCount);
+
     // Init the kernels
     {
         BuildKernelInfo build_info = { test_info.threadCount, test_info.k,
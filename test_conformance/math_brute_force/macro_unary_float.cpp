@@ -61,6 +61,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_int error = CL_SUCCESS;
     const char *name = job->f->name;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     int signbit_test = 0;
     if (!strcmp(name, "signbit")) signbit_test = 1;
 
@@ -264,6 +266,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -354,6 +358,8 @@ int TestMacro_Int_Float(const Func *f, MTdata d, bool relaxedMode)
         }
     }
 
+    InitJobs(test_info, "float", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
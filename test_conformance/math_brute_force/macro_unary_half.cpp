@@ -62,6 +62,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     const char *name = job->f->name;
     std::vector<float> s(0);
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     int signbit_test = 0;
     if (!strcmp(name, "signbit")) signbit_test = 1;
 
@@ -276,6 +278,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
+    if (error == CL_SUCCESS) MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -367,6 +371,8 @@ int TestMacro_Int_Half(const Func *f, MTdata d, bool relaxedMode)
         }
     }
 
+    InitJobs(test_info, "half", test_info.threadCount);
+
     // Init the kernels
     {
         BuildKernelInfo build_info = { test_info.threadCount, test_info.k,
@@ -162,8 +162,11 @@ int TestFunc_mad_Float(const Func *f, MTdata d, bool relaxedMode)
         float *s = (float *)gIn;
         float *s2 = (float *)gIn2;
         float *s3 = (float *)gIn3;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-            r[j] = (float)f->func.f_fff(s[j], s2[j], s3[j]);
+        if (f->bfunc.p)
+            f->bfunc.f_fff(s, s2, s3, r, BUFFER_SIZE / sizeof(float));
+        else
+            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+                r[j] = (float)f->func.f_fff(s[j], s2[j], s3[j]);
 
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
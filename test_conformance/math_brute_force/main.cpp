@@ -14,11 +14,16 @@
 // limitations under the License.
 //
 
+#include "checkpoint.h"
+#include "common.h"
 #include "function_list.h"
+#include "reference_cache.h"
 #include "sleep.h"
+#include "timing.h"
 #include "utility.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
@@ -63,8 +68,10 @@ static size_t gEndTestNumber = ~0u;
 int gSkipCorrectnessTesting = 0;
 static int gStopOnError = 0;
 static bool gSkipRestOfTests;
+static bool gBenchmarkVerify = false;
 int gForceFTZ = 0;
 int gHostFill = 0;
+cl_uint gPipelineDepth = 1;
 int gHasDouble = 0;
 int gTestFloat = 1;
 // This flag should be 'ON' by default and it can be changed through the command
@@ -117,6 +124,21 @@ static int IsTininessDetectedBeforeRounding(void);
 static int
 IsInRTZMode(void); // expensive. Please check gIsInRTZMode global instead.
 
+// Run the test of f on a type, and add it to the timing report with its
+// duration if its driver doesn't record its own timing.
+static int RunTest(int (*test)(const Func *, MTdata, bool), const Func *f,
+                   const char *typeName, bool relaxedMode)
+{
+    size_t timingRecords = TimingRecordCount();
+    auto start = std::chrono::steady_clock::now();
+    int error = test(f, gMTdata, relaxedMode);
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+    RecordUntimedTest(f, typeName, relaxedMode, timingRecords, seconds.count(),
+                      error == 0);
+    return error;
+}
+
 static int doTest(const char *name)
 {
     if (gSkipRestOfTests)
@@ -158,6 +180,13 @@ static int doTest(const char *name)
         return 0;
     }
 
+    if (!func_data->vtbl_ptr->sharded && gShardIndex != 0)
+    {
+        vlog("'%s' runs in shard 0 only, skipping function.\n",
+             func_data->name);
+        return 0;
+    }
+
     // if correctly rounded divide & sqrt are supported by the implementation
     // then test it; otherwise skip the test
     if (strcmp(func_data->name, "sqrt_cr") == 0
@@ -183,8 +212,8 @@ static int doTest(const char *name)
                 gTestCount++;
                 vlog("%3d: ", gTestCount);
                 // Test with relaxed requirements here.
-                if (func_data->vtbl_ptr->TestFunc(func_data, gMTdata,
-                                                  true /* relaxed mode */))
+                if (RunTest(func_data->vtbl_ptr->TestFunc, func_data, "float",
+                            true /* relaxed mode */))
                 {
                     gFailCount++;
                     error++;
@@ -207,8 +236,8 @@ static int doTest(const char *name)
             gTestCount++;
             vlog("%3d: ", gTestCount);
             // Don't test with relaxed requirements.
-            if (func_data->vtbl_ptr->TestFunc(func_data, gMTdata,
-                                              false /* relaxed mode */))
+            if (RunTest(func_data->vtbl_ptr->TestFunc, func_data, "float",
+                        false /* relaxed mode */))
             {
                 gFailCount++;
                 error++;
@@ -226,8 +255,8 @@ static int doTest(const char *name)
             gTestCount++;
             vlog("%3d: ", gTestCount);
             // Don't test with relaxed requirements.
-            if (func_data->vtbl_ptr->DoubleTestFunc(func_data, gMTdata,
-                                                    false /* relaxed mode*/))
+            if (RunTest(func_data->vtbl_ptr->DoubleTestFunc, func_data,
+                        "double", false /* relaxed mode*/))
             {
                 gFailCount++;
                 error++;
@@ -243,8 +272,8 @@ static int doTest(const char *name)
         {
             gTestCount++;
             vlog("%3d: ", gTestCount);
-            if (func_data->vtbl_ptr->HalfTestFunc(func_data, gMTdata,
-                                                  false /* relaxed mode*/))
+            if (RunTest(func_data->vtbl_ptr->HalfTestFunc, func_data, "half",
+                        false /* relaxed mode*/))
             {
                 gFailCount++;
                 error++;
@@ -411,6 +440,18 @@ static test_status ParseArgs(int &argc, const char *argv[],
         -z     Toggle FTZ mode (Section 6.5.3) for all functions. (Set by device capabilities by default.)
         -v     Toggle Verbosity (Default: off)
         -#     Test only vector sizes #, e.g. "-1" tests scalar only, "-16" tests 16-wide vectors only.
+        --reference-cache <dir>
+               Cache reference results of exhaustive unary float tests in <dir>. (Default: off)
+        --pipeline-depth <n>
+               Number of jobs each worker thread keeps in flight, a power of two up to 16. (Default: 1)
+        --shard <i>/<n>
+               Run only shard <i> of <n> of the inputs of each function, for <i> from 0 to <n>-1. Functions whose inputs can't be split run in shard 0. (Default: 0/1)
+        --checkpoint <dir>
+               Record the progress of each function in <dir>, and resume from it when restarted with the same options. (Default: off)
+        --timing-report <file>
+               Write the time spent in each phase of the float unary, binary, ternary and two result functions to <file>, and the duration of the other tests, as CSV if it ends in .csv and JSON otherwise. -v logs a summary. (Default: off)
+        --benchmark-verify
+               Time the comparison of results of the selected vector sizes against the reference on host buffers and exit, without testing.
 
         You may also pass a number instead of a function name.
         This causes the first N tests to be skipped. The tests are numbered.
@@ -431,6 +472,86 @@ static test_status ParseArgs(int &argc, const char *argv[],
         vlog("\t%s", arg);
         int optionFound = 0;
         removed_args.push_back(argv[i]);
+        if (strcmp(arg, "--reference-cache") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1] == NULL)
+            {
+                vlog_error("\nMissing value for '%s' argument.\n", arg);
+                return TEST_FAIL;
+            }
+            gReferenceCachePath = argv[++i];
+            vlog(" %s", argv[i]);
+            removed_args.back() += std::string(" ") + argv[i];
+            continue;
+        }
+        if (strcmp(arg, "--pipeline-depth") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1] == NULL)
+            {
+                vlog_error("\nMissing value for '%s' argument.\n", arg);
+                return TEST_FAIL;
+            }
+            long depth = strtol(argv[++i], NULL, 0);
+            if (depth < 1 || depth > 16 || (depth & (depth - 1)))
+            {
+                vlog_error("\nInvalid pipeline depth '%s'.\n", argv[i]);
+                return TEST_FAIL;
+            }
+            gPipelineDepth = (cl_uint)depth;
+            vlog(" %s", argv[i]);
+            removed_args.back() += std::string(" ") + argv[i];
+            continue;
+        }
+        if (strcmp(arg, "--shard") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1] == NULL)
+            {
+                vlog_error("\nMissing value for '%s' argument.\n", arg);
+                return TEST_FAIL;
+            }
+            unsigned index, count;
+            char end;
+            if (sscanf(argv[++i], "%u/%u%c", &index, &count, &end) != 2
+                || index >= count)
+            {
+                vlog_error("\nInvalid shard '%s'.\n", argv[i]);
+                return TEST_FAIL;
+            }
+            gShardIndex = index;
+            gShardCount = count;
+            vlog(" %s", argv[i]);
+            removed_args.back() += std::string(" ") + argv[i];
+            continue;
+        }
+        if (strcmp(arg, "--checkpoint") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1] == NULL)
+            {
+                vlog_error("\nMissing value for '%s' argument.\n", arg);
+                return TEST_FAIL;
+            }
+            gCheckpointPath = argv[++i];
+            vlog(" %s", argv[i]);
+            removed_args.back() += std::string(" ") + argv[i];
+            continue;
+        }
+        if (strcmp(arg, "--timing-report") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1] == NULL)
+            {
+                vlog_error("\nMissing value for '%s' argument.\n", arg);
+                return TEST_FAIL;
+            }
+            gTimingReportPath = argv[++i];
+            vlog(" %s", argv[i]);
+            removed_args.back() += std::string(" ") + argv[i];
+            continue;
+        }
+        if (strcmp(arg, "--benchmark-verify") == 0)
+        {
+            gBenchmarkVerify = true;
+            continue;
+        }
         if (arg[0] == '-')
         {
             while (arg[1] != '\0')
@@ -520,6 +641,13 @@ static test_status ParseArgs(int &argc, const char *argv[],
     }
     update_argc_argv_from_args_list(argList, argc, argv);
 
+    // The benchmark runs on host buffers only, so it needs no device.
+    if (gBenchmarkVerify)
+    {
+        vlog("\n");
+        exit(BenchmarkVerify());
+    }
+
     PrintArch();
 
     if (gWimpyMode)
@@ -0,0 +1,242 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "reference_cache.h"
+#include "utility.h"
+
+#include "harness/crc32.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::string gReferenceCachePath;
+
+namespace {
+
+// Bump whenever the layout or the way results are produced changes.
+constexpr uint32_t kCacheVersion = 1;
+constexpr char kCacheMagic[8] = "CLREFC";
+constexpr uint64_t kInputCount = 1ULL << 32;
+constexpr uint64_t kChunkCount = kInputCount / ReferenceCache::kChunkElements;
+constexpr size_t kHeaderSize = 4096;
+
+struct CacheHeader
+{
+    char magic[sizeof(kCacheMagic)];
+    uint32_t version;
+    uint32_t elementSize;
+    uint32_t chunkElements;
+    uint32_t fingerprint;
+    char key[128];
+};
+
+// File layout: header, one valid byte per chunk, one CRC per chunk, results.
+constexpr uint64_t kValidOffset = kHeaderSize;
+constexpr uint64_t kCRCOffset = kValidOffset + kChunkCount;
+constexpr uint64_t kDataOffset = kCRCOffset + kChunkCount * sizeof(uint32_t);
+
+} // anonymous namespace
+
+std::unique_ptr<ReferenceCache>
+ReferenceCache::Open(const std::string &key, uint32_t fingerprint,
+                     size_t elementSize)
+{
+    if (gReferenceCachePath.empty()) return nullptr;
+
+    if (sizeof(void *) < 8)
+    {
+        vlog("Reference cache requires a 64-bit host, not caching %s.\n",
+             key.c_str());
+        return nullptr;
+    }
+
+    CacheHeader expected{};
+    memcpy(expected.magic, kCacheMagic, sizeof(kCacheMagic));
+    expected.version = kCacheVersion;
+    expected.elementSize = (uint32_t)elementSize;
+    expected.chunkElements = (uint32_t)kChunkElements;
+    expected.fingerprint = fingerprint;
+    strncpy(expected.key, key.c_str(), sizeof(expected.key) - 1);
+
+    std::string fileName = gReferenceCachePath + "/" + key + ".refcache";
+    uint64_t fileSize = kDataOffset + kInputCount * elementSize;
+
+    std::unique_ptr<ReferenceCache> cache(new ReferenceCache);
+    cache->elementSize = elementSize;
+    cache->mapSize = (size_t)fileSize;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        vlog_error("Unable to open reference cache %s (%lu).\n",
+                   fileName.c_str(), GetLastError());
+        return nullptr;
+    }
+    cache->fileHandle = file;
+
+    HANDLE mapping =
+        CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)(fileSize >> 32),
+                           (DWORD)(fileSize & 0xffffffff), NULL);
+    if (mapping == NULL)
+    {
+        vlog_error("Unable to map reference cache %s (%lu).\n",
+                   fileName.c_str(), GetLastError());
+        return nullptr;
+    }
+    cache->mappingHandle = mapping;
+
+    cache->map = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (cache->map == NULL)
+    {
+        vlog_error("Unable to map reference cache %s (%lu).\n",
+                   fileName.c_str(), GetLastError());
+        return nullptr;
+    }
+#else
+    // Shards running as separate processes share the file, and may already
+    // have it mapped, so a file of the wrong size is never resized in place,
+    // which would make their mapped pages past the new end fault.  A file of
+    // the right size is created under a name of this process instead, zeroed
+    // i.e. with no valid chunks, and renamed over it.  Processes that mapped
+    // the old file keep using it.
+    for (int attempt = 0;; attempt++)
+    {
+        cache->fd = open(fileName.c_str(), O_RDWR);
+        struct stat st;
+        if (cache->fd >= 0 && fstat(cache->fd, &st) == 0
+            && (uint64_t)st.st_size == fileSize)
+            break;
+        if (cache->fd >= 0) close(cache->fd);
+        cache->fd = -1;
+        if (attempt > 0)
+        {
+            vlog_error("Unable to open reference cache %s (%s).\n",
+                       fileName.c_str(), strerror(errno));
+            return nullptr;
+        }
+
+        std::string tempName =
+            fileName + "." + std::to_string((long)getpid()) + ".tmp";
+        int fd = open(tempName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        bool ok = fd >= 0 && ftruncate(fd, (off_t)fileSize) == 0;
+        if (fd >= 0) ok = close(fd) == 0 && ok;
+        if (!ok || rename(tempName.c_str(), fileName.c_str()) != 0)
+        {
+            vlog_error("Unable to create reference cache %s (%s).\n",
+                       fileName.c_str(), strerror(errno));
+            remove(tempName.c_str());
+            return nullptr;
+        }
+    }
+
+    void *map = mmap(NULL, cache->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     cache->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        vlog_error("Unable to map reference cache %s (%s).\n",
+                   fileName.c_str(), strerror(errno));
+        return nullptr;
+    }
+    cache->map = map;
+#endif
+
+    uint8_t *base = (uint8_t *)cache->map;
+    cache->chunkValid = base + kValidOffset;
+    cache->chunkCRC = (uint32_t *)(base + kCRCOffset);
+    cache->data = base + kDataOffset;
+
+    if (memcmp(base, &expected, sizeof(expected)) != 0)
+    {
+        // Stale or new cache, drop everything it holds.
+        if (gVerboseBruteForce)
+            vlog("Rebuilding reference cache %s.\n", fileName.c_str());
+        memset((void *)cache->chunkValid, 0, kChunkCount);
+        memcpy(base, &expected, sizeof(expected));
+    }
+
+    return cache;
+}
+
+ReferenceCache::~ReferenceCache()
+{
+#if defined(_WIN32)
+    if (map) UnmapViewOfFile(map);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+#else
+    if (map) munmap(map, mapSize);
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool ReferenceCache::Read(uint32_t base, size_t count, void *out) const
+{
+    if (base % kChunkElements || count % kChunkElements) return false;
+
+    size_t chunkSize = kChunkElements * elementSize;
+    uint64_t first = base / kChunkElements;
+    uint64_t last = first + count / kChunkElements;
+    if (last > kChunkCount) return false;
+
+    uint8_t *dst = (uint8_t *)out;
+    for (uint64_t chunk = first; chunk < last; chunk++, dst += chunkSize)
+    {
+        if (!chunkValid[chunk]) return false;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        memcpy(dst, data + chunk * chunkSize, chunkSize);
+        if (crc32(dst, chunkSize) != chunkCRC[chunk]) return false;
+    }
+
+    return true;
+}
+
+void ReferenceCache::Write(uint32_t base, size_t count, const void *in)
+{
+    if (base % kChunkElements || count % kChunkElements) return;
+
+    size_t chunkSize = kChunkElements * elementSize;
+    uint64_t first = base / kChunkElements;
+    uint64_t last = first + count / kChunkElements;
+    if (last > kChunkCount) return;
+
+    const uint8_t *src = (const uint8_t *)in;
+    for (uint64_t chunk = first; chunk < last; chunk++, src += chunkSize)
+    {
+        chunkValid[chunk] = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+
+        memcpy(data + chunk * chunkSize, src, chunkSize);
+        chunkCRC[chunk] = crc32(src, chunkSize);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        chunkValid[chunk] = 1;
+    }
+}
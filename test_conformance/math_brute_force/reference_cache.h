@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef REFERENCE_CACHE_H
+#define REFERENCE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Directory holding the reference result caches, empty if caching is disabled.
+extern std::string gReferenceCachePath;
+
+// On-disk cache of the reference results of an exhaustive 32-bit input sweep.
+// The results are stored in a memory-mapped file indexed by the input's bit
+// pattern and split into fixed size chunks, each with its own CRC so that
+// partially written or corrupted chunks are detected and recomputed.
+//
+// The cache file is keyed by a caller provided name and by a fingerprint of
+// the reference library.  If either doesn't match, all chunks are invalidated
+// and the cache is rebuilt as tests run.
+class ReferenceCache {
+public:
+    // Number of results per chunk.
+    static constexpr size_t kChunkElements = 1024;
+
+    ~ReferenceCache();
+
+    // Open or create the cache for key in gReferenceCachePath.  Returns NULL if
+    // caching is disabled or the file could not be mapped.
+    static std::unique_ptr<ReferenceCache>
+    Open(const std::string &key, uint32_t fingerprint, size_t elementSize);
+
+    // Copy the results for inputs [base, base + count) to out.  Returns false
+    // if any of them is missing or fails validation.  base and count must be
+    // multiples of kChunkElements.
+    bool Read(uint32_t base, size_t count, void *out) const;
+
+    // Store the results for inputs [base, base + count).  Ranges that don't
+    // cover whole chunks are ignored.
+    void Write(uint32_t base, size_t count, const void *in);
+
+private:
+    ReferenceCache() = default;
+    ReferenceCache(const ReferenceCache &) = delete;
+    ReferenceCache &operator=(const ReferenceCache &) = delete;
+
+    void *map = nullptr;
+    size_t mapSize = 0;
+    size_t elementSize = 0;
+#if defined(_WIN32)
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    volatile uint8_t *chunkValid = nullptr;
+    uint32_t *chunkCRC = nullptr;
+    uint8_t *data = nullptr;
+};
+
+#endif /* REFERENCE_CACHE_H */
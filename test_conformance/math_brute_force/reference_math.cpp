@@ -6116,3 +6116,236 @@ long double reference_tgammal(long double x)
     }
     return olm_tgammal(x);
 }
+
+// -- batch versions for testing float --
+//
+// The functions below compute a whole buffer of float reference results at
+// once.  They return the same results as the scalar versions with the result
+// converted to float, except maybe for the payload of NaNs, and are written so
+// that the compiler can vectorize the loops.
+
+// Whether float expressions are evaluated in float, as opposed to the extended
+// precision of x87.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define FLOAT_EVAL_IN_FLOAT 1
+#else
+#define FLOAT_EVAL_IN_FLOAT 0
+#endif
+
+static inline cl_uint batch_as_uint(float x)
+{
+    int32f_t u;
+    u.f = x;
+    return (cl_uint)u.i;
+}
+
+static inline float batch_as_float(cl_uint x)
+{
+    int32f_t u;
+    u.i = (int32_t)x;
+    return u.f;
+}
+
+// Branch free select of a or b, so that the loops below have no control flow
+// that may keep the compiler from vectorizing them.
+static inline cl_uint batch_select(bool condition, cl_uint a, cl_uint b)
+{
+    cl_uint mask = 0U - (cl_uint)condition;
+    return (a & mask) | (b & ~mask);
+}
+
+void reference_fabs_batch(const float *x, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = batch_as_float(batch_as_uint(x[i]) & 0x7fffffffU);
+}
+
+void reference_copysign_batch(const float *x, const float *y, float *out,
+                              size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = batch_as_float((batch_as_uint(x[i]) & 0x7fffffffU)
+                                | (batch_as_uint(y[i]) & 0x80000000U));
+}
+
+void reference_fmax_batch(const float *x, const float *y, float *out,
+                          size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        float a = x[i];
+        float b = y[i];
+        out[i] = b != b ? a : (a != a ? b : (a >= b ? a : b));
+    }
+}
+
+void reference_fmin_batch(const float *x, const float *y, float *out,
+                          size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        float a = x[i];
+        float b = y[i];
+        out[i] = b != b ? a : (a != a ? b : (a <= b ? a : b));
+    }
+}
+
+void reference_rint_batch(const float *x, float *out, size_t n)
+{
+#if FLOAT_EVAL_IN_FLOAT
+    for (size_t i = 0; i < n; i++)
+    {
+        cl_uint u = batch_as_uint(x[i]);
+        cl_uint sign = u & 0x80000000U;
+
+        // Adding and subtracting 2^23 rounds to an integer in the current
+        // rounding mode, the sign is restored for results of zero.
+        float magic = batch_as_float(sign | 0x4b000000U);
+        float rounded = (x[i] + magic) - magic;
+        cl_uint r = (batch_as_uint(rounded) & 0x7fffffffU) | sign;
+
+        out[i] = batch_as_float(
+            batch_select((u & 0x7fffffffU) < 0x4b000000U, r, u));
+    }
+#else
+    for (size_t i = 0; i < n; i++) out[i] = (float)reference_rint(x[i]);
+#endif
+}
+
+void reference_trunc_batch(const float *x, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        cl_uint u = batch_as_uint(x[i]);
+        cl_uint sign = u & 0x80000000U;
+
+        // |x| >= 2^23 is an integer, inf or NaN.  Smaller values are truncated
+        // by the conversion to int.
+        bool small = (u & 0x7fffffffU) < 0x4b000000U;
+        float a = batch_as_float(batch_select(small, u, 0U));
+        cl_uint r = batch_as_uint((float)(int32_t)a) | sign;
+
+        out[i] = batch_as_float(batch_select(small, r, u));
+    }
+}
+
+void reference_round_batch(const float *x, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        cl_uint u = batch_as_uint(x[i]);
+        cl_uint sign = u & 0x80000000U;
+
+        // Truncate as above and round away from zero if the fraction dropped
+        // is at least one half, all exactly.
+        bool small = (u & 0x7fffffffU) < 0x4b000000U;
+        float a = batch_as_float(batch_select(small, u, 0U));
+        float t = (float)(int32_t)a;
+        float fraction = batch_as_float(batch_as_uint(a - t) & 0x7fffffffU);
+        cl_uint one = batch_select(fraction >= 0.5f, sign | 0x3f800000U, 0U);
+        float r = t + batch_as_float(one);
+
+        out[i] = batch_as_float(
+            batch_select(small, batch_as_uint(r) | sign, u));
+    }
+}
+
+void reference_add_batch(const float *x, const float *y, float *out, size_t n)
+{
+#if FLOAT_EVAL_IN_FLOAT && !defined(__PPC__) && !defined(__riscv)
+    for (size_t i = 0; i < n; i++) out[i] = x[i] + y[i];
+#else
+    for (size_t i = 0; i < n; i++) out[i] = (float)reference_add(x[i], y[i]);
+#endif
+}
+
+void reference_multiply_batch(const float *x, const float *y, float *out,
+                              size_t n)
+{
+#if FLOAT_EVAL_IN_FLOAT && !defined(__PPC__) && !defined(__riscv)
+    for (size_t i = 0; i < n; i++) out[i] = x[i] * y[i];
+#else
+    for (size_t i = 0; i < n; i++)
+        out[i] = (float)reference_multiply(x[i], y[i]);
+#endif
+}
+
+void reference_mad_batch(const float *a, const float *b, const float *c,
+                         float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = (float)((double)a[i] * (double)b[i] + (double)c[i]);
+}
+
+template <typename Compare>
+static void relational_batch(const float *x, const float *y, cl_int *out,
+                             size_t n, Compare compare)
+{
+    for (size_t i = 0; i < n; i++) out[i] = compare(x[i], y[i]);
+}
+
+void reference_isequal_batch(const float *x, const float *y, cl_int *out,
+                             size_t n)
+{
+    relational_batch(x, y, out, n,
+                     [](float a, float b) { return (cl_int)(a == b); });
+}
+
+void reference_isnotequal_batch(const float *x, const float *y, cl_int *out,
+                                size_t n)
+{
+    relational_batch(x, y, out, n,
+                     [](float a, float b) { return (cl_int)(a != b); });
+}
+
+void reference_isgreater_batch(const float *x, const float *y, cl_int *out,
+                               size_t n)
+{
+    relational_batch(x, y, out, n,
+                     [](float a, float b) { return (cl_int)(a > b); });
+}
+
+void reference_isgreaterequal_batch(const float *x, const float *y,
+                                    cl_int *out, size_t n)
+{
+    relational_batch(x, y, out, n,
+                     [](float a, float b) { return (cl_int)(a >= b); });
+}
+
+void reference_isless_batch(const float *x, const float *y, cl_int *out,
+                            size_t n)
+{
+    relational_batch(x, y, out, n,
+                     [](float a, float b) { return (cl_int)(a < b); });
+}
+
+void reference_islessequal_batch(const float *x, const float *y, cl_int *out,
+                                 size_t n)
+{
+    relational_batch(x, y, out, n,
+                     [](float a, float b) { return (cl_int)(a <= b); });
+}
+
+void reference_islessgreater_batch(const float *x, const float *y,
+                                   cl_int *out, size_t n)
+{
+    relational_batch(x, y, out, n, [](float a, float b) {
+        return (cl_int)(a < b) | (cl_int)(a > b);
+    });
+}
+
+void reference_isordered_batch(const float *x, const float *y, cl_int *out,
+                               size_t n)
+{
+    relational_batch(x, y, out, n, [](float a, float b) {
+        return (cl_int)(a == a) & (cl_int)(b == b);
+    });
+}
+
+void reference_isunordered_batch(const float *x, const float *y, cl_int *out,
+                                 size_t n)
+{
+    relational_batch(x, y, out, n, [](float a, float b) {
+        return (cl_int)(a != a) | (cl_int)(b != b);
+    });
+}
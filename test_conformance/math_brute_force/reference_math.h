@@ -144,6 +144,42 @@ double reference_relaxed_log10(double x);
 double reference_relaxed_pow(double x, double y);
 double reference_relaxed_reciprocal(double x);
 
+// -- batch versions for testing float, see function_list.h --
+
+void reference_fabs_batch(const float* x, float* out, size_t n);
+void reference_rint_batch(const float* x, float* out, size_t n);
+void reference_round_batch(const float* x, float* out, size_t n);
+void reference_trunc_batch(const float* x, float* out, size_t n);
+void reference_copysign_batch(const float* x, const float* y, float* out,
+                              size_t n);
+void reference_fmax_batch(const float* x, const float* y, float* out,
+                          size_t n);
+void reference_fmin_batch(const float* x, const float* y, float* out,
+                          size_t n);
+void reference_add_batch(const float* x, const float* y, float* out, size_t n);
+void reference_multiply_batch(const float* x, const float* y, float* out,
+                              size_t n);
+void reference_mad_batch(const float* a, const float* b, const float* c,
+                         float* out, size_t n);
+void reference_isequal_batch(const float* x, const float* y, cl_int* out,
+                             size_t n);
+void reference_isgreater_batch(const float* x, const float* y, cl_int* out,
+                               size_t n);
+void reference_isgreaterequal_batch(const float* x, const float* y,
+                                    cl_int* out, size_t n);
+void reference_isless_batch(const float* x, const float* y, cl_int* out,
+                            size_t n);
+void reference_islessequal_batch(const float* x, const float* y, cl_int* out,
+                                 size_t n);
+void reference_islessgreater_batch(const float* x, const float* y,
+                                   cl_int* out, size_t n);
+void reference_isnotequal_batch(const float* x, const float* y, cl_int* out,
+                                size_t n);
+void reference_isordered_batch(const float* x, const float* y, cl_int* out,
+                               size_t n);
+void reference_isunordered_batch(const float* x, const float* y, cl_int* out,
+                                 size_t n);
+
 // -- for testing double --
 
 long double reference_sinhl(long double x);
@@ -17,6 +17,7 @@
 #include "common.h"
 #include "function_list.h"
 #include "test_functions.h"
+#include "timing.h"
 #include "utility.h"
 
 #include <cinttypes>
@@ -39,264 +40,368 @@ cl_int BuildKernelFn(cl_uint job_id, cl_uint thread_id UNUSED, void *p)
     return BuildKernels(info, job_id, generator);
 }
 
-} // anonymous namespace
+// Slot specific data, see RunPipelined.
+struct ThreadInfo
+{
+    // Input and output buffers for the slot.
+    clMemWrapper inBuf;
+    clMemWrapper inBuf2;
+    clMemWrapper inBuf3;
+    Buffers outBuf;
 
-int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
+    // Per slot command queue, so that waiting for the results of a job
+    // doesn't wait for the jobs submitted after it.
+    clCommandQueueWrapper tQueue;
+
+    PhaseTimes times;
+};
+
+struct TestInfo
 {
-    int error;
+    const Func *f;
+    bool relaxedMode;
+    int ftz;
+    int skipNanInf;
+    float float_ulps;
 
-    logFunctionInfo(f->name, sizeof(cl_float), relaxedMode);
+    // Distance between the bases of consecutive fills of the whole buffer.
+    // Each fill is split in gPipelineDepth jobs.
+    uint64_t step;
+
+    // Number of elements tested by a job.
+    size_t bufferElements;
+
+    // Pseudorandom number generator for the inputs.  Jobs are submitted in
+    // order, so the inputs don't depend on the pipeline depth.
+    MTdata d;
 
     Programs programs;
-    const unsigned thread_id = 0; // Test is currently not multithreaded.
     KernelMatrix kernels;
-    float maxError = 0.0f;
-    int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
-    float maxErrorVal = 0.0f;
-    float maxErrorVal2 = 0.0f;
-    float maxErrorVal3 = 0.0f;
-    uint64_t step = getTestStep(sizeof(float), BUFFER_SIZE);
 
-    std::vector<cl_uchar> overflow(BUFFER_SIZE / sizeof(float));
+    // Array of slot specific information.
+    std::vector<ThreadInfo> tinfo;
 
-    float float_ulps;
-    if (gIsEmbedded)
-        float_ulps = f->float_embedded_ulps;
-    else
-        float_ulps = f->float_ulps;
+    // Overflow flags of the reference results, for all slots.
+    std::vector<cl_uchar> overflow;
 
-    int skipNanInf = (0 == strcmp("fma", f->nameInCode)) && !gInfNanSupport;
-
-    // Init the kernels
-    BuildKernelInfo build_info{ 1, kernels, programs, f->nameInCode,
-                                relaxedMode };
-    if ((error = ThreadPool_Do(BuildKernelFn,
-                               gMaxVectorSizeIndex - gMinVectorSizeIndex,
-                               &build_info)))
-        return error;
+    float maxError;
+    float maxErrorVal;
+    float maxErrorVal2;
+    float maxErrorVal3;
+};
 
+cl_int Submit(cl_uint job_id, cl_uint thread_id, cl_uint slot, void *data)
+{
+    TestInfo *job = (TestInfo *)data;
+    const Func *f = job->f;
+    size_t buffer_elements = job->bufferElements;
+    size_t buffer_size = buffer_elements * sizeof(cl_float);
+    ThreadInfo *tinfo = &(job->tinfo[slot]);
+    cl_uchar *overflow = job->overflow.data() + slot * buffer_elements;
+    cl_int error;
+    PhaseClock clock(tinfo->times);
+
+    // Init input array
+    cl_uint *p = (cl_uint *)gIn + slot * buffer_elements;
+    cl_uint *p2 = (cl_uint *)gIn2 + slot * buffer_elements;
+    cl_uint *p3 = (cl_uint *)gIn3 + slot * buffer_elements;
+    size_t idx = 0;
+
+    // The special values are tested by the jobs of the first fill.
     const std::vector<float> &specialValues = getFloatSpecialValues();
     size_t specialValuesCount = specialValues.size();
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
-    {
-        if (gSkipCorrectnessTesting) break;
-
-        // Init input array
-        cl_uint *p = (cl_uint *)gIn;
-        cl_uint *p2 = (cl_uint *)gIn2;
-        cl_uint *p3 = (cl_uint *)gIn3;
-        size_t idx = 0;
-
-        if (i == 0)
-        { // test edge cases
-            float *fp = (float *)gIn;
-            float *fp2 = (float *)gIn2;
-            float *fp3 = (float *)gIn3;
-            uint32_t x, y, z;
-            x = y = z = 0;
-            for (; idx < BUFFER_SIZE / sizeof(float); idx++)
-            {
-                fp[idx] = specialValues[x];
-                fp2[idx] = specialValues[y];
-                fp3[idx] = specialValues[z];
+    size_t first = job_id * buffer_elements;
+    size_t x = first % specialValuesCount;
+    size_t y = (first / specialValuesCount) % specialValuesCount;
+    size_t z = first / specialValuesCount / specialValuesCount;
+    if (job_id < gPipelineDepth && z < specialValuesCount)
+    { // test edge cases
+        float *fp = (float *)p;
+        float *fp2 = (float *)p2;
+        float *fp3 = (float *)p3;
+        for (; idx < buffer_elements; idx++)
+        {
+            fp[idx] = specialValues[x];
+            fp2[idx] = specialValues[y];
+            fp3[idx] = specialValues[z];
 
-                if (++x >= specialValuesCount)
+            if (++x >= specialValuesCount)
+            {
+                x = 0;
+                if (++y >= specialValuesCount)
                 {
-                    x = 0;
-                    if (++y >= specialValuesCount)
-                    {
-                        y = 0;
-                        if (++z >= specialValuesCount) break;
-                    }
+                    y = 0;
+                    if (++z >= specialValuesCount) break;
                 }
             }
-            if (idx == BUFFER_SIZE / sizeof(float))
-                vlog_error("Test Error: not all special cases tested!\n");
         }
+        if (idx == buffer_elements && job_id == gPipelineDepth - 1)
+            vlog_error("Test Error: not all special cases tested!\n");
+    }
 
-        for (; idx < BUFFER_SIZE / sizeof(float); idx++)
-        {
-            p[idx] = genrand_int32(d);
-            p2[idx] = genrand_int32(d);
-            p3[idx] = genrand_int32(d);
-        }
+    for (; idx < buffer_elements; idx++)
+    {
+        p[idx] = genrand_int32(job->d);
+        p2[idx] = genrand_int32(job->d);
+        p3[idx] = genrand_int32(job->d);
+    }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
-        {
-            vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
-            return error;
-        }
+    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+                                      buffer_size, p, 0, NULL, NULL)))
+    {
+        vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
+        return error;
+    }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer2, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn2, 0, NULL, NULL)))
-        {
-            vlog_error("\n*** Error %d in clEnqueueWriteBuffer2 ***\n", error);
-            return error;
-        }
+    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf2, CL_FALSE,
+                                      0, buffer_size, p2, 0, NULL, NULL)))
+    {
+        vlog_error("\n*** Error %d in clEnqueueWriteBuffer2 ***\n", error);
+        return error;
+    }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer3, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn3, 0, NULL, NULL)))
-        {
-            vlog_error("\n*** Error %d in clEnqueueWriteBuffer3 ***\n", error);
-            return error;
-        }
+    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf3, CL_FALSE,
+                                      0, buffer_size, p3, 0, NULL, NULL)))
+    {
+        vlog_error("\n*** Error %d in clEnqueueWriteBuffer3 ***\n", error);
+        return error;
+    }
+    clock.Lap(Phase::Fill);
 
-        // Write garbage into output arrays
-        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    // Write garbage into output arrays
+    for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    {
+        uint32_t pattern = 0xffffdead;
+        if (gHostFill)
         {
-            uint32_t pattern = 0xffffdead;
-            if (gHostFill)
+            cl_uint *out = (cl_uint *)gOut[j] + slot * buffer_elements;
+            memset_pattern4(out, &pattern, buffer_size);
+            if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->outBuf[j],
+                                              CL_FALSE, 0, buffer_size, out, 0,
+                                              NULL, NULL)))
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
-                                                  gOut[j], 0, NULL, NULL)))
-                {
-                    vlog_error(
-                        "\n*** Error %d in clEnqueueWriteBuffer2(%d) ***\n",
-                        error, j);
-                    return error;
-                }
-            }
-            else
-            {
-                if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
-                                                 &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
-                {
-                    vlog_error("Error: clEnqueueFillBuffer failed! err: %d\n",
-                               error);
-                    return error;
-                }
+                vlog_error("\n*** Error %d in clEnqueueWriteBuffer2(%d) ***\n",
+                           error, j);
+                return error;
             }
         }
-
-        // Run the kernels
-        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+        else
         {
-            size_t vectorSize = sizeof(cl_float) * sizeValues[j];
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
-            error = clSetKernelArg(kernels[j][thread_id], 0,
-                                   sizeof(gOutBuffer[j]), &gOutBuffer[j]);
-            test_error(error, "Failed to set kernel argument");
-            error = clSetKernelArg(kernels[j][thread_id], 1, sizeof(gInBuffer),
-                                   &gInBuffer);
-            test_error(error, "Failed to set kernel argument");
-            error = clSetKernelArg(kernels[j][thread_id], 2, sizeof(gInBuffer2),
-                                   &gInBuffer2);
-            test_error(error, "Failed to set kernel argument");
-            error = clSetKernelArg(kernels[j][thread_id], 3, sizeof(gInBuffer3),
-                                   &gInBuffer3);
-            test_error(error, "Failed to set kernel argument");
-
-            if ((error = clEnqueueNDRangeKernel(gQueue, kernels[j][thread_id],
-                                                1, NULL, &localCount, NULL, 0,
-                                                NULL, NULL)))
+            if ((error = clEnqueueFillBuffer(tinfo->tQueue, tinfo->outBuf[j],
+                                             &pattern, sizeof(pattern), 0,
+                                             buffer_size, 0, NULL, NULL)))
             {
-                vlog_error("FAILED -- could not execute kernel\n");
+                vlog_error("Error: clEnqueueFillBuffer failed! err: %d\n",
+                           error);
                 return error;
             }
         }
+        clock.Lap(Phase::Fill, j);
+    }
 
-        // Get that moving
-        if ((error = clFlush(gQueue))) vlog("clFlush failed\n");
-
-        // Calculate the correctly rounded reference result
-        float *r = (float *)gOut_Ref;
-        float *s = (float *)gIn;
-        float *s2 = (float *)gIn2;
-        float *s3 = (float *)gIn3;
-        if (skipNanInf)
+    // Run the kernels
+    for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    {
+        size_t vectorSize = sizeof(cl_float) * sizeValues[j];
+        size_t localCount = (buffer_size + vectorSize - 1)
+            / vectorSize; // buffer_size / vectorSize  rounded up
+        cl_kernel kernel = job->kernels[j][thread_id];
+        error = clSetKernelArg(kernel, 0, sizeof(tinfo->outBuf[j]),
+                               &tinfo->outBuf[j]);
+        test_error(error, "Failed to set kernel argument");
+        error = clSetKernelArg(kernel, 1, sizeof(tinfo->inBuf), &tinfo->inBuf);
+        test_error(error, "Failed to set kernel argument");
+        error =
+            clSetKernelArg(kernel, 2, sizeof(tinfo->inBuf2), &tinfo->inBuf2);
+        test_error(error, "Failed to set kernel argument");
+        error =
+            clSetKernelArg(kernel, 3, sizeof(tinfo->inBuf3), &tinfo->inBuf3);
+        test_error(error, "Failed to set kernel argument");
+
+        if ((error = clEnqueueNDRangeKernel(tinfo->tQueue, kernel, 1, NULL,
+                                            &localCount, NULL, 0, NULL, NULL)))
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-            {
-                feclearexcept(FE_OVERFLOW);
-                r[j] =
-                    (float)f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
-                overflow[j] =
-                    FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
-            }
+            vlog_error("FAILED -- could not execute kernel\n");
+            return error;
         }
-        else
+        clock.Lap(Phase::Enqueue, j);
+    }
+
+    // Get that moving
+    if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
+    clock.Lap(Phase::Enqueue);
+
+    // Calculate the correctly rounded reference result
+    float *r = (float *)gOut_Ref + slot * buffer_elements;
+    float *s = (float *)p;
+    float *s2 = (float *)p2;
+    float *s3 = (float *)p3;
+    if (job->skipNanInf)
+    {
+        for (size_t j = 0; j < buffer_elements; j++)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-                r[j] =
-                    (float)f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
+            feclearexcept(FE_OVERFLOW);
+            r[j] = (float)f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
+            overflow[j] =
+                FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
         }
+    }
+    else
+    {
+        for (size_t j = 0; j < buffer_elements; j++)
+            r[j] = (float)f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
+    }
+    clock.Lap(Phase::Reference);
 
-        // Read the data back
-        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    return CL_SUCCESS;
+}
+
+cl_int Complete(cl_uint job_id, cl_uint thread_id UNUSED, cl_uint slot,
+                void *data)
+{
+    TestInfo *job = (TestInfo *)data;
+    const Func *f = job->f;
+    size_t buffer_elements = job->bufferElements;
+    size_t buffer_size = buffer_elements * sizeof(cl_float);
+    ThreadInfo *tinfo = &(job->tinfo[slot]);
+    const cl_uchar *overflow = job->overflow.data() + slot * buffer_elements;
+    bool relaxedMode = job->relaxedMode;
+    int ftz = job->ftz;
+    int skipNanInf = job->skipNanInf;
+    float float_ulps = job->float_ulps;
+    cl_int error;
+    PhaseClock clock(tinfo->times);
+
+    // Read the data back
+    for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    {
+        if ((error = clEnqueueReadBuffer(
+                 tinfo->tQueue, tinfo->outBuf[j], CL_TRUE, 0, buffer_size,
+                 (cl_uint *)gOut[j] + slot * buffer_elements, 0, NULL, NULL)))
         {
-            if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
-            {
-                vlog_error("ReadArray failed %d\n", error);
-                return error;
-            }
+            vlog_error("ReadArray failed %d\n", error);
+            return error;
         }
+        clock.Lap(Phase::Map, j);
+    }
 
-        // Verify data
-        uint32_t *t = (uint32_t *)gOut_Ref;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+    // Verify data
+    float *r = (float *)gOut_Ref + slot * buffer_elements;
+    float *s = (float *)gIn + slot * buffer_elements;
+    float *s2 = (float *)gIn2 + slot * buffer_elements;
+    float *s3 = (float *)gIn3 + slot * buffer_elements;
+    uint32_t *t = (uint32_t *)r;
+    for (size_t j = 0; j < buffer_elements; j++)
+    {
+        for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
-            for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+            uint32_t *q = (uint32_t *)gOut[k] + slot * buffer_elements;
+
+            // If we aren't getting the correctly rounded result
+            if (t[j] != q[j])
             {
-                uint32_t *q = (uint32_t *)(gOut[k]);
+                float err;
+                int fail;
+                float test = ((float *)q)[j];
+                float correct =
+                    f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
+
+                // Per section 10 paragraph 6, accept any result if an input
+                // or output is a infinity or NaN or overflow
+                if (skipNanInf)
+                {
+                    if (overflow[j] || IsFloatInfinity(correct)
+                        || IsFloatNaN(correct) || IsFloatInfinity(s[j])
+                        || IsFloatNaN(s[j]) || IsFloatInfinity(s2[j])
+                        || IsFloatNaN(s2[j]) || IsFloatInfinity(s3[j])
+                        || IsFloatNaN(s3[j]))
+                        continue;
+                }
+
 
-                // If we aren't getting the correctly rounded result
-                if (t[j] != q[j])
+                err = Ulp_Error(test, correct);
+                fail = !(fabsf(err) <= float_ulps);
+
+                if (fail && (ftz || relaxedMode))
                 {
-                    float err;
-                    int fail;
-                    float test = ((float *)q)[j];
-                    float correct =
-                        f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
-
-                    // Per section 10 paragraph 6, accept any result if an input
-                    // or output is a infinity or NaN or overflow
-                    if (skipNanInf)
+                    float correct2, err2;
+
+                    // retry per section 6.5.3.2  with flushing on
+                    if (0.0f == test
+                        && 0.0f
+                            == f->func.f_fma(s[j], s2[j], s3[j], FLUSHED))
                     {
-                        if (overflow[j] || IsFloatInfinity(correct)
-                            || IsFloatNaN(correct) || IsFloatInfinity(s[j])
-                            || IsFloatNaN(s[j]) || IsFloatInfinity(s2[j])
-                            || IsFloatNaN(s2[j]) || IsFloatInfinity(s3[j])
-                            || IsFloatNaN(s3[j]))
-                            continue;
+                        fail = 0;
+                        err = 0.0f;
                     }
 
+                    // retry per section 6.5.3.3
+                    if (fail && IsFloatSubnormal(s[j]))
+                    { // look at me,
+                        float err3, correct3;
 
-                    err = Ulp_Error(test, correct);
-                    fail = !(fabsf(err) <= float_ulps);
+                        if (skipNanInf) feclearexcept(FE_OVERFLOW);
 
-                    if (fail && (ftz || relaxedMode))
-                    {
-                        float correct2, err2;
+                        correct2 = f->func.f_fma(0.0f, s2[j], s3[j],
+                                                 CORRECTLY_ROUNDED);
+                        correct3 = f->func.f_fma(-0.0f, s2[j], s3[j],
+                                                 CORRECTLY_ROUNDED);
+
+                        if (skipNanInf)
+                        {
+                            if (fetestexcept(FE_OVERFLOW)) continue;
+
+                            // Note: no double rounding here.  Reference
+                            // functions calculate in single precision.
+                            if (IsFloatInfinity(correct2)
+                                || IsFloatNaN(correct2)
+                                || IsFloatInfinity(correct3)
+                                || IsFloatNaN(correct3))
+                                continue;
+                        }
+
+                        err2 = Ulp_Error(test, correct2);
+                        err3 = Ulp_Error(test, correct3);
+                        fail = fail
+                            && ((!(fabsf(err2) <= float_ulps))
+                                && (!(fabsf(err3) <= float_ulps)));
+                        if (fabsf(err2) < fabsf(err)) err = err2;
+                        if (fabsf(err3) < fabsf(err)) err = err3;
 
-                        // retry per section 6.5.3.2  with flushing on
+                        // retry per section 6.5.3.4
                         if (0.0f == test
-                            && 0.0f
-                                == f->func.f_fma(s[j], s2[j], s3[j], FLUSHED))
+                            && (0.0f
+                                    == f->func.f_fma(0.0f, s2[j], s3[j],
+                                                     FLUSHED)
+                                || 0.0f
+                                    == f->func.f_fma(-0.0f, s2[j], s3[j],
+                                                     FLUSHED)))
                         {
                             fail = 0;
                             err = 0.0f;
                         }
 
-                        // retry per section 6.5.3.3
-                        if (fail && IsFloatSubnormal(s[j]))
-                        { // look at me,
-                            float err3, correct3;
+                        // try with first two args as zero
+                        if (IsFloatSubnormal(s2[j]))
+                        { // its fun to have fun,
+                            double correct4, correct5;
+                            float err4, err5;
 
                             if (skipNanInf) feclearexcept(FE_OVERFLOW);
 
-                            correct2 = f->func.f_fma(0.0f, s2[j], s3[j],
+                            correct2 = f->func.f_fma(0.0f, 0.0f, s3[j],
                                                      CORRECTLY_ROUNDED);
-                            correct3 = f->func.f_fma(-0.0f, s2[j], s3[j],
+                            correct3 = f->func.f_fma(-0.0f, 0.0f, s3[j],
+                                                     CORRECTLY_ROUNDED);
+                            correct4 = f->func.f_fma(0.0f, -0.0f, s3[j],
+                                                     CORRECTLY_ROUNDED);
+                            correct5 = f->func.f_fma(-0.0f, -0.0f, s3[j],
                                                      CORRECTLY_ROUNDED);
 
-                            if (skipNanInf)
+                            // Per section 10 paragraph 6, accept any result
+                            // if an input or output is a infinity or NaN or
+                            // overflow
+                            if (!gInfNanSupport)
                             {
                                 if (fetestexcept(FE_OVERFLOW)) continue;
 
@@ -305,193 +410,76 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                 if (IsFloatInfinity(correct2)
                                     || IsFloatNaN(correct2)
                                     || IsFloatInfinity(correct3)
-                                    || IsFloatNaN(correct3))
+                                    || IsFloatNaN(correct3)
+                                    || IsFloatInfinity(correct4)
+                                    || IsFloatNaN(correct4)
+                                    || IsFloatInfinity(correct5)
+                                    || IsFloatNaN(correct5))
                                     continue;
                             }
 
                             err2 = Ulp_Error(test, correct2);
                             err3 = Ulp_Error(test, correct3);
+                            err4 = Ulp_Error(test, correct4);
+                            err5 = Ulp_Error(test, correct5);
                             fail = fail
                                 && ((!(fabsf(err2) <= float_ulps))
-                                    && (!(fabsf(err3) <= float_ulps)));
+                                    && (!(fabsf(err3) <= float_ulps))
+                                    && (!(fabsf(err4) <= float_ulps))
+                                    && (!(fabsf(err5) <= float_ulps)));
                             if (fabsf(err2) < fabsf(err)) err = err2;
                             if (fabsf(err3) < fabsf(err)) err = err3;
+                            if (fabsf(err4) < fabsf(err)) err = err4;
+                            if (fabsf(err5) < fabsf(err)) err = err5;
 
                             // retry per section 6.5.3.4
                             if (0.0f == test
                                 && (0.0f
-                                        == f->func.f_fma(0.0f, s2[j], s3[j],
+                                        == f->func.f_fma(0.0f, 0.0f, s3[j],
                                                          FLUSHED)
                                     || 0.0f
-                                        == f->func.f_fma(-0.0f, s2[j], s3[j],
-                                                         FLUSHED)))
+                                        == f->func.f_fma(-0.0f, 0.0f, s3[j],
+                                                         FLUSHED)
+                                    || 0.0f
+                                        == f->func.f_fma(0.0f, -0.0f, s3[j],
+                                                         FLUSHED)
+                                    || 0.0f
+                                        == f->func.f_fma(-0.0f, -0.0f,
+                                                         s3[j], FLUSHED)))
                             {
                                 fail = 0;
                                 err = 0.0f;
                             }
 
-                            // try with first two args as zero
-                            if (IsFloatSubnormal(s2[j]))
-                            { // its fun to have fun,
-                                double correct4, correct5;
-                                float err4, err5;
-
-                                if (skipNanInf) feclearexcept(FE_OVERFLOW);
-
-                                correct2 = f->func.f_fma(0.0f, 0.0f, s3[j],
-                                                         CORRECTLY_ROUNDED);
-                                correct3 = f->func.f_fma(-0.0f, 0.0f, s3[j],
-                                                         CORRECTLY_ROUNDED);
-                                correct4 = f->func.f_fma(0.0f, -0.0f, s3[j],
-                                                         CORRECTLY_ROUNDED);
-                                correct5 = f->func.f_fma(-0.0f, -0.0f, s3[j],
-                                                         CORRECTLY_ROUNDED);
-
-                                // Per section 10 paragraph 6, accept any result
-                                // if an input or output is a infinity or NaN or
-                                // overflow
-                                if (!gInfNanSupport)
-                                {
-                                    if (fetestexcept(FE_OVERFLOW)) continue;
-
-                                    // Note: no double rounding here.  Reference
-                                    // functions calculate in single precision.
-                                    if (IsFloatInfinity(correct2)
-                                        || IsFloatNaN(correct2)
-                                        || IsFloatInfinity(correct3)
-                                        || IsFloatNaN(correct3)
-                                        || IsFloatInfinity(correct4)
-                                        || IsFloatNaN(correct4)
-                                        || IsFloatInfinity(correct5)
-                                        || IsFloatNaN(correct5))
-                                        continue;
-                                }
-
-                                err2 = Ulp_Error(test, correct2);
-                                err3 = Ulp_Error(test, correct3);
-                                err4 = Ulp_Error(test, correct4);
-                                err5 = Ulp_Error(test, correct5);
-                                fail = fail
-                                    && ((!(fabsf(err2) <= float_ulps))
-                                        && (!(fabsf(err3) <= float_ulps))
-                                        && (!(fabsf(err4) <= float_ulps))
-                                        && (!(fabsf(err5) <= float_ulps)));
-                                if (fabsf(err2) < fabsf(err)) err = err2;
-                                if (fabsf(err3) < fabsf(err)) err = err3;
-                                if (fabsf(err4) < fabsf(err)) err = err4;
-                                if (fabsf(err5) < fabsf(err)) err = err5;
-
-                                // retry per section 6.5.3.4
-                                if (0.0f == test
-                                    && (0.0f
-                                            == f->func.f_fma(0.0f, 0.0f, s3[j],
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(-0.0f, 0.0f, s3[j],
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(0.0f, -0.0f, s3[j],
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(-0.0f, -0.0f,
-                                                             s3[j], FLUSHED)))
-                                {
-                                    fail = 0;
-                                    err = 0.0f;
-                                }
-
-                                if (IsFloatSubnormal(s3[j]))
-                                {
-                                    if (test == 0.0f) // 0*0+0 is 0
-                                    {
-                                        fail = 0;
-                                        err = 0.0f;
-                                    }
-                                }
-                            }
-                            else if (IsFloatSubnormal(s3[j]))
+                            if (IsFloatSubnormal(s3[j]))
                             {
-                                double correct4, correct5;
-                                float err4, err5;
-
-                                if (skipNanInf) feclearexcept(FE_OVERFLOW);
-
-                                correct2 = f->func.f_fma(0.0f, s2[j], 0.0f,
-                                                         CORRECTLY_ROUNDED);
-                                correct3 = f->func.f_fma(-0.0f, s2[j], 0.0f,
-                                                         CORRECTLY_ROUNDED);
-                                correct4 = f->func.f_fma(0.0f, s2[j], -0.0f,
-                                                         CORRECTLY_ROUNDED);
-                                correct5 = f->func.f_fma(-0.0f, s2[j], -0.0f,
-                                                         CORRECTLY_ROUNDED);
-
-                                // Per section 10 paragraph 6, accept any result
-                                // if an input or output is a infinity or NaN or
-                                // overflow
-                                if (!gInfNanSupport)
-                                {
-                                    if (fetestexcept(FE_OVERFLOW)) continue;
-
-                                    // Note: no double rounding here.  Reference
-                                    // functions calculate in single precision.
-                                    if (IsFloatInfinity(correct2)
-                                        || IsFloatNaN(correct2)
-                                        || IsFloatInfinity(correct3)
-                                        || IsFloatNaN(correct3)
-                                        || IsFloatInfinity(correct4)
-                                        || IsFloatNaN(correct4)
-                                        || IsFloatInfinity(correct5)
-                                        || IsFloatNaN(correct5))
-                                        continue;
-                                }
-
-                                err2 = Ulp_Error(test, correct2);
-                                err3 = Ulp_Error(test, correct3);
-                                err4 = Ulp_Error(test, correct4);
-                                err5 = Ulp_Error(test, correct5);
-                                fail = fail
-                                    && ((!(fabsf(err2) <= float_ulps))
-                                        && (!(fabsf(err3) <= float_ulps))
-                                        && (!(fabsf(err4) <= float_ulps))
-                                        && (!(fabsf(err5) <= float_ulps)));
-                                if (fabsf(err2) < fabsf(err)) err = err2;
-                                if (fabsf(err3) < fabsf(err)) err = err3;
-                                if (fabsf(err4) < fabsf(err)) err = err4;
-                                if (fabsf(err5) < fabsf(err)) err = err5;
-
-                                // retry per section 6.5.3.4
-                                if (0.0f == test
-                                    && (0.0f
-                                            == f->func.f_fma(0.0f, s2[j], 0.0f,
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(-0.0f, s2[j], 0.0f,
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(0.0f, s2[j], -0.0f,
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(-0.0f, s2[j],
-                                                             -0.0f, FLUSHED)))
+                                if (test == 0.0f) // 0*0+0 is 0
                                 {
                                     fail = 0;
                                     err = 0.0f;
                                 }
                             }
                         }
-                        else if (fail && IsFloatSubnormal(s2[j]))
+                        else if (IsFloatSubnormal(s3[j]))
                         {
-                            double correct2, correct3;
-                            float err2, err3;
+                            double correct4, correct5;
+                            float err4, err5;
 
                             if (skipNanInf) feclearexcept(FE_OVERFLOW);
 
-                            correct2 = f->func.f_fma(s[j], 0.0f, s3[j],
+                            correct2 = f->func.f_fma(0.0f, s2[j], 0.0f,
+                                                     CORRECTLY_ROUNDED);
+                            correct3 = f->func.f_fma(-0.0f, s2[j], 0.0f,
                                                      CORRECTLY_ROUNDED);
-                            correct3 = f->func.f_fma(s[j], -0.0f, s3[j],
+                            correct4 = f->func.f_fma(0.0f, s2[j], -0.0f,
+                                                     CORRECTLY_ROUNDED);
+                            correct5 = f->func.f_fma(-0.0f, s2[j], -0.0f,
                                                      CORRECTLY_ROUNDED);
 
-                            if (skipNanInf)
+                            // Per section 10 paragraph 6, accept any result
+                            // if an input or output is a infinity or NaN or
+                            // overflow
+                            if (!gInfNanSupport)
                             {
                                 if (fetestexcept(FE_OVERFLOW)) continue;
 
@@ -500,115 +488,115 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                 if (IsFloatInfinity(correct2)
                                     || IsFloatNaN(correct2)
                                     || IsFloatInfinity(correct3)
-                                    || IsFloatNaN(correct3))
+                                    || IsFloatNaN(correct3)
+                                    || IsFloatInfinity(correct4)
+                                    || IsFloatNaN(correct4)
+                                    || IsFloatInfinity(correct5)
+                                    || IsFloatNaN(correct5))
                                     continue;
                             }
 
                             err2 = Ulp_Error(test, correct2);
                             err3 = Ulp_Error(test, correct3);
+                            err4 = Ulp_Error(test, correct4);
+                            err5 = Ulp_Error(test, correct5);
                             fail = fail
                                 && ((!(fabsf(err2) <= float_ulps))
-                                    && (!(fabsf(err3) <= float_ulps)));
+                                    && (!(fabsf(err3) <= float_ulps))
+                                    && (!(fabsf(err4) <= float_ulps))
+                                    && (!(fabsf(err5) <= float_ulps)));
                             if (fabsf(err2) < fabsf(err)) err = err2;
                             if (fabsf(err3) < fabsf(err)) err = err3;
+                            if (fabsf(err4) < fabsf(err)) err = err4;
+                            if (fabsf(err5) < fabsf(err)) err = err5;
 
                             // retry per section 6.5.3.4
                             if (0.0f == test
                                 && (0.0f
-                                        == f->func.f_fma(s[j], 0.0f, s3[j],
+                                        == f->func.f_fma(0.0f, s2[j], 0.0f,
                                                          FLUSHED)
                                     || 0.0f
-                                        == f->func.f_fma(s[j], -0.0f, s3[j],
-                                                         FLUSHED)))
+                                        == f->func.f_fma(-0.0f, s2[j], 0.0f,
+                                                         FLUSHED)
+                                    || 0.0f
+                                        == f->func.f_fma(0.0f, s2[j], -0.0f,
+                                                         FLUSHED)
+                                    || 0.0f
+                                        == f->func.f_fma(-0.0f, s2[j],
+                                                         -0.0f, FLUSHED)))
                             {
                                 fail = 0;
                                 err = 0.0f;
                             }
+                        }
+                    }
+                    else if (fail && IsFloatSubnormal(s2[j]))
+                    {
+                        double correct2, correct3;
+                        float err2, err3;
 
-                            // try with second two args as zero
-                            if (IsFloatSubnormal(s3[j]))
-                            {
-                                double correct4, correct5;
-                                float err4, err5;
-
-                                if (skipNanInf) feclearexcept(FE_OVERFLOW);
-
-                                correct2 = f->func.f_fma(s[j], 0.0f, 0.0f,
-                                                         CORRECTLY_ROUNDED);
-                                correct3 = f->func.f_fma(s[j], -0.0f, 0.0f,
-                                                         CORRECTLY_ROUNDED);
-                                correct4 = f->func.f_fma(s[j], 0.0f, -0.0f,
-                                                         CORRECTLY_ROUNDED);
-                                correct5 = f->func.f_fma(s[j], -0.0f, -0.0f,
-                                                         CORRECTLY_ROUNDED);
-
-                                // Per section 10 paragraph 6, accept any result
-                                // if an input or output is a infinity or NaN or
-                                // overflow
-                                if (!gInfNanSupport)
-                                {
-                                    if (fetestexcept(FE_OVERFLOW)) continue;
-
-                                    // Note: no double rounding here.  Reference
-                                    // functions calculate in single precision.
-                                    if (IsFloatInfinity(correct2)
-                                        || IsFloatNaN(correct2)
-                                        || IsFloatInfinity(correct3)
-                                        || IsFloatNaN(correct3)
-                                        || IsFloatInfinity(correct4)
-                                        || IsFloatNaN(correct4)
-                                        || IsFloatInfinity(correct5)
-                                        || IsFloatNaN(correct5))
-                                        continue;
-                                }
+                        if (skipNanInf) feclearexcept(FE_OVERFLOW);
 
-                                err2 = Ulp_Error(test, correct2);
-                                err3 = Ulp_Error(test, correct3);
-                                err4 = Ulp_Error(test, correct4);
-                                err5 = Ulp_Error(test, correct5);
-                                fail = fail
-                                    && ((!(fabsf(err2) <= float_ulps))
-                                        && (!(fabsf(err3) <= float_ulps))
-                                        && (!(fabsf(err4) <= float_ulps))
-                                        && (!(fabsf(err5) <= float_ulps)));
-                                if (fabsf(err2) < fabsf(err)) err = err2;
-                                if (fabsf(err3) < fabsf(err)) err = err3;
-                                if (fabsf(err4) < fabsf(err)) err = err4;
-                                if (fabsf(err5) < fabsf(err)) err = err5;
-
-                                // retry per section 6.5.3.4
-                                if (0.0f == test
-                                    && (0.0f
-                                            == f->func.f_fma(s[j], 0.0f, 0.0f,
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(s[j], -0.0f, 0.0f,
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(s[j], 0.0f, -0.0f,
-                                                             FLUSHED)
-                                        || 0.0f
-                                            == f->func.f_fma(s[j], -0.0f, -0.0f,
-                                                             FLUSHED)))
-                                {
-                                    fail = 0;
-                                    err = 0.0f;
-                                }
-                            }
+                        correct2 = f->func.f_fma(s[j], 0.0f, s3[j],
+                                                 CORRECTLY_ROUNDED);
+                        correct3 = f->func.f_fma(s[j], -0.0f, s3[j],
+                                                 CORRECTLY_ROUNDED);
+
+                        if (skipNanInf)
+                        {
+                            if (fetestexcept(FE_OVERFLOW)) continue;
+
+                            // Note: no double rounding here.  Reference
+                            // functions calculate in single precision.
+                            if (IsFloatInfinity(correct2)
+                                || IsFloatNaN(correct2)
+                                || IsFloatInfinity(correct3)
+                                || IsFloatNaN(correct3))
+                                continue;
+                        }
+
+                        err2 = Ulp_Error(test, correct2);
+                        err3 = Ulp_Error(test, correct3);
+                        fail = fail
+                            && ((!(fabsf(err2) <= float_ulps))
+                                && (!(fabsf(err3) <= float_ulps)));
+                        if (fabsf(err2) < fabsf(err)) err = err2;
+                        if (fabsf(err3) < fabsf(err)) err = err3;
+
+                        // retry per section 6.5.3.4
+                        if (0.0f == test
+                            && (0.0f
+                                    == f->func.f_fma(s[j], 0.0f, s3[j],
+                                                     FLUSHED)
+                                || 0.0f
+                                    == f->func.f_fma(s[j], -0.0f, s3[j],
+                                                     FLUSHED)))
+                        {
+                            fail = 0;
+                            err = 0.0f;
                         }
-                        else if (fail && IsFloatSubnormal(s3[j]))
+
+                        // try with second two args as zero
+                        if (IsFloatSubnormal(s3[j]))
                         {
-                            double correct2, correct3;
-                            float err2, err3;
+                            double correct4, correct5;
+                            float err4, err5;
 
                             if (skipNanInf) feclearexcept(FE_OVERFLOW);
 
-                            correct2 = f->func.f_fma(s[j], s2[j], 0.0f,
+                            correct2 = f->func.f_fma(s[j], 0.0f, 0.0f,
+                                                     CORRECTLY_ROUNDED);
+                            correct3 = f->func.f_fma(s[j], -0.0f, 0.0f,
+                                                     CORRECTLY_ROUNDED);
+                            correct4 = f->func.f_fma(s[j], 0.0f, -0.0f,
                                                      CORRECTLY_ROUNDED);
-                            correct3 = f->func.f_fma(s[j], s2[j], -0.0f,
+                            correct5 = f->func.f_fma(s[j], -0.0f, -0.0f,
                                                      CORRECTLY_ROUNDED);
 
-                            if (skipNanInf)
+                            // Per section 10 paragraph 6, accept any result
+                            // if an input or output is a infinity or NaN or
+                            // overflow
+                            if (!gInfNanSupport)
                             {
                                 if (fetestexcept(FE_OVERFLOW)) continue;
 
@@ -617,25 +605,41 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                 if (IsFloatInfinity(correct2)
                                     || IsFloatNaN(correct2)
                                     || IsFloatInfinity(correct3)
-                                    || IsFloatNaN(correct3))
+                                    || IsFloatNaN(correct3)
+                                    || IsFloatInfinity(correct4)
+                                    || IsFloatNaN(correct4)
+                                    || IsFloatInfinity(correct5)
+                                    || IsFloatNaN(correct5))
                                     continue;
                             }
 
                             err2 = Ulp_Error(test, correct2);
                             err3 = Ulp_Error(test, correct3);
+                            err4 = Ulp_Error(test, correct4);
+                            err5 = Ulp_Error(test, correct5);
                             fail = fail
                                 && ((!(fabsf(err2) <= float_ulps))
-                                    && (!(fabsf(err3) <= float_ulps)));
+                                    && (!(fabsf(err3) <= float_ulps))
+                                    && (!(fabsf(err4) <= float_ulps))
+                                    && (!(fabsf(err5) <= float_ulps)));
                             if (fabsf(err2) < fabsf(err)) err = err2;
                             if (fabsf(err3) < fabsf(err)) err = err3;
+                            if (fabsf(err4) < fabsf(err)) err = err4;
+                            if (fabsf(err5) < fabsf(err)) err = err5;
 
                             // retry per section 6.5.3.4
                             if (0.0f == test
                                 && (0.0f
-                                        == f->func.f_fma(s[j], s2[j], 0.0f,
+                                        == f->func.f_fma(s[j], 0.0f, 0.0f,
+                                                         FLUSHED)
+                                    || 0.0f
+                                        == f->func.f_fma(s[j], -0.0f, 0.0f,
+                                                         FLUSHED)
+                                    || 0.0f
+                                        == f->func.f_fma(s[j], 0.0f, -0.0f,
                                                          FLUSHED)
                                     || 0.0f
-                                        == f->func.f_fma(s[j], s2[j], -0.0f,
+                                        == f->func.f_fma(s[j], -0.0f, -0.0f,
                                                          FLUSHED)))
                             {
                                 fail = 0;
@@ -643,56 +647,210 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                             }
                         }
                     }
-
-                    if (fabsf(err) > maxError)
+                    else if (fail && IsFloatSubnormal(s3[j]))
                     {
-                        maxError = fabsf(err);
-                        maxErrorVal = s[j];
-                        maxErrorVal2 = s2[j];
-                        maxErrorVal3 = s3[j];
-                    }
+                        double correct2, correct3;
+                        float err2, err3;
 
-                    if (fail)
-                    {
-                        vlog_error(
-                            "\nERROR: %s%s: %f ulp error at {%a, %a, %a} "
-                            "({0x%8.8x, 0x%8.8x, 0x%8.8x}): *%a vs. %a\n",
-                            f->name, sizeNames[k], err, s[j], s2[j], s3[j],
-                            ((cl_uint *)s)[j], ((cl_uint *)s2)[j],
-                            ((cl_uint *)s3)[j], ((float *)gOut_Ref)[j], test);
-                        return -1;
+                        if (skipNanInf) feclearexcept(FE_OVERFLOW);
+
+                        correct2 = f->func.f_fma(s[j], s2[j], 0.0f,
+                                                 CORRECTLY_ROUNDED);
+                        correct3 = f->func.f_fma(s[j], s2[j], -0.0f,
+                                                 CORRECTLY_ROUNDED);
+
+                        if (skipNanInf)
+                        {
+                            if (fetestexcept(FE_OVERFLOW)) continue;
+
+                            // Note: no double rounding here.  Reference
+                            // functions calculate in single precision.
+                            if (IsFloatInfinity(correct2)
+                                || IsFloatNaN(correct2)
+                                || IsFloatInfinity(correct3)
+                                || IsFloatNaN(correct3))
+                                continue;
+                        }
+
+                        err2 = Ulp_Error(test, correct2);
+                        err3 = Ulp_Error(test, correct3);
+                        fail = fail
+                            && ((!(fabsf(err2) <= float_ulps))
+                                && (!(fabsf(err3) <= float_ulps)));
+                        if (fabsf(err2) < fabsf(err)) err = err2;
+                        if (fabsf(err3) < fabsf(err)) err = err3;
+
+                        // retry per section 6.5.3.4
+                        if (0.0f == test
+                            && (0.0f
+                                    == f->func.f_fma(s[j], s2[j], 0.0f,
+                                                     FLUSHED)
+                                || 0.0f
+                                    == f->func.f_fma(s[j], s2[j], -0.0f,
+                                                     FLUSHED)))
+                        {
+                            fail = 0;
+                            err = 0.0f;
+                        }
                     }
                 }
+
+                if (fabsf(err) > job->maxError)
+                {
+                    job->maxError = fabsf(err);
+                    job->maxErrorVal = s[j];
+                    job->maxErrorVal2 = s2[j];
+                    job->maxErrorVal3 = s3[j];
+                }
+
+                if (fail)
+                {
+                    vlog_error(
+                        "\nERROR: %s%s: %f ulp error at {%a, %a, %a} "
+                        "({0x%8.8x, 0x%8.8x, 0x%8.8x}): *%a vs. %a\n",
+                        f->name, sizeNames[k], err, s[j], s2[j], s3[j],
+                        ((cl_uint *)s)[j], ((cl_uint *)s2)[j],
+                        ((cl_uint *)s3)[j], r[j], test);
+                    return -1;
+                }
             }
         }
+    }
+    clock.Lap(Phase::Verify);
+    tinfo->times.values += buffer_elements;
 
-        if (0 == (i & 0x0fffffff))
+    // Report progress once per fill of the whole buffer.
+    uint64_t i = (job_id / gPipelineDepth) * job->step;
+    if (job_id % gPipelineDepth == gPipelineDepth - 1
+        && 0 == (i & 0x0fffffff))
+    {
+        if (gVerboseBruteForce)
         {
-            if (gVerboseBruteForce)
-            {
-                vlog("base:%14" PRIu64 " step:%10" PRIu64 " bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
-            }
-            else
+            vlog("base:%14" PRIu64 " step:%10" PRIu64 " bufferSize:%10d \n", i,
+                 job->step, BUFFER_SIZE);
+        }
+        else
+        {
+            vlog(".");
+        }
+        fflush(stdout);
+    }
+
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
+{
+    TestInfo test_info{};
+    int error;
+
+    logFunctionInfo(f->name, sizeof(cl_float), relaxedMode);
+
+    test_info.f = f;
+    test_info.relaxedMode = relaxedMode;
+    test_info.ftz =
+        f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
+    test_info.skipNanInf =
+        (0 == strcmp("fma", f->nameInCode)) && !gInfNanSupport;
+    test_info.float_ulps =
+        gIsEmbedded ? f->float_embedded_ulps : f->float_ulps;
+    test_info.step = getTestStep(sizeof(float), BUFFER_SIZE);
+    test_info.bufferElements = BUFFER_SIZE / sizeof(float) / gPipelineDepth;
+    test_info.d = d;
+
+    // Init the kernels
+    FunctionTiming timing(f, "float", relaxedMode, test_info.tinfo, 1);
+    BuildKernelInfo build_info{ 1, test_info.kernels, test_info.programs,
+                                f->nameInCode, relaxedMode };
+    if ((error = ThreadPool_Do(BuildKernelFn,
+                               gMaxVectorSizeIndex - gMinVectorSizeIndex,
+                               &build_info)))
+        return error;
+    timing.BuildDone();
+
+    cl_uint slotCount = GetPipelineSlotCount(1);
+    size_t buffer_size = test_info.bufferElements * sizeof(cl_float);
+    test_info.overflow.resize(slotCount * test_info.bufferElements);
+    test_info.tinfo.resize(slotCount);
+    for (cl_uint i = 0; i < slotCount; i++)
+    {
+        ThreadInfo &tinfo = test_info.tinfo[i];
+        cl_buffer_region region = { i * buffer_size, buffer_size };
+        tinfo.inBuf =
+            clCreateSubBuffer(gInBuffer, CL_MEM_READ_ONLY,
+                              CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+        if (error || NULL == tinfo.inBuf)
+        {
+            vlog_error("Error: Unable to create sub-buffer of gInBuffer for "
+                       "region {%zd, %zd}\n",
+                       region.origin, region.size);
+            return error;
+        }
+        tinfo.inBuf2 =
+            clCreateSubBuffer(gInBuffer2, CL_MEM_READ_ONLY,
+                              CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+        if (error || NULL == tinfo.inBuf2)
+        {
+            vlog_error("Error: Unable to create sub-buffer of gInBuffer2 for "
+                       "region {%zd, %zd}\n",
+                       region.origin, region.size);
+            return error;
+        }
+        tinfo.inBuf3 =
+            clCreateSubBuffer(gInBuffer3, CL_MEM_READ_ONLY,
+                              CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+        if (error || NULL == tinfo.inBuf3)
+        {
+            vlog_error("Error: Unable to create sub-buffer of gInBuffer3 for "
+                       "region {%zd, %zd}\n",
+                       region.origin, region.size);
+            return error;
+        }
+
+        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+        {
+            tinfo.outBuf[j] = clCreateSubBuffer(
+                gOutBuffer[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION,
+                &region, &error);
+            if (error || NULL == tinfo.outBuf[j])
             {
-                vlog(".");
+                vlog_error("Error: Unable to create sub-buffer of "
+                           "gOutBuffer[%d] for region {%zd, %zd}\n",
+                           (int)j, region.origin, region.size);
+                return error;
             }
-            fflush(stdout);
+        }
+
+        tinfo.tQueue = clCreateCommandQueue(gContext, gDevice, 0, &error);
+        if (NULL == tinfo.tQueue || error)
+        {
+            vlog_error("clCreateCommandQueue failed. (%d)\n", error);
+            return error;
         }
     }
 
     if (!gSkipCorrectnessTesting)
     {
+        cl_uint jobCount = (cl_uint)(((1ULL << 32) + test_info.step - 1)
+                                     / test_info.step * gPipelineDepth);
+        error = RunPipelined({ Submit, Complete }, 1, jobCount, &test_info);
+        if (error) return error;
+
         if (gWimpyMode)
             vlog("Wimp pass");
         else
             vlog("passed");
 
-        vlog("\t%8.2f @ {%a, %a, %a}", maxError, maxErrorVal, maxErrorVal2,
-             maxErrorVal3);
+        vlog("\t%8.2f @ {%a, %a, %a}", test_info.maxError,
+             test_info.maxErrorVal, test_info.maxErrorVal2,
+             test_info.maxErrorVal3);
     }
 
     vlog("\n");
 
+    timing.Passed();
+
     return CL_SUCCESS;
 }
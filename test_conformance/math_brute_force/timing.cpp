@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "timing.h"
+#include "function_list.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+std::string gTimingReportPath;
+
+namespace {
+
+const char *const phaseNames[(int)Phase::Count] = {
+    "build", "fill", "enqueue", "reference", "map", "verify"
+};
+
+struct TimingRecord
+{
+    std::string name;
+    std::string typeName;
+    bool relaxedMode;
+    // Whether the phases were timed, or only the whole test.
+    bool timed;
+    bool passed;
+    cl_uint threadCount;
+    double wallSeconds;
+    double runSeconds;
+    PhaseTimes times;
+};
+
+std::mutex recordsMutex;
+std::vector<TimingRecord> records;
+size_t recordCount = 0;
+
+double Seconds(uint64_t ns) { return ns * 1e-9; }
+
+double PhaseSeconds(const PhaseTimes &times, Phase phase)
+{
+    uint64_t ns = 0;
+    for (int j = 0; j <= VECTOR_SIZE_COUNT; j++) ns += times.ns[(int)phase][j];
+    return Seconds(ns);
+}
+
+double ValuesPerSecond(const TimingRecord &record)
+{
+    return record.runSeconds > 0.0 ? record.times.values / record.runSeconds
+                                   : 0.0;
+}
+
+// Fraction of the time the workers spent in the phases of the jobs while they
+// ran, the rest being spent waiting on each other or on the thread pool.
+double ThreadUtilization(const TimingRecord &record)
+{
+    double busy = 0.0;
+    for (int i = 0; i < (int)Phase::Count; i++)
+    {
+        if (i != (int)Phase::Build)
+            busy += PhaseSeconds(record.times, (Phase)i);
+    }
+    double available = record.runSeconds * record.threadCount;
+    return available > 0.0 ? busy / available : 0.0;
+}
+
+// Name of the vector size of index j of PhaseTimes::ns, "all" for phases not
+// specific to a vector size.
+std::string VectorSizeName(int j)
+{
+    return j < VECTOR_SIZE_COUNT ? std::to_string(sizeValues[j]) : "all";
+}
+
+void WriteCSV(FILE *file)
+{
+    fprintf(file,
+            "function,type,relaxed,timed,passed,threads,wall_seconds,"
+            "run_seconds,values,values_per_second,thread_utilization,phase,"
+            "vector_size,seconds\n");
+    for (const TimingRecord &record : records)
+    {
+        // An untimed test has a single row without phase.
+        if (!record.timed)
+            fprintf(file, "%s,%s,%d,0,%d,,%.6f,,,,,,,\n",
+                    record.name.c_str(), record.typeName.c_str(),
+                    record.relaxedMode, record.passed, record.wallSeconds);
+
+        for (int i = 0; i < (int)Phase::Count; i++)
+        {
+            for (int j = 0; j <= VECTOR_SIZE_COUNT; j++)
+            {
+                if (record.times.ns[i][j] == 0) continue;
+                fprintf(file,
+                        "%s,%s,%d,1,%d,%u,%.6f,%.6f,%llu,%.6g,%.4f,%s,%s,"
+                        "%.6f\n",
+                        record.name.c_str(), record.typeName.c_str(),
+                        record.relaxedMode, record.passed, record.threadCount,
+                        record.wallSeconds, record.runSeconds,
+                        (unsigned long long)record.times.values,
+                        ValuesPerSecond(record), ThreadUtilization(record),
+                        phaseNames[i], VectorSizeName(j).c_str(),
+                        Seconds(record.times.ns[i][j]));
+            }
+        }
+    }
+}
+
+void WriteJSON(FILE *file)
+{
+    fprintf(file, "{\n  \"functions\": [");
+    const char *separator = "\n";
+    for (const TimingRecord &record : records)
+    {
+        fprintf(file,
+                "%s    {\n"
+                "      \"function\": \"%s\",\n"
+                "      \"type\": \"%s\",\n"
+                "      \"relaxed\": %s,\n"
+                "      \"timed\": %s,\n"
+                "      \"passed\": %s,\n"
+                "      \"wall_seconds\": %.6f",
+                separator, record.name.c_str(), record.typeName.c_str(),
+                record.relaxedMode ? "true" : "false",
+                record.timed ? "true" : "false",
+                record.passed ? "true" : "false", record.wallSeconds);
+        separator = ",\n";
+        if (!record.timed)
+        {
+            fprintf(file, "\n    }");
+            continue;
+        }
+
+        fprintf(file,
+                ",\n"
+                "      \"threads\": %u,\n"
+                "      \"run_seconds\": %.6f,\n"
+                "      \"values\": %llu,\n"
+                "      \"values_per_second\": %.6g,\n"
+                "      \"thread_utilization\": %.4f,\n"
+                "      \"phases\": {",
+                record.threadCount, record.runSeconds,
+                (unsigned long long)record.times.values,
+                ValuesPerSecond(record), ThreadUtilization(record));
+
+        const char *phaseSeparator = "\n";
+        for (int i = 0; i < (int)Phase::Count; i++)
+        {
+            fprintf(file, "%s        \"%s\": { \"seconds\": %.6f",
+                    phaseSeparator, phaseNames[i],
+                    PhaseSeconds(record.times, (Phase)i));
+            for (int j = 0; j < VECTOR_SIZE_COUNT; j++)
+            {
+                if (record.times.ns[i][j] == 0) continue;
+                fprintf(file, ", \"%d\": %.6f", sizeValues[j],
+                        Seconds(record.times.ns[i][j]));
+            }
+            fprintf(file, " }");
+            phaseSeparator = ",\n";
+        }
+        fprintf(file, "\n      }\n    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+// Rewrite the whole report, so that it is complete even if a later test
+// crashes.
+void WriteReport()
+{
+    FILE *file = fopen(gTimingReportPath.c_str(), "w");
+    if (file == NULL)
+    {
+        vlog_error("Unable to write timing report %s (%s).\n",
+                   gTimingReportPath.c_str(), strerror(errno));
+        return;
+    }
+
+    size_t length = gTimingReportPath.size();
+    if (length >= 4 && gTimingReportPath.compare(length - 4, 4, ".csv") == 0)
+        WriteCSV(file);
+    else
+        WriteJSON(file);
+
+    if (fclose(file) != 0)
+        vlog_error("Unable to write timing report %s (%s).\n",
+                   gTimingReportPath.c_str(), strerror(errno));
+}
+
+
+// Count the record, and add it to the report if there is one.
+void AddRecord(const TimingRecord &record)
+{
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    recordCount++;
+    if (gTimingReportPath.empty()) return;
+    records.push_back(record);
+    WriteReport();
+}
+
+} // anonymous namespace
+
+void PhaseTimes::Add(const PhaseTimes &other)
+{
+    for (int i = 0; i < (int)Phase::Count; i++)
+        for (int j = 0; j <= VECTOR_SIZE_COUNT; j++) ns[i][j] += other.ns[i][j];
+    values += other.values;
+}
+
+FunctionTiming::FunctionTiming(const Func *f, const char *typeName,
+                               bool relaxedMode, cl_uint threadCount)
+    : name(f->name), typeName(typeName), relaxedMode(relaxedMode),
+      threadCount(threadCount), start(std::chrono::steady_clock::now()),
+      runStart(start)
+{}
+
+void FunctionTiming::BuildDone()
+{
+    if (!IsTimingEnabled()) return;
+    runStart = std::chrono::steady_clock::now();
+    times.ns[(int)Phase::Build][VECTOR_SIZE_COUNT] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(runStart - start)
+            .count();
+}
+
+FunctionTiming::~FunctionTiming()
+{
+    if (!IsTimingEnabled()) return;
+    collect(times);
+
+    auto end = std::chrono::steady_clock::now();
+    TimingRecord record;
+    record.name = name;
+    record.typeName = typeName;
+    record.relaxedMode = relaxedMode;
+    record.timed = true;
+    record.passed = passed;
+    record.threadCount = threadCount;
+    record.wallSeconds = std::chrono::duration<double>(end - start).count();
+    record.runSeconds = std::chrono::duration<double>(end - runStart).count();
+    record.times = times;
+
+    if (gVerboseBruteForce)
+    {
+        vlog("\t%s timing:", name.c_str());
+        for (int i = 0; i < (int)Phase::Count; i++)
+            vlog(" %s %.2fs", phaseNames[i], PhaseSeconds(times, (Phase)i));
+        vlog(", %.3g values/s, %.0f%% busy\n", ValuesPerSecond(record),
+             100.0 * ThreadUtilization(record));
+    }
+
+    AddRecord(record);
+}
+
+void RecordUntimedTest(const Func *f, const char *typeName, bool relaxedMode,
+                       size_t timingRecords, double seconds, bool passed)
+{
+    if (gTimingReportPath.empty() || TimingRecordCount() != timingRecords)
+        return;
+
+    TimingRecord record{};
+    record.name = f->name;
+    record.typeName = typeName;
+    record.relaxedMode = relaxedMode;
+    record.timed = false;
+    record.passed = passed;
+    record.wallSeconds = seconds;
+    AddRecord(record);
+}
+
+size_t TimingRecordCount()
+{
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    return recordCount;
+}
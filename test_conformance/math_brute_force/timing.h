@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef TIMING_H
+#define TIMING_H
+
+#include "utility.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// File the timing report is written to, empty if there is no report.  The
+// report is CSV if the name ends in ".csv" and JSON otherwise.
+extern std::string gTimingReportPath;
+
+// Phases of the jobs of a test.
+enum class Phase
+{
+    Build, // building the kernels
+    Fill, // writing the inputs and clearing the outputs
+    Enqueue, // setting up and enqueuing the kernels
+    Reference, // computing the reference results
+    Map, // mapping the results, which waits for the kernels
+    Verify, // comparing the results to the reference
+    Count
+};
+
+// Whether phases are timed, which is the case with -v or a timing report.
+inline bool IsTimingEnabled()
+{
+    return gVerboseBruteForce || !gTimingReportPath.empty();
+}
+
+// Time spent in each phase by a worker, in nanoseconds.  Phases of a single
+// vector size are counted under that size, others under VECTOR_SIZE_COUNT.
+struct PhaseTimes
+{
+    uint64_t ns[(int)Phase::Count][VECTOR_SIZE_COUNT + 1] = {};
+
+    // Number of inputs tested.
+    uint64_t values = 0;
+
+    void Add(const PhaseTimes &other);
+};
+
+// Splits the time of a worker into phases: each call to Lap adds the time
+// since the previous one, or since construction, to a phase.  Does nothing if
+// timing is disabled.
+class PhaseClock {
+public:
+    explicit PhaseClock(PhaseTimes &times)
+        : times(IsTimingEnabled() ? &times : nullptr)
+    {
+        if (this->times) last = std::chrono::steady_clock::now();
+    }
+
+    void Lap(Phase phase, int vectorSizeIndex = VECTOR_SIZE_COUNT)
+    {
+        if (!times) return;
+        auto now = std::chrono::steady_clock::now();
+        times->ns[(int)phase][vectorSizeIndex] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - last)
+                .count();
+        last = now;
+    }
+
+private:
+    PhaseTimes *times;
+    std::chrono::steady_clock::time_point last;
+};
+
+// Timing of the test of a function on a type by an instrumented driver.  The
+// phase times of the workers are added when the test ends, and the test is
+// then logged with -v and appended to the timing report, also when the test
+// fails and returns early.
+class FunctionTiming {
+public:
+    template <typename ThreadInfo>
+    FunctionTiming(const Func *f, const char *typeName, bool relaxedMode,
+                   const std::vector<ThreadInfo> &tinfo, cl_uint threadCount)
+        : FunctionTiming(f, typeName, relaxedMode, threadCount)
+    {
+        collect = [&tinfo](PhaseTimes &times) {
+            for (const ThreadInfo &info : tinfo) times.Add(info.times);
+        };
+    }
+    ~FunctionTiming();
+
+    // Time of the kernel build, to be called once the kernels are built.
+    void BuildDone();
+
+    // Record that the test passed, to be called before it returns success.
+    void Passed() { passed = true; }
+
+private:
+    FunctionTiming(const Func *f, const char *typeName, bool relaxedMode,
+                   cl_uint threadCount);
+
+    std::string name;
+    const char *typeName;
+    bool relaxedMode;
+    cl_uint threadCount;
+    bool passed = false;
+    std::function<void(PhaseTimes &)> collect;
+    PhaseTimes times;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point runStart;
+};
+
+// Record the test of a function on a type by a driver that isn't
+// instrumented, with only its duration, so that the report lists every test
+// run.  Does nothing if the driver recorded the test itself, i.e. if
+// timingRecords, the value of TimingRecordCount() before the test, changed.
+void RecordUntimedTest(const Func *f, const char *typeName, bool relaxedMode,
+                       size_t timingRecords, double seconds, bool passed);
+
+// Number of tests recorded so far.
+size_t TimingRecordCount();
+
+#endif /* TIMING_H */
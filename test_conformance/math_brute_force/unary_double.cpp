@@ -67,6 +67,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     int ftz = job->ftz;
     bool relaxedMode = job->relaxedMode;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     Force64BitFPUPrecision();
 
     cl_event e[VECTOR_SIZE_COUNT];
@@ -196,7 +198,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     // Verify data
     cl_ulong *t = (cl_ulong *)r;
-    for (size_t j = 0; j < buffer_elements; j++)
+    FindMismatches(t, out, buffer_elements, tinfo->mismatches);
+    for (auto j : tinfo->mismatches)
     {
         for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
@@ -277,6 +280,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -370,6 +375,8 @@ int TestFunc_Double_Double(const Func *f, MTdata d, bool relaxedMode)
 
     test_info.isRangeLimited = 0;
 
+    InitJobs(test_info, "double", test_info.threadCount);
+
     // Init the kernels
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs, f->nameInCode,
@@ -394,6 +401,8 @@ int TestFunc_Double_Double(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal = test_info.tinfo[i].maxErrorValue;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
@@ -16,10 +16,15 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "reference_cache.h"
 #include "test_functions.h"
 #include "utility.h"
 
+#include "harness/crc32.h"
+
 #include <cstring>
+#include <memory>
+#include <vector>
 
 namespace {
 
@@ -48,22 +53,60 @@ struct TestInfo : public TestInfoBase
     // k[vector_size][thread_id]
     KernelMatrix k;
 
-    // Array of thread specific information
+    // Array of slot specific information, see RunPipelined
     std::vector<ThreadInfoUnary> tinfo;
+
+    // Cached reference results, NULL if not caching.
+    std::unique_ptr<ReferenceCache> refCache;
 };
 
-cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
+// Checksum of the reference results for a sample of the inputs, used to tell
+// whether cached reference results are still valid.
+uint32_t ReferenceFingerprint(const Func *f, bool relaxedMode)
+{
+    fptr func = relaxedMode ? f->rfunc : f->func;
+    std::vector<float> results;
+    for (float value : getFloatSpecialValues())
+        results.push_back((float)func.f_f(value));
+    for (uint64_t i = 0; i < (1ULL << 32); i += 0x10001)
+    {
+        cl_uint bits = (cl_uint)i;
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        results.push_back((float)func.f_f(value));
+    }
+    return crc32(results.data(), results.size() * sizeof(float));
+}
+
+// Replace inputs outside of the relaxed mode domain of the function with NaN.
+template <RelaxedPolicy policy> void LimitRelaxedDomain(float &x)
+{
+    if constexpr (policy == RelaxedPolicy::SinCos)
+    {
+        // the domain of the function is [-pi,pi]
+        if (fabs(x) > M_PI) x = NAN;
+    }
+    else if constexpr (policy == RelaxedPolicy::Reciprocal)
+    {
+        const float l_limit = HEX_FLT(+, 1, 0, -, 126);
+        const float u_limit = HEX_FLT(+, 1, 0, +, 126);
+
+        // the domain of the function is [2^-126,2^126]
+        if (fabs(x) < l_limit || fabs(x) > u_limit) x = NAN;
+    }
+}
+
+template <RelaxedPolicy policy>
+cl_int Submit(cl_uint job_id, cl_uint thread_id, cl_uint slot, void *data)
 {
     TestInfo *job = (TestInfo *)data;
     size_t buffer_elements = job->subBufferSize;
     size_t buffer_size = buffer_elements * sizeof(cl_float);
     cl_uint scale = job->scale;
     cl_uint base = job_id * (cl_uint)job->step;
-    ThreadInfoUnary *tinfo = &(job->tinfo[thread_id]);
+    ThreadInfoUnary *tinfo = &(job->tinfo[slot]);
     fptr func = job->f->func;
-    const char *fname = job->f->name;
     bool relaxedMode = job->relaxedMode;
-    float ulps = getAllowedUlpError(job->f, kfloat, relaxedMode);
     if (relaxedMode)
     {
         func = job->f->rfunc;
@@ -71,9 +114,9 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     cl_int error;
 
-    int isRangeLimited = job->isRangeLimited;
-    float half_sin_cos_tan_limit = job->half_sin_cos_tan_limit;
-    int ftz = job->ftz;
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
+    PhaseClock clock(tinfo->times);
 
     cl_event e[VECTOR_SIZE_COUNT];
     cl_uint *out[VECTOR_SIZE_COUNT];
@@ -98,31 +141,11 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     // Write the new values to the input array
-    cl_uint *p = (cl_uint *)gIn + thread_id * buffer_elements;
+    cl_uint *p = (cl_uint *)gIn + slot * buffer_elements;
     for (size_t j = 0; j < buffer_elements; j++)
     {
         p[j] = base + j * scale;
-        if (relaxedMode)
-        {
-            float p_j = *(float *)&p[j];
-            if (strcmp(fname, "sin") == 0
-                || strcmp(fname, "cos")
-                    == 0) // the domain of the function is [-pi,pi]
-            {
-                if (fabs(p_j) > M_PI) ((float *)p)[j] = NAN;
-            }
-
-            if (strcmp(fname, "reciprocal") == 0)
-            {
-                const float l_limit = HEX_FLT(+, 1, 0, -, 126);
-                const float u_limit = HEX_FLT(+, 1, 0, +, 126);
-
-                if (fabs(p_j) < l_limit
-                    || fabs(p_j) > u_limit) // the domain of the function is
-                                            // [2^-126,2^126]
-                    ((float *)p)[j] = NAN;
-            }
-        }
+        if (relaxedMode) LimitRelaxedDomain<policy>(((float *)p)[j]);
     }
 
     if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
@@ -131,6 +154,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
     }
+    clock.Lap(Phase::Fill);
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
@@ -175,6 +199,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        clock.Lap(Phase::Fill, j);
+
         // Run the kernel
         size_t vectorCount =
             (buffer_elements + sizeValues[j] - 1) / sizeValues[j];
@@ -193,20 +219,68 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             vlog_error("FAILED -- could not execute kernel\n");
             return error;
         }
+        clock.Lap(Phase::Enqueue, j);
     }
 
     // Get that moving
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 2 failed\n");
+    clock.Lap(Phase::Enqueue);
 
     if (gSkipCorrectnessTesting) return CL_SUCCESS;
 
     // Calculate the correctly rounded reference result
-    float *r = (float *)gOut_Ref + thread_id * buffer_elements;
+    float *r = (float *)gOut_Ref + slot * buffer_elements;
     float *s = (float *)p;
-    for (size_t j = 0; j < buffer_elements; j++) r[j] = (float)func.f_f(s[j]);
+    if (!job->refCache || !job->refCache->Read(base, buffer_elements, r))
+    {
+        bptr bfunc = GetBatchReference(job->f, relaxedMode);
+        if (bfunc.p)
+            bfunc.f_f(s, r, buffer_elements);
+        else
+            for (size_t j = 0; j < buffer_elements; j++)
+                r[j] = (float)func.f_f(s[j]);
+        if (job->refCache) job->refCache->Write(base, buffer_elements, r);
+    }
+    clock.Lap(Phase::Reference);
+
+    return CL_SUCCESS;
+}
+
+template <RelaxedPolicy policy>
+cl_int Complete(cl_uint job_id, cl_uint thread_id UNUSED, cl_uint slot,
+                void *data)
+{
+    TestInfo *job = (TestInfo *)data;
+    size_t buffer_elements = job->subBufferSize;
+    size_t buffer_size = buffer_elements * sizeof(cl_float);
+    cl_uint base = job_id * (cl_uint)job->step;
+    ThreadInfoUnary *tinfo = &(job->tinfo[slot]);
+    fptr func = job->f->func;
+    bool relaxedMode = job->relaxedMode;
+    float ulps = getAllowedUlpError(job->f, kfloat, relaxedMode);
+    if (relaxedMode)
+    {
+        func = job->f->rfunc;
+    }
+
+    cl_int error;
+
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
+    int isRangeLimited = job->isRangeLimited;
+    float half_sin_cos_tan_limit = job->half_sin_cos_tan_limit;
+    int ftz = job->ftz;
+
+    if (gSkipCorrectnessTesting) return CL_SUCCESS;
+
+    float *r = (float *)gOut_Ref + slot * buffer_elements;
+    float *s = (float *)gIn + slot * buffer_elements;
+
+    PhaseClock clock(tinfo->times);
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
+    cl_uint *out[VECTOR_SIZE_COUNT];
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
         cl_bool blocking = (j + 1 < gMaxVectorSizeIndex) ? CL_FALSE : CL_TRUE;
@@ -219,11 +293,13 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                        error);
             return error;
         }
+        clock.Lap(Phase::Map, j);
     }
 
     // Verify data
     uint32_t *t = (uint32_t *)r;
-    for (size_t j = 0; j < buffer_elements; j++)
+    FindMismatches(t, out, buffer_elements, tinfo->mismatches);
+    for (auto j : tinfo->mismatches)
     {
         for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
@@ -248,13 +324,12 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                 }
                 else if (relaxedMode)
                 {
-                    if (strcmp(fname, "sin") == 0 || strcmp(fname, "cos") == 0)
+                    if constexpr (policy == RelaxedPolicy::SinCos)
                     {
                         fail = !(fabsf(abs_error) <= ulps);
                         use_abs_error = 1;
                     }
-                    if (strcmp(fname, "sinpi") == 0
-                        || strcmp(fname, "cospi") == 0)
+                    else if constexpr (policy == RelaxedPolicy::SinCosPi)
                     {
                         if (s[j] >= -1.0 && s[j] <= 1.0)
                         {
@@ -262,28 +337,16 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                             use_abs_error = 1;
                         }
                     }
-
-                    if (strcmp(fname, "reciprocal") == 0)
+                    else if constexpr (policy == RelaxedPolicy::Reciprocal)
                     {
                         fail = !(fabsf(err) <= ulps);
                     }
-
-                    if (strcmp(fname, "exp") == 0 || strcmp(fname, "exp2") == 0)
+                    else if constexpr (policy == RelaxedPolicy::Exp)
                     {
                         ulps += floor(fabs(2 * s[j]));
                         fail = !(fabsf(err) <= ulps);
                     }
-                    if (strcmp(fname, "tan") == 0)
-                    {
-
-                        if (!gFastRelaxedDerived)
-                        {
-                            fail = !(fabsf(err) <= ulps);
-                        }
-                        // Else fast math derived implementation does not
-                        // require ULP verification
-                    }
-                    if (strcmp(fname, "exp10") == 0)
+                    else if constexpr (policy == RelaxedPolicy::Derived)
                     {
                         if (!gFastRelaxedDerived)
                         {
@@ -292,8 +355,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
                         // Else fast math derived implementation does not
                         // require ULP verification
                     }
-                    if (strcmp(fname, "log") == 0 || strcmp(fname, "log2") == 0
-                        || strcmp(fname, "log10") == 0)
+                    else if constexpr (policy == RelaxedPolicy::Log)
                     {
                         if (s[j] >= 0.5 && s[j] <= 2)
                         {
@@ -412,6 +474,8 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
+    clock.Lap(Phase::Verify);
+
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
         if ((error = clEnqueueUnmapMemObject(tinfo->tQueue, tinfo->outBuf[j],
@@ -424,7 +488,11 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
+    clock.Lap(Phase::Map);
+    tinfo->times.values += buffer_elements;
+
 
+    MarkJobDone(*job, job_id, slot, *tinfo);
 
     if (0 == (base & 0x0fffffff))
     {
@@ -445,6 +513,32 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     return CL_SUCCESS;
 }
 
+// Select the instantiation of the test stages for the function's relaxed mode
+// policy.
+template <RelaxedPolicy policy> PipelineStages MakeStages()
+{
+    return { Submit<policy>, Complete<policy> };
+}
+
+PipelineStages GetTestStages(const Func *f, bool relaxedMode)
+{
+    if (!relaxedMode) return MakeStages<RelaxedPolicy::Unchecked>();
+
+    switch (f->relaxed_policy)
+    {
+        case RelaxedPolicy::SinCos: return MakeStages<RelaxedPolicy::SinCos>();
+        case RelaxedPolicy::SinCosPi:
+            return MakeStages<RelaxedPolicy::SinCosPi>();
+        case RelaxedPolicy::Reciprocal:
+            return MakeStages<RelaxedPolicy::Reciprocal>();
+        case RelaxedPolicy::Exp: return MakeStages<RelaxedPolicy::Exp>();
+        case RelaxedPolicy::Derived:
+            return MakeStages<RelaxedPolicy::Derived>();
+        case RelaxedPolicy::Log: return MakeStages<RelaxedPolicy::Log>();
+        default: return MakeStages<RelaxedPolicy::Unchecked>();
+    }
+}
+
 } // anonymous namespace
 
 int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
@@ -458,8 +552,9 @@ int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
     // Init test_info
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
-        / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
+    cl_uint slotCount = GetPipelineSlotCount(test_info.threadCount);
+    test_info.subBufferSize =
+        BUFFER_SIZE / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(slotCount));
     test_info.scale = getTestScale(sizeof(cl_float));
 
     test_info.step = (cl_uint)test_info.subBufferSize * test_info.scale;
@@ -478,8 +573,8 @@ int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
     test_info.ftz =
         f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
     test_info.relaxedMode = relaxedMode;
-    test_info.tinfo.resize(test_info.threadCount);
-    for (cl_uint i = 0; i < test_info.threadCount; i++)
+    test_info.tinfo.resize(slotCount);
+    for (cl_uint i = 0; i < slotCount; i++)
     {
         cl_buffer_region region = {
             i * test_info.subBufferSize * sizeof(cl_float),
@@ -536,9 +631,25 @@ int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             INFINITY; // out of range resut from finite inputs must be numeric
     }
 
+    // Reference results can only be cached when every input is tested, as
+    // the cache is indexed by the input value.
+    if (!gReferenceCachePath.empty() && test_info.scale == 1
+        && !gSkipCorrectnessTesting)
+    {
+        std::string key = std::string(f->name) + "_float";
+        if (relaxedMode) key += "_relaxed";
+        if (test_info.ftz) key += "_ftz";
+        test_info.refCache = ReferenceCache::Open(
+            key, ReferenceFingerprint(f, relaxedMode), sizeof(cl_float));
+    }
+
     bool correctlyRounded = strcmp(f->name, "sqrt_cr") == 0;
 
+    InitJobs(test_info, "float", slotCount);
+
     // Init the kernels
+    FunctionTiming timing(f, "float", relaxedMode, test_info.tinfo,
+                          test_info.threadCount);
     BuildKernelInfo build_info{ test_info.threadCount, test_info.k,
                                 test_info.programs,    f->nameInCode,
                                 relaxedMode,           correctlyRounded };
@@ -546,15 +657,18 @@ int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                gMaxVectorSizeIndex - gMinVectorSizeIndex,
                                &build_info)))
         return error;
+    timing.BuildDone();
 
     // Run the kernels
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(Test, test_info.jobCount, &test_info);
+        error = RunPipelined(GetTestStages(f, relaxedMode),
+                             test_info.threadCount, test_info.jobCount,
+                             &test_info);
         if (error) return error;
 
         // Accumulate the arithmetic errors
-        for (cl_uint i = 0; i < test_info.threadCount; i++)
+        for (cl_uint i = 0; i < slotCount; i++)
         {
             if (test_info.tinfo[i].maxError > maxError)
             {
@@ -562,6 +676,8 @@ int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal = test_info.tinfo[i].maxErrorValue;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal);
+        CompleteJobs(test_info);
 
         if (gWimpyMode)
             vlog("Wimp pass");
@@ -573,5 +689,7 @@ int TestFunc_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
     vlog("\n");
 
+    timing.Passed();
+
     return CL_SUCCESS;
 }
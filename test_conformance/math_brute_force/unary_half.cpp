@@ -65,12 +65,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     cl_uint j, k;
     cl_int error = CL_SUCCESS;
 
+    if (SkipJob(*job, job_id, base)) return CL_SUCCESS;
+
     int isRangeLimited = job->isRangeLimited;
     float half_sin_cos_tan_limit = job->half_sin_cos_tan_limit;
 
     int ftz = job->ftz;
 
-    std::vector<float> s(0);
+    std::vector<float> s(0), ref(0);
 
     cl_event e[VECTOR_SIZE_COUNT];
     cl_ushort *out[VECTOR_SIZE_COUNT];
@@ -173,11 +175,13 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     // Calculate the correctly rounded reference result
     cl_half *r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
     s.resize(buffer_elements);
+    ref.resize(buffer_elements);
     for (j = 0; j < buffer_elements; j++)
     {
         s[j] = (float)cl_half_to_float(p[j]);
-        r[j] = HFF(func.f_f(s[j]));
+        ref[j] = func.f_f(s[j]);
     }
+    half_from_float_array(r, ref.data(), buffer_elements, gHalfRoundingMode);
 
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
@@ -204,7 +208,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     }
 
     // Verify data
-    for (j = 0; j < buffer_elements; j++)
+    FindMismatches(r, out, buffer_elements, tinfo->mismatches);
+    for (auto j : tinfo->mismatches)
     {
         for (k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
@@ -301,6 +306,8 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     if ((error = clFlush(tinfo->tQueue))) vlog("clFlush 3 failed\n");
 
 
+    if (error == CL_SUCCESS) MarkJobDone(*job, job_id, thread_id, *tinfo);
+
     if (0 == (base & 0x0fffffff))
     {
         if (gVerboseBruteForce)
@@ -415,6 +422,8 @@ int TestFunc_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             INFINITY; // out of range resut from finite inputs must be numeric
     }
 
+    InitJobs(test_info, "half", test_info.threadCount);
+
     // Init the kernels
     {
         BuildKernelInfo build_info = { test_info.threadCount, test_info.k,
@@ -438,6 +447,8 @@ int TestFunc_Half_Half(const Func *f, MTdata d, bool relaxedMode)
                 maxErrorVal = test_info.tinfo[i].maxErrorValue;
             }
         }
+        MergeResumedMaxError(test_info, maxError, maxErrorVal);
+        CompleteJobs(test_info);
 
         test_error(error, "ThreadPool_Do: TestHalf failed\n");
 
@@ -17,6 +17,7 @@
 #include "common.h"
 #include "function_list.h"
 #include "test_functions.h"
+#include "timing.h"
 #include "utility.h"
 
 #include <cinttypes>
@@ -36,461 +37,609 @@ cl_int BuildKernelFn(cl_uint job_id, cl_uint thread_id UNUSED, void *p)
     return BuildKernels(info, job_id, generator);
 }
 
-} // anonymous namespace
+// Slot specific data, see RunPipelined.
+struct ThreadInfo
+{
+    // Input and output buffers for the slot.
+    clMemWrapper inBuf;
+    Buffers outBuf;
+    Buffers outBuf2;
+
+    // Per slot command queue, so that waiting for the results of a job
+    // doesn't wait for the jobs submitted after it.
+    clCommandQueueWrapper tQueue;
+
+    PhaseTimes times;
+};
 
-int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
+struct TestInfo
 {
-    int error;
+    const Func *f;
+    bool relaxedMode;
+    int ftz;
+    int isFract;
+    int skipNanInf;
+    bool limitDomain;
+    float float_ulps;
+
+    // Distance between the bases of consecutive fills of the whole buffer.
+    // Each fill is split in gPipelineDepth jobs.
+    uint64_t step;
+
+    // Stride between the inputs in wimpy mode.
+    int scale;
+
+    // Number of elements tested by a job.
+    size_t bufferElements;
+
     Programs programs;
-    const unsigned thread_id = 0; // Test is currently not multithreaded.
     KernelMatrix kernels;
-    float maxError0 = 0.0f;
-    float maxError1 = 0.0f;
-    int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
-    float maxErrorVal0 = 0.0f;
-    float maxErrorVal1 = 0.0f;
-    uint64_t step = getTestStep(sizeof(float), BUFFER_SIZE);
-    int scale = (int)((1ULL << 32) / (16 * BUFFER_SIZE / sizeof(float)) + 1);
-    std::vector<cl_uchar> overflow(BUFFER_SIZE / sizeof(float));
-    int isFract = 0 == strcmp("fract", f->nameInCode);
-    int skipNanInf = isFract && !gInfNanSupport;
 
-    logFunctionInfo(f->name, sizeof(cl_float), relaxedMode);
+    // Array of slot specific information.
+    std::vector<ThreadInfo> tinfo;
 
-    float float_ulps = getAllowedUlpError(f, kfloat, relaxedMode);
-    // Init the kernels
-    BuildKernelInfo build_info{ 1, kernels, programs, f->nameInCode,
-                                relaxedMode };
-    if ((error = ThreadPool_Do(BuildKernelFn,
-                               gMaxVectorSizeIndex - gMinVectorSizeIndex,
-                               &build_info)))
-        return error;
+    // Overflow flags of the reference results, for all slots.
+    std::vector<cl_uchar> overflow;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
-    {
-        if (gSkipCorrectnessTesting) break;
+    float maxError0;
+    float maxError1;
+    float maxErrorVal0;
+    float maxErrorVal1;
+};
 
-        // Init input array
-        uint32_t *p = (uint32_t *)gIn;
-        if (gWimpyMode)
-        {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-            {
-                p[j] = (uint32_t)i + j * scale;
-                if (relaxedMode && strcmp(f->name, "sincos") == 0)
-                {
-                    float pj = *(float *)&p[j];
-                    if (fabs(pj) > M_PI) ((float *)p)[j] = NAN;
-                }
-            }
-        }
-        else
+cl_int Submit(cl_uint job_id, cl_uint thread_id, cl_uint slot, void *data)
+{
+    TestInfo *job = (TestInfo *)data;
+    const Func *f = job->f;
+    size_t buffer_elements = job->bufferElements;
+    size_t buffer_size = buffer_elements * sizeof(cl_float);
+    ThreadInfo *tinfo = &(job->tinfo[slot]);
+    cl_uchar *overflow = job->overflow.data() + slot * buffer_elements;
+    bool relaxedMode = job->relaxedMode;
+    int ftz = job->ftz;
+    int isFract = job->isFract;
+    cl_int error;
+    PhaseClock clock(tinfo->times);
+
+    // Init input array
+    uint64_t i = (job_id / gPipelineDepth) * job->step;
+    size_t first = (job_id % gPipelineDepth) * buffer_elements;
+    uint32_t *p = (uint32_t *)gIn + slot * buffer_elements;
+    int scale = gWimpyMode ? job->scale : 1;
+    for (size_t j = 0; j < buffer_elements; j++)
+    {
+        p[j] = (uint32_t)i + (uint32_t)(first + j) * scale;
+        if (job->limitDomain)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-            {
-                p[j] = (uint32_t)i + j;
-                if (relaxedMode && strcmp(f->name, "sincos") == 0)
-                {
-                    float pj = *(float *)&p[j];
-                    if (fabs(pj) > M_PI) ((float *)p)[j] = NAN;
-                }
-            }
+            float pj = *(float *)&p[j];
+            if (fabs(pj) > M_PI) ((float *)p)[j] = NAN;
         }
+    }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
-        {
-            vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
-            return error;
-        }
+    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+                                      buffer_size, p, 0, NULL, NULL)))
+    {
+        vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
+        return error;
+    }
+    clock.Lap(Phase::Fill);
 
-        // Write garbage into output arrays
-        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    // Write garbage into output arrays
+    for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    {
+        uint32_t pattern = 0xffffdead;
+        if (gHostFill)
         {
-            uint32_t pattern = 0xffffdead;
-            if (gHostFill)
+            cl_uint *out = (cl_uint *)gOut[j] + slot * buffer_elements;
+            memset_pattern4(out, &pattern, buffer_size);
+            if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->outBuf[j],
+                                              CL_FALSE, 0, buffer_size, out, 0,
+                                              NULL, NULL)))
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
-                                                  gOut[j], 0, NULL, NULL)))
-                {
-                    vlog_error(
-                        "\n*** Error %d in clEnqueueWriteBuffer2(%d) ***\n",
-                        error, j);
-                    return error;
-                }
-
-                memset_pattern4(gOut2[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
-                                                  gOut2[j], 0, NULL, NULL)))
-                {
-                    vlog_error(
-                        "\n*** Error %d in clEnqueueWriteBuffer2b(%d) ***\n",
-                        error, j);
-                    return error;
-                }
+                vlog_error("\n*** Error %d in clEnqueueWriteBuffer2(%d) ***\n",
+                           error, j);
+                return error;
             }
-            else
-            {
-                if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
-                                                 &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
-                {
-                    vlog_error("Error: clEnqueueFillBuffer 1 failed! err: %d\n",
-                               error);
-                    return error;
-                }
 
-                if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
-                                                 &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
-                {
-                    vlog_error("Error: clEnqueueFillBuffer 2 failed! err: %d\n",
-                               error);
-                    return error;
-                }
+            cl_uint *out2 = (cl_uint *)gOut2[j] + slot * buffer_elements;
+            memset_pattern4(out2, &pattern, buffer_size);
+            if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->outBuf2[j],
+                                              CL_FALSE, 0, buffer_size, out2,
+                                              0, NULL, NULL)))
+            {
+                vlog_error("\n*** Error %d in clEnqueueWriteBuffer2b(%d) ***\n",
+                           error, j);
+                return error;
             }
         }
-
-        // Run the kernels
-        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+        else
         {
-            size_t vectorSize = sizeValues[j] * sizeof(cl_float);
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1) / vectorSize;
-            error = clSetKernelArg(kernels[j][thread_id], 0,
-                                   sizeof(gOutBuffer[j]), &gOutBuffer[j]);
-            test_error(error, "Failed to set kernel argument");
-            error = clSetKernelArg(kernels[j][thread_id], 1,
-                                   sizeof(gOutBuffer2[j]), &gOutBuffer2[j]);
-            test_error(error, "Failed to set kernel argument");
-            error = clSetKernelArg(kernels[j][thread_id], 2, sizeof(gInBuffer),
-                                   &gInBuffer);
-            test_error(error, "Failed to set kernel argument");
-
-            if ((error = clEnqueueNDRangeKernel(gQueue, kernels[j][thread_id],
-                                                1, NULL, &localCount, NULL, 0,
-                                                NULL, NULL)))
+            if ((error = clEnqueueFillBuffer(tinfo->tQueue, tinfo->outBuf[j],
+                                             &pattern, sizeof(pattern), 0,
+                                             buffer_size, 0, NULL, NULL)))
             {
-                vlog_error("FAILED -- could not execute kernel\n");
+                vlog_error("Error: clEnqueueFillBuffer 1 failed! err: %d\n",
+                           error);
                 return error;
             }
-        }
 
-        // Get that moving
-        if ((error = clFlush(gQueue))) vlog("clFlush failed\n");
+            if ((error = clEnqueueFillBuffer(tinfo->tQueue, tinfo->outBuf2[j],
+                                             &pattern, sizeof(pattern), 0,
+                                             buffer_size, 0, NULL, NULL)))
+            {
+                vlog_error("Error: clEnqueueFillBuffer 2 failed! err: %d\n",
+                           error);
+                return error;
+            }
+        }
+        clock.Lap(Phase::Fill, j);
+    }
 
-        FPU_mode_type oldMode = 0;
-        RoundingMode oldRoundMode = kRoundToNearestEven;
-        if (isFract)
+    // Run the kernels
+    for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    {
+        size_t vectorSize = sizeValues[j] * sizeof(cl_float);
+        size_t localCount = (buffer_size + vectorSize - 1) / vectorSize;
+        cl_kernel kernel = job->kernels[j][thread_id];
+        error = clSetKernelArg(kernel, 0, sizeof(tinfo->outBuf[j]),
+                               &tinfo->outBuf[j]);
+        test_error(error, "Failed to set kernel argument");
+        error = clSetKernelArg(kernel, 1, sizeof(tinfo->outBuf2[j]),
+                               &tinfo->outBuf2[j]);
+        test_error(error, "Failed to set kernel argument");
+        error = clSetKernelArg(kernel, 2, sizeof(tinfo->inBuf), &tinfo->inBuf);
+        test_error(error, "Failed to set kernel argument");
+
+        if ((error = clEnqueueNDRangeKernel(tinfo->tQueue, kernel, 1, NULL,
+                                            &localCount, NULL, 0, NULL, NULL)))
         {
-            // Calculate the correctly rounded reference result
-            if (ftz || relaxedMode) ForceFTZ(&oldMode);
-
-            // Set the rounding mode to match the device
-            if (gIsInRTZMode)
-                oldRoundMode = set_round(kRoundTowardZero, kfloat);
+            vlog_error("FAILED -- could not execute kernel\n");
+            return error;
         }
+        clock.Lap(Phase::Enqueue, j);
+    }
+
+    // Get that moving
+    if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
+    clock.Lap(Phase::Enqueue);
 
+    FPU_mode_type oldMode = 0;
+    RoundingMode oldRoundMode = kRoundToNearestEven;
+    if (isFract)
+    {
         // Calculate the correctly rounded reference result
-        float *r = (float *)gOut_Ref;
-        float *r2 = (float *)gOut_Ref2;
-        float *s = (float *)gIn;
+        if (ftz || relaxedMode) ForceFTZ(&oldMode);
+
+        // Set the rounding mode to match the device
+        if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
+    }
 
-        if (skipNanInf)
+    // Calculate the correctly rounded reference result
+    float *r = (float *)gOut_Ref + slot * buffer_elements;
+    float *r2 = (float *)gOut_Ref2 + slot * buffer_elements;
+    float *s = (float *)p;
+
+    if (job->skipNanInf)
+    {
+        for (size_t j = 0; j < buffer_elements; j++)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-            {
-                double dd;
-                feclearexcept(FE_OVERFLOW);
+            double dd;
+            feclearexcept(FE_OVERFLOW);
 
-                if (relaxedMode)
-                    r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
-                else
-                    r[j] = (float)f->func.f_fpf(s[j], &dd);
+            if (relaxedMode)
+                r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
+            else
+                r[j] = (float)f->func.f_fpf(s[j], &dd);
 
-                r2[j] = (float)dd;
-                overflow[j] =
-                    FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
-            }
+            r2[j] = (float)dd;
+            overflow[j] =
+                FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
         }
-        else
+    }
+    else
+    {
+        for (size_t j = 0; j < buffer_elements; j++)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-            {
-                double dd;
-                if (relaxedMode)
-                    r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
-                else
-                    r[j] = (float)f->func.f_fpf(s[j], &dd);
+            double dd;
+            if (relaxedMode)
+                r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
+            else
+                r[j] = (float)f->func.f_fpf(s[j], &dd);
 
-                r2[j] = (float)dd;
-            }
+            r2[j] = (float)dd;
         }
+    }
 
-        if (isFract && ftz) RestoreFPState(&oldMode);
+    if (isFract && ftz) RestoreFPState(&oldMode);
+    if (isFract && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    clock.Lap(Phase::Reference);
 
-        // Read the data back
-        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    return CL_SUCCESS;
+}
+
+cl_int Complete(cl_uint job_id, cl_uint thread_id UNUSED, cl_uint slot,
+                void *data)
+{
+    TestInfo *job = (TestInfo *)data;
+    const Func *f = job->f;
+    size_t buffer_elements = job->bufferElements;
+    size_t buffer_size = buffer_elements * sizeof(cl_float);
+    ThreadInfo *tinfo = &(job->tinfo[slot]);
+    const cl_uchar *overflow = job->overflow.data() + slot * buffer_elements;
+    bool relaxedMode = job->relaxedMode;
+    int ftz = job->ftz;
+    int isFract = job->isFract;
+    int skipNanInf = job->skipNanInf;
+    float float_ulps = job->float_ulps;
+    cl_int error;
+    PhaseClock clock(tinfo->times);
+
+    // Read the data back
+    for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+    {
+        if ((error = clEnqueueReadBuffer(
+                 tinfo->tQueue, tinfo->outBuf[j], CL_TRUE, 0, buffer_size,
+                 (cl_uint *)gOut[j] + slot * buffer_elements, 0, NULL, NULL)))
         {
-            if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
-            {
-                vlog_error("ReadArray failed %d\n", error);
-                return error;
-            }
-            if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer2[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut2[j], 0, NULL, NULL)))
-            {
-                vlog_error("ReadArray2 failed %d\n", error);
-                return error;
-            }
+            vlog_error("ReadArray failed %d\n", error);
+            return error;
+        }
+        if ((error = clEnqueueReadBuffer(
+                 tinfo->tQueue, tinfo->outBuf2[j], CL_TRUE, 0, buffer_size,
+                 (cl_uint *)gOut2[j] + slot * buffer_elements, 0, NULL, NULL)))
+        {
+            vlog_error("ReadArray2 failed %d\n", error);
+            return error;
         }
+        clock.Lap(Phase::Map, j);
+    }
 
-        // Verify data
-        uint32_t *t = (uint32_t *)gOut_Ref;
-        uint32_t *t2 = (uint32_t *)gOut_Ref2;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+    // Set the rounding mode to match the device
+    RoundingMode oldRoundMode = kRoundToNearestEven;
+    if (isFract && gIsInRTZMode)
+        oldRoundMode = set_round(kRoundTowardZero, kfloat);
+
+    // Verify data
+    float *r = (float *)gOut_Ref + slot * buffer_elements;
+    float *r2 = (float *)gOut_Ref2 + slot * buffer_elements;
+    float *s = (float *)gIn + slot * buffer_elements;
+    uint32_t *t = (uint32_t *)r;
+    uint32_t *t2 = (uint32_t *)r2;
+    for (size_t j = 0; j < buffer_elements; j++)
+    {
+        for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
-            for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+            uint32_t *q = (uint32_t *)gOut[k] + slot * buffer_elements;
+            uint32_t *q2 = (uint32_t *)gOut2[k] + slot * buffer_elements;
+
+            // If we aren't getting the correctly rounded result
+            if (t[j] != q[j] || t2[j] != q2[j])
             {
-                uint32_t *q = (uint32_t *)gOut[k];
-                uint32_t *q2 = (uint32_t *)gOut2[k];
+                double correct, correct2;
+                float err, err2;
+                float test = ((float *)q)[j];
+                float test2 = ((float *)q2)[j];
 
-                // If we aren't getting the correctly rounded result
-                if (t[j] != q[j] || t2[j] != q2[j])
+                if (relaxedMode)
+                    correct = f->rfunc.f_fpf(s[j], &correct2);
+                else
+                    correct = f->func.f_fpf(s[j], &correct2);
+
+                // Per section 10 paragraph 6, accept any result if an input
+                // or output is a infinity or NaN or overflow
+                if (relaxedMode || skipNanInf)
                 {
-                    double correct, correct2;
-                    float err, err2;
-                    float test = ((float *)q)[j];
-                    float test2 = ((float *)q2)[j];
-
-                    if (relaxedMode)
-                        correct = f->rfunc.f_fpf(s[j], &correct2);
-                    else
-                        correct = f->func.f_fpf(s[j], &correct2);
-
-                    // Per section 10 paragraph 6, accept any result if an input
-                    // or output is a infinity or NaN or overflow
-                    if (relaxedMode || skipNanInf)
-                    {
-                        if (skipNanInf && overflow[j]) continue;
-                        // Note: no double rounding here.  Reference functions
-                        // calculate in single precision.
-                        if (IsFloatInfinity(correct) || IsFloatNaN(correct)
-                            || IsFloatInfinity(correct2) || IsFloatNaN(correct2)
-                            || IsFloatInfinity(s[j]) || IsFloatNaN(s[j]))
-                            continue;
-                    }
+                    if (skipNanInf && overflow[j]) continue;
+                    // Note: no double rounding here.  Reference functions
+                    // calculate in single precision.
+                    if (IsFloatInfinity(correct) || IsFloatNaN(correct)
+                        || IsFloatInfinity(correct2) || IsFloatNaN(correct2)
+                        || IsFloatInfinity(s[j]) || IsFloatNaN(s[j]))
+                        continue;
+                }
 
-                    typedef int (*CheckForSubnormal)(
-                        double, float); // If we are in fast relaxed math, we
-                                        // have a different calculation for the
-                                        // subnormal threshold.
-                    CheckForSubnormal isFloatResultSubnormalPtr;
-                    if (relaxedMode)
-                    {
-                        err = Abs_Error(test, correct);
-                        err2 = Abs_Error(test2, correct2);
-                        isFloatResultSubnormalPtr =
-                            &IsFloatResultSubnormalAbsError;
-                    }
-                    else
-                    {
-                        err = Ulp_Error(test, correct);
-                        err2 = Ulp_Error(test2, correct2);
-                        isFloatResultSubnormalPtr = &IsFloatResultSubnormal;
-                    }
-                    int fail = !(fabsf(err) <= float_ulps
-                                 && fabsf(err2) <= float_ulps);
+                typedef int (*CheckForSubnormal)(
+                    double, float); // If we are in fast relaxed math, we
+                                    // have a different calculation for the
+                                    // subnormal threshold.
+                CheckForSubnormal isFloatResultSubnormalPtr;
+                if (relaxedMode)
+                {
+                    err = Abs_Error(test, correct);
+                    err2 = Abs_Error(test2, correct2);
+                    isFloatResultSubnormalPtr =
+                        &IsFloatResultSubnormalAbsError;
+                }
+                else
+                {
+                    err = Ulp_Error(test, correct);
+                    err2 = Ulp_Error(test2, correct2);
+                    isFloatResultSubnormalPtr = &IsFloatResultSubnormal;
+                }
+                int fail = !(fabsf(err) <= float_ulps
+                             && fabsf(err2) <= float_ulps);
 
-                    if (ftz || relaxedMode)
+                if (ftz || relaxedMode)
+                {
+                    // retry per section 6.5.3.2
+                    if ((*isFloatResultSubnormalPtr)(correct, float_ulps))
                     {
-                        // retry per section 6.5.3.2
-                        if ((*isFloatResultSubnormalPtr)(correct, float_ulps))
+                        if ((*isFloatResultSubnormalPtr)(correct2,
+                                                         float_ulps))
                         {
-                            if ((*isFloatResultSubnormalPtr)(correct2,
-                                                             float_ulps))
-                            {
-                                fail = fail && !(test == 0.0f && test2 == 0.0f);
-                                if (!fail)
-                                {
-                                    err = 0.0f;
-                                    err2 = 0.0f;
-                                }
-                            }
-                            else
+                            fail = fail && !(test == 0.0f && test2 == 0.0f);
+                            if (!fail)
                             {
-                                fail = fail
-                                    && !(test == 0.0f
-                                         && fabsf(err2) <= float_ulps);
-                                if (!fail) err = 0.0f;
+                                err = 0.0f;
+                                err2 = 0.0f;
                             }
                         }
-                        else if ((*isFloatResultSubnormalPtr)(correct2,
-                                                              float_ulps))
+                        else
                         {
                             fail = fail
-                                && !(test2 == 0.0f && fabsf(err) <= float_ulps);
-                            if (!fail) err2 = 0.0f;
+                                && !(test == 0.0f
+                                     && fabsf(err2) <= float_ulps);
+                            if (!fail) err = 0.0f;
                         }
+                    }
+                    else if ((*isFloatResultSubnormalPtr)(correct2,
+                                                          float_ulps))
+                    {
+                        fail = fail
+                            && !(test2 == 0.0f && fabsf(err) <= float_ulps);
+                        if (!fail) err2 = 0.0f;
+                    }
 
 
-                        // retry per section 6.5.3.3
-                        if (IsFloatSubnormal(s[j]))
-                        {
-                            double correctp, correctn;
-                            double correct2p, correct2n;
-                            float errp, err2p, errn, err2n;
+                    // retry per section 6.5.3.3
+                    if (IsFloatSubnormal(s[j]))
+                    {
+                        double correctp, correctn;
+                        double correct2p, correct2n;
+                        float errp, err2p, errn, err2n;
 
-                            if (skipNanInf) feclearexcept(FE_OVERFLOW);
-                            if (relaxedMode)
-                            {
-                                correctp = f->rfunc.f_fpf(0.0, &correct2p);
-                                correctn = f->rfunc.f_fpf(-0.0, &correct2n);
-                            }
-                            else
-                            {
-                                correctp = f->func.f_fpf(0.0, &correct2p);
-                                correctn = f->func.f_fpf(-0.0, &correct2n);
-                            }
+                        if (skipNanInf) feclearexcept(FE_OVERFLOW);
+                        if (relaxedMode)
+                        {
+                            correctp = f->rfunc.f_fpf(0.0, &correct2p);
+                            correctn = f->rfunc.f_fpf(-0.0, &correct2n);
+                        }
+                        else
+                        {
+                            correctp = f->func.f_fpf(0.0, &correct2p);
+                            correctn = f->func.f_fpf(-0.0, &correct2n);
+                        }
 
-                            // Per section 10 paragraph 6, accept any result if
-                            // an input or output is a infinity or NaN or
-                            // overflow
-                            if (skipNanInf)
-                            {
-                                if (fetestexcept(FE_OVERFLOW)) continue;
-
-                                // Note: no double rounding here.  Reference
-                                // functions calculate in single precision.
-                                if (IsFloatInfinity(correctp)
-                                    || IsFloatNaN(correctp)
-                                    || IsFloatInfinity(correctn)
-                                    || IsFloatNaN(correctn)
-                                    || IsFloatInfinity(correct2p)
-                                    || IsFloatNaN(correct2p)
-                                    || IsFloatInfinity(correct2n)
-                                    || IsFloatNaN(correct2n))
-                                    continue;
-                            }
+                        // Per section 10 paragraph 6, accept any result if
+                        // an input or output is a infinity or NaN or
+                        // overflow
+                        if (skipNanInf)
+                        {
+                            if (fetestexcept(FE_OVERFLOW)) continue;
+
+                            // Note: no double rounding here.  Reference
+                            // functions calculate in single precision.
+                            if (IsFloatInfinity(correctp)
+                                || IsFloatNaN(correctp)
+                                || IsFloatInfinity(correctn)
+                                || IsFloatNaN(correctn)
+                                || IsFloatInfinity(correct2p)
+                                || IsFloatNaN(correct2p)
+                                || IsFloatInfinity(correct2n)
+                                || IsFloatNaN(correct2n))
+                                continue;
+                        }
 
-                            if (relaxedMode)
-                            {
-                                errp = Abs_Error(test, correctp);
-                                err2p = Abs_Error(test, correct2p);
-                                errn = Abs_Error(test, correctn);
-                                err2n = Abs_Error(test, correct2n);
-                            }
-                            else
-                            {
-                                errp = Ulp_Error(test, correctp);
-                                err2p = Ulp_Error(test, correct2p);
-                                errn = Ulp_Error(test, correctn);
-                                err2n = Ulp_Error(test, correct2n);
-                            }
+                        if (relaxedMode)
+                        {
+                            errp = Abs_Error(test, correctp);
+                            err2p = Abs_Error(test, correct2p);
+                            errn = Abs_Error(test, correctn);
+                            err2n = Abs_Error(test, correct2n);
+                        }
+                        else
+                        {
+                            errp = Ulp_Error(test, correctp);
+                            err2p = Ulp_Error(test, correct2p);
+                            errn = Ulp_Error(test, correctn);
+                            err2n = Ulp_Error(test, correct2n);
+                        }
 
-                            fail = fail
-                                && ((!(fabsf(errp) <= float_ulps))
-                                    && (!(fabsf(err2p) <= float_ulps))
-                                    && ((!(fabsf(errn) <= float_ulps))
-                                        && (!(fabsf(err2n) <= float_ulps))));
-                            if (fabsf(errp) < fabsf(err)) err = errp;
-                            if (fabsf(errn) < fabsf(err)) err = errn;
-                            if (fabsf(err2p) < fabsf(err2)) err2 = err2p;
-                            if (fabsf(err2n) < fabsf(err2)) err2 = err2n;
-
-                            // retry per section 6.5.3.4
-                            if ((*isFloatResultSubnormalPtr)(correctp,
+                        fail = fail
+                            && ((!(fabsf(errp) <= float_ulps))
+                                && (!(fabsf(err2p) <= float_ulps))
+                                && ((!(fabsf(errn) <= float_ulps))
+                                    && (!(fabsf(err2n) <= float_ulps))));
+                        if (fabsf(errp) < fabsf(err)) err = errp;
+                        if (fabsf(errn) < fabsf(err)) err = errn;
+                        if (fabsf(err2p) < fabsf(err2)) err2 = err2p;
+                        if (fabsf(err2n) < fabsf(err2)) err2 = err2n;
+
+                        // retry per section 6.5.3.4
+                        if ((*isFloatResultSubnormalPtr)(correctp,
+                                                         float_ulps)
+                            || (*isFloatResultSubnormalPtr)(correctn,
+                                                            float_ulps))
+                        {
+                            if ((*isFloatResultSubnormalPtr)(correct2p,
                                                              float_ulps)
-                                || (*isFloatResultSubnormalPtr)(correctn,
+                                || (*isFloatResultSubnormalPtr)(correct2n,
                                                                 float_ulps))
                             {
-                                if ((*isFloatResultSubnormalPtr)(correct2p,
-                                                                 float_ulps)
-                                    || (*isFloatResultSubnormalPtr)(correct2n,
-                                                                    float_ulps))
-                                {
-                                    fail = fail
-                                        && !(test == 0.0f && test2 == 0.0f);
-                                    if (!fail) err = err2 = 0.0f;
-                                }
-                                else
-                                {
-                                    fail = fail
-                                        && !(test == 0.0f
-                                             && fabsf(err2) <= float_ulps);
-                                    if (!fail) err = 0.0f;
-                                }
+                                fail = fail
+                                    && !(test == 0.0f && test2 == 0.0f);
+                                if (!fail) err = err2 = 0.0f;
                             }
-                            else if ((*isFloatResultSubnormalPtr)(correct2p,
-                                                                  float_ulps)
-                                     || (*isFloatResultSubnormalPtr)(
-                                         correct2n, float_ulps))
+                            else
                             {
                                 fail = fail
-                                    && !(test2 == 0.0f
-                                         && (fabsf(err) <= float_ulps));
-                                if (!fail) err2 = 0.0f;
+                                    && !(test == 0.0f
+                                         && fabsf(err2) <= float_ulps);
+                                if (!fail) err = 0.0f;
                             }
                         }
+                        else if ((*isFloatResultSubnormalPtr)(correct2p,
+                                                              float_ulps)
+                                 || (*isFloatResultSubnormalPtr)(
+                                     correct2n, float_ulps))
+                        {
+                            fail = fail
+                                && !(test2 == 0.0f
+                                     && (fabsf(err) <= float_ulps));
+                            if (!fail) err2 = 0.0f;
+                        }
                     }
-                    if (fabsf(err) > maxError0)
-                    {
-                        maxError0 = fabsf(err);
-                        maxErrorVal0 = s[j];
-                    }
-                    if (fabsf(err2) > maxError1)
-                    {
-                        maxError1 = fabsf(err2);
-                        maxErrorVal1 = s[j];
-                    }
-                    if (fail)
-                    {
-                        vlog_error("\nERROR: %s%s: {%f, %f} ulp error at %a: "
-                                   "*{%a, %a} vs. {%a, %a}\n",
-                                   f->name, sizeNames[k], err, err2,
-                                   ((float *)gIn)[j], ((float *)gOut_Ref)[j],
-                                   ((float *)gOut_Ref2)[j], test, test2);
-                        return -1;
-                    }
+                }
+                if (fabsf(err) > job->maxError0)
+                {
+                    job->maxError0 = fabsf(err);
+                    job->maxErrorVal0 = s[j];
+                }
+                if (fabsf(err2) > job->maxError1)
+                {
+                    job->maxError1 = fabsf(err2);
+                    job->maxErrorVal1 = s[j];
+                }
+                if (fail)
+                {
+                    vlog_error("\nERROR: %s%s: {%f, %f} ulp error at %a: "
+                               "*{%a, %a} vs. {%a, %a}\n",
+                               f->name, sizeNames[k], err, err2, s[j], r[j],
+                               r2[j], test, test2);
+                    return -1;
                 }
             }
         }
+    }
 
-        if (isFract && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    if (isFract && gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
+    clock.Lap(Phase::Verify);
+    tinfo->times.values += buffer_elements;
 
-        if (0 == (i & 0x0fffffff))
+    // Report progress once per fill of the whole buffer.
+    uint64_t i = (job_id / gPipelineDepth) * job->step;
+    if (job_id % gPipelineDepth == gPipelineDepth - 1
+        && 0 == (i & 0x0fffffff))
+    {
+        if (gVerboseBruteForce)
         {
-            if (gVerboseBruteForce)
+            vlog("base:%14" PRIu64 " step:%10" PRIu64 "  bufferSize:%10d \n", i,
+                 job->step, BUFFER_SIZE);
+        }
+        else
+        {
+            vlog(".");
+        }
+        fflush(stdout);
+    }
+
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int TestFunc_Float2_Float(const Func *f, MTdata d UNUSED, bool relaxedMode)
+{
+    TestInfo test_info{};
+    int error;
+
+    logFunctionInfo(f->name, sizeof(cl_float), relaxedMode);
+
+    test_info.f = f;
+    test_info.relaxedMode = relaxedMode;
+    test_info.ftz =
+        f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
+    test_info.isFract = 0 == strcmp("fract", f->nameInCode);
+    test_info.skipNanInf = test_info.isFract && !gInfNanSupport;
+    test_info.limitDomain =
+        relaxedMode && f->relaxed_policy == RelaxedPolicy::SinCos;
+    test_info.float_ulps = getAllowedUlpError(f, kfloat, relaxedMode);
+    test_info.step = getTestStep(sizeof(float), BUFFER_SIZE);
+    test_info.scale =
+        (int)((1ULL << 32) / (16 * BUFFER_SIZE / sizeof(float)) + 1);
+    test_info.bufferElements = BUFFER_SIZE / sizeof(float) / gPipelineDepth;
+
+    // Init the kernels
+    FunctionTiming timing(f, "float", relaxedMode, test_info.tinfo, 1);
+    BuildKernelInfo build_info{ 1, test_info.kernels, test_info.programs,
+                                f->nameInCode, relaxedMode };
+    if ((error = ThreadPool_Do(BuildKernelFn,
+                               gMaxVectorSizeIndex - gMinVectorSizeIndex,
+                               &build_info)))
+        return error;
+    timing.BuildDone();
+
+    cl_uint slotCount = GetPipelineSlotCount(1);
+    size_t buffer_size = test_info.bufferElements * sizeof(cl_float);
+    test_info.overflow.resize(slotCount * test_info.bufferElements);
+    test_info.tinfo.resize(slotCount);
+    for (cl_uint i = 0; i < slotCount; i++)
+    {
+        ThreadInfo &tinfo = test_info.tinfo[i];
+        cl_buffer_region region = { i * buffer_size, buffer_size };
+        tinfo.inBuf =
+            clCreateSubBuffer(gInBuffer, CL_MEM_READ_ONLY,
+                              CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+        if (error || NULL == tinfo.inBuf)
+        {
+            vlog_error("Error: Unable to create sub-buffer of gInBuffer for "
+                       "region {%zd, %zd}\n",
+                       region.origin, region.size);
+            return error;
+        }
+
+        for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
+        {
+            tinfo.outBuf[j] = clCreateSubBuffer(
+                gOutBuffer[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION,
+                &region, &error);
+            if (error || NULL == tinfo.outBuf[j])
             {
-                vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                vlog_error("Error: Unable to create sub-buffer of "
+                           "gOutBuffer[%d] for region {%zd, %zd}\n",
+                           (int)j, region.origin, region.size);
+                return error;
             }
-            else
+            tinfo.outBuf2[j] = clCreateSubBuffer(
+                gOutBuffer2[j], CL_MEM_WRITE_ONLY, CL_BUFFER_CREATE_TYPE_REGION,
+                &region, &error);
+            if (error || NULL == tinfo.outBuf2[j])
             {
-                vlog(".");
+                vlog_error("Error: Unable to create sub-buffer of "
+                           "gOutBuffer2[%d] for region {%zd, %zd}\n",
+                           (int)j, region.origin, region.size);
+                return error;
             }
-            fflush(stdout);
+        }
+
+        tinfo.tQueue = clCreateCommandQueue(gContext, gDevice, 0, &error);
+        if (NULL == tinfo.tQueue || error)
+        {
+            vlog_error("clCreateCommandQueue failed. (%d)\n", error);
+            return error;
         }
     }
 
     if (!gSkipCorrectnessTesting)
     {
+        cl_uint jobCount = (cl_uint)(((1ULL << 32) + test_info.step - 1)
+                                     / test_info.step * gPipelineDepth);
+        error = RunPipelined({ Submit, Complete }, 1, jobCount, &test_info);
+        if (error) return error;
+
         if (gWimpyMode)
             vlog("Wimp pass");
         else
             vlog("passed");
 
-        vlog("\t{%8.2f, %8.2f} @ {%a, %a}", maxError0, maxError1, maxErrorVal0,
-             maxErrorVal1);
+        vlog("\t{%8.2f, %8.2f} @ {%a, %a}", test_info.maxError0,
+             test_info.maxError1, test_info.maxErrorVal0,
+             test_info.maxErrorVal1);
     }
 
     vlog("\n");
 
+    timing.Passed();
+
     return CL_SUCCESS;
 }
@@ -23,6 +23,7 @@
 #include "harness/testHarness.h"
 #include "harness/ThreadPool.h"
 #include "harness/conversions.h"
+#include "harness/halfConversions.h"
 #include "harness/parseParameters.h"
 #include "CL/cl_half.h"
 
@@ -62,6 +63,7 @@ extern int gSkipCorrectnessTesting;
 extern int gForceFTZ;
 extern int gFastRelaxedDerived;
 extern int gHostFill;
+extern cl_uint gPipelineDepth;
 extern int gIsInRTZMode;
 extern int gHasHalf;
 extern int gHasDouble;
@@ -78,8 +80,8 @@ extern RoundingMode gFloatToHalfRoundingMode;
 
 extern cl_half_rounding_mode gHalfRoundingMode;
 
-#define HFF(num) cl_half_from_float(num, gHalfRoundingMode)
-#define HFD(num) cl_half_from_double(num, gHalfRoundingMode)
+#define HFF(num) half_from_float(num, gHalfRoundingMode)
+#define HFD(num) half_from_double(num, gHalfRoundingMode)
 #define HTF(num) cl_half_to_float(num)
 
 #define LOWER_IS_BETTER 0
@@ -25,6 +25,8 @@
 #include <errno.h>
 #include <memory>
 #include <string.h>
+#include <string>
+#include <thread>
 #include <vector>
 
 #if ! defined( _WIN32)
@@ -34,15 +36,18 @@
 #include <unistd.h>
 #define streamDup(fd1) dup(fd1)
 #define streamDup2(fd1,fd2) dup2(fd1,fd2)
+#define streamPipe(fds) pipe(fds)
 #endif
 #include <limits.h>
 #include <time.h>
 #include "test_printf.h"
 
 #if defined(_WIN32)
+#include <fcntl.h>
 #include <io.h>
 #define streamDup(fd1) _dup(fd1)
 #define streamDup2(fd1,fd2) _dup2(fd1,fd2)
+#define streamPipe(fds) _pipe(fds, 4096, _O_BINARY)
 #endif
 
 #include "harness/testHarness.h"
@@ -66,10 +71,10 @@ namespace {
 
 //Stream helper functions
 
-//Associate stdout stream with the file(gFileName):i.e redirect stdout stream to the specific files (gFileName)
+//Redirect stdout to a pipe drained into memory (gCapturedOutput)
 int acquireOutputStream(int* error);
 
-//Close the file(gFileName) associated with the stdout stream and disassociates it.
+//Restore stdout and wait until the captured output is complete
 void releaseOutputStream(int fd);
 
 //Get analysis buffer to verify the correctess of printed data
@@ -92,6 +97,23 @@ cl_program makePrintfProgram(cl_kernel* kernel_ptr, const cl_context context,
                              const unsigned int testNum,
                              const unsigned int formatNum);
 
+// Kernel code of the printf of a vector or generic test case, shared by its own
+// program and the batched ones
+std::string makePrintfStatement(const unsigned int testId,
+                                const unsigned int testNum,
+                                const unsigned int formatNum);
+
+// Builds and runs the kernel of a single printf test case, and verifies it
+void runPrintfCase(cl_command_queue queue, cl_context context,
+                   cl_device_id device, const unsigned int testId,
+                   const unsigned int testNum, const unsigned int formatNum);
+
+// Runs printf test cases of the same type/format family together, in as few
+// kernels as the printf buffer allows
+void runPrintfBatches(cl_command_queue queue, cl_context context,
+                      cl_device_id device, const unsigned int testId,
+                      const std::vector<std::pair<unsigned, unsigned>>& cases);
+
 // Creates and execute the printf test for the given device, context, type/format
 int doTest(cl_command_queue queue, cl_context context,
            const unsigned int testId, cl_device_id device);
@@ -121,13 +143,24 @@ cl_context gContext;
 cl_command_queue gQueue;
 int gFd;
 
-char gFileName[256];
+// Output written to stdout while it is redirected, and the thread reading it
+std::string gCapturedOutput;
+std::thread gCaptureReader;
 
 MTdataHolder gMTdata;
 
 // For the sake of proper logging of negative results
 std::string gLatestKernelSource;
 
+// Run test cases of a family in batched kernels (-batch)
+bool gBatchCases = false;
+
+// Size of the device printf buffer, which bounds the output of a batch
+size_t gPrintfBufferSize = 0;
+
+// Printed by batched kernels before the output of each test case
+const char* const gCaseMarker = "#printf_case_";
+
 //-----------------------------------------
 // helper functions definition
 //-----------------------------------------
@@ -137,13 +170,33 @@ std::string gLatestKernelSource;
 //-----------------------------------------
 int acquireOutputStream(int* error)
 {
+    int pipeFds[2];
+    gCapturedOutput.clear();
+    fflush(stdout);
     int fd = streamDup(fileno(stdout));
     *error = 0;
-    if (!freopen(gFileName, "w", stdout))
+    if (fd < 0 || streamPipe(pipeFds) != 0)
     {
-        releaseOutputStream(fd);
+        if (fd >= 0) close(fd);
         *error = -1;
+        return -1;
     }
+    streamDup2(pipeFds[1], fileno(stdout));
+    close(pipeFds[1]);
+
+    // The pipe is drained as it is written, so that printf never blocks on
+    // it; the reader sees the end of the output once stdout is restored.
+    gCaptureReader = std::thread([readFd = pipeFds[0]] {
+        char buffer[4096];
+        for (;;)
+        {
+            int len = read(readFd, buffer, sizeof(buffer));
+            if (len < 0 && errno == EINTR) continue;
+            if (len <= 0) break;
+            gCapturedOutput.append(buffer, len);
+        }
+        close(readFd);
+    });
     return fd;
 }
 
@@ -155,6 +208,7 @@ void releaseOutputStream(int fd)
     fflush(stdout);
     streamDup2(fd,fileno(stdout));
     close(fd);
+    if (gCaptureReader.joinable()) gCaptureReader.join();
 }
 
 //-----------------------------------------
@@ -171,18 +225,12 @@ void CL_CALLBACK printfCallBack(const char* printf_data, size_t len,
 //-----------------------------------------
 void getAnalysisBuffer(char* analysisBuffer)
 {
-    FILE *fp;
     memset(analysisBuffer,0,ANALYSIS_BUFFER_SIZE);
 
-    fp = fopen(gFileName, "r");
-    if (NULL == fp)
-        log_error("Failed to open analysis buffer ('%s')\n", strerror(errno));
-    else if (0
-             == std::fread(analysisBuffer, sizeof(analysisBuffer[0]),
-                           ANALYSIS_BUFFER_SIZE, fp))
+    if (gCapturedOutput.empty())
         log_error("No data read from analysis buffer\n");
-
-    fclose(fp);
+    else
+        gCapturedOutput.copy(analysisBuffer, ANALYSIS_BUFFER_SIZE - 1);
 }
 
 //-----------------------------------------
@@ -411,47 +459,7 @@ cl_program makePrintfProgram(cl_kernel* kernel_ptr, const cl_context context,
 
     // create program based on its type
 
-    if(allTestCase[testId]->_type == TYPE_VECTOR)
-    {
-        if (strcmp(allTestCase[testId]->_genParameters[testNum].dataType,
-                   "half")
-            == 0)
-            strcpy(extension,
-                   "#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n");
-
-        // Program Source code for vector
-        const char* sourceVec[] = {
-            extension,
-            "__kernel void ",
-            testname,
-            "(void)\n",
-            "{\n",
-            allTestCase[testId]->_genParameters[testNum].dataType,
-            allTestCase[testId]->_genParameters[testNum].vectorSize,
-            " tmp = (",
-            allTestCase[testId]->_genParameters[testNum].dataType,
-            allTestCase[testId]->_genParameters[testNum].vectorSize,
-            ")",
-            allTestCase[testId]->_genParameters[testNum].dataRepresentation,
-            ";",
-            "   printf(\"",
-            allTestCase[testId]->_genParameters[testNum].vectorFormatFlag,
-            "v",
-            allTestCase[testId]->_genParameters[testNum].vectorSize,
-            allTestCase[testId]->_genParameters[testNum].vectorFormatSpecifier,
-            "\\n\",",
-            "tmp);",
-            "}\n"
-        };
-
-        err = create_single_kernel_helper(
-            context, &program, kernel_ptr,
-            sizeof(sourceVec) / sizeof(sourceVec[0]), sourceVec, testname);
-
-        gLatestKernelSource =
-            concat_kernel(sourceVec, sizeof(sourceVec) / sizeof(sourceVec[0]));
-    }
-    else if(allTestCase[testId]->_type == TYPE_ADDRESS_SPACE)
+    if (allTestCase[testId]->_type == TYPE_ADDRESS_SPACE)
     {
         // Program Source code for address space
         const char* sourceAddrSpace[] = {
@@ -491,29 +499,18 @@ cl_program makePrintfProgram(cl_kernel* kernel_ptr, const cl_context context,
     }
     else
     {
-        // Program Source code for int,float,octal,hexadecimal,char,string
-        std::ostringstream sourceGen;
-        sourceGen << extension << "__kernel void " << testname
-                  << "(void)\n"
-                     "{\n"
-                     "   printf(\""
-                  << allTestCase[testId]
-                         ->_genParameters[testNum]
-                         .genericFormats[formatNum]
-                         .c_str()
-                  << "\\n\"";
-
-        if (allTestCase[testId]->_genParameters[testNum].dataRepresentation)
-        {
-            sourceGen << ","
-                      << allTestCase[testId]
-                             ->_genParameters[testNum]
-                             .dataRepresentation;
-        }
-
-        sourceGen << ");\n}\n";
+        // Program Source code for vector,int,float,octal,hexadecimal,char,
+        // string
+        if (allTestCase[testId]->_type == TYPE_VECTOR
+            && strcmp(allTestCase[testId]->_genParameters[testNum].dataType,
+                      "half")
+                == 0)
+            strcpy(extension,
+                   "#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n");
 
-        std::string kernel_source = sourceGen.str();
+        std::string kernel_source = std::string(extension) + "__kernel void "
+            + testname + "(void)\n{\n"
+            + makePrintfStatement(testId, testNum, formatNum) + "}\n";
         const char* ptr = kernel_source.c_str();
 
         err = create_single_kernel_helper(context, &program, kernel_ptr, 1,
@@ -683,14 +680,368 @@ void logTestType(const unsigned testId, const unsigned testNum,
     fflush(stdout);
 }
 
+//-----------------------------------------
+// runPrintfCase
+//-----------------------------------------
+void runPrintfCase(cl_command_queue queue, cl_context context,
+                   cl_device_id device, const unsigned int testId,
+                   const unsigned int testNum, const unsigned int formatNum)
+{
+    int err;
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    clMemWrapper d_out;
+    clMemWrapper d_a;
+    char _analysisBuffer[ANALYSIS_BUFFER_SIZE];
+    cl_uint out32 = 0;
+    cl_ulong out64 = 0;
+    int fd = -1;
+
+    // Define an index space (global work size) of threads for execution.
+    size_t globalWorkSize[1];
+
+    program = makePrintfProgram(&kernel, context, device, testId, testNum,
+                                formatNum);
+    if (!program || !kernel)
+    {
+        subtest_fail(nullptr);
+        return;
+    }
+
+    // For address space test if there is kernel argument - set it
+    if (allTestCase[testId]->_type == TYPE_ADDRESS_SPACE)
+    {
+        if (isKernelArgument(allTestCase[testId], testNum))
+        {
+            int a = 2;
+            d_a = clCreateBuffer(
+                context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeof(int),
+                &a, &err);
+            if (err != CL_SUCCESS || d_a == NULL)
+            {
+                subtest_fail("clCreateBuffer failed\n");
+                return;
+            }
+            err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &d_a);
+            if (err != CL_SUCCESS)
+            {
+                subtest_fail("clSetKernelArg failed\n");
+                return;
+            }
+        }
+        // For address space test if %p is tested
+        if (isKernelPFormat(allTestCase[testId], testNum))
+        {
+            d_out = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_ulong),
+                                   NULL, &err);
+            if (err != CL_SUCCESS || d_out == NULL)
+            {
+                subtest_fail("clCreateBuffer failed\n");
+                return;
+            }
+            err = clSetKernelArg(kernel, 1, sizeof(cl_mem), &d_out);
+            if (err != CL_SUCCESS)
+            {
+                subtest_fail("clSetKernelArg failed\n");
+                return;
+            }
+        }
+    }
+
+    fd = acquireOutputStream(&err);
+    if (err != 0)
+    {
+        subtest_fail("Error while redirecting stdout");
+        return;
+    }
+    globalWorkSize[0] = 1;
+    cl_event ndrEvt;
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, globalWorkSize, NULL,
+                                 0, NULL, &ndrEvt);
+    if (err != CL_SUCCESS)
+    {
+        releaseOutputStream(fd);
+        subtest_fail("\n clEnqueueNDRangeKernel failed errcode:%d\n", err);
+        return;
+    }
+
+    fflush(stdout);
+    err = clFlush(queue);
+    if (err != CL_SUCCESS)
+    {
+        releaseOutputStream(fd);
+        subtest_fail("clFlush failed : %d\n", err);
+        return;
+    }
+    // Wait until kernel finishes its execution and (thus) the output printed
+    // from the kernel is immediately printed
+    err = waitForEvent(&ndrEvt);
+
+    releaseOutputStream(fd);
+
+    if (err != CL_SUCCESS)
+    {
+        subtest_fail("waitforEvent failed : %d\n", err);
+        return;
+    }
+    fflush(stdout);
+
+    if (allTestCase[testId]->_type == TYPE_ADDRESS_SPACE
+        && isKernelPFormat(allTestCase[testId], testNum))
+    {
+        // Read the OpenCL output buffer (d_out) to the host output array (out)
+        if (!is64bAddressSpace(device)) // 32-bit address space
+        {
+            clEnqueueReadBuffer(queue, d_out, CL_TRUE, 0, sizeof(cl_int),
+                                &out32, 0, NULL, NULL);
+        }
+        else // 64-bit address space
+        {
+            clEnqueueReadBuffer(queue, d_out, CL_TRUE, 0, sizeof(cl_ulong),
+                                &out64, 0, NULL, NULL);
+        }
+    }
+
+    //
+    // Get the output printed from the kernel to _analysisBuffer and verify
+    // its correctness
+    getAnalysisBuffer(_analysisBuffer);
+    if (!is64bAddressSpace(device)) // 32-bit address space
+    {
+        if (0
+            != verifyOutputBuffer(_analysisBuffer, allTestCase[testId],
+                                  testNum, (cl_ulong)out32))
+        {
+            subtest_fail("verifyOutputBuffer failed with kernel: "
+                         "\n%s\n expected: %s\n got:      %s\n",
+                         gLatestKernelSource.c_str(),
+                         allTestCase[testId]->_correctBuffer[testNum].c_str(),
+                         _analysisBuffer);
+            return;
+        }
+    }
+    else // 64-bit address space
+    {
+        if (0
+            != verifyOutputBuffer(_analysisBuffer, allTestCase[testId],
+                                  testNum, out64))
+        {
+            subtest_fail("verifyOutputBuffer failed with kernel: "
+                         "\n%s\n expected: %s\n got:      %s\n",
+                         gLatestKernelSource.c_str(),
+                         allTestCase[testId]->_correctBuffer[testNum].c_str(),
+                         _analysisBuffer);
+            return;
+        }
+    }
+}
+
+//-----------------------------------------
+// isBatchable
+//-----------------------------------------
+bool isBatchable(const unsigned int testId)
+{
+    // Address space cases take kernel arguments, and mixed format cases
+    // generate their reference results along with their kernel
+    return allTestCase[testId]->_type != TYPE_ADDRESS_SPACE
+        && allTestCase[testId]->_type != TYPE_MIXED_FORMAT_RANDOM;
+}
+
+//-----------------------------------------
+// makePrintfStatement
+//-----------------------------------------
+std::string makePrintfStatement(const unsigned int testId,
+                                const unsigned int testNum,
+                                const unsigned int formatNum)
+{
+    const printDataGenParameters& params =
+        allTestCase[testId]->_genParameters[testNum];
+    std::ostringstream statement;
+
+    // Vector cases declare their value in a block of their own, so that cases
+    // of a batch don't clash
+    if (allTestCase[testId]->_type == TYPE_VECTOR)
+    {
+        statement << "{\n"
+                  << params.dataType << params.vectorSize << " tmp = ("
+                  << params.dataType << params.vectorSize << ")"
+                  << params.dataRepresentation << ";   printf(\""
+                  << params.vectorFormatFlag << "v" << params.vectorSize
+                  << params.vectorFormatSpecifier << "\\n\",tmp);}\n";
+    }
+    else
+    {
+        statement << "   printf(\"" << params.genericFormats[formatNum]
+                  << "\\n\"";
+        if (params.dataRepresentation)
+            statement << "," << params.dataRepresentation;
+        statement << ");\n";
+    }
+    return statement.str();
+}
+
+//-----------------------------------------
+// runPrintfBatch
+// Returns false when the batch could not be built or run, in which case its
+// test cases have to be run separately
+//-----------------------------------------
+bool runPrintfBatch(cl_command_queue queue, cl_context context,
+                    cl_device_id device, const unsigned int testId,
+                    const std::vector<std::pair<unsigned, unsigned>>& cases)
+{
+    std::vector<std::string> statements;
+    std::ostringstream sourceGen;
+    std::string kernelName = "test" + std::to_string(testId) + "_batch";
+    bool halfUsed = allTestCase[testId]->_type == TYPE_HALF
+        || allTestCase[testId]->_type == TYPE_HALF_LIMITS;
+
+    // Each case is preceded by a marker, so that its output can be told
+    // apart even when it spans several lines
+    sourceGen << "__kernel void " << kernelName << "(void)\n{\n";
+    for (size_t i = 0; i < cases.size(); i++)
+    {
+        const printDataGenParameters& params =
+            allTestCase[testId]->_genParameters[cases[i].first];
+        if (allTestCase[testId]->_type == TYPE_VECTOR
+            && strcmp(params.dataType, "half") == 0)
+            halfUsed = true;
+
+        statements.push_back(
+            makePrintfStatement(testId, cases[i].first, cases[i].second));
+        sourceGen << "   printf(\"" << gCaseMarker << i << "#\\n\");\n"
+                  << statements.back();
+    }
+    sourceGen << "}\n";
+
+    std::string kernel_source =
+        (halfUsed ? "#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n" : "")
+        + sourceGen.str();
+    const char* ptr = kernel_source.c_str();
+    gLatestKernelSource = kernel_source;
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int err = create_single_kernel_helper(context, &program, &kernel, 1, &ptr,
+                                          kernelName.c_str());
+    if (err != CL_SUCCESS || !program || !kernel)
+    {
+        log_info("Batched kernel of %zu test cases failed to build, running "
+                 "them separately\n",
+                 cases.size());
+        return false;
+    }
+
+    int fd = acquireOutputStream(&err);
+    if (err != 0) return false;
+
+    size_t globalWorkSize[1] = { 1 };
+    cl_event ndrEvt;
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, globalWorkSize, NULL,
+                                 0, NULL, &ndrEvt);
+    if (err != CL_SUCCESS)
+    {
+        releaseOutputStream(fd);
+        log_info("Batched kernel failed to launch (%d), running its test "
+                 "cases separately\n",
+                 err);
+        return false;
+    }
+
+    fflush(stdout);
+    err = clFlush(queue);
+    if (err == CL_SUCCESS) err = waitForEvent(&ndrEvt);
+
+    releaseOutputStream(fd);
+
+    if (err != CL_SUCCESS)
+    {
+        log_info("Batched kernel failed (%d), running its test cases "
+                 "separately\n",
+                 err);
+        return false;
+    }
+
+    // Split the output at the markers
+    std::vector<std::string> outputs(cases.size());
+    size_t pos = gCapturedOutput.find(gCaseMarker);
+    while (pos != std::string::npos)
+    {
+        const char* caseId =
+            gCapturedOutput.c_str() + pos + strlen(gCaseMarker);
+        char* caseIdEnd;
+        unsigned long caseNum = strtoul(caseId, &caseIdEnd, 10);
+        size_t begin = caseIdEnd - gCapturedOutput.c_str() + 2;
+
+        pos = gCapturedOutput.find(gCaseMarker, begin);
+        if (caseNum < cases.size() && strncmp(caseIdEnd, "#\n", 2) == 0)
+            outputs[caseNum] = gCapturedOutput.substr(begin, pos - begin);
+    }
+
+    for (size_t i = 0; i < cases.size(); i++)
+    {
+        const unsigned testNum = cases[i].first;
+        char _analysisBuffer[ANALYSIS_BUFFER_SIZE] = { 0 };
+        outputs[i].copy(_analysisBuffer, ANALYSIS_BUFFER_SIZE - 1);
+
+        if (0
+            != verifyOutputBuffer(_analysisBuffer, allTestCase[testId],
+                                  testNum))
+        {
+            subtest_fail("verifyOutputBuffer failed with batched kernel code: "
+                         "\n%s\n expected: %s\n got:      %s\n",
+                         statements[i].c_str(),
+                         allTestCase[testId]->_correctBuffer[testNum].c_str(),
+                         _analysisBuffer);
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------
+// runPrintfBatches
+//-----------------------------------------
+void runPrintfBatches(cl_command_queue queue, cl_context context,
+                      cl_device_id device, const unsigned int testId,
+                      const std::vector<std::pair<unsigned, unsigned>>& cases)
+{
+    size_t begin = 0;
+    while (begin < cases.size())
+    {
+        // Take cases while their code and output take at most half of the
+        // printf buffer, the rest being left for the implementation
+        size_t end = begin;
+        size_t printfSize = 0;
+        while (end < cases.size())
+        {
+            const unsigned testNum = cases[end].first;
+            size_t caseSize = 64
+                + makePrintfStatement(testId, testNum, cases[end].second).size()
+                + allTestCase[testId]->_correctBuffer[testNum].size();
+            if (end > begin && printfSize + caseSize > gPrintfBufferSize / 2)
+                break;
+            printfSize += caseSize;
+            end++;
+        }
+
+        std::vector<std::pair<unsigned, unsigned>> batch(
+            cases.begin() + begin, cases.begin() + end);
+        if (!runPrintfBatch(queue, context, device, testId, batch))
+        {
+            for (auto& testCase : batch)
+                runPrintfCase(queue, context, device, testId, testCase.first,
+                              testCase.second);
+        }
+        begin = end;
+    }
+}
+
 //-----------------------------------------
 // doTest
 //-----------------------------------------
 int doTest(cl_command_queue queue, cl_context context,
            const unsigned int testId, cl_device_id device)
 {
-    int err = TEST_FAIL;
-
     if ((allTestCase[testId]->_type == TYPE_HALF
          || allTestCase[testId]->_type == TYPE_HALF_LIMITS)
         && !is_extension_available(device, "cl_khr_fp16"))
@@ -721,6 +1072,9 @@ int doTest(cl_command_queue queue, cl_context context,
     auto pass_count = s_test_cnt;
     auto skip_count = s_test_skip;
 
+    // Test cases run in batches once all of them are known
+    std::vector<std::pair<unsigned, unsigned>> batchedCases;
+
     for (unsigned testNum = 0; testNum < genParams.size(); testNum++)
     {
         if (allTestCase[testId]->_type == TYPE_VECTOR)
@@ -764,163 +1118,18 @@ int doTest(cl_command_queue queue, cl_context context,
              formatNum++)
         {
             logTestType(testId, testNum, formatNum);
-
-            clProgramWrapper program;
-            clKernelWrapper kernel;
-            clMemWrapper d_out;
-            clMemWrapper d_a;
-            char _analysisBuffer[ANALYSIS_BUFFER_SIZE];
-            cl_uint out32 = 0;
-            cl_ulong out64 = 0;
-            int fd = -1;
-
-            // Define an index space (global work size) of threads for
-            // execution.
-            size_t globalWorkSize[1];
-
-            program = makePrintfProgram(&kernel, context, device, testId,
-                                        testNum, formatNum);
-            if (!program || !kernel)
-            {
-                subtest_fail(nullptr);
-                continue;
-            }
-
-            // For address space test if there is kernel argument - set it
-            if (allTestCase[testId]->_type == TYPE_ADDRESS_SPACE)
-            {
-                if (isKernelArgument(allTestCase[testId], testNum))
-                {
-                    int a = 2;
-                    d_a = clCreateBuffer(
-                        context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                        sizeof(int), &a, &err);
-                    if (err != CL_SUCCESS || d_a == NULL)
-                    {
-                        subtest_fail("clCreateBuffer failed\n");
-                        continue;
-                    }
-                    err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &d_a);
-                    if (err != CL_SUCCESS)
-                    {
-                        subtest_fail("clSetKernelArg failed\n");
-                        continue;
-                    }
-                }
-                // For address space test if %p is tested
-                if (isKernelPFormat(allTestCase[testId], testNum))
-                {
-                    d_out = clCreateBuffer(context, CL_MEM_READ_WRITE,
-                                           sizeof(cl_ulong), NULL, &err);
-                    if (err != CL_SUCCESS || d_out == NULL)
-                    {
-                        subtest_fail("clCreateBuffer failed\n");
-                        continue;
-                    }
-                    err = clSetKernelArg(kernel, 1, sizeof(cl_mem), &d_out);
-                    if (err != CL_SUCCESS)
-                    {
-                        subtest_fail("clSetKernelArg failed\n");
-                        continue;
-                    }
-                }
-            }
-
-            fd = acquireOutputStream(&err);
-            if (err != 0)
-            {
-                subtest_fail("Error while redirection stdout to file");
-                continue;
-            }
-            globalWorkSize[0] = 1;
-            cl_event ndrEvt;
-            err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, globalWorkSize,
-                                         NULL, 0, NULL, &ndrEvt);
-            if (err != CL_SUCCESS)
-            {
-                releaseOutputStream(fd);
-                subtest_fail("\n clEnqueueNDRangeKernel failed errcode:%d\n",
-                             err);
-                continue;
-            }
-
-            fflush(stdout);
-            err = clFlush(queue);
-            if (err != CL_SUCCESS)
-            {
-                releaseOutputStream(fd);
-                subtest_fail("clFlush failed : %d\n", err);
-                continue;
-            }
-            // Wait until kernel finishes its execution and (thus) the output
-            // printed from the kernel is immediately printed
-            err = waitForEvent(&ndrEvt);
-
-            releaseOutputStream(fd);
-
-            if (err != CL_SUCCESS)
-            {
-                subtest_fail("waitforEvent failed : %d\n", err);
-                continue;
-            }
-            fflush(stdout);
-
-            if (allTestCase[testId]->_type == TYPE_ADDRESS_SPACE
-                && isKernelPFormat(allTestCase[testId], testNum))
-            {
-                // Read the OpenCL output buffer (d_out) to the host output
-                // array (out)
-                if (!is64bAddressSpace(device)) // 32-bit address space
-                {
-                    clEnqueueReadBuffer(queue, d_out, CL_TRUE, 0,
-                                        sizeof(cl_int), &out32, 0, NULL, NULL);
-                }
-                else // 64-bit address space
-                {
-                    clEnqueueReadBuffer(queue, d_out, CL_TRUE, 0,
-                                        sizeof(cl_ulong), &out64, 0, NULL,
-                                        NULL);
-                }
-            }
-
-            //
-            // Get the output printed from the kernel to _analysisBuffer
-            // and verify its correctness
-            getAnalysisBuffer(_analysisBuffer);
-            if (!is64bAddressSpace(device)) // 32-bit address space
-            {
-                if (0
-                    != verifyOutputBuffer(_analysisBuffer, allTestCase[testId],
-                                          testNum, (cl_ulong)out32))
-                {
-                    subtest_fail(
-                        "verifyOutputBuffer failed with kernel: "
-                        "\n%s\n expected: %s\n got:      %s\n",
-                        gLatestKernelSource.c_str(),
-                        allTestCase[testId]->_correctBuffer[testNum].c_str(),
-                        _analysisBuffer);
-                    continue;
-                }
-            }
-            else // 64-bit address space
-            {
-                if (0
-                    != verifyOutputBuffer(_analysisBuffer, allTestCase[testId],
-                                          testNum, out64))
-                {
-                    subtest_fail(
-                        "verifyOutputBuffer failed with kernel: "
-                        "\n%s\n expected: %s\n got:      %s\n",
-                        gLatestKernelSource.c_str(),
-                        allTestCase[testId]->_correctBuffer[testNum].c_str(),
-                        _analysisBuffer);
-                    continue;
-                }
-            }
+            if (gBatchCases && isBatchable(testId))
+                batchedCases.emplace_back(testNum, formatNum);
+            else
+                runPrintfCase(queue, context, device, testId, testNum,
+                              formatNum);
         }
         ++s_test_cnt;
     }
 
+    if (!batchedCases.empty())
+        runPrintfBatches(queue, context, device, testId, batchedCases);
+
     // all subtests skipped ?
     if (s_test_skip - skip_count == s_test_cnt - pass_count)
         return TEST_SKIPPED_ITSELF;
@@ -1098,14 +1307,44 @@ __kernel void test_printf_return(__global int *result)
     return TEST_PASS;
 }
 
+//-----------------------------------------
+// parseArgs
+//-----------------------------------------
+static test_status parseArgs(int& argc, const char* argv[],
+                             std::vector<std::string>& removed_args,
+                             std::string& help)
+{
+    help = "        -batch - Run the test cases of each test in as few kernels "
+           "as possible\n";
+
+    std::vector<const char*> argList;
+    argList.push_back(argv[0]);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-batch") == 0)
+        {
+            gBatchCases = true;
+            removed_args.push_back(argv[i]);
+        }
+        else
+        {
+            argList.push_back(argv[i]);
+        }
+    }
+
+    update_argc_argv_from_args_list(argList, argc, argv);
+    return TEST_PASS;
+}
+
 //-----------------------------------------
 // main
 //-----------------------------------------
 int main(int argc, const char* argv[])
 {
-    int err = runTestHarnessWithCheck(
+    int err = runTestHarnessWithCheckAndParse(
         argc, argv, test_registry::getInstance().num_tests(),
-        test_registry::getInstance().definitions(), true, 0, InitCL);
+        test_registry::getInstance().definitions(), true, 0, InitCL, parseArgs);
 
     if (gQueue)
     {
@@ -1120,27 +1359,11 @@ int main(int argc, const char* argv[])
     if (gContext && clReleaseContext(gContext) != CL_SUCCESS)
         log_error("clReleaseContext\n");
 
-    remove(gFileName);
     return err;
 }
 
 test_status InitCL( cl_device_id device )
 {
-    char* pcTempFname = get_temp_filename();
-    if (pcTempFname != nullptr)
-    {
-        strncpy(gFileName, pcTempFname, sizeof(gFileName) - 1);
-        gFileName[sizeof(gFileName) - 1] = '\0';
-    }
-
-    free(pcTempFname);
-
-    if (strlen(gFileName) == 0)
-    {
-        log_error("get_temp_filename failed\n");
-        return TEST_FAIL;
-    }
-
     gMTdata = MTdataHolder(gRandomSeed);
 
     uint32_t device_frequency = 0;
@@ -1150,7 +1373,7 @@ test_status InitCL( cl_device_id device )
     gFd = acquireOutputStream(&err);
     if (err != 0)
     {
-        log_error("Error while redirection stdout to file");
+        log_error("Error while redirecting stdout");
         return TEST_FAIL;
     }
 
@@ -1184,15 +1407,28 @@ test_status InitCL( cl_device_id device )
         return TEST_SKIP;
     }
 
+    err = clGetDeviceInfo(device, CL_DEVICE_PRINTF_BUFFER_SIZE,
+                          sizeof(gPrintfBufferSize), &gPrintfBufferSize, NULL);
+    if (err != CL_SUCCESS)
+    {
+        log_error("Unable to get the printf buffer size: %d\n", err);
+        return TEST_FAIL;
+    }
+
+    // Batched kernels print the output of many test cases at once
+    size_t armPrintfBufferSize = ANALYSIS_BUFFER_SIZE;
+    if (gBatchCases)
+        armPrintfBufferSize = std::max(armPrintfBufferSize, gPrintfBufferSize);
+
     gFd = acquireOutputStream(&err);
     if (err != 0)
     {
-        log_error("Error while redirection stdout to file");
+        log_error("Error while redirecting stdout");
         return TEST_FAIL;
     }
     cl_context_properties printf_properties[] = {
         CL_PRINTF_CALLBACK_ARM, (cl_context_properties)printfCallBack,
-        CL_PRINTF_BUFFERSIZE_ARM, ANALYSIS_BUFFER_SIZE, 0
+        CL_PRINTF_BUFFERSIZE_ARM, (cl_context_properties)armPrintfBufferSize, 0
     };
 
     cl_context_properties* props = NULL;
@@ -1202,14 +1438,17 @@ test_status InitCL( cl_device_id device )
         props = printf_properties;
     }
 
+    // Checked once stdout is restored, so that an early return doesn't leave
+    // it redirected with the reader thread still running.
     gContext = clCreateContext(props, 1, &device, notify_callback, NULL, NULL);
-    checkNull(gContext, "clCreateContext");
-
-    gQueue = clCreateCommandQueue(gContext, device, 0, NULL);
-    checkNull(gQueue, "clCreateCommandQueue");
+    if (gContext)
+        gQueue = clCreateCommandQueue(gContext, device, 0, NULL);
 
     releaseOutputStream(gFd);
 
+    checkNull(gContext, "clCreateContext");
+    checkNull(gQueue, "clCreateCommandQueue");
+
     if (is_extension_available(device, "cl_khr_fp16"))
     {
         const cl_device_fp_config fpConfigHalf =